@@ -0,0 +1,519 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief In-memory B+tree mapping unique keys to values
+ *
+ * Nodes are wide (up to MaxKeys keys) and keep their keys in one contiguous
+ * array so a lookup touches a handful of cache lines per level. Values live
+ * only in the leaves, which are linked in both directions for range scans.
+ *
+ * Duplicate keys are not stored; callers that need a multimap keep a
+ * container (e.g. a list of row ids) as the value.
+ */
+template <typename Key, typename Value, typename Compare = std::less<Key>, int MaxKeys = 64>
+class BPlusTree {
+    static_assert(MaxKeys >= 4, "B+tree nodes need room for at least four keys");
+
+    struct Node {
+        explicit Node(bool leaf) : isLeaf(leaf) {}
+        bool isLeaf;
+        std::vector<Key> keys;
+    };
+
+    struct Leaf : Node {
+        Leaf() : Node(true) { this->keys.reserve(MaxKeys + 1); values.reserve(MaxKeys + 1); }
+        std::vector<Value> values;
+        Leaf* prev = nullptr;
+        Leaf* next = nullptr;
+    };
+
+    struct Internal : Node {
+        Internal() : Node(false) { this->keys.reserve(MaxKeys + 1); children.reserve(MaxKeys + 2); }
+        std::vector<Node*> children;    // children[i] holds keys < keys[i] <= children[i + 1]
+    };
+
+    static constexpr int MinKeys = MaxKeys / 2;
+
+public:
+    /**
+     * @brief Position of an entry in the leaf chain
+     */
+    class Iterator {
+    public:
+        Iterator() = default;
+
+        const Key& key() const { return leaf->keys[index]; }
+        const Value& value() const { return leaf->values[index]; }
+        bool atEnd() const { return leaf == nullptr; }
+
+        Iterator& operator++() {
+            if (++index >= static_cast<int>(leaf->keys.size())) {
+                leaf = leaf->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        Iterator& operator--() {
+            if (--index < 0) {
+                leaf = leaf->prev;
+                index = leaf ? static_cast<int>(leaf->keys.size()) - 1 : 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return leaf == other.leaf && index == other.index; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class BPlusTree;
+        Iterator(const Leaf* leaf, int index) : leaf(leaf), index(index) {}
+
+        const Leaf* leaf = nullptr;
+        int index = 0;
+    };
+
+    explicit BPlusTree(const Compare& compare = Compare()) : less(compare) {}
+    ~BPlusTree() { destroy(root); }
+
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    BPlusTree(BPlusTree&& other) noexcept { swap(other); }
+    BPlusTree& operator=(BPlusTree&& other) noexcept {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+
+    int height() const {
+        int levels = 0;
+        for (const Node* node = root; node; node = node->isLeaf ? nullptr : static_cast<const Internal*>(node)->children.front()) {
+            levels++;
+        }
+        return levels;
+    }
+
+    void clear() {
+        destroy(root);
+        root = nullptr;
+        head = nullptr;
+        tail = nullptr;
+        count = 0;
+    }
+
+    // Point lookup; nullptr when the key is absent
+    const Value* find(const Key& key) const {
+        const Leaf* leaf = findLeaf(key);
+        if (!leaf) {
+            return nullptr;
+        }
+        int pos = lowerIndex(leaf->keys, key);
+        if (pos < static_cast<int>(leaf->keys.size()) && !less(key, leaf->keys[pos])) {
+            return &leaf->values[pos];
+        }
+        return nullptr;
+    }
+
+    Value* find(const Key& key) {
+        return const_cast<Value*>(static_cast<const BPlusTree*>(this)->find(key));
+    }
+
+    bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    // Inserts key -> value; returns false (and leaves the tree unchanged) if the key exists
+    bool insert(const Key& key, const Value& value) {
+        bool inserted = false;
+        locate(key, value, inserted);
+        return inserted;
+    }
+
+    // Returns the value for key, default-constructing it first if needed
+    Value& getOrInsert(const Key& key) {
+        bool inserted = false;
+        return *locate(key, Value(), inserted);
+    }
+
+    // Removes key; returns false if it was not present
+    bool erase(const Key& key) {
+        if (!root || !eraseFrom(root, key)) {
+            return false;
+        }
+        count--;
+
+        // Collapse the root once it is left with a single child
+        if (!root->isLeaf && static_cast<Internal*>(root)->keys.empty()) {
+            Internal* oldRoot = static_cast<Internal*>(root);
+            root = oldRoot->children.front();
+            oldRoot->children.clear();
+            delete oldRoot;
+        } else if (root->isLeaf && root->keys.empty()) {
+            clear();
+        }
+        return true;
+    }
+
+    // Iteration in key order
+    Iterator begin() const { return Iterator(head, 0); }
+    Iterator end() const { return Iterator(); }
+    Iterator last() const { return tail ? Iterator(tail, static_cast<int>(tail->keys.size()) - 1) : Iterator(); }
+
+    // First entry with key >= the given key
+    Iterator lowerBound(const Key& key) const {
+        const Leaf* leaf = findLeaf(key);
+        if (!leaf) {
+            return end();
+        }
+        return normalize(leaf, lowerIndex(leaf->keys, key));
+    }
+
+    // First entry with key > the given key
+    Iterator upperBound(const Key& key) const {
+        const Leaf* leaf = findLeaf(key);
+        if (!leaf) {
+            return end();
+        }
+        return normalize(leaf, upperIndex(leaf->keys, key));
+    }
+
+    // Calls visit(value) for every entry in key order, allowing in-place updates
+    template <typename Visitor>
+    void forEachValue(Visitor visit) {
+        for (Leaf* leaf = head; leaf; leaf = leaf->next) {
+            for (Value& value : leaf->values) {
+                visit(value);
+            }
+        }
+    }
+
+    /**
+     * @brief Replaces the contents with entries already sorted by key
+     *
+     * Builds the tree bottom-up in O(n) instead of n separate inserts.
+     * Entries with duplicate keys keep only the first occurrence.
+     */
+    void bulkLoad(std::vector<std::pair<Key, Value>>&& entries) {
+        clear();
+        entries.erase(std::unique(entries.begin(), entries.end(),
+            [this](const std::pair<Key, Value>& a, const std::pair<Key, Value>& b) {
+                return !less(a.first, b.first) && !less(b.first, a.first);
+            }), entries.end());
+
+        // Leaf level
+        std::vector<Node*> level;
+        std::vector<Key> levelMin;
+        int n = static_cast<int>(entries.size());
+        int i = 0;
+        for (int remaining = groupCount(n, MaxKeys); remaining > 0; remaining--) {
+            int take = (n - i) / remaining + ((n - i) % remaining ? 1 : 0);
+            Leaf* leaf = new Leaf();
+            for (int end = i + take; i < end; ++i) {
+                leaf->keys.push_back(std::move(entries[i].first));
+                leaf->values.push_back(std::move(entries[i].second));
+            }
+            leaf->prev = tail;
+            if (tail) {
+                tail->next = leaf;
+            } else {
+                head = leaf;
+            }
+            tail = leaf;
+            count += static_cast<int>(leaf->keys.size());
+            level.push_back(leaf);
+            levelMin.push_back(leaf->keys.front());
+        }
+
+        // Internal levels until a single root remains
+        while (level.size() > 1) {
+            std::vector<Node*> parents;
+            std::vector<Key> parentMin;
+            int m = static_cast<int>(level.size());
+            int j = 0;
+            for (int remaining = groupCount(m, MaxKeys + 1); remaining > 0; remaining--) {
+                int take = (m - j) / remaining + ((m - j) % remaining ? 1 : 0);
+                Internal* node = new Internal();
+                parentMin.push_back(levelMin[j]);
+                for (int end = j + take; j < end; ++j) {
+                    if (!node->children.empty()) {
+                        node->keys.push_back(levelMin[j]);
+                    }
+                    node->children.push_back(level[j]);
+                }
+                parents.push_back(node);
+            }
+            level.swap(parents);
+            levelMin.swap(parentMin);
+        }
+
+        root = level.empty() ? nullptr : level.front();
+    }
+
+private:
+    Node* root = nullptr;
+    Leaf* head = nullptr;
+    Leaf* tail = nullptr;
+    int count = 0;
+    Compare less;
+
+    void swap(BPlusTree& other) {
+        std::swap(root, other.root);
+        std::swap(head, other.head);
+        std::swap(tail, other.tail);
+        std::swap(count, other.count);
+        std::swap(less, other.less);
+    }
+
+    static int groupCount(int items, int perGroup) {
+        return (items + perGroup - 1) / perGroup;
+    }
+
+    static void destroy(Node* node) {
+        if (!node) {
+            return;
+        }
+        if (node->isLeaf) {
+            delete static_cast<Leaf*>(node);
+        } else {
+            Internal* internal = static_cast<Internal*>(node);
+            for (Node* child : internal->children) {
+                destroy(child);
+            }
+            delete internal;
+        }
+    }
+
+    int lowerIndex(const std::vector<Key>& keys, const Key& key) const {
+        return static_cast<int>(std::lower_bound(keys.begin(), keys.end(), key, less) - keys.begin());
+    }
+
+    int upperIndex(const std::vector<Key>& keys, const Key& key) const {
+        return static_cast<int>(std::upper_bound(keys.begin(), keys.end(), key, less) - keys.begin());
+    }
+
+    const Leaf* findLeaf(const Key& key) const {
+        const Node* node = root;
+        while (node && !node->isLeaf) {
+            const Internal* internal = static_cast<const Internal*>(node);
+            node = internal->children[upperIndex(internal->keys, key)];
+        }
+        return static_cast<const Leaf*>(node);
+    }
+
+    static Iterator normalize(const Leaf* leaf, int index) {
+        if (index >= static_cast<int>(leaf->keys.size())) {
+            return Iterator(leaf->next, 0);
+        }
+        return Iterator(leaf, index);
+    }
+
+    // Finds or inserts key, splitting full nodes on the way back up
+    Value* locate(const Key& key, const Value& value, bool& inserted) {
+        if (!root) {
+            Leaf* leaf = new Leaf();
+            root = head = tail = leaf;
+        }
+
+        Value* slot = nullptr;
+        Key separator;
+        Node* sibling = insertInto(root, key, value, inserted, slot, separator);
+        if (sibling) {
+            Internal* newRoot = new Internal();
+            newRoot->keys.push_back(std::move(separator));
+            newRoot->children.push_back(root);
+            newRoot->children.push_back(sibling);
+            root = newRoot;
+        }
+        if (inserted) {
+            count++;
+        }
+        return slot;
+    }
+
+    // Returns the new right sibling if node had to split, with its lowest key in separator
+    Node* insertInto(Node* node, const Key& key, const Value& value, bool& inserted, Value*& slot, Key& separator) {
+        if (node->isLeaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            int pos = lowerIndex(leaf->keys, key);
+            if (pos < static_cast<int>(leaf->keys.size()) && !less(key, leaf->keys[pos])) {
+                slot = &leaf->values[pos];
+                return nullptr;
+            }
+
+            leaf->keys.insert(leaf->keys.begin() + pos, key);
+            leaf->values.insert(leaf->values.begin() + pos, value);
+            inserted = true;
+
+            if (static_cast<int>(leaf->keys.size()) <= MaxKeys) {
+                slot = &leaf->values[pos];
+                return nullptr;
+            }
+
+            int mid = static_cast<int>(leaf->keys.size()) / 2;
+            Leaf* right = new Leaf();
+            right->keys.assign(std::make_move_iterator(leaf->keys.begin() + mid), std::make_move_iterator(leaf->keys.end()));
+            right->values.assign(std::make_move_iterator(leaf->values.begin() + mid), std::make_move_iterator(leaf->values.end()));
+            leaf->keys.resize(mid);
+            leaf->values.resize(mid);
+
+            right->next = leaf->next;
+            right->prev = leaf;
+            if (leaf->next) {
+                leaf->next->prev = right;
+            } else {
+                tail = right;
+            }
+            leaf->next = right;
+
+            slot = pos < mid ? &leaf->values[pos] : &right->values[pos - mid];
+            separator = right->keys.front();
+            return right;
+        }
+
+        Internal* internal = static_cast<Internal*>(node);
+        int childIndex = upperIndex(internal->keys, key);
+        Key childSeparator;
+        Node* childSibling = insertInto(internal->children[childIndex], key, value, inserted, slot, childSeparator);
+        if (!childSibling) {
+            return nullptr;
+        }
+
+        internal->keys.insert(internal->keys.begin() + childIndex, std::move(childSeparator));
+        internal->children.insert(internal->children.begin() + childIndex + 1, childSibling);
+        if (static_cast<int>(internal->keys.size()) <= MaxKeys) {
+            return nullptr;
+        }
+
+        // The middle key moves up; it is not repeated in either half
+        int mid = static_cast<int>(internal->keys.size()) / 2;
+        Internal* right = new Internal();
+        separator = std::move(internal->keys[mid]);
+        right->keys.assign(std::make_move_iterator(internal->keys.begin() + mid + 1), std::make_move_iterator(internal->keys.end()));
+        right->children.assign(internal->children.begin() + mid + 1, internal->children.end());
+        internal->keys.resize(mid);
+        internal->children.resize(mid + 1);
+        return right;
+    }
+
+    // Removes key below node, rebalancing children that drop under MinKeys
+    bool eraseFrom(Node* node, const Key& key) {
+        if (node->isLeaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            int pos = lowerIndex(leaf->keys, key);
+            if (pos >= static_cast<int>(leaf->keys.size()) || less(key, leaf->keys[pos])) {
+                return false;
+            }
+            leaf->keys.erase(leaf->keys.begin() + pos);
+            leaf->values.erase(leaf->values.begin() + pos);
+            return true;
+        }
+
+        Internal* internal = static_cast<Internal*>(node);
+        int childIndex = upperIndex(internal->keys, key);
+        if (!eraseFrom(internal->children[childIndex], key)) {
+            return false;
+        }
+        if (static_cast<int>(internal->children[childIndex]->keys.size()) < MinKeys) {
+            rebalance(internal, childIndex);
+        }
+        return true;
+    }
+
+    void rebalance(Internal* parent, int index) {
+        Node* left = index > 0 ? parent->children[index - 1] : nullptr;
+        Node* right = index + 1 < static_cast<int>(parent->children.size()) ? parent->children[index + 1] : nullptr;
+
+        if (left && static_cast<int>(left->keys.size()) > MinKeys) {
+            borrowFromLeft(parent, index);
+        } else if (right && static_cast<int>(right->keys.size()) > MinKeys) {
+            borrowFromRight(parent, index);
+        } else if (left) {
+            merge(parent, index - 1);
+        } else if (right) {
+            merge(parent, index);
+        }
+    }
+
+    void borrowFromLeft(Internal* parent, int index) {
+        Node* child = parent->children[index];
+        Node* left = parent->children[index - 1];
+        if (child->isLeaf) {
+            Leaf* leaf = static_cast<Leaf*>(child);
+            Leaf* sibling = static_cast<Leaf*>(left);
+            leaf->keys.insert(leaf->keys.begin(), std::move(sibling->keys.back()));
+            leaf->values.insert(leaf->values.begin(), std::move(sibling->values.back()));
+            sibling->keys.pop_back();
+            sibling->values.pop_back();
+            parent->keys[index - 1] = leaf->keys.front();
+        } else {
+            Internal* node = static_cast<Internal*>(child);
+            Internal* sibling = static_cast<Internal*>(left);
+            node->keys.insert(node->keys.begin(), std::move(parent->keys[index - 1]));
+            node->children.insert(node->children.begin(), sibling->children.back());
+            parent->keys[index - 1] = std::move(sibling->keys.back());
+            sibling->keys.pop_back();
+            sibling->children.pop_back();
+        }
+    }
+
+    void borrowFromRight(Internal* parent, int index) {
+        Node* child = parent->children[index];
+        Node* right = parent->children[index + 1];
+        if (child->isLeaf) {
+            Leaf* leaf = static_cast<Leaf*>(child);
+            Leaf* sibling = static_cast<Leaf*>(right);
+            leaf->keys.push_back(std::move(sibling->keys.front()));
+            leaf->values.push_back(std::move(sibling->values.front()));
+            sibling->keys.erase(sibling->keys.begin());
+            sibling->values.erase(sibling->values.begin());
+            parent->keys[index] = sibling->keys.front();
+        } else {
+            Internal* node = static_cast<Internal*>(child);
+            Internal* sibling = static_cast<Internal*>(right);
+            node->keys.push_back(std::move(parent->keys[index]));
+            node->children.push_back(sibling->children.front());
+            parent->keys[index] = std::move(sibling->keys.front());
+            sibling->keys.erase(sibling->keys.begin());
+            sibling->children.erase(sibling->children.begin());
+        }
+    }
+
+    // Folds children[index + 1] into children[index]
+    void merge(Internal* parent, int index) {
+        Node* left = parent->children[index];
+        Node* right = parent->children[index + 1];
+        if (left->isLeaf) {
+            Leaf* leaf = static_cast<Leaf*>(left);
+            Leaf* sibling = static_cast<Leaf*>(right);
+            std::move(sibling->keys.begin(), sibling->keys.end(), std::back_inserter(leaf->keys));
+            std::move(sibling->values.begin(), sibling->values.end(), std::back_inserter(leaf->values));
+            leaf->next = sibling->next;
+            if (sibling->next) {
+                sibling->next->prev = leaf;
+            } else {
+                tail = leaf;
+            }
+            delete sibling;
+        } else {
+            Internal* node = static_cast<Internal*>(left);
+            Internal* sibling = static_cast<Internal*>(right);
+            node->keys.push_back(std::move(parent->keys[index]));
+            std::move(sibling->keys.begin(), sibling->keys.end(), std::back_inserter(node->keys));
+            node->children.insert(node->children.end(), sibling->children.begin(), sibling->children.end());
+            sibling->children.clear();
+            delete sibling;
+        }
+        parent->keys.erase(parent->keys.begin() + index);
+        parent->children.erase(parent->children.begin() + index + 1);
+    }
+};
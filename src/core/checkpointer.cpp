@@ -0,0 +1,47 @@
+#include "checkpointer.h"
+#include "table_manager.h"
+
+Checkpointer::Checkpointer(TableManager* manager, int intervalMs)
+    : manager(manager), intervalMs(intervalMs) {
+}
+
+Checkpointer::~Checkpointer() {
+    stop();
+}
+
+void Checkpointer::requestCheckpoint() {
+    QMutexLocker locker(&mutex);
+    checkpointRequested = true;
+    wakeUp.wakeOne();
+}
+
+void Checkpointer::stop() {
+    {
+        QMutexLocker locker(&mutex);
+        stopRequested = true;
+        wakeUp.wakeOne();
+    }
+    wait();
+}
+
+void Checkpointer::setInterval(int intervalMs) {
+    QMutexLocker locker(&mutex);
+    this->intervalMs = intervalMs;
+    wakeUp.wakeOne();
+}
+
+void Checkpointer::run() {
+    while (true) {
+        {
+            QMutexLocker locker(&mutex);
+            if (!stopRequested && !checkpointRequested) {
+                wakeUp.wait(&mutex, static_cast<unsigned long>(intervalMs));
+            }
+            if (stopRequested) {
+                break;
+            }
+            checkpointRequested = false;
+        }
+        manager->checkpoint();
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+class TableManager;
+
+/**
+ * @brief Background thread that periodically checkpoints dirty tables
+ *
+ * Wakes every interval (or early when requestCheckpoint() is called, e.g.
+ * because the write-ahead log grew too large) and asks the TableManager to
+ * write out the tables changed since the previous checkpoint.
+ */
+class Checkpointer : public QThread {
+public:
+    explicit Checkpointer(TableManager* manager, int intervalMs = 5000);
+    ~Checkpointer() override;
+
+    void requestCheckpoint();
+    void stop();
+
+    void setInterval(int intervalMs);
+    int getInterval() const { return intervalMs; }
+
+protected:
+    void run() override;
+
+private:
+    TableManager* manager;
+    int intervalMs;
+    QMutex mutex;
+    QWaitCondition wakeUp;
+    bool stopRequested = false;
+    bool checkpointRequested = false;
+};
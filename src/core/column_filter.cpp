@@ -0,0 +1,374 @@
+#include "column_filter.h"
+#include "filter_kernels.h"
+#include "table_manager.h"
+#include "table_schema.h"
+#include "../parser/ast_nodes.h"
+#include <QDate>
+#include <QtAlgorithms>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Doubles hold every integer below this exactly, so integer bounds derived from
+// a literal under it select the same rows as the evaluator's double comparison
+constexpr double EXACT_INTEGER_LIMIT = 9007199254740992.0;  // 2^53
+
+// Julian day of 1970-01-01, the origin of ColumnVector dates
+constexpr qint64 EPOCH_JULIAN_DAY = 2440588;
+
+bool isBoolKeyword(const Expression* literal) {
+    return !literal->stringLiteral &&
+           (literal->value.compare("TRUE", Qt::CaseInsensitive) == 0 ||
+            literal->value.compare("FALSE", Qt::CaseInsensitive) == 0);
+}
+
+// Literal as the evaluator compares it against a numeric column
+bool literalNumber(const Expression* literal, double& number) {
+    if (literal->kind != Expression::LITERAL || isBoolKeyword(literal)) {
+        return false;
+    }
+    bool ok = false;
+    number = literal->value.toDouble(&ok);
+    return ok && !std::isnan(number);
+}
+
+// Date columns compare as text, which orders like the date only for canonical literals
+bool literalDate(const Expression* literal, qint64& days) {
+    if (literal->kind != Expression::LITERAL || !literal->stringLiteral) {
+        return false;
+    }
+    QDate date = QDate::fromString(literal->value, Qt::ISODate);
+    if (!date.isValid() || date.toString(Qt::ISODate) != literal->value) {
+        return false;
+    }
+    days = date.toJulianDay() - EPOCH_JULIAN_DAY;
+    return true;
+}
+
+// Literal as the evaluator compares it against a text column: as text unless it reads as a number
+bool literalText(const Expression* literal, QString& text) {
+    if (literal->kind != Expression::LITERAL || isBoolKeyword(literal)) {
+        return false;
+    }
+    bool number = false;
+    literal->value.toDouble(&number);
+    if (!literal->stringLiteral && number) {
+        return false;
+    }
+    text = literal->value;
+    return true;
+}
+
+Expression::Operator flipComparison(Expression::Operator op) {
+    switch (op) {
+        case Expression::LT: return Expression::GT;
+        case Expression::LE: return Expression::GE;
+        case Expression::GT: return Expression::LT;
+        case Expression::GE: return Expression::LE;
+        default:             return op;
+    }
+}
+
+void collectConjuncts(const Expression* expression, QVector<const Expression*>& conjuncts) {
+    if (expression->kind == Expression::BINARY && expression->op == Expression::AND &&
+        expression->children.size() == 2) {
+        collectConjuncts(expression->children[0].get(), conjuncts);
+        collectConjuncts(expression->children[1].get(), conjuncts);
+    } else {
+        conjuncts.append(expression);
+    }
+}
+
+}
+
+std::unique_ptr<ColumnFilter> ColumnFilter::plan(const Expression* condition, const TableSchema& schema) {
+    if (!condition) {
+        return nullptr;
+    }
+
+    QVector<const Expression*> conjuncts;
+    collectConjuncts(condition, conjuncts);
+
+    std::unique_ptr<ColumnFilter> filter(new ColumnFilter());
+    for (const Expression* conjunct : conjuncts) {
+        Term term;
+        if (planTerm(conjunct, schema, term)) {
+            filter->terms.append(term);
+        }
+    }
+    if (filter->terms.isEmpty()) {
+        return nullptr;
+    }
+    return filter;
+}
+
+bool ColumnFilter::planTerm(const Expression* expression, const TableSchema& schema, Term& term) {
+    const auto& children = expression->children;
+
+    switch (expression->kind) {
+        case Expression::BINARY: {
+            if (children.size() != 2 || expression->op < Expression::EQ || expression->op > Expression::GE ||
+                expression->op == Expression::NE) {
+                return false;
+            }
+            // Column on the left; a literal on the left flips the comparison
+            if (children[0]->kind == Expression::COLUMN) {
+                return bindColumn(children[0].get(), schema, term) &&
+                       applyBound(term, expression->op, children[1].get());
+            }
+            if (children[1]->kind == Expression::COLUMN) {
+                return bindColumn(children[1].get(), schema, term) &&
+                       applyBound(term, flipComparison(expression->op), children[0].get());
+            }
+            return false;
+        }
+
+        case Expression::BETWEEN:
+            if (expression->negated || children.size() != 3 || children[0]->kind != Expression::COLUMN) {
+                return false;
+            }
+            return bindColumn(children[0].get(), schema, term) &&
+                   applyBound(term, Expression::GE, children[1].get()) &&
+                   applyBound(term, Expression::LE, children[2].get());
+
+        case Expression::IN_LIST:
+            if (expression->negated || children.size() < 2 || children[0]->kind != Expression::COLUMN ||
+                !bindColumn(children[0].get(), schema, term)) {
+                return false;
+            }
+            term.inList = true;
+            for (int i = 1; i < children.size(); ++i) {
+                if (!addItem(term, children[i].get())) {
+                    return false;
+                }
+            }
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool ColumnFilter::bindColumn(const Expression* expression, const TableSchema& schema, Term& term) {
+    int ordinal = schema.getColumnIndex(expression->value);
+    const Column* column = schema.getColumn(ordinal);
+    if (ordinal < 0 || !column) {
+        return false;
+    }
+
+    term.column = ordinal;
+    term.storage = ColumnVector::storageFor(column->getType());
+    term.intLow = std::numeric_limits<qint64>::min();
+    term.intHigh = std::numeric_limits<qint64>::max();
+    term.doubleLow = -std::numeric_limits<double>::infinity();
+    term.doubleHigh = std::numeric_limits<double>::infinity();
+    // Text terms are tested on dictionary codes, so only types that start dictionary encoded qualify
+    return term.storage == ColumnVector::Storage::Int64 ||
+           term.storage == ColumnVector::Storage::Double ||
+           term.storage == ColumnVector::Storage::Date ||
+           (term.storage == ColumnVector::Storage::Text && ColumnVector::prefersDictionary(column->getType()));
+}
+
+// Narrows the term's range by "column op literal"
+bool ColumnFilter::applyBound(Term& term, int op, const Expression* literal) {
+    const bool lower = op == Expression::GT || op == Expression::GE || op == Expression::EQ;
+    const bool upper = op == Expression::LT || op == Expression::LE || op == Expression::EQ;
+    const bool strict = op == Expression::GT || op == Expression::LT;
+
+    if (term.storage == ColumnVector::Storage::Text) {
+        // Codes carry no order, so only equality becomes a one-item IN test
+        QString text;
+        if (op != Expression::EQ || !literalText(literal, text)) {
+            return false;
+        }
+        term.inList = true;
+        term.textItems.append(text);
+        return true;
+    }
+
+    if (term.storage == ColumnVector::Storage::Date) {
+        qint64 days = 0;
+        if (!literalDate(literal, days)) {
+            return false;
+        }
+        if (lower) {
+            term.intLow = qMax(term.intLow, strict ? days + 1 : days);
+        }
+        if (upper) {
+            term.intHigh = qMin(term.intHigh, strict ? days - 1 : days);
+        }
+        return true;
+    }
+
+    double number = 0.0;
+    if (!literalNumber(literal, number)) {
+        return false;
+    }
+
+    if (term.storage == ColumnVector::Storage::Double) {
+        const double infinity = std::numeric_limits<double>::infinity();
+        if (lower) {
+            term.doubleLow = qMax(term.doubleLow, strict ? std::nextafter(number, infinity) : number);
+        }
+        if (upper) {
+            term.doubleHigh = qMin(term.doubleHigh, strict ? std::nextafter(number, -infinity) : number);
+        }
+        return true;
+    }
+
+    // Past 2^53 integer and double order can disagree; leave that side unbounded
+    if (std::fabs(number) >= EXACT_INTEGER_LIMIT) {
+        return true;
+    }
+    if (lower) {
+        qint64 bound = static_cast<qint64>(strict ? std::floor(number) + 1 : std::ceil(number));
+        term.intLow = qMax(term.intLow, bound);
+    }
+    if (upper) {
+        qint64 bound = static_cast<qint64>(strict ? std::ceil(number) - 1 : std::floor(number));
+        term.intHigh = qMin(term.intHigh, bound);
+    }
+    return true;
+}
+
+// Adds one IN-list item; returns false when the list cannot be tested natively
+bool ColumnFilter::addItem(Term& term, const Expression* literal) {
+    // NULL never makes IN true, and TRUE/FALSE compare as booleans
+    if (literal->kind == Expression::NULL_LITERAL) {
+        return true;
+    }
+    if (literal->kind != Expression::LITERAL || isBoolKeyword(literal)) {
+        return false;
+    }
+
+    if (term.storage == ColumnVector::Storage::Text) {
+        QString text;
+        if (!literalText(literal, text)) {
+            // A number compares numerically with cells that parse as one
+            return false;
+        }
+        term.textItems.append(text);
+        return true;
+    }
+
+    if (term.storage == ColumnVector::Storage::Date) {
+        // Anything but a canonical date literal can never equal a canonical date
+        qint64 days = 0;
+        if (literalDate(literal, days)) {
+            term.intItems.append(days);
+        }
+        return true;
+    }
+
+    double number = 0.0;
+    if (!literalNumber(literal, number)) {
+        // Compared as text against the cell's number; only a number's text could match
+        return false;
+    }
+    if (term.storage == ColumnVector::Storage::Double) {
+        term.doubleItems.append(number);
+        return true;
+    }
+    if (std::fabs(number) >= EXACT_INTEGER_LIMIT) {
+        return false;
+    }
+    if (std::floor(number) == number) {
+        term.intItems.append(static_cast<qint64>(number));
+    }
+    return true;
+}
+
+QVector<int> ColumnFilter::select(const TableScan& rows) const {
+    const int slotCount = rows.slotCount();
+    const int words = (slotCount + 63) / 64;
+
+    QVector<quint64> selection(words, ~quint64(0));
+    if (slotCount % 64 != 0) {
+        selection.last() = (quint64(1) << (slotCount % 64)) - 1;
+    }
+    QVector<quint64> bits(words);
+
+    for (const Term& term : terms) {
+        if (term.column >= rows.columnCount()) {
+            continue;
+        }
+        // Tables written before columns were typed may still hold this column as text
+        const ColumnVector& column = rows.column(term.column);
+        if (column.getStorage() != term.storage || column.size() != slotCount) {
+            continue;
+        }
+
+        switch (term.storage) {
+            case ColumnVector::Storage::Int64:
+                if (term.inList) {
+                    FilterKernels::selectIn(column.int64Data(), slotCount, term.intItems, bits.data());
+                } else {
+                    FilterKernels::selectRange(column.int64Data(), slotCount, term.intLow, term.intHigh, bits.data());
+                }
+                break;
+            case ColumnVector::Storage::Double:
+                if (term.inList) {
+                    FilterKernels::selectIn(column.doubleData(), slotCount, term.doubleItems, bits.data());
+                } else {
+                    FilterKernels::selectRange(column.doubleData(), slotCount, term.doubleLow, term.doubleHigh, bits.data());
+                }
+                break;
+            case ColumnVector::Storage::Date:
+                if (term.inList) {
+                    QVector<qint32> items;
+                    for (qint64 days : term.intItems) {
+                        if (days >= std::numeric_limits<qint32>::min() && days <= std::numeric_limits<qint32>::max()) {
+                            items.append(static_cast<qint32>(days));
+                        }
+                    }
+                    FilterKernels::selectIn(column.dateData(), slotCount, items, bits.data());
+                } else {
+                    qint64 low = qMax<qint64>(term.intLow, std::numeric_limits<qint32>::min());
+                    qint64 high = qMin<qint64>(term.intHigh, std::numeric_limits<qint32>::max());
+                    FilterKernels::selectRange(column.dateData(), slotCount, static_cast<qint32>(low),
+                                               static_cast<qint32>(high), bits.data());
+                }
+                break;
+            case ColumnVector::Storage::Text: {
+                // Columns that left dictionary encoding are left to the full condition
+                if (!column.isDictionaryEncoded()) {
+                    continue;
+                }
+                QVector<qint32> items;
+                for (const QString& text : term.textItems) {
+                    qint32 code = column.codeOf(text);
+                    if (code >= 0) {
+                        items.append(code);
+                    }
+                }
+                FilterKernels::selectIn(column.codeData(), slotCount, items, bits.data());
+                break;
+            }
+            case ColumnVector::Storage::Bool:
+                continue;
+        }
+
+        // NULLs never pass; verbatim cells are left for the full condition
+        const quint64* nulls = column.nullData();
+        for (int w = 0; w < words; ++w) {
+            bits[w] &= ~nulls[w];
+        }
+        for (int slot : column.verbatimSlots()) {
+            bits[slot >> 6] |= quint64(1) << (slot & 63);
+        }
+        for (int w = 0; w < words; ++w) {
+            selection[w] &= bits[w];
+        }
+    }
+
+    QVector<int> candidates;
+    for (int w = 0; w < words; ++w) {
+        quint64 word = selection[w];
+        while (word) {
+            candidates.append(w * 64 + static_cast<int>(qCountTrailingZeroBits(word)));
+            word &= word - 1;
+        }
+    }
+    return candidates;
+}
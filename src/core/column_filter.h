@@ -0,0 +1,62 @@
+#pragma once
+
+#include "column_vector.h"
+#include <QString>
+#include <QVector>
+#include <memory>
+
+class Expression;
+class TableSchema;
+class TableScan;
+
+/**
+ * @brief WHERE pre-filter run with vectorized kernels over typed columns
+ *
+ * Planned from the top-level AND terms of a condition that compare an
+ * integer, floating-point or DATE column against literals (=, <, <=, >,
+ * >=, BETWEEN, IN). Each term becomes one inclusive range or IN-list test
+ * run by FilterKernels over the column's native array; the per-term
+ * bitmaps are ANDed into the set of slots worth testing. Equality and IN
+ * on a dictionary encoded text column are tested on its codes, after
+ * looking the literals up in the column's dictionary once.
+ *
+ * The result is a superset of the matching rows: NULLs are dropped (a
+ * comparison with NULL is never TRUE), cells kept as verbatim text are
+ * always kept, and every surviving row must still pass the full
+ * CompiledExpression. Other terms (OR, LIKE, text ranges) are left to
+ * that row-at-a-time check.
+ */
+class ColumnFilter {
+public:
+    // Returns nullptr when no term of the condition can be vectorized
+    static std::unique_ptr<ColumnFilter> plan(const Expression* condition, const TableSchema& schema);
+
+    // Slots whose rows may match, in slot order
+    QVector<int> select(const TableScan& rows) const;
+
+    int termCount() const { return terms.size(); }
+
+private:
+    ColumnFilter() = default;
+
+    struct Term {
+        int column = -1;
+        ColumnVector::Storage storage = ColumnVector::Storage::Int64;
+        bool inList = false;
+        // Inclusive bounds; dates use the integer bounds
+        qint64 intLow = 0;
+        qint64 intHigh = 0;
+        double doubleLow = 0.0;
+        double doubleHigh = 0.0;
+        QVector<qint64> intItems;
+        QVector<double> doubleItems;
+        QVector<QString> textItems;
+    };
+
+    QVector<Term> terms;
+
+    static bool planTerm(const Expression* expression, const TableSchema& schema, Term& term);
+    static bool bindColumn(const Expression* expression, const TableSchema& schema, Term& term);
+    static bool applyBound(Term& term, int op, const Expression* literal);
+    static bool addItem(Term& term, const Expression* literal);
+};
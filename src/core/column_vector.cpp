@@ -0,0 +1,413 @@
+#include "column_vector.h"
+#include <QDate>
+#include <QLocale>
+#include <cmath>
+
+namespace {
+
+// Spellings a BOOL cell is stored natively for; the low bit of the index is the value
+const char* const BOOL_SPELLINGS[] = {"false", "true", "FALSE", "TRUE", "0", "1"};
+constexpr int BOOL_SPELLING_COUNT = 6;
+
+// Julian day of 1970-01-01
+constexpr qint64 EPOCH_JULIAN_DAY = 2440588;
+
+// The arena is rewritten once this much of it is unreferenced and it is mostly garbage
+constexpr qint64 MIN_ARENA_GARBAGE = 1 << 20;
+
+QString renderDouble(double value) {
+    return QString::number(value, 'g', QLocale::FloatingPointShortest);
+}
+
+QString renderDate(qint32 days) {
+    return QDate::fromJulianDay(days + EPOCH_JULIAN_DAY).toString(Qt::ISODate);
+}
+
+}
+
+ColumnVector::ColumnVector(DataType type)
+    : type(type), storage(storageFor(type)) {
+    dictionary = storage == Storage::Text && prefersDictionary(type);
+}
+
+ColumnVector::Storage ColumnVector::storageFor(DataType type) {
+    switch (type) {
+        case DataType::TINYINT:
+        case DataType::SMALLINT:
+        case DataType::INT:
+        case DataType::BIGINT:
+            return Storage::Int64;
+        case DataType::FLOAT:
+        case DataType::DOUBLE:
+            return Storage::Double;
+        case DataType::BOOL:
+            return Storage::Bool;
+        case DataType::DATE:
+            return Storage::Date;
+        default:
+            // DECIMAL/NUMERIC stay text so their digits are kept exactly
+            return Storage::Text;
+    }
+}
+
+bool ColumnVector::prefersDictionary(DataType type) {
+    switch (type) {
+        case DataType::CHAR:
+        case DataType::VARCHAR:
+        case DataType::TEXT:
+        case DataType::NCHAR:
+        case DataType::NVARCHAR:
+        case DataType::TINYTEXT:
+        case DataType::ENUM:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void ColumnVector::append(const QString& value) {
+    openSlot(count);
+    assign(count - 1, value);
+}
+
+void ColumnVector::insert(int slot, const QString& value) {
+    openSlot(slot);
+    assign(slot, value);
+}
+
+void ColumnVector::set(int slot, const QString& value) {
+    release(slot);
+    assign(slot, value);
+
+    if (garbage >= MIN_ARENA_GARBAGE && garbage * 2 > arena.size()) {
+        rebuildArena();
+    }
+}
+
+QString ColumnVector::value(int slot) const {
+    if (isNull(slot)) {
+        return QString();
+    }
+    if (!verbatim.isEmpty()) {
+        auto it = verbatim.constFind(slot);
+        if (it != verbatim.constEnd()) {
+            return it.value();
+        }
+    }
+
+    switch (storage) {
+        case Storage::Int64:
+            return QString::number(ints[slot]);
+        case Storage::Double:
+            return renderDouble(doubles[slot]);
+        case Storage::Bool:
+            return QString::fromLatin1(BOOL_SPELLINGS[boolCodes[slot]]);
+        case Storage::Date:
+            return renderDate(dates[slot]);
+        case Storage::Text:
+            break;
+    }
+    if (dictionary) {
+        return dictionaryValues[codes[slot]];
+    }
+    return QString(arena.constData() + offsets[slot], lengths[slot]);
+}
+
+void ColumnVector::compact(const QVector<bool>& keep) {
+    if (storage == Storage::Text) {
+        // Re-adding the kept values drops stale dictionary entries and arena garbage, and
+        // lets a column that has become repetitive go back to dictionary encoding
+        ColumnVector rebuilt(type);
+        for (int slot = 0; slot < count; ++slot) {
+            if (keep[slot]) {
+                rebuilt.append(value(slot));
+            }
+        }
+        *this = rebuilt;
+        return;
+    }
+
+    QHash<int, QString> oldVerbatim;
+    oldVerbatim.swap(verbatim);
+
+    int kept = 0;
+    for (int slot = 0; slot < count; ++slot) {
+        if (!keep[slot]) {
+            continue;
+        }
+        setBit(nulls, kept, testBit(nulls, slot));
+        switch (storage) {
+            case Storage::Int64:
+                ints[kept] = ints[slot];
+                break;
+            case Storage::Double:
+                doubles[kept] = doubles[slot];
+                break;
+            case Storage::Bool:
+                boolCodes[kept] = boolCodes[slot];
+                break;
+            case Storage::Date:
+                dates[kept] = dates[slot];
+                break;
+            case Storage::Text:
+                break;
+        }
+        auto it = oldVerbatim.constFind(slot);
+        if (it != oldVerbatim.constEnd()) {
+            verbatim.insert(kept, it.value());
+        }
+        kept++;
+    }
+    truncate(kept);
+    nulls.squeeze();
+    ints.squeeze();
+    doubles.squeeze();
+    boolCodes.squeeze();
+    dates.squeeze();
+}
+
+void ColumnVector::truncate(int slotCount) {
+    if (slotCount >= count) {
+        return;
+    }
+    if (slotCount == 0) {
+        clear();
+        return;
+    }
+    if (storage == Storage::Text && !dictionary) {
+        for (int slot = slotCount; slot < count; ++slot) {
+            garbage += lengths[slot];
+        }
+    }
+    if (!verbatim.isEmpty()) {
+        for (auto it = verbatim.begin(); it != verbatim.end();) {
+            it = it.key() >= slotCount ? verbatim.erase(it) : ++it;
+        }
+    }
+
+    count = slotCount;
+    nulls.resize((count + 63) / 64);
+    // Clear the bits past the end so reopened slots start clean
+    if (count % 64 != 0) {
+        nulls.last() &= (quint64(1) << (count % 64)) - 1;
+    }
+    switch (storage) {
+        case Storage::Int64:
+            ints.resize(count);
+            break;
+        case Storage::Double:
+            doubles.resize(count);
+            break;
+        case Storage::Bool:
+            boolCodes.resize(count);
+            break;
+        case Storage::Date:
+            dates.resize(count);
+            break;
+        case Storage::Text:
+            codes.resize(dictionary ? count : 0);
+            offsets.resize(dictionary ? 0 : count);
+            lengths.resize(dictionary ? 0 : count);
+            break;
+    }
+}
+
+void ColumnVector::reserve(int slotCount) {
+    nulls.reserve((slotCount + 63) / 64);
+    switch (storage) {
+        case Storage::Int64:
+            ints.reserve(slotCount);
+            break;
+        case Storage::Double:
+            doubles.reserve(slotCount);
+            break;
+        case Storage::Bool:
+            boolCodes.reserve(slotCount);
+            break;
+        case Storage::Date:
+            dates.reserve(slotCount);
+            break;
+        case Storage::Text:
+            if (dictionary) {
+                codes.reserve(slotCount);
+            } else {
+                offsets.reserve(slotCount);
+                lengths.reserve(slotCount);
+            }
+            break;
+    }
+}
+
+void ColumnVector::clear() {
+    *this = ColumnVector(type);
+}
+
+void ColumnVector::setBit(QVector<quint64>& bits, int slot, bool on) {
+    quint64 mask = quint64(1) << (slot & 63);
+    if (on) {
+        bits[slot >> 6] |= mask;
+    } else {
+        bits[slot >> 6] &= ~mask;
+    }
+}
+
+void ColumnVector::openSlot(int slot) {
+    count++;
+    if (nulls.size() * 64 < count) {
+        nulls.append(0);
+    }
+    // Appends are the common case; a slot in the middle shifts the rest up by one
+    for (int i = count - 1; i > slot; --i) {
+        setBit(nulls, i, testBit(nulls, i - 1));
+    }
+    setBit(nulls, slot, false);
+
+    switch (storage) {
+        case Storage::Int64:
+            ints.insert(slot, 0);
+            break;
+        case Storage::Double:
+            doubles.insert(slot, 0.0);
+            break;
+        case Storage::Bool:
+            boolCodes.insert(slot, 0);
+            break;
+        case Storage::Date:
+            dates.insert(slot, 0);
+            break;
+        case Storage::Text:
+            if (dictionary) {
+                codes.insert(slot, 0);
+            } else {
+                offsets.insert(slot, arena.size());
+                lengths.insert(slot, 0);
+            }
+            break;
+    }
+
+    if (!verbatim.isEmpty() && slot < count - 1) {
+        QHash<int, QString> shifted;
+        for (auto it = verbatim.constBegin(); it != verbatim.constEnd(); ++it) {
+            shifted.insert(it.key() >= slot ? it.key() + 1 : it.key(), it.value());
+        }
+        verbatim.swap(shifted);
+    }
+}
+
+void ColumnVector::assign(int slot, const QString& value) {
+    if (value.isEmpty()) {
+        setBit(nulls, slot, true);
+        return;
+    }
+    setBit(nulls, slot, false);
+
+    bool native = false;
+    switch (storage) {
+        case Storage::Int64: {
+            qint64 number = value.toLongLong(&native);
+            native = native && QString::number(number) == value;
+            ints[slot] = native ? number : 0;
+            break;
+        }
+        case Storage::Double: {
+            double number = value.toDouble(&native);
+            // NaN compares unlike any number, so it is left to the text path
+            native = native && !std::isnan(number) && renderDouble(number) == value;
+            doubles[slot] = native ? number : 0.0;
+            break;
+        }
+        case Storage::Bool:
+            boolCodes[slot] = 0;
+            for (int code = 0; code < BOOL_SPELLING_COUNT; ++code) {
+                if (value == QLatin1String(BOOL_SPELLINGS[code])) {
+                    boolCodes[slot] = static_cast<quint8>(code);
+                    native = true;
+                    break;
+                }
+            }
+            break;
+        case Storage::Date: {
+            QDate date = QDate::fromString(value, Qt::ISODate);
+            native = date.isValid();
+            if (native) {
+                qint32 days = static_cast<qint32>(date.toJulianDay() - EPOCH_JULIAN_DAY);
+                native = renderDate(days) == value;
+                dates[slot] = native ? days : 0;
+            }
+            break;
+        }
+        case Storage::Text:
+            if (dictionary) {
+                qint32 code = encode(value);
+                if (code >= 0) {
+                    codes[slot] = code;
+                    return;
+                }
+                leaveDictionary(slot);
+            }
+            offsets[slot] = arena.size();
+            lengths[slot] = static_cast<qint32>(value.size());
+            arena.append(value);
+            return;
+    }
+
+    if (!native) {
+        verbatim.insert(slot, value);
+    }
+}
+
+void ColumnVector::release(int slot) {
+    if (storage == Storage::Text && !dictionary) {
+        garbage += lengths[slot];
+        lengths[slot] = 0;
+    } else if (!verbatim.isEmpty()) {
+        verbatim.remove(slot);
+    }
+}
+
+void ColumnVector::rebuildArena() {
+    QString compacted;
+    compacted.reserve(arena.size() - garbage);
+    for (int slot = 0; slot < count; ++slot) {
+        qint64 offset = compacted.size();
+        compacted.append(arena.constData() + offsets[slot], lengths[slot]);
+        offsets[slot] = offset;
+    }
+    arena = compacted;
+    garbage = 0;
+}
+
+qint32 ColumnVector::encode(const QString& value) {
+    auto it = dictionaryCodes.constFind(value);
+    if (it != dictionaryCodes.constEnd()) {
+        return it.value();
+    }
+
+    const int entries = dictionaryValues.size();
+    if (entries >= MAX_DICTIONARY_SIZE || (entries >= MIN_DICTIONARY_SAMPLE && entries * 2 > count)) {
+        return -1;
+    }
+    qint32 code = static_cast<qint32>(entries);
+    dictionaryValues.append(value);
+    dictionaryCodes.insert(value, code);
+    return code;
+}
+
+void ColumnVector::leaveDictionary(int openSlot) {
+    offsets.resize(count);
+    lengths.resize(count);
+    for (int slot = 0; slot < count; ++slot) {
+        offsets[slot] = arena.size();
+        lengths[slot] = 0;
+        if (slot != openSlot && !isNull(slot)) {
+            const QString& text = dictionaryValues[codes[slot]];
+            lengths[slot] = static_cast<qint32>(text.size());
+            arena.append(text);
+        }
+    }
+
+    dictionary = false;
+    codes = QVector<qint32>();
+    dictionaryValues = QVector<QString>();
+    dictionaryCodes = QHash<QString, qint32>();
+}
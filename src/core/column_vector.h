@@ -0,0 +1,130 @@
+#pragma once
+
+#include "data_type.h"
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+/**
+ * @brief One column of a RowStore, held in its type's native representation
+ *
+ * Integer types are stored as int64, FLOAT/DOUBLE as double, BOOL as a
+ * one-byte code and DATE as int32 days since 1970-01-01. Every other type
+ * is text, kept in a single per-column character arena addressed by
+ * offset and length instead of one heap-allocated QString per cell.
+ * NULLs (empty values) live in a bitmap.
+ *
+ * Short string types (CHAR, VARCHAR, TEXT, ENUM and their variants) start
+ * out dictionary encoded: each distinct value is stored once and cells hold
+ * an int32 code. A column whose values turn out to be mostly distinct moves
+ * to the arena; compact() re-decides from the values that are left.
+ *
+ * The engine's values are text, so a column has to give back exactly the
+ * string it was given. A value whose text is not the canonical rendering of
+ * its native value ("007" in an INT column, "1.50" in a DOUBLE column) is
+ * kept verbatim on the side and still reads back unchanged; scans treat such
+ * cells as non-native.
+ */
+class ColumnVector {
+public:
+    enum class Storage {
+        Int64,
+        Double,
+        Bool,
+        Date,
+        Text
+    };
+
+    // A dictionary takes no more values once it holds MAX_DICTIONARY_SIZE of them, or once
+    // it holds MIN_DICTIONARY_SAMPLE and they are most of the values seen. Table files
+    // decide which values go to their dictionary pages by the same rule.
+    static constexpr int MAX_DICTIONARY_SIZE = 1 << 16;
+    static constexpr int MIN_DICTIONARY_SAMPLE = 1024;
+
+    explicit ColumnVector(DataType type = DataType::VARCHAR);
+
+    static Storage storageFor(DataType type);
+    // Text types that begin dictionary encoded
+    static bool prefersDictionary(DataType type);
+
+    DataType getType() const { return type; }
+    Storage getStorage() const { return storage; }
+    int size() const { return count; }
+
+    void append(const QString& value);
+    void insert(int slot, const QString& value);
+    void set(int slot, const QString& value);
+    QString value(int slot) const;
+
+    bool isNull(int slot) const { return testBit(nulls, slot); }
+    // True when the cell holds a native value (not NULL, not kept as text)
+    bool isNative(int slot) const {
+        return storage != Storage::Text && !isNull(slot) && (verbatim.isEmpty() || !verbatim.contains(slot));
+    }
+    qint64 int64At(int slot) const { return ints[slot]; }
+    double doubleAt(int slot) const { return doubles[slot]; }
+    bool boolAt(int slot) const { return (boolCodes[slot] & 1) != 0; }
+    qint32 dateAt(int slot) const { return dates[slot]; }
+
+    // Dictionary encoded text: a cell's code indexes dictionaryValue(); codes of NULL cells are meaningless
+    bool isDictionaryEncoded() const { return dictionary; }
+    qint32 codeAt(int slot) const { return codes[slot]; }
+    int dictionarySize() const { return dictionaryValues.size(); }
+    const QString& dictionaryValue(qint32 code) const { return dictionaryValues[code]; }
+    // -1 when no cell was ever given the value
+    qint32 codeOf(const QString& value) const { return dictionaryCodes.value(value, -1); }
+
+    // Raw arrays for vectorized scans; cells that are not native hold zero
+    const qint64* int64Data() const { return ints.constData(); }
+    const double* doubleData() const { return doubles.constData(); }
+    const qint32* dateData() const { return dates.constData(); }
+    const qint32* codeData() const { return codes.constData(); }
+    // NULL bitmap, one bit per slot in 64-bit words
+    const quint64* nullData() const { return nulls.constData(); }
+    // Slots of a typed column whose text is kept verbatim
+    QList<int> verbatimSlots() const { return verbatim.keys(); }
+
+    // Keeps the slots whose flag is set, in order
+    void compact(const QVector<bool>& keep);
+    // Drops every slot from the given one on
+    void truncate(int slotCount);
+    void reserve(int slotCount);
+    void clear();
+
+private:
+    DataType type;
+    Storage storage;
+    int count = 0;
+
+    QVector<quint64> nulls;         // bit per slot, set for NULL
+    QVector<qint64> ints;           // Int64
+    QVector<double> doubles;        // Double
+    QVector<quint8> boolCodes;      // Bool: index into the accepted spellings, low bit is the value
+    QVector<qint32> dates;          // Date: days since 1970-01-01
+    QString arena;                  // Text: every value back to back
+    QVector<qint64> offsets;        // Text: slot -> start in arena
+    QVector<qint32> lengths;        // Text: slot -> length in arena
+    qint64 garbage = 0;             // Text: arena characters no slot refers to any more
+    QHash<int, QString> verbatim;   // Typed columns: slot -> text that is not the canonical rendering
+    bool dictionary = false;        // Text: cells are codes instead of arena ranges
+    QVector<qint32> codes;          // Dictionary: slot -> code
+    QVector<QString> dictionaryValues;       // Dictionary: code -> value
+    QHash<QString, qint32> dictionaryCodes;  // Dictionary: value -> code
+
+    static bool testBit(const QVector<quint64>& bits, int slot) {
+        return (bits[slot >> 6] >> (slot & 63)) & 1;
+    }
+    static void setBit(QVector<quint64>& bits, int slot, bool on);
+
+    // Grows every array by one default cell at slot
+    void openSlot(int slot);
+    // Stores value into an open slot
+    void assign(int slot, const QString& value);
+    // Drops the slot's text from the arena and side table
+    void release(int slot);
+    void rebuildArena();
+    // Code for value, adding it to the dictionary; -1 when the column should leave dictionary encoding
+    qint32 encode(const QString& value);
+    // Moves every cell but the open slot from codes to the arena
+    void leaveDictionary(int openSlot);
+};
@@ -60,6 +60,11 @@ DataType DataTypeManager::stringToType(const QString& str) {
     return DataType::INT; // Default fallback
 }
 
+bool DataTypeManager::isTypeName(const QString& str) {
+    QString upper = str.toUpper();
+    return upper == "INT" || upper == "INTEGER" || stringToType(str) != DataType::INT;
+}
+
 int DataTypeManager::getTypeSize(DataType type) {
     switch (type) {
         case DataType::TINYINT:     return 1;
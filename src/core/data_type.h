@@ -49,6 +49,8 @@ public:
     // String conversion
     static QString typeToString(DataType type);
     static DataType stringToType(const QString& str);
+    // True when stringToType knows the name (it falls back to INT otherwise)
+    static bool isTypeName(const QString& str);
     
     // Type information
     static int getTypeSize(DataType type);
@@ -0,0 +1,551 @@
+#include "expression_evaluator.h"
+#include "table_schema.h"
+#include "table_manager.h"
+#include "../parser/ast_nodes.h"
+#include <cmath>
+
+namespace {
+
+bool isNullText(const QString& value) {
+    return value.isEmpty() || value.compare("null", Qt::CaseInsensitive) == 0;
+}
+
+}
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(const Expression* expression,
+                                                                const TableSchema& schema,
+                                                                QString& error) {
+    std::unique_ptr<CompiledExpression> compiled(new CompiledExpression());
+    if (!expression) {
+        return compiled;
+    }
+
+    if (!compiled->compileNode(expression, schema, error)) {
+        return nullptr;
+    }
+
+    // Constants are final now, so their text can be referenced safely
+    for (size_t i = 0; i < compiled->constants.size(); ++i) {
+        compiled->constants[i].text = &compiled->constantText[i];
+        compiled->numbersNeedText = compiled->numbersNeedText || compiled->constants[i].kind == Datum::Text;
+    }
+    for (const Instruction& instruction : compiled->program) {
+        compiled->numbersNeedText = compiled->numbersNeedText || instruction.op == OpCode::Like;
+    }
+    compiled->stack.reserve(compiled->program.size());
+    compiled->cellText.resize(compiled->program.size());
+    return compiled;
+}
+
+int CompiledExpression::addConstant(const Datum& datum, const QString& text) {
+    constants.push_back(datum);
+    constantText.push_back(text);
+    return static_cast<int>(constants.size()) - 1;
+}
+
+bool CompiledExpression::compileNode(const Expression* expression, const TableSchema& schema, QString& error) {
+    switch (expression->kind) {
+        case Expression::COLUMN: {
+            int ordinal = schema.getColumnIndex(expression->value);
+            if (ordinal < 0) {
+                error = QString("Unknown column '%1' in WHERE clause").arg(expression->value);
+                return false;
+            }
+            const Column* column = schema.getColumn(ordinal);
+            bool numeric = column && DataTypeManager::isNumericType(column->getType());
+            program.push_back({numeric ? OpCode::LoadNumber : OpCode::LoadText, ordinal});
+            return true;
+        }
+
+        case Expression::LITERAL: {
+            Datum datum;
+            if (!expression->stringLiteral && expression->value.compare("TRUE", Qt::CaseInsensitive) == 0) {
+                datum = makeBool(true);
+            } else if (!expression->stringLiteral && expression->value.compare("FALSE", Qt::CaseInsensitive) == 0) {
+                datum = makeBool(false);
+            } else if (!expression->stringLiteral) {
+                bool ok = false;
+                datum.number = expression->value.toDouble(&ok);
+                datum.kind = ok ? Datum::Number : Datum::Text;
+            } else {
+                datum.kind = Datum::Text;
+            }
+            program.push_back({OpCode::PushConst, addConstant(datum, expression->value)});
+            return true;
+        }
+
+        case Expression::NULL_LITERAL:
+            program.push_back({OpCode::PushConst, addConstant(Datum(), QString())});
+            return true;
+
+        case Expression::UNARY:
+            if (expression->children.size() != 1 || !compileNode(expression->children[0].get(), schema, error)) {
+                return false;
+            }
+            program.push_back({expression->op == Expression::NOT ? OpCode::Not : OpCode::Negate, 0});
+            return true;
+
+        case Expression::BINARY: {
+            if (expression->children.size() != 2) {
+                error = "Malformed binary expression";
+                return false;
+            }
+            if (!compileNode(expression->children[0].get(), schema, error)) {
+                return false;
+            }
+
+            // Short-circuit AND/OR: skip the right side once the result is decided
+            int jump = -1;
+            if (expression->op == Expression::AND || expression->op == Expression::OR) {
+                jump = static_cast<int>(program.size());
+                program.push_back({expression->op == Expression::AND ? OpCode::JumpIfFalse : OpCode::JumpIfTrue, 0});
+            }
+
+            if (!compileNode(expression->children[1].get(), schema, error)) {
+                return false;
+            }
+
+            switch (expression->op) {
+                case Expression::AND:
+                    program.push_back({OpCode::And, 0});
+                    break;
+                case Expression::OR:
+                    program.push_back({OpCode::Or, 0});
+                    break;
+                case Expression::EQ: case Expression::NE:
+                case Expression::LT: case Expression::LE:
+                case Expression::GT: case Expression::GE:
+                    program.push_back({OpCode::Compare, expression->op});
+                    break;
+                case Expression::PLUS: case Expression::MINUS:
+                case Expression::MULTIPLY: case Expression::DIVIDE:
+                case Expression::MODULO:
+                    program.push_back({OpCode::Arithmetic, expression->op});
+                    break;
+                default:
+                    error = "Unsupported operator in WHERE clause";
+                    return false;
+            }
+
+            if (jump >= 0) {
+                program[jump].operand = static_cast<int>(program.size());
+            }
+            return true;
+        }
+
+        case Expression::IN_LIST:
+        case Expression::BETWEEN:
+        case Expression::LIKE:
+        case Expression::IS_NULL: {
+            for (const auto& child : expression->children) {
+                if (!compileNode(child.get(), schema, error)) {
+                    return false;
+                }
+            }
+
+            if (expression->kind == Expression::IN_LIST) {
+                program.push_back({OpCode::In, static_cast<int>(expression->children.size()) - 1});
+            } else if (expression->kind == Expression::BETWEEN) {
+                program.push_back({OpCode::Between, 0});
+            } else if (expression->kind == Expression::LIKE) {
+                program.push_back({OpCode::Like, 0});
+            } else {
+                // IS [NOT] NULL always yields TRUE or FALSE, so it carries its own negation
+                program.push_back({OpCode::IsNull, expression->negated ? 1 : 0});
+                return true;
+            }
+
+            if (expression->negated) {
+                program.push_back({OpCode::Not, 0});
+            }
+            return true;
+        }
+
+        case Expression::AGGREGATE:
+            error = QString("Aggregate function %1() is only allowed in the select list, HAVING and ORDER BY")
+                .arg(expression->value);
+            return false;
+    }
+
+    error = "Unsupported expression in WHERE clause";
+    return false;
+}
+
+bool CompiledExpression::matches(const QVector<QString>& row) const {
+    return evaluate([&](int ordinal, bool numeric, size_t) {
+        Datum datum;
+        if (ordinal < row.size() && !isNullText(row[ordinal])) {
+            datum.text = &row[ordinal];
+            datum.kind = Datum::Text;
+            if (numeric) {
+                bool ok = false;
+                datum.number = datum.text->toDouble(&ok);
+                if (ok) {
+                    datum.kind = Datum::Number;
+                }
+            }
+        }
+        return datum;
+    });
+}
+
+bool CompiledExpression::matches(const TableScan& rows, int slot) const {
+    return evaluate([&](int ordinal, bool numeric, size_t pc) {
+        Datum datum;
+        if (ordinal >= rows.columnCount()) {
+            return datum;
+        }
+        const ColumnVector& column = rows.column(ordinal);
+        if (column.isNull(slot)) {
+            return datum;
+        }
+        // A native number is its canonical text, so it parses to the same value
+        if (numeric && column.isNative(slot) &&
+            (column.getStorage() == ColumnVector::Storage::Int64 || column.getStorage() == ColumnVector::Storage::Double)) {
+            datum.kind = Datum::Number;
+            datum.number = column.getStorage() == ColumnVector::Storage::Int64
+                ? static_cast<double>(column.int64At(slot)) : column.doubleAt(slot);
+            if (numbersNeedText) {
+                cellText[pc] = column.value(slot);
+                datum.text = &cellText[pc];
+            }
+            return datum;
+        }
+        // Anything else as the row would have it; dictionary values need no copy
+        if (column.isDictionaryEncoded()) {
+            datum.text = &column.dictionaryValue(column.codeAt(slot));
+        } else {
+            cellText[pc] = column.value(slot);
+            datum.text = &cellText[pc];
+        }
+        if (isNullText(*datum.text)) {
+            datum.text = nullptr;
+            return datum;
+        }
+        datum.kind = Datum::Text;
+        if (numeric) {
+            bool ok = false;
+            datum.number = datum.text->toDouble(&ok);
+            if (ok) {
+                datum.kind = Datum::Number;
+            }
+        }
+        return datum;
+    });
+}
+
+template <typename LoadCell>
+bool CompiledExpression::evaluate(const LoadCell& loadCell) const {
+    if (program.empty()) {
+        return true;
+    }
+
+    stack.clear();
+    const size_t count = program.size();
+
+    for (size_t pc = 0; pc < count; ++pc) {
+        const Instruction& instruction = program[pc];
+
+        switch (instruction.op) {
+            case OpCode::PushConst:
+                stack.push_back(constants[instruction.operand]);
+                break;
+
+            case OpCode::LoadText:
+            case OpCode::LoadNumber:
+                stack.push_back(loadCell(instruction.operand, instruction.op == OpCode::LoadNumber, pc));
+                break;
+
+            case OpCode::Compare: {
+                Datum right = stack.back();
+                stack.pop_back();
+                Datum& left = stack.back();
+                int result = 0;
+                if (!compare(left, right, result)) {
+                    left = Datum();
+                    break;
+                }
+                bool value = false;
+                switch (instruction.operand) {
+                    case Expression::EQ: value = result == 0; break;
+                    case Expression::NE: value = result != 0; break;
+                    case Expression::LT: value = result < 0; break;
+                    case Expression::LE: value = result <= 0; break;
+                    case Expression::GT: value = result > 0; break;
+                    case Expression::GE: value = result >= 0; break;
+                    default: break;
+                }
+                left = makeBool(value);
+                break;
+            }
+
+            case OpCode::Arithmetic: {
+                Datum right = stack.back();
+                stack.pop_back();
+                Datum& left = stack.back();
+                double a = 0.0;
+                double b = 0.0;
+                if (!toNumber(left, a) || !toNumber(right, b)) {
+                    left = Datum();
+                    break;
+                }
+                Datum result;
+                result.kind = Datum::Number;
+                switch (instruction.operand) {
+                    case Expression::PLUS: result.number = a + b; break;
+                    case Expression::MINUS: result.number = a - b; break;
+                    case Expression::MULTIPLY: result.number = a * b; break;
+                    case Expression::DIVIDE:
+                    case Expression::MODULO:
+                        if (b == 0.0) {
+                            result.kind = Datum::Null;  // Division by zero yields NULL
+                        } else {
+                            result.number = instruction.operand == Expression::DIVIDE ? a / b : std::fmod(a, b);
+                        }
+                        break;
+                    default: break;
+                }
+                left = result;
+                break;
+            }
+
+            case OpCode::Negate: {
+                Datum& top = stack.back();
+                double value = 0.0;
+                if (toNumber(top, value)) {
+                    top = Datum();
+                    top.kind = Datum::Number;
+                    top.number = -value;
+                } else {
+                    top = Datum();
+                }
+                break;
+            }
+
+            case OpCode::Not: {
+                Datum& top = stack.back();
+                if (top.kind != Datum::Null) {
+                    top = makeBool(!isTrue(top));
+                }
+                break;
+            }
+
+            case OpCode::And:
+            case OpCode::Or: {
+                Datum right = stack.back();
+                stack.pop_back();
+                Datum& left = stack.back();
+                if (instruction.op == OpCode::And) {
+                    if (isFalse(left) || isFalse(right)) {
+                        left = makeBool(false);
+                    } else if (left.kind == Datum::Null || right.kind == Datum::Null) {
+                        left = Datum();
+                    } else {
+                        left = makeBool(true);
+                    }
+                } else {
+                    if (isTrue(left) || isTrue(right)) {
+                        left = makeBool(true);
+                    } else if (left.kind == Datum::Null || right.kind == Datum::Null) {
+                        left = Datum();
+                    } else {
+                        left = makeBool(false);
+                    }
+                }
+                break;
+            }
+
+            case OpCode::JumpIfFalse:
+                if (isFalse(stack.back())) {
+                    stack.back() = makeBool(false);
+                    pc = instruction.operand - 1;
+                }
+                break;
+
+            case OpCode::JumpIfTrue:
+                if (isTrue(stack.back())) {
+                    stack.back() = makeBool(true);
+                    pc = instruction.operand - 1;
+                }
+                break;
+
+            case OpCode::IsNull: {
+                Datum& top = stack.back();
+                bool isNull = top.kind == Datum::Null;
+                top = makeBool(instruction.operand ? !isNull : isNull);
+                break;
+            }
+
+            case OpCode::In: {
+                const size_t base = stack.size() - instruction.operand - 1;
+                const Datum& needle = stack[base];
+                bool found = false;
+                bool sawNull = needle.kind == Datum::Null;
+                for (size_t i = base + 1; i < stack.size() && !found && needle.kind != Datum::Null; ++i) {
+                    int result = 0;
+                    if (!compare(needle, stack[i], result)) {
+                        sawNull = true;
+                    } else if (result == 0) {
+                        found = true;
+                    }
+                }
+                Datum outcome = found ? makeBool(true) : (sawNull ? Datum() : makeBool(false));
+                stack.resize(base + 1);
+                stack[base] = outcome;
+                break;
+            }
+
+            case OpCode::Between: {
+                Datum high = stack.back();
+                stack.pop_back();
+                Datum low = stack.back();
+                stack.pop_back();
+                Datum& value = stack.back();
+                int lowResult = 0;
+                int highResult = 0;
+                bool lowKnown = compare(value, low, lowResult);
+                bool highKnown = compare(value, high, highResult);
+                if ((lowKnown && lowResult < 0) || (highKnown && highResult > 0)) {
+                    value = makeBool(false);
+                } else if (!lowKnown || !highKnown) {
+                    value = Datum();
+                } else {
+                    value = makeBool(true);
+                }
+                break;
+            }
+
+            case OpCode::Like: {
+                Datum pattern = stack.back();
+                stack.pop_back();
+                Datum& value = stack.back();
+                if (value.kind == Datum::Null || pattern.kind == Datum::Null) {
+                    value = Datum();
+                } else {
+                    value = makeBool(likeMatch(toText(value), toText(pattern)));
+                }
+                break;
+            }
+        }
+    }
+
+    return !stack.empty() && isTrue(stack.back());
+}
+
+bool CompiledExpression::likeMatch(const QString& text, const QString& pattern) {
+    // Iterative wildcard match; backtracks only to the most recent '%'
+    int t = 0;
+    int p = 0;
+    int starPattern = -1;
+    int starText = 0;
+
+    while (t < text.size()) {
+        if (p < pattern.size() && pattern[p] == QChar('%')) {
+            starPattern = p++;
+            starText = t;
+        } else if (p < pattern.size() &&
+                   (pattern[p] == QChar('_') || pattern[p].toCaseFolded() == text[t].toCaseFolded())) {
+            ++p;
+            ++t;
+        } else if (starPattern >= 0) {
+            p = starPattern + 1;
+            t = ++starText;
+        } else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == QChar('%')) {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+bool CompiledExpression::isTrue(const Datum& datum) {
+    switch (datum.kind) {
+        case Datum::Bool:
+            return datum.boolean;
+        case Datum::Number:
+            return datum.number != 0.0;
+        case Datum::Text: {
+            if (datum.text->compare("true", Qt::CaseInsensitive) == 0) {
+                return true;
+            }
+            bool ok = false;
+            double number = datum.text->toDouble(&ok);
+            return ok && number != 0.0;
+        }
+        default:
+            return false;
+    }
+}
+
+bool CompiledExpression::isFalse(const Datum& datum) {
+    return datum.kind != Datum::Null && !isTrue(datum);
+}
+
+bool CompiledExpression::toNumber(const Datum& datum, double& number) {
+    switch (datum.kind) {
+        case Datum::Number:
+            number = datum.number;
+            return true;
+        case Datum::Bool:
+            number = datum.boolean ? 1.0 : 0.0;
+            return true;
+        case Datum::Text: {
+            bool ok = false;
+            number = datum.text->toDouble(&ok);
+            return ok;
+        }
+        default:
+            return false;
+    }
+}
+
+QString CompiledExpression::toText(const Datum& datum) {
+    if (datum.text) {
+        return *datum.text;
+    }
+    switch (datum.kind) {
+        case Datum::Number:
+            return QString::number(datum.number);
+        case Datum::Bool:
+            return datum.boolean ? "true" : "false";
+        default:
+            return QString();
+    }
+}
+
+bool CompiledExpression::compare(const Datum& a, const Datum& b, int& result) {
+    if (a.kind == Datum::Null || b.kind == Datum::Null) {
+        return false;
+    }
+
+    if (a.kind == Datum::Bool || b.kind == Datum::Bool) {
+        result = static_cast<int>(isTrue(a)) - static_cast<int>(isTrue(b));
+        return true;
+    }
+
+    if (a.kind == Datum::Text && b.kind == Datum::Text) {
+        result = QString::compare(*a.text, *b.text);
+        return true;
+    }
+
+    // At least one side is numeric: compare numerically when the other side parses
+    double x = 0.0;
+    double y = 0.0;
+    if (toNumber(a, x) && toNumber(b, y)) {
+        result = x < y ? -1 : (x > y ? 1 : 0);
+        return true;
+    }
+
+    result = QString::compare(toText(a), toText(b));
+    return true;
+}
+
+CompiledExpression::Datum CompiledExpression::makeBool(bool value) {
+    Datum datum;
+    datum.kind = Datum::Bool;
+    datum.boolean = value;
+    return datum;
+}
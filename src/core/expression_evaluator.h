@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+class Expression;
+class TableSchema;
+class TableScan;
+
+/**
+ * @brief WHERE condition compiled into a flat program over column ordinals
+ *
+ * The expression tree produced by the parser is compiled once per query:
+ * column names are resolved to ordinals, literals are converted to numbers
+ * up front and the tree is flattened into a postfix instruction list, so
+ * testing a row is a tight loop over a small stack with no string parsing
+ * or name lookups. Comparisons follow SQL three-valued logic; a row matches
+ * only when the condition is TRUE. Empty and "null" values are NULL, as
+ * elsewhere in the engine.
+ *
+ * A compiled expression keeps scratch state between evaluations and must
+ * not be shared between threads.
+ */
+class CompiledExpression {
+public:
+    // Compiles a condition against a table; a null expression matches every row.
+    // Returns nullptr and sets error when the expression references an unknown column.
+    static std::unique_ptr<CompiledExpression> compile(const Expression* expression,
+                                                       const TableSchema& schema,
+                                                       QString& error);
+
+    CompiledExpression(const CompiledExpression&) = delete;
+    CompiledExpression& operator=(const CompiledExpression&) = delete;
+
+    bool matches(const QVector<QString>& row) const;
+    // Tests one slot of a scan, reading only the cells the condition uses from their
+    // columns: native numbers are taken as they are, without building the row's text
+    bool matches(const TableScan& rows, int slot) const;
+    bool isTrivial() const { return program.empty(); }
+
+    // SQL LIKE with % and _ wildcards, case-insensitive
+    static bool likeMatch(const QString& text, const QString& pattern);
+
+private:
+    CompiledExpression() = default;
+
+    enum class OpCode : quint8 {
+        PushConst,      // operand = constant slot
+        LoadText,       // operand = column ordinal
+        LoadNumber,     // operand = column ordinal of a numeric column
+        Compare,        // operand = Expression::Operator (EQ..GE)
+        Arithmetic,     // operand = Expression::Operator (PLUS..MODULO)
+        Negate,
+        Not,
+        And,
+        Or,
+        JumpIfFalse,    // operand = target; leaves FALSE on the stack when taken
+        JumpIfTrue,     // operand = target; leaves TRUE on the stack when taken
+        IsNull,
+        In,             // operand = number of list items
+        Between,
+        Like
+    };
+
+    struct Instruction {
+        OpCode op;
+        int operand;
+    };
+
+    struct Datum {
+        enum Kind : quint8 { Null, Bool, Number, Text };
+        Kind kind = Null;
+        bool boolean = false;
+        double number = 0.0;
+        const QString* text = nullptr;  // Source text for Text, and for Number when available
+    };
+
+    std::vector<Instruction> program;
+    std::vector<QString> constantText;
+    std::vector<Datum> constants;
+    mutable std::vector<Datum> stack;
+    // Text of the cells loaded from a scan, by instruction
+    mutable std::vector<QString> cellText;
+    // A number loaded from a column is also needed as its text (LIKE, or a text constant)
+    bool numbersNeedText = false;
+
+    // Runs the program; loadCell(ordinal, numeric, pc) gives a column's cell
+    template <typename LoadCell>
+    bool evaluate(const LoadCell& loadCell) const;
+
+    bool compileNode(const Expression* expression, const TableSchema& schema, QString& error);
+    int addConstant(const Datum& datum, const QString& text);
+
+    static bool isTrue(const Datum& datum);
+    static bool isFalse(const Datum& datum);
+    static bool toNumber(const Datum& datum, double& number);
+    static QString toText(const Datum& datum);
+    static bool compare(const Datum& a, const Datum& b, int& result);
+    static Datum makeBool(bool value);
+};
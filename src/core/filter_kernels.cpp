@@ -0,0 +1,327 @@
+#include "filter_kernels.h"
+#include <QtGlobal>
+#include <atomic>
+
+// Vector paths are compiled per function with target attributes, so the rest of
+// the build keeps its baseline instruction set and older CPUs take the scalar path
+#if defined(Q_PROCESSOR_X86) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+#define FILTER_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+std::atomic<int>& isaSetting() {
+    static std::atomic<int> isa(static_cast<int>(FilterKernels::detectIsa()));
+    return isa;
+}
+
+// Scalar word builders; also finish the lanes a vector loop leaves over
+template <typename T>
+quint64 rangeWordScalar(const T* values, int n, T lo, T hi) {
+    quint64 word = 0;
+    for (int i = 0; i < n; ++i) {
+        word |= quint64(values[i] >= lo && values[i] <= hi) << i;
+    }
+    return word;
+}
+
+template <typename T>
+quint64 inWordScalar(const T* values, int n, const T* list, int listCount) {
+    quint64 word = 0;
+    for (int i = 0; i < n; ++i) {
+        bool found = false;
+        for (int j = 0; j < listCount && !found; ++j) {
+            found = values[i] == list[j];
+        }
+        word |= quint64(found) << i;
+    }
+    return word;
+}
+
+// Fills out one 64-value word at a time; wordFor(values, n) returns the bits for n <= 64 values
+template <typename T, typename WordFn>
+void runKernel(const T* values, int count, quint64* out, WordFn wordFor) {
+    const int words = (count + 63) / 64;
+    for (int w = 0; w < words; ++w) {
+        const int base = w * 64;
+        out[w] = wordFor(values + base, qMin(64, count - base));
+    }
+}
+
+#ifdef FILTER_KERNELS_X86
+
+// Each vector loop handles whole registers and leaves the remainder to the scalar builder
+#define FINISH_WORD(word, i, n, scalarCall) \
+    ((i) < (n) ? (word) | ((scalarCall) << (i)) : (word))
+
+__attribute__((target("avx2")))
+quint64 rangeWordAvx2(const qint64* values, int n, qint64 lo, qint64 hi) {
+    const __m256i vlo = _mm256_set1_epi64x(lo);
+    const __m256i vhi = _mm256_set1_epi64x(hi);
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(vlo, x), _mm256_cmpgt_epi64(x, vhi));
+        word |= quint64(~_mm256_movemask_pd(_mm256_castsi256_pd(outside)) & 0xF) << i;
+    }
+    return FINISH_WORD(word, i, n, rangeWordScalar(values + i, n - i, lo, hi));
+}
+
+__attribute__((target("avx2")))
+quint64 rangeWordAvx2(const double* values, int n, double lo, double hi) {
+    const __m256d vlo = _mm256_set1_pd(lo);
+    const __m256d vhi = _mm256_set1_pd(hi);
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(values + i);
+        __m256d inside = _mm256_and_pd(_mm256_cmp_pd(x, vlo, _CMP_GE_OQ), _mm256_cmp_pd(x, vhi, _CMP_LE_OQ));
+        word |= quint64(_mm256_movemask_pd(inside)) << i;
+    }
+    return FINISH_WORD(word, i, n, rangeWordScalar(values + i, n - i, lo, hi));
+}
+
+__attribute__((target("avx2")))
+quint64 rangeWordAvx2(const qint32* values, int n, qint32 lo, qint32 hi) {
+    const __m256i vlo = _mm256_set1_epi32(lo);
+    const __m256i vhi = _mm256_set1_epi32(hi);
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(vlo, x), _mm256_cmpgt_epi32(x, vhi));
+        word |= quint64(~_mm256_movemask_ps(_mm256_castsi256_ps(outside)) & 0xFF) << i;
+    }
+    return FINISH_WORD(word, i, n, rangeWordScalar(values + i, n - i, lo, hi));
+}
+
+__attribute__((target("avx2")))
+quint64 inWordAvx2(const qint64* values, int n, const qint64* list, int listCount) {
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i found = _mm256_setzero_si256();
+        for (int j = 0; j < listCount; ++j) {
+            found = _mm256_or_si256(found, _mm256_cmpeq_epi64(x, _mm256_set1_epi64x(list[j])));
+        }
+        word |= quint64(_mm256_movemask_pd(_mm256_castsi256_pd(found))) << i;
+    }
+    return FINISH_WORD(word, i, n, inWordScalar(values + i, n - i, list, listCount));
+}
+
+__attribute__((target("avx2")))
+quint64 inWordAvx2(const double* values, int n, const double* list, int listCount) {
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(values + i);
+        __m256d found = _mm256_setzero_pd();
+        for (int j = 0; j < listCount; ++j) {
+            found = _mm256_or_pd(found, _mm256_cmp_pd(x, _mm256_set1_pd(list[j]), _CMP_EQ_OQ));
+        }
+        word |= quint64(_mm256_movemask_pd(found)) << i;
+    }
+    return FINISH_WORD(word, i, n, inWordScalar(values + i, n - i, list, listCount));
+}
+
+__attribute__((target("avx2")))
+quint64 inWordAvx2(const qint32* values, int n, const qint32* list, int listCount) {
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i found = _mm256_setzero_si256();
+        for (int j = 0; j < listCount; ++j) {
+            found = _mm256_or_si256(found, _mm256_cmpeq_epi32(x, _mm256_set1_epi32(list[j])));
+        }
+        word |= quint64(_mm256_movemask_ps(_mm256_castsi256_ps(found))) << i;
+    }
+    return FINISH_WORD(word, i, n, inWordScalar(values + i, n - i, list, listCount));
+}
+
+__attribute__((target("sse4.2")))
+quint64 rangeWordSse42(const qint64* values, int n, qint64 lo, qint64 hi) {
+    const __m128i vlo = _mm_set1_epi64x(lo);
+    const __m128i vhi = _mm_set1_epi64x(hi);
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        __m128i outside = _mm_or_si128(_mm_cmpgt_epi64(vlo, x), _mm_cmpgt_epi64(x, vhi));
+        word |= quint64(~_mm_movemask_pd(_mm_castsi128_pd(outside)) & 0x3) << i;
+    }
+    return FINISH_WORD(word, i, n, rangeWordScalar(values + i, n - i, lo, hi));
+}
+
+__attribute__((target("sse4.2")))
+quint64 rangeWordSse42(const double* values, int n, double lo, double hi) {
+    const __m128d vlo = _mm_set1_pd(lo);
+    const __m128d vhi = _mm_set1_pd(hi);
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(values + i);
+        __m128d inside = _mm_and_pd(_mm_cmpge_pd(x, vlo), _mm_cmple_pd(x, vhi));
+        word |= quint64(_mm_movemask_pd(inside)) << i;
+    }
+    return FINISH_WORD(word, i, n, rangeWordScalar(values + i, n - i, lo, hi));
+}
+
+__attribute__((target("sse4.2")))
+quint64 rangeWordSse42(const qint32* values, int n, qint32 lo, qint32 hi) {
+    const __m128i vlo = _mm_set1_epi32(lo);
+    const __m128i vhi = _mm_set1_epi32(hi);
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(vlo, x), _mm_cmpgt_epi32(x, vhi));
+        word |= quint64(~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xF) << i;
+    }
+    return FINISH_WORD(word, i, n, rangeWordScalar(values + i, n - i, lo, hi));
+}
+
+__attribute__((target("sse4.2")))
+quint64 inWordSse42(const qint64* values, int n, const qint64* list, int listCount) {
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        __m128i found = _mm_setzero_si128();
+        for (int j = 0; j < listCount; ++j) {
+            found = _mm_or_si128(found, _mm_cmpeq_epi64(x, _mm_set1_epi64x(list[j])));
+        }
+        word |= quint64(_mm_movemask_pd(_mm_castsi128_pd(found))) << i;
+    }
+    return FINISH_WORD(word, i, n, inWordScalar(values + i, n - i, list, listCount));
+}
+
+__attribute__((target("sse4.2")))
+quint64 inWordSse42(const double* values, int n, const double* list, int listCount) {
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(values + i);
+        __m128d found = _mm_setzero_pd();
+        for (int j = 0; j < listCount; ++j) {
+            found = _mm_or_pd(found, _mm_cmpeq_pd(x, _mm_set1_pd(list[j])));
+        }
+        word |= quint64(_mm_movemask_pd(found)) << i;
+    }
+    return FINISH_WORD(word, i, n, inWordScalar(values + i, n - i, list, listCount));
+}
+
+__attribute__((target("sse4.2")))
+quint64 inWordSse42(const qint32* values, int n, const qint32* list, int listCount) {
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        __m128i found = _mm_setzero_si128();
+        for (int j = 0; j < listCount; ++j) {
+            found = _mm_or_si128(found, _mm_cmpeq_epi32(x, _mm_set1_epi32(list[j])));
+        }
+        word |= quint64(_mm_movemask_ps(_mm_castsi128_ps(found))) << i;
+    }
+    return FINISH_WORD(word, i, n, inWordScalar(values + i, n - i, list, listCount));
+}
+
+#undef FINISH_WORD
+
+#endif
+
+template <typename T>
+void selectRangeDispatch(const T* values, int count, T lo, T hi, quint64* out) {
+    switch (FilterKernels::activeIsa()) {
+#ifdef FILTER_KERNELS_X86
+        case FilterKernels::Isa::AVX2:
+            runKernel(values, count, out, [=](const T* v, int n) { return rangeWordAvx2(v, n, lo, hi); });
+            return;
+        case FilterKernels::Isa::SSE42:
+            runKernel(values, count, out, [=](const T* v, int n) { return rangeWordSse42(v, n, lo, hi); });
+            return;
+#endif
+        default:
+            runKernel(values, count, out, [=](const T* v, int n) { return rangeWordScalar(v, n, lo, hi); });
+            return;
+    }
+}
+
+template <typename T>
+void selectInDispatch(const T* values, int count, const QVector<T>& list, quint64* out) {
+    const T* items = list.constData();
+    const int itemCount = list.size();
+    switch (FilterKernels::activeIsa()) {
+#ifdef FILTER_KERNELS_X86
+        case FilterKernels::Isa::AVX2:
+            runKernel(values, count, out, [=](const T* v, int n) { return inWordAvx2(v, n, items, itemCount); });
+            return;
+        case FilterKernels::Isa::SSE42:
+            runKernel(values, count, out, [=](const T* v, int n) { return inWordSse42(v, n, items, itemCount); });
+            return;
+#endif
+        default:
+            runKernel(values, count, out, [=](const T* v, int n) { return inWordScalar(v, n, items, itemCount); });
+            return;
+    }
+}
+
+}
+
+FilterKernels::Isa FilterKernels::activeIsa() {
+    return static_cast<Isa>(isaSetting().load(std::memory_order_relaxed));
+}
+
+FilterKernels::Isa FilterKernels::detectIsa() {
+#ifdef FILTER_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return Isa::SSE42;
+    }
+#endif
+    return Isa::Scalar;
+}
+
+void FilterKernels::setIsa(Isa isa) {
+    Isa supported = detectIsa();
+    isaSetting().store(static_cast<int>(qMin(isa, supported)), std::memory_order_relaxed);
+}
+
+QString FilterKernels::isaName(Isa isa) {
+    switch (isa) {
+        case Isa::AVX2:  return "AVX2";
+        case Isa::SSE42: return "SSE4.2";
+        case Isa::Scalar: break;
+    }
+    return "scalar";
+}
+
+void FilterKernels::selectRange(const qint64* values, int count, qint64 lo, qint64 hi, quint64* out) {
+    selectRangeDispatch(values, count, lo, hi, out);
+}
+
+void FilterKernels::selectRange(const double* values, int count, double lo, double hi, quint64* out) {
+    selectRangeDispatch(values, count, lo, hi, out);
+}
+
+void FilterKernels::selectRange(const qint32* values, int count, qint32 lo, qint32 hi, quint64* out) {
+    selectRangeDispatch(values, count, lo, hi, out);
+}
+
+void FilterKernels::selectIn(const qint64* values, int count, const QVector<qint64>& list, quint64* out) {
+    selectInDispatch(values, count, list, out);
+}
+
+void FilterKernels::selectIn(const double* values, int count, const QVector<double>& list, quint64* out) {
+    selectInDispatch(values, count, list, out);
+}
+
+void FilterKernels::selectIn(const qint32* values, int count, const QVector<qint32>& list, quint64* out) {
+    selectInDispatch(values, count, list, out);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Vectorized selection kernels over native column arrays
+ *
+ * Each kernel tests a contiguous array of values and writes a selection
+ * bitmap: bit i of out[i / 64] is set when values[i] passes. Range kernels
+ * test lo <= value <= hi (every comparison and BETWEEN reduces to one
+ * inclusive range); IN kernels test equality against a short list.
+ *
+ * The instruction set is picked once at runtime from what the CPU
+ * supports: AVX2, then SSE4.2, then a portable scalar loop. Builds for
+ * other architectures or compilers always use the scalar loop.
+ */
+class FilterKernels {
+public:
+    enum class Isa {
+        Scalar,
+        SSE42,
+        AVX2
+    };
+
+    // Instruction set the kernels currently use
+    static Isa activeIsa();
+    // Best instruction set the CPU supports
+    static Isa detectIsa();
+    // Forces an instruction set (clamped to what the CPU supports); used by tests and benchmarks
+    static void setIsa(Isa isa);
+    static QString isaName(Isa isa);
+
+    // out must hold (count + 63) / 64 words; bits past count are cleared
+    static void selectRange(const qint64* values, int count, qint64 lo, qint64 hi, quint64* out);
+    static void selectRange(const double* values, int count, double lo, double hi, quint64* out);
+    static void selectRange(const qint32* values, int count, qint32 lo, qint32 hi, quint64* out);
+
+    static void selectIn(const qint64* values, int count, const QVector<qint64>& list, quint64* out);
+    static void selectIn(const double* values, int count, const QVector<double>& list, quint64* out);
+    static void selectIn(const qint32* values, int count, const QVector<qint32>& list, quint64* out);
+};
@@ -0,0 +1,398 @@
+#include "hash_aggregator.h"
+#include "table_manager.h"
+#include "table_schema.h"
+#include <QLocale>
+#include <QtNumeric>
+#include <cstring>
+
+namespace {
+
+constexpr int MIN_BUCKETS = 16;
+
+// Without dictionaries to go by, the table starts at this many groups and grows as needed
+constexpr int DEFAULT_GROUP_ESTIMATE = 4096;
+
+quint64 mixKey(quint64 hash, quint64 word) {
+    hash ^= word + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+quint64 finishHash(quint64 hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+bool isNullText(const QString& value) {
+    return value.isEmpty() || value.compare("null", Qt::CaseInsensitive) == 0;
+}
+
+QString renderDouble(double value) {
+    return QString::number(value, 'g', QLocale::FloatingPointShortest);
+}
+
+}
+
+HashAggregator::HashAggregator(const TableScan& rows, const TableSchema& schema,
+                               const QVector<int>& groupColumns, const QVector<Aggregate>& aggregates)
+    : rows(rows), groupColumns(groupColumns), interned(groupColumns.size()),
+      probeWords(groupColumns.size()), probeTags(groupColumns.size()) {
+    for (const Aggregate& aggregate : aggregates) {
+        Accumulator accumulator;
+        accumulator.aggregate = aggregate;
+        const Column* column = aggregate.column >= 0 ? schema.getColumn(aggregate.column) : nullptr;
+        accumulator.numeric = column && DataTypeManager::isNumericType(column->getType());
+        accumulators.append(accumulator);
+    }
+}
+
+DataType HashAggregator::resultType(SelectItem::Aggregate function, DataType input) {
+    switch (function) {
+        case SelectItem::COUNT:
+            return DataType::BIGINT;
+        case SelectItem::SUM:
+            return DataTypeManager::isIntegerType(input) ? DataType::BIGINT : DataType::DOUBLE;
+        case SelectItem::AVG:
+            return DataType::DOUBLE;
+        default:
+            return input;
+    }
+}
+
+int HashAggregator::estimateGroups(int rowCount) const {
+    if (groupColumns.isEmpty()) {
+        return 1;
+    }
+    qint64 groups = 1;
+    for (int column : groupColumns) {
+        if (column >= rows.columnCount() || !rows.column(column).isDictionaryEncoded()) {
+            return qMin(rowCount, DEFAULT_GROUP_ESTIMATE);
+        }
+        // One more for NULL
+        groups = qMin<qint64>(groups * (rows.column(column).dictionarySize() + 1), rowCount);
+    }
+    return static_cast<int>(qMax<qint64>(groups, 1));
+}
+
+void HashAggregator::reserve(int expectedGroups) {
+    int bucketCount = MIN_BUCKETS;
+    while (bucketCount < expectedGroups * 2) {
+        bucketCount *= 2;
+    }
+    if (bucketCount > buckets.size()) {
+        rehash(bucketCount);
+    }
+
+    const int width = groupColumns.size();
+    keyWords.reserve(expectedGroups * width);
+    keyTags.reserve(expectedGroups * width);
+    groupHashes.reserve(expectedGroups);
+    firstSlots.reserve(expectedGroups);
+}
+
+void HashAggregator::add(int slot) {
+    int group = findOrAddGroup(slot);
+    for (Accumulator& accumulator : accumulators) {
+        accumulate(accumulator, group, slot);
+    }
+}
+
+QVector<QStringList> HashAggregator::results() const {
+    QVector<QStringList> output;
+    const int groups = groupCount();
+    output.reserve(qMax(groups, 1));
+
+    for (int group = 0; group < groups; ++group) {
+        QStringList row;
+        row.reserve(groupColumns.size() + accumulators.size());
+        for (int column : groupColumns) {
+            row.append(column < rows.columnCount() ? rows.valueAt(firstSlots[group], column) : QString());
+        }
+        for (const Accumulator& accumulator : accumulators) {
+            row.append(resultText(accumulator, group));
+        }
+        output.append(row);
+    }
+
+    // An aggregate over no rows still yields one row: COUNT is 0, everything else NULL
+    if (groups == 0 && groupColumns.isEmpty()) {
+        QStringList row;
+        for (const Accumulator& accumulator : accumulators) {
+            row.append(accumulator.aggregate.function == SelectItem::COUNT ? QString("0") : QString());
+        }
+        output.append(row);
+    }
+    return output;
+}
+
+int HashAggregator::findOrAddGroup(int slot) {
+    const int width = groupColumns.size();
+    quint64 hash = 0;
+
+    for (int k = 0; k < width; ++k) {
+        const int column = groupColumns[k];
+        quint8 tag = NullKey;
+        qint64 word = 0;
+
+        if (!isNullCell(column, slot)) {
+            const ColumnVector& cells = rows.column(column);
+            tag = NativeKey;
+            if (cells.isDictionaryEncoded()) {
+                word = cells.codeAt(slot);
+            } else if (cells.isNative(slot) && cells.getStorage() == ColumnVector::Storage::Int64) {
+                word = cells.int64At(slot);
+            } else if (cells.isNative(slot) && cells.getStorage() == ColumnVector::Storage::Double) {
+                double value = cells.doubleAt(slot);
+                std::memcpy(&word, &value, sizeof(word));
+            } else if (cells.isNative(slot) && cells.getStorage() == ColumnVector::Storage::Date) {
+                word = cells.dateAt(slot);
+            } else {
+                // BOOL spellings, verbatim and arena text group by their exact text
+                QHash<QString, qint64>& ids = interned[k];
+                QString text = cells.value(slot);
+                auto it = ids.constFind(text);
+                if (it == ids.constEnd()) {
+                    it = ids.insert(text, ids.size());
+                }
+                word = it.value();
+                tag = InternedKey;
+            }
+        }
+
+        probeWords[k] = word;
+        probeTags[k] = tag;
+        hash = mixKey(hash, static_cast<quint64>(word) * 4 + tag);
+    }
+    hash = finishHash(hash);
+
+    if (buckets.isEmpty()) {
+        rehash(MIN_BUCKETS);
+    }
+    const quint64 mask = static_cast<quint64>(buckets.size() - 1);
+    quint64 bucket = hash & mask;
+    while (buckets[bucket] >= 0) {
+        const int group = buckets[bucket];
+        bool same = groupHashes[group] == hash;
+        for (int k = 0; same && k < width; ++k) {
+            same = keyWords[group * width + k] == probeWords[k] && keyTags[group * width + k] == probeTags[k];
+        }
+        if (same) {
+            return group;
+        }
+        bucket = (bucket + 1) & mask;
+    }
+
+    const int group = firstSlots.size();
+    keyWords += probeWords;
+    keyTags += probeTags;
+    groupHashes.append(hash);
+    firstSlots.append(slot);
+    buckets[bucket] = group;
+
+    for (Accumulator& accumulator : accumulators) {
+        switch (accumulator.aggregate.function) {
+            case SelectItem::COUNT:
+                accumulator.counts.append(0);
+                break;
+            case SelectItem::SUM:
+                accumulator.intSums.append(0);
+                accumulator.doubleSums.append(0.0);
+                accumulator.sumStates.append(NoInput);
+                break;
+            case SelectItem::AVG:
+                accumulator.counts.append(0);
+                accumulator.doubleSums.append(0.0);
+                break;
+            case SelectItem::MIN:
+            case SelectItem::MAX:
+                accumulator.bestSlots.append(-1);
+                break;
+            case SelectItem::NONE:
+                break;
+        }
+    }
+
+    if ((group + 1) * 2 > buckets.size()) {
+        rehash(buckets.size() * 2);
+    }
+    return group;
+}
+
+void HashAggregator::rehash(int bucketCount) {
+    buckets.fill(-1, bucketCount);
+    const quint64 mask = static_cast<quint64>(bucketCount - 1);
+    for (int group = 0; group < groupHashes.size(); ++group) {
+        quint64 bucket = groupHashes[group] & mask;
+        while (buckets[bucket] >= 0) {
+            bucket = (bucket + 1) & mask;
+        }
+        buckets[bucket] = group;
+    }
+}
+
+void HashAggregator::accumulate(Accumulator& accumulator, int group, int slot) {
+    const int column = accumulator.aggregate.column;
+
+    switch (accumulator.aggregate.function) {
+        case SelectItem::COUNT:
+            if (column < 0 || !isNullCell(column, slot)) {
+                accumulator.counts[group]++;
+            }
+            return;
+
+        case SelectItem::SUM:
+        case SelectItem::AVG: {
+            if (isNullCell(column, slot)) {
+                return;
+            }
+            const ColumnVector& cells = rows.column(column);
+            bool integer = false;
+            qint64 intValue = 0;
+            double value = 0.0;
+            if (cells.isNative(slot) && cells.getStorage() == ColumnVector::Storage::Int64) {
+                integer = true;
+                intValue = cells.int64At(slot);
+            } else if (cells.isNative(slot) && cells.getStorage() == ColumnVector::Storage::Double) {
+                value = cells.doubleAt(slot);
+            } else {
+                QString text = cells.value(slot);
+                intValue = text.toLongLong(&integer);
+                bool ok = integer;
+                if (!integer) {
+                    value = text.toDouble(&ok);
+                }
+                if (!ok) {
+                    return;
+                }
+            }
+            if (integer) {
+                value = static_cast<double>(intValue);
+            }
+
+            accumulator.doubleSums[group] += value;
+            if (accumulator.aggregate.function == SelectItem::AVG) {
+                accumulator.counts[group]++;
+                return;
+            }
+            quint8& state = accumulator.sumStates[group];
+            if (!integer) {
+                state = DoubleSum;
+            } else if (state != DoubleSum) {
+                qint64 sum = 0;
+                state = qAddOverflow(accumulator.intSums[group], intValue, &sum) ? DoubleSum : IntegerSum;
+                accumulator.intSums[group] = sum;
+            }
+            return;
+        }
+
+        case SelectItem::MIN:
+        case SelectItem::MAX: {
+            if (isNullCell(column, slot)) {
+                return;
+            }
+            int& best = accumulator.bestSlots[group];
+            if (best < 0) {
+                best = slot;
+                return;
+            }
+            int cmp = compareCells(column, accumulator.numeric, slot, best);
+            if (accumulator.aggregate.function == SelectItem::MIN ? cmp < 0 : cmp > 0) {
+                best = slot;
+            }
+            return;
+        }
+
+        case SelectItem::NONE:
+            return;
+    }
+}
+
+bool HashAggregator::isNullCell(int column, int slot) const {
+    if (column >= rows.columnCount()) {
+        return true;
+    }
+    const ColumnVector& cells = rows.column(column);
+    if (cells.isNull(slot)) {
+        return true;
+    }
+    if (cells.isNative(slot)) {
+        return false;
+    }
+    // Stored "null" text reads as NULL everywhere else in the engine
+    if (cells.isDictionaryEncoded()) {
+        return isNullText(cells.dictionaryValue(cells.codeAt(slot)));
+    }
+    return isNullText(cells.value(slot));
+}
+
+// Orders two non-NULL cells the way ORDER BY does
+int HashAggregator::compareCells(int column, bool numeric, int a, int b) const {
+    const ColumnVector& cells = rows.column(column);
+    if (cells.isNative(a) && cells.isNative(b)) {
+        switch (cells.getStorage()) {
+            case ColumnVector::Storage::Int64: {
+                qint64 x = cells.int64At(a);
+                qint64 y = cells.int64At(b);
+                return x < y ? -1 : (x > y ? 1 : 0);
+            }
+            case ColumnVector::Storage::Double: {
+                double x = cells.doubleAt(a);
+                double y = cells.doubleAt(b);
+                return x < y ? -1 : (x > y ? 1 : 0);
+            }
+            case ColumnVector::Storage::Date: {
+                qint32 x = cells.dateAt(a);
+                qint32 y = cells.dateAt(b);
+                return x < y ? -1 : (x > y ? 1 : 0);
+            }
+            default:
+                break;
+        }
+    }
+    if (cells.isDictionaryEncoded()) {
+        return QString::compare(cells.dictionaryValue(cells.codeAt(a)), cells.dictionaryValue(cells.codeAt(b)));
+    }
+
+    QString x = cells.value(a);
+    QString y = cells.value(b);
+    if (numeric) {
+        bool xOk = false;
+        bool yOk = false;
+        double xNumber = x.toDouble(&xOk);
+        double yNumber = y.toDouble(&yOk);
+        if (xOk && yOk) {
+            return xNumber < yNumber ? -1 : (xNumber > yNumber ? 1 : 0);
+        }
+    }
+    return QString::compare(x, y);
+}
+
+QString HashAggregator::resultText(const Accumulator& accumulator, int group) const {
+    switch (accumulator.aggregate.function) {
+        case SelectItem::COUNT:
+            return QString::number(accumulator.counts[group]);
+        case SelectItem::SUM:
+            switch (accumulator.sumStates[group]) {
+                case IntegerSum:
+                    return QString::number(accumulator.intSums[group]);
+                case DoubleSum:
+                    return renderDouble(accumulator.doubleSums[group]);
+                default:
+                    return QString();
+            }
+        case SelectItem::AVG:
+            if (accumulator.counts[group] == 0) {
+                return QString();
+            }
+            return renderDouble(accumulator.doubleSums[group] / accumulator.counts[group]);
+        case SelectItem::MIN:
+        case SelectItem::MAX: {
+            int best = accumulator.bestSlots[group];
+            return best >= 0 ? rows.valueAt(best, accumulator.aggregate.column) : QString();
+        }
+        case SelectItem::NONE:
+            break;
+    }
+    return QString();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "data_type.h"
+#include "../parser/ast_nodes.h"
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+class TableSchema;
+class TableScan;
+
+/**
+ * @brief Hash GROUP BY and aggregate functions over a table scan
+ *
+ * Rows are added one slot at a time. A row's group key is built from its
+ * GROUP BY cells as they are stored: dictionary codes and native integers,
+ * doubles and dates are used directly, and any other cell is interned per
+ * column, so no row is assembled as text. Keys live in an open-addressing
+ * table with linear probing that is pre-sized from the expected number of
+ * groups and doubled whenever it becomes half full.
+ *
+ * Accumulators are typed per aggregate. COUNT keeps an int64. SUM keeps an
+ * int64 while every input is an integer and continues in double after an
+ * overflow or a fractional input. AVG keeps a double sum and a count.
+ * MIN/MAX keep the slot of the winning cell, compared natively where both
+ * cells allow it, so the result is the stored text. NULL inputs are
+ * skipped, and so are SUM and AVG inputs that are not numbers.
+ */
+class HashAggregator {
+public:
+    struct Aggregate {
+        SelectItem::Aggregate function;
+        int column;                 // -1 for COUNT(*)
+    };
+
+    HashAggregator(const TableScan& rows, const TableSchema& schema,
+                   const QVector<int>& groupColumns, const QVector<Aggregate>& aggregates);
+
+    // Type of an aggregate's result for a column of the given type
+    static DataType resultType(SelectItem::Aggregate function, DataType input);
+
+    // Rough number of groups a scan of rowCount rows forms, from dictionary sizes where the keys have them
+    int estimateGroups(int rowCount) const;
+    // Sizes the table for the expected number of groups
+    void reserve(int expectedGroups);
+
+    void add(int slot);
+
+    int groupCount() const { return firstSlots.size(); }
+    // One row per group, in the order groups were first seen: the GROUP BY values, then each
+    // aggregate's result. Without GROUP BY there is exactly one group, even over no rows.
+    // Reads the scan, so it must still be open
+    QVector<QStringList> results() const;
+
+private:
+    enum KeyTag : quint8 {
+        NullKey,
+        NativeKey,      // Dictionary code or native value
+        InternedKey     // Id of the cell's text in the column's intern table
+    };
+
+    enum SumState : quint8 {
+        NoInput,
+        IntegerSum,
+        DoubleSum
+    };
+
+    struct Accumulator {
+        Aggregate aggregate;
+        bool numeric = false;       // Input column has a numeric type
+        QVector<qint64> counts;     // COUNT, AVG: inputs seen
+        QVector<qint64> intSums;    // SUM while every input is an integer
+        QVector<double> doubleSums; // SUM, AVG
+        QVector<quint8> sumStates;  // SUM: SumState
+        QVector<int> bestSlots;     // MIN, MAX: slot of the winning cell, -1 before the first input
+    };
+
+    const TableScan& rows;
+    QVector<int> groupColumns;
+    QVector<Accumulator> accumulators;
+    QVector<QHash<QString, qint64>> interned;   // GROUP BY column -> text -> id
+
+    // Group keys, one entry per GROUP BY column of each group
+    QVector<qint64> keyWords;
+    QVector<quint8> keyTags;
+    QVector<quint64> groupHashes;
+    QVector<int> firstSlots;        // Slot of the group's first row; its cells are the group's values
+
+    // Open-addressing table of group numbers, -1 for an empty bucket
+    QVector<qint32> buckets;
+    QVector<qint64> probeWords;
+    QVector<quint8> probeTags;
+
+    int findOrAddGroup(int slot);
+    void rehash(int bucketCount);
+    void accumulate(Accumulator& accumulator, int group, int slot);
+
+    bool isNullCell(int column, int slot) const;
+    int compareCells(int column, bool numeric, int a, int b) const;
+    QString resultText(const Accumulator& accumulator, int group) const;
+};
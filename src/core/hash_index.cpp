@@ -0,0 +1,71 @@
+#include "hash_index.h"
+#include "row_store.h"
+
+HashIndex::HashIndex(const QString& constraintName, const QStringList& columns, const QVector<int>& columnPositions)
+    : constraintName(constraintName), columns(columns), columnPositions(columnPositions) {
+}
+
+bool HashIndex::makeKey(const QVector<QString>& row, QString& key) const {
+    key.clear();
+    for (int pos : columnPositions) {
+        const QString value = pos < row.size() ? row[pos] : QString();
+        if (value.isEmpty() || value.compare("null", Qt::CaseInsensitive) == 0) {
+            return false;
+        }
+        
+        // Single-column keys are used as-is; composite parts are length-prefixed
+        // so ("ab", "c") and ("a", "bc") stay distinct
+        if (columnPositions.size() == 1) {
+            key = value;
+        } else {
+            key += QString::number(value.size());
+            key += QChar(':');
+            key += value;
+        }
+    }
+    return true;
+}
+
+qint64 HashIndex::find(const QVector<QString>& row) const {
+    QString key;
+    if (!makeKey(row, key)) {
+        return -1;
+    }
+    return entries.value(key, -1);
+}
+
+bool HashIndex::insert(const QVector<QString>& row, qint64 rowId) {
+    QString key;
+    if (!makeKey(row, key)) {
+        return true;
+    }
+    if (entries.contains(key)) {
+        return false;
+    }
+    entries.insert(key, rowId);
+    return true;
+}
+
+void HashIndex::remove(const QVector<QString>& row, qint64 rowId) {
+    QString key;
+    if (!makeKey(row, key)) {
+        return;
+    }
+    auto it = entries.find(key);
+    if (it != entries.end() && it.value() == rowId) {
+        entries.erase(it);
+    }
+}
+
+int HashIndex::build(const RowStore& rows) {
+    entries.clear();
+    entries.reserve(rows.size());
+    
+    int duplicates = 0;
+    for (auto row = rows.begin(); row != rows.end(); ++row) {
+        if (!insert(*row, row.rowId())) {
+            duplicates++;
+        }
+    }
+    return duplicates;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+class RowStore;
+
+/**
+ * @brief Hash index enforcing a PRIMARY KEY or UNIQUE constraint
+ *
+ * Maps the constrained column values of each row to its row id so a
+ * duplicate check is a single hash lookup instead of a table scan. Rows
+ * with a NULL in any constrained column are not indexed and never
+ * conflict, matching SQL UNIQUE semantics.
+ */
+class HashIndex {
+public:
+    HashIndex(const QString& constraintName, const QStringList& columns, const QVector<int>& columnPositions);
+    
+    QString getConstraintName() const { return constraintName; }
+    QStringList getColumns() const { return columns; }
+    
+    // Row id already holding the row's key, or -1
+    qint64 find(const QVector<QString>& row) const;
+    qint64 findKey(const QString& key) const { return entries.value(key, -1); }
+    bool insert(const QVector<QString>& row, qint64 rowId);
+    void remove(const QVector<QString>& row, qint64 rowId);
+    
+    // Rebuilds from scratch; returns the number of rows whose key was already taken
+    int build(const RowStore& rows);
+    void clear() { entries.clear(); }
+    int size() const { return entries.size(); }
+    
+    // Returns false when the row has a NULL in a constrained column
+    bool makeKey(const QVector<QString>& row, QString& key) const;
+    
+private:
+    QString constraintName;
+    QStringList columns;
+    QVector<int> columnPositions;
+    QHash<QString, qint64> entries;  // encoded key -> row ID
+};
@@ -1,20 +1,210 @@
 #include "index.h"
+#include <algorithm>
 
-Index::Index(const QString& indexName, const QString& tableName, const QStringList& columns)
-    : indexName(indexName), tableName(tableName), columns(columns) {
+// IndexKey
+
+IndexKey IndexKey::fromValues(const QVector<QString>& values, const QVector<DataType>& types) {
+    IndexKey key;
+    key.parts.reserve(values.size());
+    for (int i = 0; i < values.size(); ++i) {
+        key.parts.append(makePart(values[i], i < types.size() ? types[i] : DataType::VARCHAR));
+    }
+    return key;
+}
+
+IndexKey IndexKey::fromString(const QString& value, DataType type) {
+    IndexKey key;
+    key.parts.append(makePart(value, type));
+    return key;
 }
 
-void Index::insert(const QString& key, int rowId) {
-    if (!indexMap.contains(key)) {
-        indexMap[key] = QVector<int>();
+IndexKey::Part IndexKey::makePart(const QString& value, DataType type) {
+    Part part;
+    if (value.isEmpty() || value.compare("null", Qt::CaseInsensitive) == 0) {
+        return part;
     }
-    indexMap[key].append(rowId);
+    
+    bool ok = false;
+    if (DataTypeManager::isIntegerType(type)) {
+        part.integer = value.toLongLong(&ok);
+        part.kind = Kind::Integer;
+    } else if (DataTypeManager::isNumericType(type)) {
+        part.real = value.toDouble(&ok);
+        part.kind = Kind::Real;
+    } else if (type == DataType::BOOL) {
+        QString upper = value.toUpper();
+        part.integer = (upper == "TRUE" || upper == "1" || upper == "YES") ? 1 : 0;
+        part.kind = Kind::Integer;
+        ok = true;
+    }
+    
+    // Values that do not parse as their column type still get a stable order
+    if (!ok) {
+        part.kind = Kind::Text;
+        part.text = value;
+    }
+    return part;
+}
+
+int IndexKey::comparePart(const Part& a, const Part& b) {
+    if (a.kind == Kind::Null || b.kind == Kind::Null) {
+        return (a.kind == Kind::Null ? 0 : 1) - (b.kind == Kind::Null ? 0 : 1);
+    }
+    if (a.kind == Kind::Integer && b.kind == Kind::Integer) {
+        return a.integer < b.integer ? -1 : (a.integer > b.integer ? 1 : 0);
+    }
+    if (a.kind != Kind::Text && b.kind != Kind::Text) {
+        double x = a.kind == Kind::Integer ? static_cast<double>(a.integer) : a.real;
+        double y = b.kind == Kind::Integer ? static_cast<double>(b.integer) : b.real;
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+    // Numbers sort before text
+    if (a.kind != Kind::Text || b.kind != Kind::Text) {
+        return a.kind == Kind::Text ? 1 : -1;
+    }
+    return a.text.compare(b.text);
+}
+
+int IndexKey::compare(const IndexKey& other) const {
+    int n = qMin(parts.size(), other.parts.size());
+    for (int i = 0; i < n; ++i) {
+        int result = comparePart(parts[i], other.parts[i]);
+        if (result != 0) {
+            return result;
+        }
+    }
+    return parts.size() - other.parts.size();
+}
+
+bool IndexKey::hasNull() const {
+    for (const Part& part : parts) {
+        if (part.kind == Kind::Null) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString IndexKey::toString() const {
+    QStringList values;
+    for (const Part& part : parts) {
+        switch (part.kind) {
+            case Kind::Null:    values.append("NULL"); break;
+            case Kind::Integer: values.append(QString::number(part.integer)); break;
+            case Kind::Real:    values.append(QString::number(part.real)); break;
+            case Kind::Text:    values.append(part.text); break;
+        }
+    }
+    return values.join(", ");
+}
+
+// Index
+
+Index::Index(const QString& indexName, const QString& tableName, const QStringList& columns,
+             const QVector<DataType>& columnTypes, bool unique)
+    : indexName(indexName), tableName(tableName), columns(columns),
+      columnTypes(columnTypes), unique(unique) {
+}
+
+IndexKey Index::makeKey(const QVector<QString>& values) const {
+    return IndexKey::fromValues(values, columnTypes);
+}
+
+void Index::insert(const QString& key, qint64 rowId) {
+    insert(makeKey(QVector<QString>() << key), rowId);
 }
 
 bool Index::search(const QString& key) const {
-    return indexMap.contains(key);
+    return contains(makeKey(QVector<QString>() << key));
 }
 
 void Index::remove(const QString& key) {
-    indexMap.remove(key);
+    IndexKey indexKey = makeKey(QVector<QString>() << key);
+    if (const QVector<qint64>* rowIds = tree.find(indexKey)) {
+        entries -= rowIds->size();
+        tree.erase(indexKey);
+    }
+}
+
+void Index::insert(const IndexKey& key, qint64 rowId) {
+    tree.getOrInsert(key).append(rowId);
+    entries++;
+}
+
+bool Index::remove(const IndexKey& key, qint64 rowId) {
+    QVector<qint64>* rowIds = tree.find(key);
+    if (!rowIds) {
+        return false;
+    }
+    
+    int pos = rowIds->indexOf(rowId);
+    if (pos < 0) {
+        return false;
+    }
+    rowIds->removeAt(pos);
+    entries--;
+    
+    if (rowIds->isEmpty()) {
+        tree.erase(key);
+    }
+    return true;
+}
+
+bool Index::contains(const IndexKey& key) const {
+    return tree.contains(key);
+}
+
+QVector<qint64> Index::find(const IndexKey& key) const {
+    const QVector<qint64>* rowIds = tree.find(key);
+    return rowIds ? *rowIds : QVector<qint64>();
+}
+
+QVector<qint64> Index::range(const IndexKey* low, bool lowInclusive,
+                          const IndexKey* high, bool highInclusive) const {
+    QVector<qint64> result;
+    scan(low, lowInclusive, high, highInclusive, [&result](const IndexKey&, const QVector<qint64>& rowIds) {
+        result += rowIds;
+        return true;
+    });
+    return result;
+}
+
+void Index::scan(const IndexKey* low, bool lowInclusive,
+                 const IndexKey* high, bool highInclusive,
+                 const std::function<bool(const IndexKey&, const QVector<qint64>&)>& visit) const {
+    auto it = !low ? tree.begin() : (lowInclusive ? tree.lowerBound(*low) : tree.upperBound(*low));
+    for (; !it.atEnd(); ++it) {
+        if (high) {
+            int cmp = it.key().compare(*high);
+            if (cmp > 0 || (cmp == 0 && !highInclusive)) {
+                break;
+            }
+        }
+        if (!visit(it.key(), it.value())) {
+            break;
+        }
+    }
+}
+
+void Index::bulkLoad(QVector<QPair<IndexKey, qint64>> input) {
+    std::stable_sort(input.begin(), input.end(), [](const QPair<IndexKey, qint64>& a, const QPair<IndexKey, qint64>& b) {
+        return a.first < b.first;
+    });
+    
+    // Group row ids of equal keys into one entry per key
+    std::vector<std::pair<IndexKey, QVector<qint64>>> grouped;
+    for (const auto& entry : input) {
+        if (grouped.empty() || grouped.back().first != entry.first) {
+            grouped.emplace_back(entry.first, QVector<qint64>());
+        }
+        grouped.back().second.append(entry.second);
+    }
+    
+    tree.bulkLoad(std::move(grouped));
+    entries = input.size();
+}
+
+void Index::clear() {
+    tree.clear();
+    entries = 0;
 }
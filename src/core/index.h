@@ -1,28 +1,103 @@
 #pragma once
 
+#include "bplus_tree.h"
+#include "data_type.h"
 #include <QString>
-#include <QMap>
+#include <QStringList>
 #include <QVector>
+#include <QPair>
+#include <functional>
 
 /**
- * @brief Index structure for query optimization
+ * @brief Typed, possibly composite, index key
+ *
+ * Each part is compared by the type of its column: integers and reals
+ * numerically, everything else as text. NULL sorts before any value.
+ */
+class IndexKey {
+public:
+    IndexKey() = default;
+
+    static IndexKey fromValues(const QVector<QString>& values, const QVector<DataType>& types);
+    static IndexKey fromString(const QString& value, DataType type = DataType::VARCHAR);
+
+    int compare(const IndexKey& other) const;
+    bool operator<(const IndexKey& other) const { return compare(other) < 0; }
+    bool operator==(const IndexKey& other) const { return compare(other) == 0; }
+    bool operator!=(const IndexKey& other) const { return compare(other) != 0; }
+
+    int partCount() const { return parts.size(); }
+    bool hasNull() const;
+    QString toString() const;
+
+private:
+    enum class Kind : quint8 { Null, Integer, Real, Text };
+
+    struct Part {
+        Kind kind = Kind::Null;
+        qint64 integer = 0;
+        double real = 0.0;
+        QString text;
+    };
+
+    QVector<Part> parts;
+
+    static Part makePart(const QString& value, DataType type);
+    static int comparePart(const Part& a, const Part& b);
+};
+
+/**
+ * @brief Secondary index over one or more columns of a table
+ *
+ * Backed by a B+tree from IndexKey to the ids of the rows holding that key,
+ * so point lookups and range scans are logarithmic instead of a table scan.
  */
 class Index {
 public:
-    Index(const QString& indexName, const QString& tableName, const QStringList& columns);
+    Index(const QString& indexName, const QString& tableName, const QStringList& columns,
+          const QVector<DataType>& columnTypes = QVector<DataType>(), bool unique = false);
     
     QString getIndexName() const { return indexName; }
     QString getTableName() const { return tableName; }
     QStringList getColumns() const { return columns; }
+    QVector<DataType> getColumnTypes() const { return columnTypes; }
+    bool isUnique() const { return unique; }
+    
+    // Builds a key from values given in index column order
+    IndexKey makeKey(const QVector<QString>& values) const;
     
-    // To be implemented in Phase 10
-    void insert(const QString& key, int rowId);
+    // Single-column string keys
+    void insert(const QString& key, qint64 rowId);
     bool search(const QString& key) const;
     void remove(const QString& key);
     
+    // Typed keys
+    void insert(const IndexKey& key, qint64 rowId);
+    bool remove(const IndexKey& key, qint64 rowId);
+    bool contains(const IndexKey& key) const;
+    QVector<qint64> find(const IndexKey& key) const;
+    
+    // Rows with low <= key <= high (bounds may be exclusive, nullptr means unbounded)
+    QVector<qint64> range(const IndexKey* low, bool lowInclusive,
+                       const IndexKey* high, bool highInclusive) const;
+    // Visits keys in order; return false from visit to stop early
+    void scan(const IndexKey* low, bool lowInclusive,
+              const IndexKey* high, bool highInclusive,
+              const std::function<bool(const IndexKey&, const QVector<qint64>&)>& visit) const;
+    
+    // Replaces the contents in one pass (entries need not be sorted)
+    void bulkLoad(QVector<QPair<IndexKey, qint64>> entries);
+    void clear();
+    
+    int keyCount() const { return tree.size(); }
+    int entryCount() const { return entries; }
+    
 private:
     QString indexName;
     QString tableName;
     QStringList columns;
-    QMap<QString, QVector<int>> indexMap;  // key -> row IDs
+    QVector<DataType> columnTypes;
+    bool unique;
+    BPlusTree<IndexKey, QVector<qint64>> tree;  // key -> row IDs
+    int entries = 0;
 };
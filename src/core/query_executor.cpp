@@ -1,43 +1,417 @@
 #include "query_executor.h"
 #include "table_manager.h"
 #include "table_schema.h"
+#include "index.h"
+#include "expression_evaluator.h"
+#include "column_filter.h"
+#include "hash_aggregator.h"
+#include "table_join.h"
+#include "transaction_manager.h"
 #include "../parser/ast_nodes.h"
+#include "../storage/copy_file.h"
 #include "../utils/logger.h"
 #include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
 
-// Helper to check if a row matches a WHERE condition
-// Supports simple "col = val" conditions
-// Very basic parsing for now
-static bool evaluateCondition(const QString& whereClause, const std::shared_ptr<TableSchema>& schema, const QVector<QString>& row) {
-    if (whereClause.isEmpty()) return true;
+// Helper to find the rows a WHERE condition can match through an index
+// Looks for "col = literal" or "col IN (literals)" among the top-level AND terms.
+// Returns false when no index covers the condition and every row must be checked
+static bool lookupIndexedRows(const Expression* condition, const QString& tableName,
+                              const TableManager& tableManager, QVector<qint64>& rowIds) {
+    if (!condition) return false;
+    
+    if (condition->kind == Expression::BINARY && condition->op == Expression::AND) {
+        for (const auto& child : condition->children) {
+            if (lookupIndexedRows(child.get(), tableName, tableManager, rowIds)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    const Expression* column = nullptr;
+    QVector<const Expression*> literals;
+    
+    if (condition->kind == Expression::BINARY && condition->op == Expression::EQ) {
+        const Expression* left = condition->children[0].get();
+        const Expression* right = condition->children[1].get();
+        if (left->kind == Expression::COLUMN && right->kind == Expression::LITERAL) {
+            column = left;
+            literals.append(right);
+        } else if (right->kind == Expression::COLUMN && left->kind == Expression::LITERAL) {
+            column = right;
+            literals.append(left);
+        }
+    } else if (condition->kind == Expression::IN_LIST && !condition->negated &&
+               condition->children[0]->kind == Expression::COLUMN) {
+        column = condition->children[0].get();
+        for (int i = 1; i < condition->children.size(); ++i) {
+            if (condition->children[i]->kind != Expression::LITERAL) {
+                return false;
+            }
+            literals.append(condition->children[i].get());
+        }
+    }
+    if (!column) return false;
+    
+    auto index = tableManager.findIndex(tableName, QStringList() << column->value);
+    if (!index) return false;
+    
+    rowIds.clear();
+    for (const Expression* literal : literals) {
+        rowIds += index->find(index->makeKey(QVector<QString>() << literal->value));
+    }
+    std::sort(rowIds.begin(), rowIds.end());
+    rowIds.erase(std::unique(rowIds.begin(), rowIds.end()), rowIds.end());
+    return true;
+}
+
+// Helper to narrow a full scan with the vectorized column filters.
+// Returns false when no term of the condition can be tested over typed columns;
+// the slots it returns still have to pass the full condition
+static bool prefilterSlots(const Expression* condition, const TableSchema& schema,
+                           const TableScan& rows, QVector<int>& candidateSlots) {
+    auto filter = ColumnFilter::plan(condition, schema);
+    if (!filter) return false;
+    
+    candidateSlots = filter->select(rows);
+    return true;
+}
+
+// Candidate rows of a single-table WHERE, narrowed the same way by every statement: to
+// the rows an index covering the condition points at, else to the slots the vectorized
+// column filters keep, else to every slot. Each must still pass the compiled condition
+class CandidateSlots {
+public:
+    // Consults the indexes, which describe the live table only; so before the scan
+    // switches to a snapshot, and never for a table read as last committed
+    void lookupIndex(const Expression* condition, const QString& tableName, const TableScan& rows,
+                     const TableManager& tableManager) {
+        indexed = !rows.isSnapshot() && lookupIndexedRows(condition, tableName, tableManager, rowIds);
+    }
+    // Runs the column filters unless an index has narrowed the rows already
+    void filter(const Expression* condition, const TableSchema& schema, const TableScan& rows) {
+        prefiltered = !indexed && prefilterSlots(condition, schema, rows, filtered);
+        candidateCount = indexed ? rowIds.size() : (prefiltered ? filtered.size() : rows.slotCount());
+    }
+    
+    int count() const { return candidateCount; }
+    // Slot of the c-th candidate when it is a live row, else -1
+    int slotAt(const TableScan& rows, int c) const {
+        int slot = indexed ? rows.slotOf(rowIds[c]) : (prefiltered ? filtered[c] : c);
+        return slot >= 0 && rows.isLive(slot) ? slot : -1;
+    }
+    
+private:
+    QVector<qint64> rowIds;
+    QVector<int> filtered;
+    bool indexed = false;
+    bool prefiltered = false;
+    int candidateCount = 0;
+};
+
+// ORDER BY term resolved against the table
+struct SortKey {
+    int column;
+    bool descending;
+    bool numeric;
+};
+
+// Compares two column values for ORDER BY; NULLs sort first.
+// Numeric columns compare by value, falling back to text for values that do not parse
+static int compareSortValues(const QString& a, const QString& b, bool numeric) {
+    bool aNull = a.isEmpty() || a.compare("null", Qt::CaseInsensitive) == 0;
+    bool bNull = b.isEmpty() || b.compare("null", Qt::CaseInsensitive) == 0;
+    if (aNull || bNull) {
+        return aNull == bNull ? 0 : (aNull ? -1 : 1);
+    }
+    
+    if (numeric) {
+        bool aOk = false;
+        bool bOk = false;
+        double x = a.toDouble(&aOk);
+        double y = b.toDouble(&bOk);
+        if (aOk && bOk) {
+            return x < y ? -1 : (x > y ? 1 : 0);
+        }
+    }
+    return QString::compare(a, b);
+}
+
+// Compares the sort columns of two slots, reading cells in place. Integers,
+// doubles and dates held natively compare without going through text; they
+// order exactly as their canonical text would under compareSortValues
+static int compareSortKeys(const TableScan& rows, int a, int b, const QVector<SortKey>& keys) {
+    for (const auto& key : keys) {
+        if (key.column >= rows.columnCount()) {
+            continue;
+        }
+        const ColumnVector& column = rows.column(key.column);
+        int cmp = 0;
+        if (column.isNative(a) && column.isNative(b)) {
+            switch (column.getStorage()) {
+                case ColumnVector::Storage::Int64: {
+                    qint64 x = column.int64At(a);
+                    qint64 y = column.int64At(b);
+                    cmp = x < y ? -1 : (x > y ? 1 : 0);
+                    break;
+                }
+                case ColumnVector::Storage::Double: {
+                    double x = column.doubleAt(a);
+                    double y = column.doubleAt(b);
+                    cmp = x < y ? -1 : (x > y ? 1 : 0);
+                    break;
+                }
+                case ColumnVector::Storage::Date: {
+                    qint32 x = column.dateAt(a);
+                    qint32 y = column.dateAt(b);
+                    cmp = x < y ? -1 : (x > y ? 1 : 0);
+                    break;
+                }
+                default:
+                    cmp = compareSortValues(column.value(a), column.value(b), key.numeric);
+                    break;
+            }
+        } else {
+            cmp = compareSortValues(column.value(a), column.value(b), key.numeric);
+        }
+        if (cmp != 0) {
+            return key.descending ? -cmp : cmp;
+        }
+    }
+    return 0;
+}
+
+// Adds an aggregate call to the list computed per group, once per distinct call.
+// Returns its position, or -1 with error set when the column does not exist
+static int addAggregate(SelectItem::Aggregate function, const QString& columnName, const TableSchema& schema,
+                        QVector<HashAggregator::Aggregate>& aggregates, QStringList& labels, QString& error) {
+    int column = -1;
+    if (!columnName.isEmpty()) {
+        column = schema.getColumnIndex(columnName);
+        if (column < 0) {
+            error = QString("Unknown column '%1' in %2").arg(columnName, SelectItem(columnName, function).label());
+            return -1;
+        }
+    }
+    // Labels use the schema's spelling so SUM(Price) and SUM(price) are one aggregate
+    QString label = SelectItem(column >= 0 ? schema.getColumn(column)->getName() : QString(), function).label();
+    int index = labels.indexOf(label);
+    if (index < 0) {
+        index = labels.size();
+        labels.append(label);
+        aggregates.append({function, column});
+    }
+    return index;
+}
+
+// Copies a HAVING condition for evaluation over grouped rows: aggregate calls become
+// references to their result columns, and plain columns must be GROUP BY columns
+static std::shared_ptr<Expression> bindHavingCondition(const Expression* expression, const TableSchema& schema,
+                                                       const QVector<int>& groupColumns,
+                                                       QVector<HashAggregator::Aggregate>& aggregates,
+                                                       QStringList& labels, QString& error) {
+    auto bound = std::make_shared<Expression>(*expression);
+    bound->children.clear();
+    
+    if (expression->kind == Expression::AGGREGATE) {
+        SelectItem::Aggregate function = SelectItem::aggregateNamed(expression->value);
+        QString columnName = expression->children.isEmpty() ? QString() : expression->children[0]->value;
+        int index = addAggregate(function, columnName, schema, aggregates, labels, error);
+        if (index < 0) {
+            return nullptr;
+        }
+        bound->kind = Expression::COLUMN;
+        bound->value = labels[index];
+        return bound;
+    }
+    
+    if (expression->kind == Expression::COLUMN) {
+        int column = schema.getColumnIndex(expression->value);
+        if (column < 0 || !groupColumns.contains(column)) {
+            error = QString("Column '%1' in HAVING must appear in GROUP BY or be used in an aggregate").arg(expression->value);
+            return nullptr;
+        }
+        bound->value = schema.getColumn(column)->getName();
+        return bound;
+    }
+    
+    for (const auto& child : expression->children) {
+        auto boundChild = bindHavingCondition(child.get(), schema, groupColumns, aggregates, labels, error);
+        if (!boundChild) {
+            return nullptr;
+        }
+        bound->children.append(boundChild);
+    }
+    return bound;
+}
+
+// Table of a join query and where its columns sit in the combined row
+struct JoinTable {
+    QString name;
+    QString alias;                        // Name the query refers to it by
+    std::shared_ptr<TableSchema> schema;
+    int offset;                           // Position of its first column in the combined row
+};
+
+// Splits "table.column" into its qualifier and column name
+static void splitColumnReference(const QString& reference, QString& qualifier, QString& name) {
+    int dot = reference.indexOf('.');
+    qualifier = dot >= 0 ? reference.left(dot) : QString();
+    name = dot >= 0 ? reference.mid(dot + 1) : reference;
+}
+
+// Resolves a column against the first tableCount tables of a join.
+// Returns the table's position and sets column, or -1 with error set
+static int resolveJoinColumn(const QString& qualifier, const QString& name, const QVector<JoinTable>& tables,
+                             int tableCount, int& column, QString& error) {
+    int found = -1;
+    for (int t = 0; t < tableCount; ++t) {
+        if (!qualifier.isEmpty() && tables[t].alias.compare(qualifier, Qt::CaseInsensitive) != 0) {
+            continue;
+        }
+        int index = tables[t].schema->getColumnIndex(name);
+        if (index < 0) {
+            continue;
+        }
+        if (found >= 0) {
+            error = QString("Column '%1' is ambiguous; qualify it with a table name").arg(name);
+            return -1;
+        }
+        found = t;
+        column = index;
+    }
+    if (found < 0) {
+        error = qualifier.isEmpty() ? QString("Unknown column '%1'").arg(name)
+                                    : QString("Unknown column '%1.%2'").arg(qualifier, name);
+    }
+    return found;
+}
 
-    // Simple parsing: split by "="
-    // Example: "id = 5"
-    QStringList parts = whereClause.split("=");
-    if (parts.size() != 2) return true; // Complex condition or error, default to true (unsafe?) or false? 
-                                        // For safety in DELETE/UPDATE, maybe default to false if parse fails?
-                                        // But currently whereClause is raw string. Let's try to support "id = 123"
+// Collects the bit of every table a condition reads; false with error set when a column does not resolve
+static bool joinTablesRead(const Expression* expression, const QVector<JoinTable>& tables, int tableCount,
+                           quint64& mask, QString& error) {
+    if (expression->kind == Expression::COLUMN) {
+        int column = -1;
+        int table = resolveJoinColumn(expression->qualifier, expression->value, tables, tableCount, column, error);
+        if (table < 0) {
+            return false;
+        }
+        mask |= quint64(1) << table;
+        return true;
+    }
+    for (const auto& child : expression->children) {
+        if (!joinTablesRead(child.get(), tables, tableCount, mask, error)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    QString colName = parts[0].trimmed();
-    QString targetVal = parts[1].trimmed();
+// Copies a condition over joined tables for evaluation over combined rows,
+// where every column is named by its qualified name ("alias.column")
+static std::shared_ptr<Expression> bindJoinCondition(const Expression* expression, const QVector<JoinTable>& tables,
+                                                     QString& error) {
+    auto bound = std::make_shared<Expression>(*expression);
+    bound->children.clear();
+    
+    if (expression->kind == Expression::COLUMN) {
+        int column = -1;
+        int table = resolveJoinColumn(expression->qualifier, expression->value, tables, tables.size(), column, error);
+        if (table < 0) {
+            return nullptr;
+        }
+        bound->value = tables[table].alias + "." + tables[table].schema->getColumn(column)->getName();
+        bound->qualifier.clear();
+        return bound;
+    }
     
-    // Remove quotes if string
-    if (targetVal.startsWith("'") && targetVal.endsWith("'")) {
-        targetVal = targetVal.mid(1, targetVal.length() - 2);
+    for (const auto& child : expression->children) {
+        auto boundChild = bindJoinCondition(child.get(), tables, error);
+        if (!boundChild) {
+            return nullptr;
+        }
+        bound->children.append(boundChild);
     }
+    return bound;
+}
 
-    int colIdx = schema->getColumnIndex(colName);
-    if (colIdx == -1) return false; // Column not found
+// Top-level AND terms of a condition
+static void splitConjuncts(const std::shared_ptr<Expression>& expression, QVector<std::shared_ptr<Expression>>& terms) {
+    if (!expression) {
+        return;
+    }
+    if (expression->kind == Expression::BINARY && expression->op == Expression::AND) {
+        for (const auto& child : expression->children) {
+            splitConjuncts(child, terms);
+        }
+        return;
+    }
+    terms.append(expression);
+}
 
-    if (colIdx >= row.size()) return false;
+// AND of the terms; null when there are none
+static std::shared_ptr<Expression> conjunction(const QVector<std::shared_ptr<Expression>>& terms) {
+    std::shared_ptr<Expression> result;
+    for (const auto& term : terms) {
+        if (!result) {
+            result = term;
+            continue;
+        }
+        auto node = std::make_shared<Expression>(Expression::BINARY, Expression::AND);
+        node->children << result << term;
+        result = node;
+    }
+    return result;
+}
 
-    return row[colIdx] == targetVal;
+// An ON term "outer = inner" between two columns the hash join can key on: numeric
+// columns on both sides, or non-numeric columns on both sides, as = compares them
+static bool joinKeyOf(const Expression* term, const QVector<JoinTable>& tables, int inner,
+                      TableJoin::KeyPair& key) {
+    if (term->kind != Expression::BINARY || term->op != Expression::EQ ||
+        term->children[0]->kind != Expression::COLUMN || term->children[1]->kind != Expression::COLUMN) {
+        return false;
+    }
+    
+    int columns[2] = {-1, -1};
+    int owners[2] = {-1, -1};
+    QString error;
+    for (int side = 0; side < 2; ++side) {
+        const Expression* column = term->children[side].get();
+        owners[side] = resolveJoinColumn(column->qualifier, column->value, tables, inner + 1, columns[side], error);
+    }
+    int innerSide = owners[0] == inner ? 0 : 1;
+    int outerSide = 1 - innerSide;
+    if (owners[innerSide] != inner || owners[outerSide] < 0 || owners[outerSide] == inner) {
+        return false;
+    }
+    
+    bool innerNumeric = DataTypeManager::isNumericType(
+        tables[inner].schema->getColumn(columns[innerSide])->getType());
+    bool outerNumeric = DataTypeManager::isNumericType(
+        tables[owners[outerSide]].schema->getColumn(columns[outerSide])->getType());
+    if (innerNumeric != outerNumeric) {
+        return false;
+    }
+    key = {owners[outerSide], columns[outerSide], columns[innerSide], innerNumeric};
+    return true;
 }
 
 QueryExecutor::QueryExecutor() 
-    : tableManager(std::make_shared<TableManager>()) {
+    : tableManager(std::make_shared<TableManager>()),
+      transaction(std::make_unique<TransactionManager>(tableManager)) {
+}
+
+QueryExecutor::QueryExecutor(std::shared_ptr<TableManager> manager)
+    : tableManager(manager),
+      transaction(std::make_unique<TransactionManager>(manager)) {
 }
 
+QueryExecutor::~QueryExecutor() = default;
+
 // Helper function to compute default values that are functions
 static QString computeDefaultValue(const QString& defaultValue) {
     if (defaultValue == "NOW()" || defaultValue == "CURRENT_TIMESTAMP" || defaultValue == "CURRENT_TIMESTAMP()") {
@@ -55,9 +429,77 @@ static QString computeDefaultValue(const QString& defaultValue) {
 }
 
 void QueryExecutor::setTableManager(std::shared_ptr<TableManager> manager) {
+    transaction->setTableManager(manager);
     tableManager = manager;
 }
 
+void QueryExecutor::setCopyDirectory(const QString& directory) {
+    copyRestricted = true;
+    copyDirectory = directory;
+}
+
+// Error of a statement that gave up waiting for a table another session holds
+static QString lockWaitTimeoutError() {
+    return QString("Lock wait timeout after %1 ms").arg(TableManager::LOCK_WAIT_TIMEOUT_MS);
+}
+
+// Error of a write to a table the statement already holds for reading; the latch is not upgraded
+static QString notLatchedError(const QString& tableName) {
+    return QString("Table '%1' is held for reading and cannot be changed").arg(tableName);
+}
+
+bool QueryExecutor::resolveCopyPath(const QString& path, QString& resolvedPath, QString& errorMessage) const {
+    // Whether a canonical path is the directory or lies below it
+    auto within = [](const QString& file, const QString& directory) {
+        return !directory.isEmpty() && (file == directory || file.startsWith(directory + '/'));
+    };
+    
+    QString base;
+    if (copyRestricted) {
+        if (copyDirectory.isEmpty()) {
+            errorMessage = "COPY to or from files is disabled for this session";
+            return false;
+        }
+        base = QDir(copyDirectory).canonicalPath();
+        if (base.isEmpty()) {
+            errorMessage = QString("COPY directory '%1' does not exist").arg(copyDirectory);
+            return false;
+        }
+    }
+    
+    // Symbolic links and ".." are resolved before the path is checked; a file that
+    // does not exist yet is checked by its directory
+    QFileInfo info(copyRestricted ? QDir(base).absoluteFilePath(path) : QFileInfo(path).absoluteFilePath());
+    QString canonical = info.canonicalFilePath();
+    if (canonical.isEmpty()) {
+        QString directory = QDir(info.absolutePath()).canonicalPath();
+        if (directory.isEmpty()) {
+            errorMessage = QString("Directory of '%1' does not exist").arg(path);
+            return false;
+        }
+        canonical = QDir(directory).filePath(info.fileName());
+    }
+    
+    if (copyRestricted && !within(canonical, base)) {
+        errorMessage = QString("COPY file '%1' is outside the COPY directory").arg(path);
+        return false;
+    }
+    if (within(canonical, QDir(tableManager->getDataPath()).canonicalPath())) {
+        errorMessage = QString("COPY file '%1' is in the data directory").arg(path);
+        return false;
+    }
+    resolvedPath = canonical;
+    return true;
+}
+
+bool QueryExecutor::isInTransaction() const {
+    return transaction->isInTransaction();
+}
+
+TransactionManager* QueryExecutor::activeTransaction() const {
+    return transaction->isInTransaction() ? transaction.get() : nullptr;
+}
+
 std::unique_ptr<QueryResult> QueryExecutor::execute(const std::unique_ptr<ASTNode>& statement) {
     auto result = std::make_unique<QueryResult>();
     
@@ -67,16 +509,74 @@ std::unique_ptr<QueryResult> QueryExecutor::execute(const std::unique_ptr<ASTNod
         return result;
     }
     
+    if (dynamic_cast<BeginStatement*>(statement.get()) || dynamic_cast<CommitStatement*>(statement.get()) ||
+        dynamic_cast<RollbackStatement*>(statement.get())) {
+        return executeTransactionControl(statement.get());
+    }
+    
+    QStringList readTables;
+    QStringList writeTables;
+    if (!transaction->isInTransaction()) {
+        // On its own a statement that changes rows latches its tables up front, and one that
+        // changes the catalog the catalog, with the same bounded wait as in a transaction:
+        // statements queued behind an open transaction give up instead of filling the worker
+        // pool while its COMMIT waits for a worker. Reads latch as they scan, and read the
+        // tables a transaction is changing as last committed (see TableScan).
+        statementTables(statement.get(), readTables, writeTables, result->errorMessage);
+        bool changesCatalog = dynamic_cast<CreateTableStatement*>(statement.get()) ||
+                              dynamic_cast<CreateIndexStatement*>(statement.get());
+        if (!changesCatalog && writeTables.isEmpty()) {
+            return dispatch(statement.get());
+        }
+        auto locks = changesCatalog
+            ? tableManager->lockCatalog(writeTables, TableManager::LOCK_WAIT_TIMEOUT_MS)
+            : tableManager->lockTables(readTables, writeTables, TableManager::LOCK_WAIT_TIMEOUT_MS);
+        if (!locks.acquired()) {
+            result->success = false;
+            result->errorMessage = lockWaitTimeoutError();
+            Logger::instance().warning(result->errorMessage);
+            return result;
+        }
+        return dispatch(statement.get());
+    }
+    
+    // Inside a transaction the statement's latches belong to the transaction, so the
+    // tables it changes stay latched after it returns. It latches all its tables up
+    // front with a bounded wait: two transactions each waiting for a table the other
+    // holds would otherwise wait forever, and one of them gives up instead.
+    TableLatch::HolderScope holder(transaction.get());
+    if (!statementTables(statement.get(), readTables, writeTables, result->errorMessage)) {
+        result->success = false;
+        return result;
+    }
+    auto locks = tableManager->lockTables(readTables, writeTables, TableManager::LOCK_WAIT_TIMEOUT_MS);
+    if (!locks.acquired()) {
+        transaction->rollback();
+        result->success = false;
+        result->errorMessage = lockWaitTimeoutError() + "; transaction rolled back";
+        Logger::instance().warning(result->errorMessage);
+        return result;
+    }
+    return dispatch(statement.get());
+}
+
+std::unique_ptr<QueryResult> QueryExecutor::dispatch(const ASTNode* statement) {
+    auto result = std::make_unique<QueryResult>();
+    
     // Determine statement type and dispatch
-    if (auto createStmt = dynamic_cast<CreateTableStatement*>(statement.get())) {
+    if (auto createStmt = dynamic_cast<const CreateTableStatement*>(statement)) {
         return executeCreate(createStmt);
-    } else if (auto insertStmt = dynamic_cast<InsertStatement*>(statement.get())) {
+    } else if (auto createIndexStmt = dynamic_cast<const CreateIndexStatement*>(statement)) {
+        return executeCreateIndex(createIndexStmt);
+    } else if (auto insertStmt = dynamic_cast<const InsertStatement*>(statement)) {
         return executeInsert(insertStmt);
-    } else if (auto updateStmt = dynamic_cast<UpdateStatement*>(statement.get())) {
+    } else if (auto copyStmt = dynamic_cast<const CopyStatement*>(statement)) {
+        return executeCopy(copyStmt);
+    } else if (auto updateStmt = dynamic_cast<const UpdateStatement*>(statement)) {
         return executeUpdate(updateStmt);
-    } else if (auto deleteStmt = dynamic_cast<DeleteStatement*>(statement.get())) {
+    } else if (auto deleteStmt = dynamic_cast<const DeleteStatement*>(statement)) {
         return executeDelete(deleteStmt);
-    } else if (auto selectStmt = dynamic_cast<SelectStatement*>(statement.get())) {
+    } else if (auto selectStmt = dynamic_cast<const SelectStatement*>(statement)) {
         return executeSelect(selectStmt);
     } else {
         result->success = false;
@@ -85,6 +585,86 @@ std::unique_ptr<QueryResult> QueryExecutor::execute(const std::unique_ptr<ASTNod
     }
 }
 
+bool QueryExecutor::statementTables(const ASTNode* statement, QStringList& readTables,
+                                    QStringList& writeTables, QString& errorMessage) const {
+    // Tables whose rows a statement on table checks its foreign keys against
+    auto referencedTables = [this](const QString& table) {
+        QStringList referenced;
+        if (auto schema = tableManager->getTable(table)) {
+            const auto foreignKeys = schema->getForeignKeyConstraints();
+            for (ForeignKeyConstraint* foreignKey : foreignKeys) {
+                if (foreignKey) {
+                    referenced.append(foreignKey->getReferencedTable());
+                }
+            }
+        }
+        return referenced;
+    };
+    
+    // Schema changes are not part of a transaction. CREATE INDEX latches its table with
+    // the catalog, so it waits for a transaction that is changing the table
+    if (dynamic_cast<const CreateTableStatement*>(statement)) {
+        if (transaction->isInTransaction()) {
+            errorMessage = "CREATE TABLE cannot run inside a transaction";
+            return false;
+        }
+    } else if (auto indexStmt = dynamic_cast<const CreateIndexStatement*>(statement)) {
+        if (transaction->isInTransaction()) {
+            errorMessage = "CREATE INDEX cannot run inside a transaction";
+            return false;
+        }
+        writeTables.append(indexStmt->tableName);
+    } else if (auto insertStmt = dynamic_cast<const InsertStatement*>(statement)) {
+        writeTables.append(insertStmt->tableName);
+        readTables = referencedTables(insertStmt->tableName);
+    } else if (auto copyStmt = dynamic_cast<const CopyStatement*>(statement)) {
+        // COPY TO reads like SELECT, through scans that never wait for a writer
+        if (!copyStmt->toFile) {
+            if (transaction->isInTransaction()) {
+                // A bulk load is made durable by its own checkpoint, not by the transaction's commit
+                errorMessage = "COPY FROM cannot run inside a transaction";
+                return false;
+            }
+            writeTables.append(copyStmt->tableName);
+        }
+    } else if (auto updateStmt = dynamic_cast<const UpdateStatement*>(statement)) {
+        writeTables.append(updateStmt->tableName);
+        readTables = referencedTables(updateStmt->tableName);
+    } else if (auto deleteStmt = dynamic_cast<const DeleteStatement*>(statement)) {
+        writeTables.append(deleteStmt->tableName);
+    }
+    // A SELECT latches nothing up front: its scans read a table a writer holds as last
+    // committed, and one the transaction itself changed with its own changes
+    return true;
+}
+
+std::unique_ptr<QueryResult> QueryExecutor::executeTransactionControl(const ASTNode* statement) {
+    auto result = std::make_unique<QueryResult>();
+    
+    OperationResult opResult;
+    QString action;
+    if (dynamic_cast<const BeginStatement*>(statement)) {
+        action = "BEGIN";
+        opResult = transaction->beginTransaction();
+    } else if (dynamic_cast<const CommitStatement*>(statement)) {
+        action = "COMMIT";
+        opResult = transaction->commit();
+    } else {
+        action = "ROLLBACK";
+        opResult = transaction->rollback();
+    }
+    
+    result->success = opResult.success;
+    result->errorMessage = opResult.errorMessage;
+    result->affectedRows = opResult.rowsAffected;
+    if (opResult.success) {
+        Logger::instance().info(QString("%1: %2 change(s)").arg(action).arg(opResult.rowsAffected));
+    } else {
+        Logger::instance().error(QString("%1 failed: %2").arg(action, opResult.errorMessage));
+    }
+    return result;
+}
+
 std::unique_ptr<QueryResult> QueryExecutor::executeCreate(const ASTNode* statement) {
     auto result = std::make_unique<QueryResult>();
     
@@ -101,12 +681,18 @@ std::unique_ptr<QueryResult> QueryExecutor::executeCreate(const ASTNode* stateme
         Logger::instance().info(QString("CREATE TABLE: Parsing %1 columns").arg(createStmt->columns.size()));
         
         // Add columns with constraints
+        QStringList primaryKeyColumns;
         for (const auto& colDef : createStmt->columns) {
-            Column col(colDef.name, DataType::VARCHAR);  // Default to VARCHAR, needs proper type conversion
+            if (!DataTypeManager::isTypeName(colDef.dataType)) {
+                result->errorMessage = QString("Unknown data type '%1' for column '%2'").arg(colDef.dataType, colDef.name);
+                return result;
+            }
+            Column col(colDef.name, DataTypeManager::stringToType(colDef.dataType));
             
             // Apply constraints
             if (colDef.primaryKey) {
                 col.setPrimaryKey(true);
+                primaryKeyColumns.append(colDef.name);
             }
             if (colDef.unique) {
                 col.setUnique(true);
@@ -122,6 +708,11 @@ std::unique_ptr<QueryResult> QueryExecutor::executeCreate(const ASTNode* stateme
             schema->addColumn(col);
         }
         
+        // Register the key so it is persisted and enforced through its hash index
+        if (!primaryKeyColumns.isEmpty()) {
+            schema->addPrimaryKey(primaryKeyColumns);
+        }
+        
         // Add table to manager
         tableManager->addTable(schema);
         
@@ -137,6 +728,34 @@ std::unique_ptr<QueryResult> QueryExecutor::executeCreate(const ASTNode* stateme
     return result;
 }
 
+std::unique_ptr<QueryResult> QueryExecutor::executeCreateIndex(const ASTNode* statement) {
+    auto result = std::make_unique<QueryResult>();
+    
+    auto indexStmt = dynamic_cast<const CreateIndexStatement*>(statement);
+    if (!indexStmt) {
+        result->errorMessage = "Invalid CREATE INDEX statement";
+        return result;
+    }
+    
+    if (!tableManager->tableExists(indexStmt->tableName)) {
+        result->errorMessage = QString("Table '%1' does not exist").arg(indexStmt->tableName);
+        return result;
+    }
+    
+    auto opResult = tableManager->createIndex(indexStmt->tableName, indexStmt->indexName,
+                                              indexStmt->columns, indexStmt->unique);
+    if (!opResult.success) {
+        result->errorMessage = opResult.errorMessage;
+        Logger::instance().error(QString("CREATE INDEX failed: %1").arg(result->errorMessage));
+        return result;
+    }
+    
+    result->success = true;
+    result->affectedRows = opResult.rowsAffected;
+    Logger::instance().info(QString("Index '%1' created successfully").arg(indexStmt->indexName));
+    return result;
+}
+
 std::unique_ptr<QueryResult> QueryExecutor::executeInsert(const ASTNode* statement) {
     auto result = std::make_unique<QueryResult>();
     
@@ -155,55 +774,56 @@ std::unique_ptr<QueryResult> QueryExecutor::executeInsert(const ASTNode* stateme
         auto schema = tableManager->getTable(insertStmt->tableName);
         const auto& allColumns = schema->getColumns();
         
-        // Insert each row using TableManager with constraint enforcement
-        int totalInserted = 0;
-        for (const auto& rowValues : insertStmt->values) {
-            QVector<QString> completeRow;
-            
-            // If specific columns were mentioned in INSERT, map values to correct positions
-            if (!insertStmt->columns.isEmpty()) {
-                // Initialize complete row with default/null values
-                completeRow.resize(allColumns.size());
-                for (int i = 0; i < allColumns.size(); ++i) {
-                    // Use column's default value if available, computing function defaults
-                    QString defaultValue = allColumns[i].getDefaultValue();
-                    QString computed = computeDefaultValue(defaultValue);
-                    completeRow[i] = computed;
-                    Logger::instance().info(QString("Column '%1': default='%2' computed='%3'")
-                        .arg(allColumns[i].getName()).arg(defaultValue).arg(computed));
-                }
-                
-                // Map provided values to their column positions
-                for (int i = 0; i < insertStmt->columns.size() && i < rowValues.size(); ++i) {
-                    QString colName = insertStmt->columns[i];
-                    // Find column index
-                    for (int j = 0; j < allColumns.size(); ++j) {
-                        if (allColumns[j].getName() == colName) {
-                            completeRow[j] = rowValues[i];
-                            Logger::instance().info(QString("  Mapping column '%1' = '%2'").arg(colName).arg(rowValues[i]));
-                            break;
-                        }
+        // Resolve the column list once; defaults are computed once per statement
+        QVector<int> targetColumns;
+        QVector<QString> defaultRow;
+        if (!insertStmt->columns.isEmpty()) {
+            defaultRow.resize(allColumns.size());
+            for (int i = 0; i < allColumns.size(); ++i) {
+                defaultRow[i] = computeDefaultValue(allColumns[i].getDefaultValue());
+            }
+            for (const QString& colName : insertStmt->columns) {
+                int colIdx = -1;
+                for (int j = 0; j < allColumns.size(); ++j) {
+                    if (allColumns[j].getName() == colName) {
+                        colIdx = j;
+                        break;
                     }
                 }
-                
-                // Log final row to be inserted
-                QString rowStr = completeRow.join(" | ");
-                Logger::instance().info(QString("Final row to insert: [%1]").arg(rowStr));
-            } else {
+                targetColumns.append(colIdx);
+            }
+            Logger::instance().debug(QString("INSERT columns [%1], defaults [%2]")
+                .arg(insertStmt->columns.join(", "), defaultRow.join(" | ")));
+        }
+        
+        // Build every row first, then insert them as one batch with constraint enforcement
+        QVector<QVector<QString>> rows;
+        rows.reserve(insertStmt->values.size());
+        for (const auto& rowValues : insertStmt->values) {
+            if (targetColumns.isEmpty()) {
                 // All columns provided in order
-                completeRow = rowValues;
+                rows.append(rowValues);
+                continue;
             }
             
-            auto opResult = tableManager->insertRow(insertStmt->tableName, completeRow);
-            
-            if (!opResult.success) {
-                result->success = false;
-                result->errorMessage = opResult.errorMessage;
-                Logger::instance().error(QString("INSERT failed: %1").arg(result->errorMessage));
-                return result;
+            // Map provided values to their column positions over the defaults
+            QVector<QString> completeRow = defaultRow;
+            for (int i = 0; i < targetColumns.size() && i < rowValues.size(); ++i) {
+                if (targetColumns[i] >= 0) {
+                    completeRow[targetColumns[i]] = rowValues[i];
+                }
             }
-            totalInserted++;
+            rows.append(completeRow);
+        }
+        
+        auto opResult = tableManager->insertRows(insertStmt->tableName, rows, activeTransaction());
+        if (!opResult.success) {
+            result->success = false;
+            result->errorMessage = opResult.errorMessage;
+            Logger::instance().error(QString("INSERT failed: %1").arg(result->errorMessage));
+            return result;
         }
+        int totalInserted = opResult.rowsAffected;
         
         result->success = true;
         result->affectedRows = totalInserted;
@@ -218,64 +838,331 @@ std::unique_ptr<QueryResult> QueryExecutor::executeInsert(const ASTNode* stateme
     return result;
 }
 
-std::unique_ptr<QueryResult> QueryExecutor::executeUpdate(const ASTNode* statement) {
+std::unique_ptr<QueryResult> QueryExecutor::executeCopy(const ASTNode* statement) {
     auto result = std::make_unique<QueryResult>();
     
-    auto updateStmt = dynamic_cast<const UpdateStatement*>(statement);
-    if (!updateStmt) {
-        result->errorMessage = "Invalid UPDATE statement";
+    auto copyStmt = dynamic_cast<const CopyStatement*>(statement);
+    if (!copyStmt) {
+        result->errorMessage = "Invalid COPY statement";
         return result;
     }
     
-    try {
-        if (!tableManager->tableExists(updateStmt->tableName)) {
-            result->errorMessage = QString("Table '%1' does not exist").arg(updateStmt->tableName);
+    CopyOptions options;
+    options.header = copyStmt->header;
+    options.format = CopyOptions::formatFromPath(copyStmt->filePath);
+    if (!copyStmt->format.isEmpty() && !CopyOptions::formatFromName(copyStmt->format, options.format)) {
+        result->errorMessage = QString("Unknown COPY format '%1'").arg(copyStmt->format);
+        return result;
+    }
+    if (!copyStmt->delimiter.isEmpty()) {
+        if (copyStmt->delimiter.size() != 1) {
+            result->errorMessage = "COPY delimiter must be a single character";
             return result;
         }
+        options.delimiter = copyStmt->delimiter[0];
+    }
+    
+    QString filePath;
+    if (!resolveCopyPath(copyStmt->filePath, filePath, result->errorMessage)) {
+        return result;
+    }
+    if (copyStmt->toFile) {
+        return executeCopyTo(copyStmt, filePath, options);
+    }
+    
+    // Readers wait for the load to finish or abort rather than see part of it. The
+    // table is looked up under the latch, so it cannot be dropped from here on
+    auto locks = tableManager->lockTables(QStringList(), QStringList() << copyStmt->tableName);
+    if (!locks.acquired()) {
+        result->errorMessage = notLatchedError(copyStmt->tableName);
+        return result;
+    }
+    auto schema = tableManager->getTable(copyStmt->tableName);
+    if (!schema) {
+        result->errorMessage = QString("Table '%1' does not exist").arg(copyStmt->tableName);
+        return result;
+    }
+    const auto& allColumns = schema->getColumns();
+    
+    CopyReader reader(filePath, options);
+    if (!reader.open()) {
+        result->errorMessage = reader.getError();
+        return result;
+    }
+    
+    // Columns come from the statement, else the file's header, else the table in order
+    QStringList columnNames = copyStmt->columns;
+    bool fileHasHeader = options.format == CopyFormat::BINARY || (options.format == CopyFormat::CSV && options.header);
+    if (columnNames.isEmpty() && fileHasHeader) {
+        columnNames = reader.getHeader();
+    }
+    QVector<int> targetColumns;
+    for (const QString& colName : columnNames) {
+        int colIdx = schema->getColumnIndex(colName);
+        if (colIdx < 0) {
+            result->errorMessage = QString("Unknown column '%1' in COPY").arg(colName);
+            return result;
+        }
+        targetColumns.append(colIdx);
+    }
+    if (targetColumns.isEmpty()) {
+        for (int i = 0; i < allColumns.size(); ++i) {
+            columnNames.append(allColumns[i].getName());
+            targetColumns.append(i);
+        }
+    }
+    reader.setColumns(columnNames);
+    
+    // Columns not in the file take their defaults, computed once per statement
+    QVector<QString> defaultRow(allColumns.size());
+    for (int i = 0; i < allColumns.size(); ++i) {
+        defaultRow[i] = computeDefaultValue(allColumns[i].getDefaultValue());
+    }
+    bool identity = targetColumns.size() == allColumns.size();
+    for (int i = 0; identity && i < targetColumns.size(); ++i) {
+        identity = targetColumns[i] == i;
+    }
+    
+    if (!tableManager->beginBulkLoad(copyStmt->tableName)) {
+        result->errorMessage = QString("A bulk load into '%1' is already running").arg(copyStmt->tableName);
+        return result;
+    }
+    
+    // Stream the file through fixed-size batches; any failure discards the whole load
+    constexpr int COPY_BATCH_ROWS = 10000;
+    QVector<QVector<QString>> batch;
+    batch.reserve(COPY_BATCH_ROWS);
+    qint64 loaded = 0;
+    
+    auto flushBatch = [&]() {
+        auto opResult = tableManager->insertRows(copyStmt->tableName, batch);
+        if (!opResult.success) {
+            result->errorMessage = QString("COPY failed before line %1: %2")
+                .arg(reader.getLineNumber()).arg(opResult.errorMessage);
+            return false;
+        }
+        loaded += opResult.rowsAffected;
+        batch.clear();
+        return true;
+    };
+    
+    QStringList fields;
+    bool ok = true;
+    while (ok && reader.readRow(fields)) {
+        if (fields.size() != targetColumns.size()) {
+            result->errorMessage = QString("Line %1 has %2 field(s), expected %3")
+                .arg(reader.getLineNumber()).arg(fields.size()).arg(targetColumns.size());
+            ok = false;
+            break;
+        }
         
-        auto schema = tableManager->getTable(updateStmt->tableName);
-        auto rows = tableManager->selectAll(updateStmt->tableName);
-        
-        int updatedCount = 0;
-        for (int i = 0; i < rows.size(); ++i) {
-            // Check condition
-            if (!evaluateCondition(updateStmt->whereClause, schema, rows[i])) {
-                continue;
-            }
-
-            QVector<QString> newValues = rows[i];
-            
-            // Update specified columns
-            for (int j = 0; j < updateStmt->columns.size() && j < updateStmt->values.size(); ++j) {
-                int colIdx = schema->getColumnIndex(updateStmt->columns[j]);
-                if (colIdx >= 0 && colIdx < newValues.size()) {
-                    newValues[colIdx] = updateStmt->values[j];
-                }
-            }
-            
-            auto opResult = tableManager->updateRow(updateStmt->tableName, i, newValues);
-            if (opResult.success) {
-                updatedCount++;
-            } else {
-                result->errorMessage = opResult.errorMessage;
-                return result;
+        if (identity) {
+            batch.append(fields);
+        } else {
+            QVector<QString> row = defaultRow;
+            for (int i = 0; i < targetColumns.size(); ++i) {
+                row[targetColumns[i]] = fields[i];
             }
+            batch.append(row);
         }
         
-        result->success = true;
-        result->affectedRows = updatedCount;
-        Logger::instance().info(QString("Updated %1 row(s) in '%2'").arg(updatedCount).arg(updateStmt->tableName));
-        
-    } catch (const std::exception& e) {
-        result->success = false;
-        result->errorMessage = QString::fromStdString(e.what());
-        Logger::instance().error(QString("UPDATE exception: %1").arg(result->errorMessage));
+        if (batch.size() >= COPY_BATCH_ROWS) {
+            ok = flushBatch();
+        }
+    }
+    if (ok && reader.hasError()) {
+        result->errorMessage = reader.getError();
+        ok = false;
+    }
+    if (ok && !batch.isEmpty()) {
+        ok = flushBatch();
+    }
+    reader.close();
+    
+    if (!ok) {
+        tableManager->abortBulkLoad(copyStmt->tableName);
+        Logger::instance().error(QString("COPY into '%1' failed: %2").arg(copyStmt->tableName, result->errorMessage));
+        return result;
     }
     
+    // Rebuilds deferred indexes and writes the table; the rows stay loaded even if the write is retried later
+    tableManager->finishBulkLoad(copyStmt->tableName);
+    
+    result->success = true;
+    result->affectedRows = static_cast<int>(loaded);
+    Logger::instance().info(QString("Copied %1 row(s) into '%2' from %3")
+        .arg(loaded).arg(copyStmt->tableName, copyStmt->filePath));
     return result;
 }
 
-std::unique_ptr<QueryResult> QueryExecutor::executeDelete(const ASTNode* statement) {
+std::unique_ptr<QueryResult> QueryExecutor::executeCopyTo(const CopyStatement* copyStmt, const QString& filePath,
+                                                         const CopyOptions& options) {
+    auto result = std::make_unique<QueryResult>();
+    
+    // The table is looked up while the scan holds it, so it cannot be dropped in between
+    auto rows = tableManager->scanRows(copyStmt->tableName, TableManager::LOCK_WAIT_TIMEOUT_MS);
+    if (rows.timedOut()) {
+        result->errorMessage = lockWaitTimeoutError();
+        return result;
+    }
+    auto schema = tableManager->getTable(copyStmt->tableName);
+    if (!schema) {
+        result->errorMessage = QString("Table '%1' does not exist").arg(copyStmt->tableName);
+        return result;
+    }
+    const auto& allColumns = schema->getColumns();
+    
+    QStringList columnNames = copyStmt->columns;
+    QVector<int> sourceColumns;
+    for (const QString& colName : columnNames) {
+        int colIdx = schema->getColumnIndex(colName);
+        if (colIdx < 0) {
+            result->errorMessage = QString("Unknown column '%1' in COPY").arg(colName);
+            return result;
+        }
+        sourceColumns.append(colIdx);
+    }
+    bool allInOrder = sourceColumns.isEmpty();
+    if (allInOrder) {
+        for (const auto& column : allColumns) {
+            columnNames.append(column.getName());
+        }
+    }
+    
+    // Write from a snapshot of the table: the file shows one consistent version
+    // and writers are not held up while it is written
+    rows.takeSnapshot();
+    
+    CopyWriter writer(filePath, options);
+    if (!writer.open(columnNames)) {
+        result->errorMessage = writer.getError();
+        return result;
+    }
+    
+    for (int slot = 0; slot < rows.slotCount(); ++slot) {
+        if (!rows.isLive(slot)) {
+            continue;
+        }
+        QVector<QString> row;
+        if (allInOrder) {
+            row = rows[slot];
+        } else {
+            row.reserve(sourceColumns.size());
+            for (int colIdx : sourceColumns) {
+                row.append(colIdx < rows.columnCount() ? rows.valueAt(slot, colIdx) : QString());
+            }
+        }
+        if (!writer.writeRow(row)) {
+            result->errorMessage = writer.getError();
+            Logger::instance().error(QString("COPY from '%1' failed: %2").arg(copyStmt->tableName, result->errorMessage));
+            return result;
+        }
+    }
+    
+    if (!writer.commit()) {
+        result->errorMessage = writer.getError();
+        Logger::instance().error(QString("COPY from '%1' failed: %2").arg(copyStmt->tableName, result->errorMessage));
+        return result;
+    }
+    
+    result->success = true;
+    result->affectedRows = static_cast<int>(writer.getRowCount());
+    Logger::instance().info(QString("Copied %1 row(s) from '%2' to %3")
+        .arg(writer.getRowCount()).arg(copyStmt->tableName, copyStmt->filePath));
+    return result;
+}
+
+std::unique_ptr<QueryResult> QueryExecutor::executeUpdate(const ASTNode* statement) {
+    auto result = std::make_unique<QueryResult>();
+    
+    auto updateStmt = dynamic_cast<const UpdateStatement*>(statement);
+    if (!updateStmt) {
+        result->errorMessage = "Invalid UPDATE statement";
+        return result;
+    }
+    
+    try {
+        if (!tableManager->tableExists(updateStmt->tableName)) {
+            result->errorMessage = QString("Table '%1' does not exist").arg(updateStmt->tableName);
+            return result;
+        }
+        
+        auto schema = tableManager->getTable(updateStmt->tableName);
+        
+        // Compile the condition once; rows are then tested without re-parsing it
+        QString compileError;
+        auto condition = CompiledExpression::compile(updateStmt->where.get(), *schema, compileError);
+        if (!condition) {
+            result->errorMessage = compileError;
+            return result;
+        }
+        
+        // Resolve the SET targets once
+        QVector<int> targetColumns;
+        for (int j = 0; j < updateStmt->columns.size() && j < updateStmt->values.size(); ++j) {
+            int colIdx = schema->getColumnIndex(updateStmt->columns[j]);
+            if (colIdx < 0) {
+                result->errorMessage = QString("Unknown column '%1' in SET").arg(updateStmt->columns[j]);
+                return result;
+            }
+            targetColumns.append(colIdx);
+        }
+        
+        // Hold the table until the update is applied so the scanned rows cannot change in between
+        auto locks = tableManager->lockTables(QStringList(), QStringList() << updateStmt->tableName);
+        if (!locks.acquired()) {
+            result->errorMessage = notLatchedError(updateStmt->tableName);
+            return result;
+        }
+        
+        // Find the matching rows in place; only those rows are copied
+        QVector<QPair<qint64, QVector<QString>>> updates;
+        {
+            auto rows = tableManager->scanRows(updateStmt->tableName);
+            
+            // Narrowed like a SELECT: through an index, else the vectorized column filters
+            CandidateSlots candidates;
+            candidates.lookupIndex(updateStmt->where.get(), updateStmt->tableName, rows, *tableManager);
+            candidates.filter(updateStmt->where.get(), *schema, rows);
+            
+            for (int c = 0; c < candidates.count(); ++c) {
+                int slot = candidates.slotAt(rows, c);
+                if (slot < 0 || !condition->matches(rows, slot)) {
+                    continue;
+                }
+                
+                QVector<QString> newValues = rows[slot];
+                for (int j = 0; j < targetColumns.size(); ++j) {
+                    if (targetColumns[j] < newValues.size()) {
+                        newValues[targetColumns[j]] = updateStmt->values[j];
+                    }
+                }
+                updates.append(qMakePair(rows.rowIdAt(slot), newValues));
+            }
+        }
+        
+        // Apply as one statement after the scan has released the rows (the statement still holds the table)
+        auto opResult = tableManager->updateRows(updateStmt->tableName, updates, activeTransaction());
+        if (!opResult.success) {
+            result->errorMessage = opResult.errorMessage;
+            return result;
+        }
+        int updatedCount = opResult.rowsAffected;
+        
+        result->success = true;
+        result->affectedRows = updatedCount;
+        Logger::instance().info(QString("Updated %1 row(s) in '%2'").arg(updatedCount).arg(updateStmt->tableName));
+        
+    } catch (const std::exception& e) {
+        result->success = false;
+        result->errorMessage = QString::fromStdString(e.what());
+        Logger::instance().error(QString("UPDATE exception: %1").arg(result->errorMessage));
+    }
+    
+    return result;
+}
+
+std::unique_ptr<QueryResult> QueryExecutor::executeDelete(const ASTNode* statement) {
     auto result = std::make_unique<QueryResult>();
     
     auto deleteStmt = dynamic_cast<const DeleteStatement*>(statement);
@@ -291,25 +1178,48 @@ std::unique_ptr<QueryResult> QueryExecutor::executeDelete(const ASTNode* stateme
         }
         
         auto schema = tableManager->getTable(deleteStmt->tableName);
-        auto rows = tableManager->selectAll(deleteStmt->tableName);
-        int deletedCount = 0;
         
-        // Start from the end to avoid index shifting
-        for (int i = rows.size() - 1; i >= 0; --i) {
-            // Check condition
-            if (!evaluateCondition(deleteStmt->whereClause, schema, rows[i])) {
-                continue; 
-            }
-
-            auto opResult = tableManager->deleteRow(deleteStmt->tableName, i);
-            if (opResult.success) {
-                deletedCount++;
-            } else {
-                result->errorMessage = opResult.errorMessage;
-                return result;
+        // Compile the condition once; rows are then tested without re-parsing it
+        QString compileError;
+        auto condition = CompiledExpression::compile(deleteStmt->where.get(), *schema, compileError);
+        if (!condition) {
+            result->errorMessage = compileError;
+            return result;
+        }
+        
+        // Hold the table until the rows are deleted so the scanned rows cannot change in between
+        auto locks = tableManager->lockTables(QStringList(), QStringList() << deleteStmt->tableName);
+        if (!locks.acquired()) {
+            result->errorMessage = notLatchedError(deleteStmt->tableName);
+            return result;
+        }
+        
+        // Find the matching rows in place without copying the table
+        QVector<qint64> matched;
+        {
+            auto rows = tableManager->scanRows(deleteStmt->tableName);
+            
+            // Narrowed like a SELECT: through an index, else the vectorized column filters
+            CandidateSlots candidates;
+            candidates.lookupIndex(deleteStmt->where.get(), deleteStmt->tableName, rows, *tableManager);
+            candidates.filter(deleteStmt->where.get(), *schema, rows);
+            
+            for (int c = 0; c < candidates.count(); ++c) {
+                int slot = candidates.slotAt(rows, c);
+                if (slot >= 0 && condition->matches(rows, slot)) {
+                    matched.append(rows.rowIdAt(slot));
+                }
             }
         }
         
+        // Delete as one statement after the scan has released the rows (the statement still holds the table)
+        auto opResult = tableManager->deleteRows(deleteStmt->tableName, matched, activeTransaction());
+        if (!opResult.success) {
+            result->errorMessage = opResult.errorMessage;
+            return result;
+        }
+        int deletedCount = opResult.rowsAffected;
+        
         result->success = true;
         result->affectedRows = deletedCount;
         Logger::instance().info(QString("Deleted %1 row(s) from '%2'").arg(deletedCount).arg(deleteStmt->tableName));
@@ -332,6 +1242,22 @@ std::unique_ptr<QueryResult> QueryExecutor::executeSelect(const ASTNode* stateme
         return result;
     }
     
+    if (!selectStmt->joins.isEmpty()) {
+        return executeJoinSelect(selectStmt);
+    }
+    
+    // Aggregates anywhere in the query make it a grouped one
+    bool grouped = !selectStmt->groupBy.isEmpty() || selectStmt->having;
+    for (const auto& item : selectStmt->items) {
+        grouped = grouped || item.aggregate != SelectItem::NONE;
+    }
+    for (const auto& item : selectStmt->orderByItems) {
+        grouped = grouped || item.aggregate != SelectItem::NONE;
+    }
+    if (grouped) {
+        return executeGroupedSelect(selectStmt);
+    }
+    
     try {
         if (!tableManager->tableExists(selectStmt->fromTable)) {
             result->errorMessage = QString("Table '%1' does not exist").arg(selectStmt->fromTable);
@@ -339,25 +1265,148 @@ std::unique_ptr<QueryResult> QueryExecutor::executeSelect(const ASTNode* stateme
         }
         
         auto schema = tableManager->getTable(selectStmt->fromTable);
-        auto rows = tableManager->selectAllAsMap(selectStmt->fromTable);
+        const auto& allColumns = schema->getColumns();
         
-        // Get selected columns
-        QStringList selectedColumns = selectStmt->columns;
-        if (selectedColumns.isEmpty() || (selectedColumns.size() == 1 && selectedColumns[0] == "*")) {
+        // Resolve the projection to column ordinals
+        QStringList selectedColumns;
+        QVector<int> projection;
+        if (selectStmt->columns.isEmpty() || (selectStmt->columns.size() == 1 && selectStmt->columns[0] == "*")) {
             // SELECT *
-            const auto& allColumns = schema->getColumns();
-            for (const auto& col : allColumns) {
-                selectedColumns.append(col.getName());
+            for (int i = 0; i < allColumns.size(); ++i) {
+                selectedColumns.append(allColumns[i].getName());
+                projection.append(i);
+            }
+        } else {
+            for (const auto& colName : selectStmt->columns) {
+                int colIdx = schema->getColumnIndex(colName);
+                if (colIdx < 0) {
+                    result->errorMessage = QString("Unknown column '%1' in SELECT list").arg(colName);
+                    return result;
+                }
+                selectedColumns.append(colName);
+                projection.append(colIdx);
+            }
+        }
+        
+        // Resolve ORDER BY terms
+        QVector<SortKey> sortKeys;
+        for (const auto& item : selectStmt->orderByItems) {
+            int colIdx = schema->getColumnIndex(item.column);
+            if (colIdx < 0) {
+                result->errorMessage = QString("Unknown column '%1' in ORDER BY").arg(item.column);
+                return result;
+            }
+            sortKeys.append({colIdx, item.descending,
+                             DataTypeManager::isNumericType(allColumns[colIdx].getType())});
+        }
+        
+        QString compileError;
+        auto condition = CompiledExpression::compile(selectStmt->where.get(), *schema, compileError);
+        if (!condition) {
+            result->errorMessage = compileError;
+            return result;
+        }
+        
+        // Scan the stored rows in place
+        auto rows = tableManager->scanRows(selectStmt->fromTable, TableManager::LOCK_WAIT_TIMEOUT_MS);
+        if (rows.timedOut()) {
+            result->errorMessage = lockWaitTimeoutError();
+            return result;
+        }
+        
+        // Narrow the candidate rows through an index when one covers the condition. A table
+        // read as last committed is already a snapshot the live indexes do not describe
+        CandidateSlots candidates;
+        candidates.lookupIndex(selectStmt->where.get(), selectStmt->fromTable, rows, *tableManager);
+        // The rest reads a snapshot taken with the index lookup, so writers need not wait
+        rows.takeSnapshot();
+        // Otherwise narrow them with the vectorized column filters
+        candidates.filter(selectStmt->where.get(), *schema, rows);
+        const int candidateCount = candidates.count();
+        const int limit = selectStmt->limit;
+        
+        // Slot of the c-th candidate when it is a live row matching the condition, else -1
+        auto matchingSlot = [&](int c) {
+            int slot = candidates.slotAt(rows, c);
+            return slot >= 0 && condition->matches(rows, slot) ? slot : -1;
+        };
+        
+        // Slots of the result rows, in output order
+        QVector<int> matched;
+        
+        if (limit == 0) {
+            // Nothing to return
+        } else if (sortKeys.isEmpty()) {
+            // No ordering: stop scanning as soon as LIMIT rows have matched
+            for (int c = 0; c < candidateCount; ++c) {
+                int i = matchingSlot(c);
+                if (i < 0) {
+                    continue;
+                }
+                matched.append(i);
+                if (limit > 0 && matched.size() >= limit) {
+                    break;
+                }
+            }
+        } else {
+            // Row order with the slot (row id order) as tie-breaker, so equal keys stay stable
+            auto rowLess = [&](int a, int b) {
+                int cmp = compareSortKeys(rows, a, b, sortKeys);
+                return cmp != 0 ? cmp < 0 : a < b;
+            };
+            
+            if (limit > 0) {
+                // Top-K: keep the best LIMIT rows in a max-heap instead of sorting every match
+                // The heap never holds more rows than there are candidates, whatever LIMIT says
+                std::vector<int> heap;
+                heap.reserve(qMin(limit, candidateCount));
+                for (int c = 0; c < candidateCount; ++c) {
+                    int i = matchingSlot(c);
+                    if (i < 0) {
+                        continue;
+                    }
+                    if (static_cast<int>(heap.size()) < limit) {
+                        heap.push_back(i);
+                        std::push_heap(heap.begin(), heap.end(), rowLess);
+                    } else if (rowLess(i, heap.front())) {
+                        std::pop_heap(heap.begin(), heap.end(), rowLess);
+                        heap.back() = i;
+                        std::push_heap(heap.begin(), heap.end(), rowLess);
+                    }
+                }
+                std::sort_heap(heap.begin(), heap.end(), rowLess);
+                matched = QVector<int>(heap.begin(), heap.end());
+            } else {
+                for (int c = 0; c < candidateCount; ++c) {
+                    int i = matchingSlot(c);
+                    if (i >= 0) {
+                        matched.append(i);
+                    }
+                }
+                std::sort(matched.begin(), matched.end(), rowLess);
             }
         }
         
         result->columns = selectedColumns;
         
-        // Build result rows
-        for (const auto& rowMap : rows) {
+        // Build result rows by ordinal. When every column is selected in table order
+        // the whole row is assembled at once (QStringList and QVector<QString> are the same type)
+        bool identityProjection = projection.size() == allColumns.size();
+        for (int p = 0; identityProjection && p < projection.size(); ++p) {
+            identityProjection = projection[p] == p;
+        }
+        
+        result->rows.reserve(matched.size());
+        for (int i : matched) {
+            if (identityProjection) {
+                result->rows.append(rows[i]);
+                continue;
+            }
+            // Only the selected cells are read out of their columns
             QStringList rowData;
-            for (const auto& colName : selectedColumns) {
-                rowData.append(rowMap.value(colName, ""));
+            rowData.reserve(projection.size());
+            for (int colIdx : projection) {
+                rowData.append(colIdx < rows.columnCount() ? rows.valueAt(i, colIdx) : QString());
             }
             result->rows.append(rowData);
         }
@@ -374,3 +1423,548 @@ std::unique_ptr<QueryResult> QueryExecutor::executeSelect(const ASTNode* stateme
     
     return result;
 }
+
+std::unique_ptr<QueryResult> QueryExecutor::executeGroupedSelect(const SelectStatement* selectStmt) {
+    auto result = std::make_unique<QueryResult>();
+    
+    try {
+        if (!tableManager->tableExists(selectStmt->fromTable)) {
+            result->errorMessage = QString("Table '%1' does not exist").arg(selectStmt->fromTable);
+            return result;
+        }
+        if (selectStmt->items.isEmpty()) {
+            result->errorMessage = "SELECT * cannot be combined with GROUP BY or aggregate functions";
+            return result;
+        }
+        
+        auto schema = tableManager->getTable(selectStmt->fromTable);
+        
+        // Grouped rows hold the GROUP BY columns, then one column per distinct aggregate
+        QVector<int> groupColumns;
+        for (const auto& colName : selectStmt->groupBy) {
+            int colIdx = schema->getColumnIndex(colName);
+            if (colIdx < 0) {
+                result->errorMessage = QString("Unknown column '%1' in GROUP BY").arg(colName);
+                return result;
+            }
+            if (!groupColumns.contains(colIdx)) {
+                groupColumns.append(colIdx);
+            }
+        }
+        
+        QVector<HashAggregator::Aggregate> aggregates;
+        QStringList aggregateLabels;
+        QString error;
+        
+        // Select list, as positions in the grouped row
+        // Each output column's header is taken from the item that produces it, so the two line up
+        QVector<int> projection;
+        QStringList headers;
+        for (const auto& item : selectStmt->items) {
+            int position = -1;
+            if (item.aggregate != SelectItem::NONE) {
+                int index = addAggregate(item.aggregate, item.column, *schema, aggregates, aggregateLabels, error);
+                if (index < 0) {
+                    result->errorMessage = error;
+                    return result;
+                }
+                position = groupColumns.size() + index;
+            } else {
+                position = groupColumns.indexOf(schema->getColumnIndex(item.column));
+                if (position < 0) {
+                    result->errorMessage = QString("Column '%1' must appear in GROUP BY or be used in an aggregate")
+                        .arg(item.column);
+                    return result;
+                }
+            }
+            projection.append(position);
+            headers.append(item.label());
+        }
+        
+        // ORDER BY terms, as positions in the grouped row
+        QVector<int> sortPositions;
+        for (const auto& item : selectStmt->orderByItems) {
+            int position = -1;
+            if (item.aggregate != SelectItem::NONE) {
+                int index = addAggregate(item.aggregate, item.column, *schema, aggregates, aggregateLabels, error);
+                if (index < 0) {
+                    result->errorMessage = error;
+                    return result;
+                }
+                position = groupColumns.size() + index;
+            } else {
+                position = groupColumns.indexOf(schema->getColumnIndex(item.column));
+            }
+            if (position < 0) {
+                result->errorMessage = QString("Column '%1' in ORDER BY must appear in GROUP BY or be used in an aggregate")
+                    .arg(item.column);
+                return result;
+            }
+            sortPositions.append(position);
+        }
+        
+        std::shared_ptr<Expression> having;
+        if (selectStmt->having) {
+            having = bindHavingCondition(selectStmt->having.get(), *schema, groupColumns, aggregates, aggregateLabels, error);
+            if (!having) {
+                result->errorMessage = error;
+                return result;
+            }
+        }
+        
+        // HAVING and ORDER BY see the grouped rows as a table of their own
+        TableSchema groupedSchema(schema->getTableName());
+        for (int colIdx : groupColumns) {
+            groupedSchema.addColumn(*schema->getColumn(colIdx));
+        }
+        for (int i = 0; i < aggregates.size(); ++i) {
+            DataType input = aggregates[i].column >= 0 ? schema->getColumn(aggregates[i].column)->getType() : DataType::BIGINT;
+            groupedSchema.addColumn(Column(aggregateLabels[i], HashAggregator::resultType(aggregates[i].function, input)));
+        }
+        
+        auto condition = CompiledExpression::compile(selectStmt->where.get(), *schema, error);
+        if (!condition) {
+            result->errorMessage = error;
+            return result;
+        }
+        auto havingCondition = CompiledExpression::compile(having.get(), groupedSchema, error);
+        if (!havingCondition) {
+            result->errorMessage = error;
+            return result;
+        }
+        
+        QVector<QStringList> groups;
+        {
+            // Scan the stored rows in place; MIN/MAX results are read before the scan ends
+            auto rows = tableManager->scanRows(selectStmt->fromTable, TableManager::LOCK_WAIT_TIMEOUT_MS);
+            if (rows.timedOut()) {
+                result->errorMessage = lockWaitTimeoutError();
+                return result;
+            }
+            
+            CandidateSlots candidates;
+            candidates.lookupIndex(selectStmt->where.get(), selectStmt->fromTable, rows, *tableManager);
+            // Aggregate over a snapshot taken with the index lookup, so writers need not wait
+            rows.takeSnapshot();
+            candidates.filter(selectStmt->where.get(), *schema, rows);
+            
+            HashAggregator aggregator(rows, *schema, groupColumns, aggregates);
+            aggregator.reserve(aggregator.estimateGroups(candidates.count()));
+            
+            for (int c = 0; c < candidates.count(); ++c) {
+                int slot = candidates.slotAt(rows, c);
+                if (slot < 0) {
+                    continue;
+                }
+                if (!condition->isTrivial() && !condition->matches(rows, slot)) {
+                    continue;
+                }
+                aggregator.add(slot);
+            }
+            groups = aggregator.results();
+        }
+        
+        if (!havingCondition->isTrivial()) {
+            QVector<QStringList> kept;
+            for (const auto& group : groups) {
+                if (havingCondition->matches(group)) {
+                    kept.append(group);
+                }
+            }
+            groups = kept;
+        }
+        
+        if (!sortPositions.isEmpty()) {
+            const auto& groupedColumns = groupedSchema.getColumns();
+            std::stable_sort(groups.begin(), groups.end(), [&](const QStringList& a, const QStringList& b) {
+                for (int k = 0; k < sortPositions.size(); ++k) {
+                    int position = sortPositions[k];
+                    bool numeric = DataTypeManager::isNumericType(groupedColumns[position].getType());
+                    int cmp = compareSortValues(a[position], b[position], numeric);
+                    if (cmp != 0) {
+                        return selectStmt->orderByItems[k].descending ? cmp > 0 : cmp < 0;
+                    }
+                }
+                return false;
+            });
+        }
+        
+        const int limit = selectStmt->limit;
+        result->columns = headers;
+        for (const auto& group : groups) {
+            if (limit >= 0 && result->rows.size() >= limit) {
+                break;
+            }
+            QStringList rowData;
+            rowData.reserve(projection.size());
+            for (int position : projection) {
+                rowData.append(group[position]);
+            }
+            result->rows.append(rowData);
+        }
+        
+        result->success = true;
+        result->affectedRows = result->rows.size();
+        Logger::instance().info(QString("SELECT returned %1 row(s) from %2 group(s)").arg(result->rows.size()).arg(groups.size()));
+        
+    } catch (const std::exception& e) {
+        result->success = false;
+        result->errorMessage = QString::fromStdString(e.what());
+        Logger::instance().error(QString("SELECT exception: %1").arg(result->errorMessage));
+    }
+    
+    return result;
+}
+
+std::unique_ptr<QueryResult> QueryExecutor::executeJoinSelect(const SelectStatement* selectStmt) {
+    auto result = std::make_unique<QueryResult>();
+    
+    try {
+        bool grouped = !selectStmt->groupBy.isEmpty() || selectStmt->having;
+        for (const auto& item : selectStmt->items) {
+            grouped = grouped || item.aggregate != SelectItem::NONE;
+        }
+        for (const auto& item : selectStmt->orderByItems) {
+            grouped = grouped || item.aggregate != SelectItem::NONE;
+        }
+        if (grouped) {
+            result->errorMessage = "GROUP BY, HAVING and aggregate functions cannot be combined with JOIN";
+            return result;
+        }
+        
+        // Tables in join order; a joined row holds their columns side by side
+        QVector<JoinTable> tables;
+        int width = 0;
+        for (int t = 0; t <= selectStmt->joins.size(); ++t) {
+            const QString name = t == 0 ? selectStmt->fromTable : selectStmt->joins[t - 1].table;
+            const QString alias = t == 0 ? selectStmt->fromAlias : selectStmt->joins[t - 1].alias;
+            if (!tableManager->tableExists(name)) {
+                result->errorMessage = QString("Table '%1' does not exist").arg(name);
+                return result;
+            }
+            JoinTable table{name, alias.isEmpty() ? name : alias, tableManager->getTable(name), width};
+            for (const auto& other : tables) {
+                if (other.alias.compare(table.alias, Qt::CaseInsensitive) == 0) {
+                    result->errorMessage = QString("Table '%1' appears more than once in FROM; give it an alias")
+                        .arg(table.alias);
+                    return result;
+                }
+            }
+            width += table.schema->getColumns().size();
+            tables.append(table);
+        }
+        if (tables.size() > 64) {
+            result->errorMessage = "Too many tables in JOIN";
+            return result;
+        }
+        
+        // Combined row layout: column position -> table and ordinal, named "alias.column"
+        TableSchema joinedSchema(selectStmt->fromTable);
+        QVector<int> columnTables;
+        QVector<int> columnOrdinals;
+        for (int t = 0; t < tables.size(); ++t) {
+            const auto& columns = tables[t].schema->getColumns();
+            for (int c = 0; c < columns.size(); ++c) {
+                joinedSchema.addColumn(Column(tables[t].alias + "." + columns[c].getName(), columns[c].getType()));
+                columnTables.append(t);
+                columnOrdinals.append(c);
+            }
+        }
+        
+        QString error;
+        auto position = [&](const QString& reference) {
+            QString qualifier;
+            QString name;
+            splitColumnReference(reference, qualifier, name);
+            int column = -1;
+            int table = resolveJoinColumn(qualifier, name, tables, tables.size(), column, error);
+            return table < 0 ? -1 : tables[table].offset + column;
+        };
+        
+        // Select list, as positions in the combined row
+        QStringList selectedColumns;
+        QVector<int> projection;
+        if (selectStmt->items.isEmpty()) {
+            // SELECT *: every column, by its qualified name
+            for (int p = 0; p < width; ++p) {
+                selectedColumns.append(joinedSchema.getColumn(p)->getName());
+                projection.append(p);
+            }
+        } else {
+            for (const auto& item : selectStmt->items) {
+                int p = position(item.column);
+                if (p < 0) {
+                    result->errorMessage = QString("%1 in SELECT list").arg(error);
+                    return result;
+                }
+                selectedColumns.append(item.label());
+                projection.append(p);
+            }
+        }
+        
+        QVector<SortKey> sortKeys;
+        for (const auto& item : selectStmt->orderByItems) {
+            int p = position(item.column);
+            if (p < 0) {
+                result->errorMessage = QString("%1 in ORDER BY").arg(error);
+                return result;
+            }
+            sortKeys.append({p, item.descending, DataTypeManager::isNumericType(joinedSchema.getColumn(p)->getType())});
+        }
+        
+        // WHERE terms that read only the first table filter its scan, and those that read only
+        // the table of an INNER JOIN filter it before it is joined; the rest test the joined rows
+        QVector<QVector<std::shared_ptr<Expression>>> localTerms(tables.size());
+        QVector<std::shared_ptr<Expression>> whereTerms;
+        QVector<std::shared_ptr<Expression>> remainingTerms;
+        splitConjuncts(selectStmt->where, whereTerms);
+        for (const auto& term : whereTerms) {
+            quint64 mask = 0;
+            if (!joinTablesRead(term.get(), tables, tables.size(), mask, error)) {
+                result->errorMessage = QString("%1 in WHERE clause").arg(error);
+                return result;
+            }
+            int single = -1;
+            for (int t = 0; t < tables.size(); ++t) {
+                if (mask == quint64(1) << t) {
+                    single = t;
+                }
+            }
+            if (single == 0 || (single > 0 && selectStmt->joins[single - 1].type == JoinClause::INNER)) {
+                localTerms[single].append(term);
+            } else {
+                remainingTerms.append(term);
+            }
+        }
+        
+        // Split each ON condition into terms on the joined table alone, equality keys
+        // and the rest, which may only read the tables joined so far
+        std::vector<std::unique_ptr<CompiledExpression>> compiled;
+        auto compile = [&](const std::shared_ptr<Expression>& expression, const TableSchema& schema) {
+            auto condition = CompiledExpression::compile(expression.get(), schema, error);
+            const CompiledExpression* pointer = condition.get();
+            if (condition) {
+                compiled.push_back(std::move(condition));
+            }
+            return pointer;
+        };
+        // Terms over several tables test combined rows, where columns go by their qualified names
+        auto compileJoined = [&](const QVector<std::shared_ptr<Expression>>& terms) -> const CompiledExpression* {
+            std::shared_ptr<Expression> bound;
+            if (auto condition = conjunction(terms)) {
+                bound = bindJoinCondition(condition.get(), tables, error);
+                if (!bound) {
+                    return nullptr;
+                }
+            }
+            return compile(bound, joinedSchema);
+        };
+        
+        QVector<TableJoin::Step> steps;
+        for (int t = 1; t < tables.size(); ++t) {
+            const JoinClause& join = selectStmt->joins[t - 1];
+            TableJoin::Step step;
+            step.width = tables[t].schema->getColumns().size();
+            step.left = join.type == JoinClause::LEFT;
+            
+            QVector<std::shared_ptr<Expression>> onTerms;
+            QVector<std::shared_ptr<Expression>> keyTerms;
+            QVector<std::shared_ptr<Expression>> residualTerms;
+            QVector<std::shared_ptr<Expression>> innerTerms = localTerms[t];
+            splitConjuncts(join.on, onTerms);
+            for (const auto& term : onTerms) {
+                quint64 mask = 0;
+                if (!joinTablesRead(term.get(), tables, t + 1, mask, error)) {
+                    result->errorMessage = QString("%1 in ON clause of JOIN %2").arg(error, join.table);
+                    return result;
+                }
+                TableJoin::KeyPair key;
+                if (mask == quint64(1) << t) {
+                    innerTerms.append(term);
+                } else if (joinKeyOf(term.get(), tables, t, key)) {
+                    step.keys.append(key);
+                    keyTerms.append(term);
+                } else {
+                    residualTerms.append(term);
+                }
+            }
+            
+            // An index on the key columns, or failing that on one of them, allows index lookups
+            QStringList keyColumns;
+            for (const auto& key : step.keys) {
+                keyColumns.append(tables[t].schema->getColumn(key.innerColumn)->getName());
+            }
+            if (!keyColumns.isEmpty()) {
+                step.index = tableManager->findIndex(tables[t].name, keyColumns);
+                if (step.index) {
+                    for (int k = 0; k < keyColumns.size(); ++k) {
+                        step.indexKeys.append(k);
+                    }
+                }
+                for (int k = 0; k < keyColumns.size() && !step.index; ++k) {
+                    step.index = tableManager->findIndex(tables[t].name, QStringList() << keyColumns[k]);
+                    if (step.index) {
+                        step.indexKeys.append(k);
+                    }
+                }
+            }
+            
+            // Terms on the table alone are compiled against its own schema and tested on its rows
+            step.innerFilter = compile(conjunction(innerTerms), *tables[t].schema);
+            step.keyCheck = step.innerFilter ? compileJoined(keyTerms) : nullptr;
+            step.residual = step.keyCheck ? compileJoined(residualTerms) : nullptr;
+            if (!step.residual) {
+                result->errorMessage = error;
+                return result;
+            }
+            steps.append(step);
+        }
+        
+        auto firstCondition = conjunction(localTerms[0]);
+        const CompiledExpression* firstFilter = compile(firstCondition, *tables[0].schema);
+        const CompiledExpression* remainingFilter = compileJoined(remainingTerms);
+        if (!firstFilter || !remainingFilter) {
+            result->errorMessage = error;
+            return result;
+        }
+        
+        // Scan every table in place, latched together in the manager's deadlock-free order
+        QStringList tableNames;
+        for (const JoinTable& table : tables) {
+            tableNames.append(table.name);
+        }
+        auto scans = tableManager->scanTables(tableNames, TableManager::LOCK_WAIT_TIMEOUT_MS);
+        if (scans.empty()) {
+            result->errorMessage = lockWaitTimeoutError();
+            return result;
+        }
+        TableScan& firstRows = *scans[0];
+        for (int t = 1; t < tables.size(); ++t) {
+            steps[t - 1].rows = scans[t].get();
+            // A table read as last committed is not what its live indexes describe
+            if (scans[t]->isSnapshot()) {
+                steps[t - 1].index = nullptr;
+                steps[t - 1].indexKeys.clear();
+            }
+        }
+        
+        // Rows of the first table, narrowed through an index or the column filters when its terms allow
+        CandidateSlots candidates;
+        candidates.lookupIndex(firstCondition.get(), tables[0].name, firstRows, *tableManager);
+        
+        // Without index probes left to do, the join reads snapshots of all its tables, taken
+        // together under the latches, and lets writers in. Index probes need the live tables
+        bool probesIndexes = false;
+        for (const TableJoin::Step& step : steps) {
+            probesIndexes = probesIndexes || step.index;
+        }
+        if (!probesIndexes) {
+            for (auto& rows : scans) {
+                rows->takeSnapshot();
+            }
+        }
+        
+        candidates.filter(firstCondition.get(), *tables[0].schema, firstRows);
+        
+        QVector<int> firstSlots;
+        for (int c = 0; c < candidates.count(); ++c) {
+            int slot = candidates.slotAt(firstRows, c);
+            if (slot < 0) {
+                continue;
+            }
+            if (!firstFilter->isTrivial() && !firstFilter->matches(firstRows, slot)) {
+                continue;
+            }
+            firstSlots.append(slot);
+        }
+        
+        TableJoin joined(firstRows, tables[0].schema->getColumns().size(), firstSlots);
+        for (int t = 1; t < tables.size(); ++t) {
+            TableJoin::Method method = joined.join(steps[t - 1]);
+            Logger::instance().debug(QString("JOIN %1: %2, %3 row(s)")
+                .arg(tables[t].alias, TableJoin::methodName(method)).arg(joined.size()));
+        }
+        
+        auto cell = [&](int tuple, int p) {
+            return joined.valueAt(tuple, columnTables[p], columnOrdinals[p]);
+        };
+        auto matches = [&](int tuple) {
+            return remainingFilter->isTrivial() || remainingFilter->matches(joined.row(tuple));
+        };
+        
+        const int limit = selectStmt->limit;
+        QVector<int> matched;
+        if (limit == 0) {
+            // Nothing to return
+        } else if (sortKeys.isEmpty()) {
+            for (int tuple = 0; tuple < joined.size(); ++tuple) {
+                if (!matches(tuple)) {
+                    continue;
+                }
+                matched.append(tuple);
+                if (limit > 0 && matched.size() >= limit) {
+                    break;
+                }
+            }
+        } else {
+            // Sort values are read once per row rather than once per comparison
+            QVector<QStringList> sortValues;
+            for (int tuple = 0; tuple < joined.size(); ++tuple) {
+                if (!matches(tuple)) {
+                    continue;
+                }
+                QStringList values;
+                for (const auto& key : sortKeys) {
+                    values.append(cell(tuple, key.column));
+                }
+                matched.append(tuple);
+                sortValues.append(values);
+            }
+            QVector<int> order(matched.size());
+            for (int i = 0; i < order.size(); ++i) {
+                order[i] = i;
+            }
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                for (int k = 0; k < sortKeys.size(); ++k) {
+                    int cmp = compareSortValues(sortValues[a][k], sortValues[b][k], sortKeys[k].numeric);
+                    if (cmp != 0) {
+                        return sortKeys[k].descending ? cmp > 0 : cmp < 0;
+                    }
+                }
+                return false;
+            });
+            if (limit > 0 && order.size() > limit) {
+                order.resize(limit);
+            }
+            QVector<int> sorted;
+            sorted.reserve(order.size());
+            for (int i : order) {
+                sorted.append(matched[i]);
+            }
+            matched = sorted;
+        }
+        
+        result->columns = selectedColumns;
+        result->rows.reserve(matched.size());
+        for (int tuple : matched) {
+            QStringList rowData;
+            rowData.reserve(projection.size());
+            for (int p : projection) {
+                rowData.append(cell(tuple, p));
+            }
+            result->rows.append(rowData);
+        }
+        
+        result->success = true;
+        result->affectedRows = result->rows.size();
+        Logger::instance().info(QString("SELECT returned %1 row(s) from %2 joined table(s)")
+            .arg(result->rows.size()).arg(tables.size()));
+        
+    } catch (const std::exception& e) {
+        result->success = false;
+        result->errorMessage = QString::fromStdString(e.what());
+        Logger::instance().error(QString("SELECT exception: %1").arg(result->errorMessage));
+    }
+    
+    return result;
+}
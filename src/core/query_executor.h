@@ -6,30 +6,71 @@
 #include "query_result.h"
 
 class ASTNode;
+class CopyStatement;
+class SelectStatement;
 class TableManager;
+class TransactionManager;
+struct CopyOptions;
 
 /**
  * @brief Executes SQL queries against the database
  * 
- * Handles INSERT, UPDATE, DELETE, SELECT, and CREATE TABLE statements
+ * Handles INSERT, UPDATE, DELETE, SELECT (including GROUP BY, aggregates
+ * and INNER/LEFT JOIN), CREATE TABLE and CREATE INDEX statements
  * by delegating to TableManager for data operations.
+ *
+ * BEGIN, COMMIT and ROLLBACK group the statements in between into one
+ * transaction (see TransactionManager). The transaction belongs to the
+ * executor, so an executor serves one session and runs its statements
+ * one at a time; they may run on different threads. CREATE TABLE, CREATE
+ * INDEX and COPY FROM are not allowed inside a transaction.
  */
 class QueryExecutor {
 public:
     QueryExecutor();
-    virtual ~QueryExecutor() = default;
+    // Runs against an existing table manager instead of opening one of its own
+    explicit QueryExecutor(std::shared_ptr<TableManager> manager);
+    virtual ~QueryExecutor();     // Rolls back an open transaction
     
     std::unique_ptr<QueryResult> execute(const std::unique_ptr<ASTNode>& statement);
     
     void setTableManager(std::shared_ptr<TableManager> manager);
     
+    // Confines the files COPY reads and writes to a directory; relative paths are
+    // resolved against it. An empty directory turns COPY off. Without a call paths
+    // are used as given. COPY never touches files in the data directory either way.
+    void setCopyDirectory(const QString& directory);
+    
+    bool isInTransaction() const;
+    
 private:
     std::shared_ptr<TableManager> tableManager;
+    std::unique_ptr<TransactionManager> transaction;
+    bool copyRestricted = false;
+    QString copyDirectory;
+    
+    // The transaction mutations belong to, nullptr outside one
+    TransactionManager* activeTransaction() const;
+    // Runs a statement other than BEGIN/COMMIT/ROLLBACK
+    std::unique_ptr<QueryResult> dispatch(const ASTNode* statement);
+    // Tables a statement reads and writes; false when it may not run inside the open transaction
+    bool statementTables(const ASTNode* statement, QStringList& readTables, QStringList& writeTables,
+                         QString& errorMessage) const;
+    
+    // Where a COPY file path points; false when the session may not use it
+    bool resolveCopyPath(const QString& path, QString& resolvedPath, QString& errorMessage) const;
     
     // Statement execution methods
+    std::unique_ptr<QueryResult> executeTransactionControl(const ASTNode* statement);
     std::unique_ptr<QueryResult> executeCreate(const ASTNode* statement);
+    std::unique_ptr<QueryResult> executeCreateIndex(const ASTNode* statement);
     std::unique_ptr<QueryResult> executeInsert(const ASTNode* statement);
+    std::unique_ptr<QueryResult> executeCopy(const ASTNode* statement);
+    std::unique_ptr<QueryResult> executeCopyTo(const CopyStatement* copyStmt, const QString& filePath,
+                                               const CopyOptions& options);
     std::unique_ptr<QueryResult> executeUpdate(const ASTNode* statement);
     std::unique_ptr<QueryResult> executeDelete(const ASTNode* statement);
     std::unique_ptr<QueryResult> executeSelect(const ASTNode* statement);
+    std::unique_ptr<QueryResult> executeGroupedSelect(const SelectStatement* selectStmt);
+    std::unique_ptr<QueryResult> executeJoinSelect(const SelectStatement* selectStmt);
 };
@@ -0,0 +1,221 @@
+#include "row_store.h"
+#include <algorithm>
+
+namespace {
+// Vacuum is not worth a pass over the table below this many tombstones
+constexpr int MIN_VACUUM_TOMBSTONES = 1024;
+}
+
+RowStore::RowStore(const QVector<DataType>& columnTypes)
+    : typed(!columnTypes.isEmpty()) {
+    columns.reserve(columnTypes.size());
+    for (DataType type : columnTypes) {
+        columns.append(ColumnVector(type));
+    }
+}
+
+qint64 RowStore::insert(const QVector<QString>& row) {
+    qint64 rowId = nextId++;
+    appendRow(row);
+    ids.append(rowId);
+    live.append(true);
+    liveCount++;
+    return rowId;
+}
+
+void RowStore::insertWithId(qint64 rowId, const QVector<QString>& row) {
+    nextId = qMax(nextId, rowId + 1);
+
+    // Ids normally arrive in ascending order and are appended
+    if (ids.isEmpty() || rowId > ids.last()) {
+        appendRow(row);
+        ids.append(rowId);
+        live.append(true);
+        liveCount++;
+        return;
+    }
+
+    fitColumns(row.size());
+    int slot = lowerBound(rowId);
+    if (ids[slot] == rowId) {
+        for (int c = 0; c < columns.size(); ++c) {
+            columns[c].set(slot, c < row.size() ? row[c] : QString());
+        }
+        if (!live[slot]) {
+            live[slot] = true;
+            liveCount++;
+        }
+        return;
+    }
+
+    for (int c = 0; c < columns.size(); ++c) {
+        columns[c].insert(slot, c < row.size() ? row[c] : QString());
+    }
+    ids.insert(slot, rowId);
+    live.insert(slot, true);
+    liveCount++;
+}
+
+bool RowStore::update(qint64 rowId, const QVector<QString>& row, QVector<QString>* oldRow) {
+    int slot = slotOf(rowId);
+    if (slot < 0) {
+        return false;
+    }
+    if (oldRow) {
+        *oldRow = rowAt(slot);
+    }
+    fitColumns(row.size());
+    for (int c = 0; c < columns.size(); ++c) {
+        columns[c].set(slot, c < row.size() ? row[c] : QString());
+    }
+    return true;
+}
+
+bool RowStore::remove(qint64 rowId, QVector<QString>* oldRow) {
+    int slot = slotOf(rowId);
+    if (slot < 0) {
+        return false;
+    }
+    if (oldRow) {
+        *oldRow = rowAt(slot);
+    }
+    // Release the values now; the slot itself goes at the next vacuum
+    for (ColumnVector& column : columns) {
+        column.set(slot, QString());
+    }
+    live[slot] = false;
+    liveCount--;
+    return true;
+}
+
+std::optional<QVector<QString>> RowStore::find(qint64 rowId) const {
+    int slot = slotOf(rowId);
+    if (slot < 0) {
+        return std::nullopt;
+    }
+    return rowAt(slot);
+}
+
+QVector<QString> RowStore::rowAt(int slot) const {
+    QVector<QString> row;
+    if (!live[slot]) {
+        return row;
+    }
+    row.reserve(columns.size());
+    for (const ColumnVector& column : columns) {
+        row.append(column.value(slot));
+    }
+    return row;
+}
+
+int RowStore::slotOf(qint64 rowId) const {
+    int slot = lowerBound(rowId);
+    if (slot < ids.size() && ids[slot] == rowId && live[slot]) {
+        return slot;
+    }
+    return -1;
+}
+
+bool RowStore::needsVacuum() const {
+    int tombstones = tombstoneCount();
+    return tombstones >= MIN_VACUUM_TOMBSTONES && tombstones >= liveCount;
+}
+
+int RowStore::vacuum() {
+    int removed = tombstoneCount();
+    if (removed == 0) {
+        return 0;
+    }
+
+    for (ColumnVector& column : columns) {
+        column.compact(live);
+    }
+    int kept = 0;
+    for (int slot = 0; slot < ids.size(); ++slot) {
+        if (live[slot]) {
+            ids[kept++] = ids[slot];
+        }
+    }
+    ids.resize(kept);
+    live.fill(true, kept);
+    ids.squeeze();
+    live.squeeze();
+    return removed;
+}
+
+int RowStore::truncateFrom(qint64 rowId) {
+    int firstSlot = lowerBound(rowId);
+    int removed = 0;
+    for (int slot = firstSlot; slot < ids.size(); ++slot) {
+        if (live[slot]) {
+            removed++;
+        }
+    }
+    for (ColumnVector& column : columns) {
+        column.truncate(firstSlot);
+    }
+    ids.resize(firstSlot);
+    live.resize(firstSlot);
+    liveCount -= removed;
+    return removed;
+}
+
+void RowStore::reserve(int slotCount) {
+    for (ColumnVector& column : columns) {
+        column.reserve(slotCount);
+    }
+    ids.reserve(slotCount);
+    live.reserve(slotCount);
+}
+
+QVector<QVector<QString>> RowStore::liveRows() const {
+    QVector<QVector<QString>> result;
+    result.reserve(liveCount);
+    for (auto it = begin(); it != end(); ++it) {
+        result.append(*it);
+    }
+    return result;
+}
+
+QVector<qint64> RowStore::liveRowIds() const {
+    QVector<qint64> result;
+    result.reserve(liveCount);
+    for (auto it = begin(); it != end(); ++it) {
+        result.append(it.rowId());
+    }
+    return result;
+}
+
+void RowStore::clear() {
+    for (ColumnVector& column : columns) {
+        column.clear();
+    }
+    ids.clear();
+    live.clear();
+    liveCount = 0;
+}
+
+int RowStore::lowerBound(qint64 rowId) const {
+    return static_cast<int>(std::lower_bound(ids.constBegin(), ids.constEnd(), rowId) - ids.constBegin());
+}
+
+void RowStore::fitColumns(int width) {
+    if (typed) {
+        return;
+    }
+    while (columns.size() < width) {
+        ColumnVector column(DataType::TEXT);
+        column.reserve(ids.size());
+        for (int slot = 0; slot < ids.size(); ++slot) {
+            column.append(QString());
+        }
+        columns.append(column);
+    }
+}
+
+void RowStore::appendRow(const QVector<QString>& row) {
+    fitColumns(row.size());
+    for (int c = 0; c < columns.size(); ++c) {
+        columns[c].append(c < row.size() ? row[c] : QString());
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "column_vector.h"
+#include <QString>
+#include <QVector>
+#include <optional>
+
+/**
+ * @brief Rows of one table addressed by stable 64-bit row ids
+ *
+ * Each row keeps the id it was given on insert for its whole life, so
+ * indexes and the write-ahead log can refer to it durably. Rows are held
+ * in slots ordered by id; a delete only marks the slot as a tombstone,
+ * which makes it O(1) after the id lookup and leaves every other slot
+ * where it was. vacuum() drops the tombstones in one pass without
+ * renumbering anything.
+ *
+ * Slots are positions in the current layout and are only meaningful until
+ * the next insert or vacuum; row ids are the durable handle.
+ *
+ * Values are held column by column in each column's native type (see
+ * ColumnVector), so a row is assembled as text only when it is read.
+ * A store built without column types keeps every column as text and
+ * takes its width from the rows it is given.
+ */
+class RowStore {
+public:
+    explicit RowStore(const QVector<DataType>& columnTypes = QVector<DataType>());
+    
+    // Assigns the next row id
+    qint64 insert(const QVector<QString>& row);
+    // Places a row under a known id (loading, WAL replay), replacing any row with that id
+    void insertWithId(qint64 rowId, const QVector<QString>& row);
+    bool update(qint64 rowId, const QVector<QString>& row, QVector<QString>* oldRow = nullptr);
+    // Leaves a tombstone in the row's slot
+    bool remove(qint64 rowId, QVector<QString>* oldRow = nullptr);
+
+    // Live row with the given id, if any
+    std::optional<QVector<QString>> find(qint64 rowId) const;
+    bool contains(qint64 rowId) const { return slotOf(rowId) >= 0; }
+    // Slot of a live row, or -1
+    int slotOf(qint64 rowId) const;
+    // First slot whose id is >= rowId (slotCount() if none); lets a scan resume by id
+    int lowerBound(qint64 rowId) const;
+
+    int size() const { return liveCount; }
+    bool isEmpty() const { return liveCount == 0; }
+    int slotCount() const { return ids.size(); }
+    int tombstoneCount() const { return ids.size() - liveCount; }
+    bool isLive(int slot) const { return live[slot]; }
+    qint64 rowIdAt(int slot) const { return ids[slot]; }
+    // Row in the slot as text (empty for tombstones)
+    QVector<QString> rowAt(int slot) const;
+    QString valueAt(int slot, int column) const { return columns[column].value(slot); }
+    int columnCount() const { return columns.size(); }
+    const ColumnVector& column(int column) const { return columns[column]; }
+
+    qint64 nextRowId() const { return nextId; }
+    void setNextRowId(qint64 rowId) { nextId = qMax(nextId, rowId); }
+
+    // True once tombstones are both numerous and at least as many as live rows
+    bool needsVacuum() const;
+    // Drops tombstoned slots; returns how many were removed
+    int vacuum();
+    // Drops every row with an id >= rowId outright (undoing appends); returns how many live rows went
+    int truncateFrom(qint64 rowId);
+
+    // Makes room for slotCount slots in total before a batch of appends
+    void reserve(int slotCount);
+
+    QVector<QVector<QString>> liveRows() const;
+    QVector<qint64> liveRowIds() const;
+    void clear();
+
+    /**
+     * @brief Forward iterator over live rows, skipping tombstones
+     */
+    class const_iterator {
+    public:
+        QVector<QString> operator*() const { return store->rowAt(slot); }
+        qint64 rowId() const { return store->ids[slot]; }
+
+        const_iterator& operator++() {
+            ++slot;
+            skipTombstones();
+            return *this;
+        }
+        bool operator==(const const_iterator& other) const { return slot == other.slot; }
+        bool operator!=(const const_iterator& other) const { return slot != other.slot; }
+
+    private:
+        friend class RowStore;
+        const_iterator(const RowStore* store, int slot) : store(store), slot(slot) { skipTombstones(); }
+
+        void skipTombstones() {
+            while (slot < store->ids.size() && !store->live[slot]) {
+                ++slot;
+            }
+        }
+
+        const RowStore* store;
+        int slot;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, ids.size()); }
+
+private:
+    QVector<ColumnVector> columns;   // column -> values by slot (NULL for tombstones)
+    bool typed = false;              // Column types came from the schema
+    QVector<qint64> ids;             // slot -> row id, strictly ascending
+    QVector<bool> live;              // slot -> false once deleted
+    int liveCount = 0;
+    qint64 nextId = 0;
+
+    // Untyped stores grow text columns to fit wider rows
+    void fitColumns(int width);
+    void appendRow(const QVector<QString>& row);
+};
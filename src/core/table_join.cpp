@@ -0,0 +1,295 @@
+#include "table_join.h"
+#include "table_manager.h"
+#include "index.h"
+#include "expression_evaluator.h"
+#include <QHash>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool isNullText(const QString& value) {
+    return value.isEmpty() || value.compare("null", Qt::CaseInsensitive) == 0;
+}
+
+// Appends a row's cells, or width NULLs for the NULL side of a LEFT JOIN
+void appendCells(QVector<QString>& row, const TableScan& rows, int slot, int width) {
+    for (int column = 0; column < width; ++column) {
+        row.append(slot >= 0 && column < rows.columnCount() ? rows.valueAt(slot, column) : QString());
+    }
+}
+
+bool passes(const CompiledExpression* condition, const QVector<QString>& row) {
+    return !condition || condition->isTrivial() || condition->matches(row);
+}
+
+}
+
+TableJoin::TableJoin(const TableScan& first, int width, const QVector<int>& firstSlots)
+    : tuples(firstSlots) {
+    inputs.append({&first, width});
+}
+
+TableJoin::Method TableJoin::join(const Step& step) {
+    Method method = Method::NestedLoop;
+    if (step.index && !step.indexKeys.isEmpty() && size() < step.rows->size()) {
+        method = Method::IndexNestedLoop;
+    } else if (!step.keys.isEmpty()) {
+        method = Method::HashJoin;
+    }
+
+    QVector<int> output;
+    output.reserve(size() * (inputs.size() + 1));
+    switch (method) {
+        case Method::IndexNestedLoop:
+            joinIndexed(step, output);
+            break;
+        case Method::HashJoin:
+            joinHashed(step, output);
+            break;
+        case Method::NestedLoop:
+            joinNestedLoop(step, output);
+            break;
+    }
+
+    inputs.append({step.rows, step.width});
+    tuples = std::move(output);
+    return method;
+}
+
+QString TableJoin::methodName(Method method) {
+    switch (method) {
+        case Method::IndexNestedLoop: return "index nested-loop join";
+        case Method::HashJoin: return "hash join";
+        case Method::NestedLoop: return "nested-loop join";
+    }
+    return QString();
+}
+
+QString TableJoin::valueAt(int tuple, int table, int column) const {
+    int slot = slotAt(tuple, table);
+    const TableScan& rows = *inputs[table].rows;
+    return slot >= 0 && column < rows.columnCount() ? rows.valueAt(slot, column) : QString();
+}
+
+QVector<QString> TableJoin::row(int tuple) const {
+    QVector<QString> combined;
+    for (int table = 0; table < inputs.size(); ++table) {
+        appendCells(combined, *inputs[table].rows, slotAt(tuple, table), inputs[table].width);
+    }
+    return combined;
+}
+
+// Probes the index with each outer row's key; the key equalities are checked
+// again because the index compares by its own column types
+void TableJoin::joinIndexed(const Step& step, QVector<int>& output) const {
+    const int tupleCount = size();
+    const bool checked = step.keyCheck || step.residual;
+    QVector<QString> values(step.indexKeys.size());
+
+    for (int tuple = 0; tuple < tupleCount; ++tuple) {
+        bool matched = false;
+        bool complete = true;
+        for (int k = 0; k < step.indexKeys.size() && complete; ++k) {
+            const KeyPair& key = step.keys[step.indexKeys[k]];
+            values[k] = valueAt(tuple, key.outerTable, key.outerColumn);
+            complete = !isNullText(values[k]);
+        }
+
+        if (complete) {
+            // Visit the matches in row id order, which is slot order
+            QVector<qint64> rowIds = step.index->find(step.index->makeKey(values));
+            std::sort(rowIds.begin(), rowIds.end());
+
+            QVector<QString> combined = checked ? row(tuple) : QVector<QString>();
+            const int outerWidth = combined.size();
+            for (qint64 rowId : rowIds) {
+                int slot = step.rows->slotOf(rowId);
+                if (slot < 0 || !passesInnerFilter(step, slot)) {
+                    continue;
+                }
+                if (checked) {
+                    combined.resize(outerWidth);
+                    appendCells(combined, *step.rows, slot, step.width);
+                    if (!passes(step.keyCheck, combined) || !passes(step.residual, combined)) {
+                        continue;
+                    }
+                }
+                appendTuple(output, tuple, slot);
+                matched = true;
+            }
+        }
+
+        if (!matched && step.left) {
+            appendTuple(output, tuple, -1);
+        }
+    }
+}
+
+// Builds a hash table over the inner rows' keys, then probes it once per outer row
+void TableJoin::joinHashed(const Step& step, QVector<int>& output) const {
+    const QVector<int> candidates = innerSlots(step);
+
+    // Build: the first slot of each key, chained to the next slot with the same key.
+    // Going backwards leaves every chain in slot order
+    QHash<QString, int> heads;
+    heads.reserve(candidates.size());
+    QVector<int> next(step.rows->slotCount(), -1);
+    QString key;
+    for (int i = candidates.size() - 1; i >= 0; --i) {
+        const int slot = candidates[i];
+        key.clear();
+        bool complete = true;
+        for (int k = 0; k < step.keys.size() && complete; ++k) {
+            complete = appendKeyPart(*step.rows, slot, step.keys[k].innerColumn, step.keys[k].numeric, key);
+        }
+        if (!complete) {
+            continue;
+        }
+        auto it = heads.find(key);
+        if (it != heads.end()) {
+            next[slot] = it.value();
+            it.value() = slot;
+        } else {
+            heads.insert(key, slot);
+        }
+    }
+
+    // Probe
+    const int tupleCount = size();
+    const bool checked = step.residual && !step.residual->isTrivial();
+    for (int tuple = 0; tuple < tupleCount; ++tuple) {
+        bool matched = false;
+        key.clear();
+        auto it = outerKey(step, tuple, key) ? heads.constFind(key) : heads.constEnd();
+        if (it != heads.constEnd()) {
+            QVector<QString> combined = checked ? row(tuple) : QVector<QString>();
+            const int outerWidth = combined.size();
+            for (int slot = it.value(); slot >= 0; slot = next[slot]) {
+                if (checked) {
+                    combined.resize(outerWidth);
+                    appendCells(combined, *step.rows, slot, step.width);
+                    if (!step.residual->matches(combined)) {
+                        continue;
+                    }
+                }
+                appendTuple(output, tuple, slot);
+                matched = true;
+            }
+        }
+
+        if (!matched && step.left) {
+            appendTuple(output, tuple, -1);
+        }
+    }
+}
+
+void TableJoin::joinNestedLoop(const Step& step, QVector<int>& output) const {
+    const QVector<int> candidates = innerSlots(step);
+    const int tupleCount = size();
+    const bool checked = step.residual && !step.residual->isTrivial();
+
+    for (int tuple = 0; tuple < tupleCount; ++tuple) {
+        bool matched = false;
+        QVector<QString> combined = checked ? row(tuple) : QVector<QString>();
+        const int outerWidth = combined.size();
+        for (int slot : candidates) {
+            if (checked) {
+                combined.resize(outerWidth);
+                appendCells(combined, *step.rows, slot, step.width);
+                if (!step.residual->matches(combined)) {
+                    continue;
+                }
+            }
+            appendTuple(output, tuple, slot);
+            matched = true;
+        }
+
+        if (!matched && step.left) {
+            appendTuple(output, tuple, -1);
+        }
+    }
+}
+
+QVector<int> TableJoin::innerSlots(const Step& step) const {
+    QVector<int> matching;
+    matching.reserve(step.rows->size());
+    for (int slot = 0; slot < step.rows->slotCount(); ++slot) {
+        if (step.rows->isLive(slot) && passesInnerFilter(step, slot)) {
+            matching.append(slot);
+        }
+    }
+    return matching;
+}
+
+bool TableJoin::passesInnerFilter(const Step& step, int slot) const {
+    return !step.innerFilter || step.innerFilter->isTrivial() || step.innerFilter->matches(*step.rows, slot);
+}
+
+void TableJoin::appendTuple(QVector<int>& output, int tuple, int innerSlot) const {
+    const int width = inputs.size();
+    for (int table = 0; table < width; ++table) {
+        output.append(tuples[tuple * width + table]);
+    }
+    output.append(innerSlot);
+}
+
+// Numbers are keyed by the bits of their double value (the = operator compares
+// numbers as doubles); text is keyed by its exact characters behind its length
+bool TableJoin::appendKeyPart(const TableScan& rows, int slot, int column, bool numeric, QString& key) {
+    if (column >= rows.columnCount()) {
+        return false;
+    }
+    const ColumnVector& cells = rows.column(column);
+    if (cells.isNull(slot)) {
+        return false;
+    }
+
+    double number = 0.0;
+    bool isNumber = false;
+    QString text;
+    if (numeric && cells.isNative(slot) && cells.getStorage() == ColumnVector::Storage::Int64) {
+        number = static_cast<double>(cells.int64At(slot));
+        isNumber = true;
+    } else if (numeric && cells.isNative(slot) && cells.getStorage() == ColumnVector::Storage::Double) {
+        number = cells.doubleAt(slot);
+        isNumber = true;
+    } else {
+        text = cells.value(slot);
+        if (isNullText(text)) {
+            return false;
+        }
+        if (numeric) {
+            number = text.toDouble(&isNumber);
+        }
+    }
+
+    if (isNumber) {
+        // 0 and -0 are equal
+        if (number == 0.0) {
+            number = 0.0;
+        }
+        quint64 bits = 0;
+        std::memcpy(&bits, &number, sizeof(bits));
+        key += QChar('n');
+        for (int shift = 0; shift < 64; shift += 16) {
+            key += QChar(static_cast<ushort>(bits >> shift));
+        }
+    } else {
+        key += QChar('t');
+        key += QChar(static_cast<ushort>(text.size() & 0xffff));
+        key += QChar(static_cast<ushort>(text.size() >> 16));
+        key += text;
+    }
+    return true;
+}
+
+bool TableJoin::outerKey(const Step& step, int tuple, QString& key) const {
+    for (const KeyPair& pair : step.keys) {
+        int slot = slotAt(tuple, pair.outerTable);
+        if (slot < 0 || !appendKeyPart(*inputs[pair.outerTable].rows, slot, pair.outerColumn, pair.numeric, key)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <memory>
+
+class CompiledExpression;
+class Index;
+class TableScan;
+
+/**
+ * @brief Joins table scans left to right, one JOIN clause at a time
+ *
+ * The joined rows are held as tuples of slots, one per table joined so far
+ * (-1 for the NULL side of a LEFT JOIN), so no row is assembled as text
+ * until a condition or the result needs it. Each step joins one more table
+ * with one of three operators:
+ *
+ * - Index nested-loop join: when the table has an index on the join key and
+ *   the outer side has fewer rows than the table, each outer row looks its
+ *   matches up in the index.
+ * - Hash join: with equality keys and no usable index, the table's rows are
+ *   hashed on their key columns once (build) and each outer row looks up its
+ *   key (probe).
+ * - Nested loop: without equality keys every pair of rows is tested.
+ *
+ * Hash keys compare numeric columns by value and other columns by exact
+ * text, as the = operator does, so a hash match needs no further check;
+ * index lookups are re-checked with the key equalities.
+ */
+class TableJoin {
+public:
+    enum class Method {
+        IndexNestedLoop,
+        HashJoin,
+        NestedLoop
+    };
+
+    // Equality between a column already joined and a column of the table being joined
+    struct KeyPair {
+        int outerTable;             // Position among the tables joined so far
+        int outerColumn;            // Column ordinal in that table
+        int innerColumn;            // Column ordinal in the table being joined
+        bool numeric;               // Both columns numeric: compared by value, else by text
+    };
+
+    struct Step {
+        const TableScan* rows = nullptr;
+        int width = 0;              // Column count of the table's schema
+        bool left = false;          // LEFT JOIN: keep outer rows that match nothing
+        QVector<KeyPair> keys;
+        // Index on the table whose columns are the inner columns of keys[indexKeys[0]], ...
+        std::shared_ptr<Index> index;
+        QVector<int> indexKeys;
+        // Tested on the table's row alone (terms of ON that only read this table)
+        const CompiledExpression* innerFilter = nullptr;
+        // Tested on the combined row: the key equalities (only after index lookups) and the rest of ON
+        const CompiledExpression* keyCheck = nullptr;
+        const CompiledExpression* residual = nullptr;
+    };
+
+    // Starts from the given slots of the first table
+    TableJoin(const TableScan& first, int width, const QVector<int>& firstSlots);
+
+    // Joins one more table; returns the operator it used
+    Method join(const Step& step);
+
+    static QString methodName(Method method);
+
+    int tableCount() const { return inputs.size(); }
+    int size() const { return tuples.size() / inputs.size(); }
+    // Slot of the tuple's row in a table, -1 when the table's side is NULL
+    int slotAt(int tuple, int table) const { return tuples[tuple * inputs.size() + table]; }
+    QString valueAt(int tuple, int table, int column) const;
+    // The tuple's rows side by side, each padded to its table's width
+    QVector<QString> row(int tuple) const;
+
+private:
+    struct Input {
+        const TableScan* rows;
+        int width;
+    };
+
+    QVector<Input> inputs;
+    QVector<int> tuples;            // tableCount() slots per joined row
+
+    void joinIndexed(const Step& step, QVector<int>& output) const;
+    void joinHashed(const Step& step, QVector<int>& output) const;
+    void joinNestedLoop(const Step& step, QVector<int>& output) const;
+
+    // Inner slots that are live and pass the step's inner filter
+    QVector<int> innerSlots(const Step& step) const;
+    bool passesInnerFilter(const Step& step, int slot) const;
+    // Appends the tuple extended by an inner slot
+    void appendTuple(QVector<int>& output, int tuple, int innerSlot) const;
+    // Appends one cell to an exact hash key; false when the cell is NULL
+    static bool appendKeyPart(const TableScan& rows, int slot, int column, bool numeric, QString& key);
+    // Hash key of the tuple's outer key columns; false when one of them is NULL
+    bool outerKey(const Step& step, int tuple, QString& key) const;
+};
@@ -0,0 +1,142 @@
+#include "table_latch.h"
+#include <QDeadlineTimer>
+
+namespace {
+thread_local TableLatch::Holder actingFor = nullptr;
+}
+
+TableLatch::Holder TableLatch::currentHolder() {
+    return actingFor ? actingFor : QThread::currentThreadId();
+}
+
+TableLatch::HolderScope::HolderScope(Holder holder) : previous(actingFor) {
+    actingFor = holder;
+}
+
+TableLatch::HolderScope::~HolderScope() {
+    actingFor = previous;
+}
+
+bool TableLatch::lockShared(Holder holder, int timeoutMs) {
+    QDeadlineTimer deadline(timeoutMs);
+    QMutexLocker locker(&mutex);
+
+    auto it = readers.find(holder);
+    if (it != readers.end()) {
+        ++it.value();
+        return true;
+    }
+    // The exclusive holder reads without waiting; anyone else also yields to waiting writers
+    while (writer != holder && (writer || waitingWriters > 0)) {
+        if (deadline.hasExpired()) {
+            return false;
+        }
+        released.wait(&mutex, deadline);
+    }
+    readers.insert(holder, 1);
+    return true;
+}
+
+bool TableLatch::lockExclusive(Holder holder, int timeoutMs) {
+    QDeadlineTimer deadline(timeoutMs);
+    QMutexLocker locker(&mutex);
+
+    if (writer == holder) {
+        ++writeHolds;
+        return true;
+    }
+    // A shared hold is not upgraded: waiting for the other readers would include waiting
+    // for the holder itself, which never ends
+    if (readers.contains(holder)) {
+        return false;
+    }
+
+    ++waitingWriters;
+    while (writer || !readers.isEmpty()) {
+        if (deadline.hasExpired()) {
+            // Readers held back behind this writer may go ahead
+            --waitingWriters;
+            released.wakeAll();
+            return false;
+        }
+        released.wait(&mutex, deadline);
+    }
+    --waitingWriters;
+    writer = holder;
+    writeHolds = 1;
+    return true;
+}
+
+bool TableLatch::tryLockExclusive(Holder holder) {
+    QMutexLocker locker(&mutex);
+
+    if (writer == holder) {
+        ++writeHolds;
+        return true;
+    }
+    if (writer || !readers.isEmpty()) {
+        return false;
+    }
+    writer = holder;
+    writeHolds = 1;
+    return true;
+}
+
+void TableLatch::unlockShared(Holder holder) {
+    QMutexLocker locker(&mutex);
+    auto it = readers.find(holder);
+    if (it == readers.end()) {
+        return;
+    }
+    if (--it.value() == 0) {
+        readers.erase(it);
+        if (readers.isEmpty()) {
+            released.wakeAll();
+        }
+    }
+}
+
+void TableLatch::unlockExclusive(Holder holder) {
+    QMutexLocker locker(&mutex);
+    if (writer != holder) {
+        return;
+    }
+    if (--writeHolds == 0) {
+        writer = nullptr;
+        released.wakeAll();
+    }
+}
+
+bool TableLatch::isHeldBy(Holder holder) const {
+    QMutexLocker locker(&mutex);
+    return writer == holder || readers.contains(holder);
+}
+
+LatchHold::LatchHold(TableLatch* latch, Mode mode, int timeoutMs)
+    : latch(latch), mode(mode), holder(TableLatch::currentHolder()) {
+    if (!latch) {
+        return;
+    }
+    bool taken = mode == Exclusive ? latch->lockExclusive(holder, timeoutMs)
+                                   : latch->lockShared(holder, timeoutMs);
+    if (!taken) {
+        this->latch = nullptr;
+        expired = true;
+    }
+}
+
+LatchHold::~LatchHold() {
+    release();
+}
+
+void LatchHold::release() {
+    if (!latch) {
+        return;
+    }
+    if (mode == Exclusive) {
+        latch->unlockExclusive(holder);
+    } else {
+        latch->unlockShared(holder);
+    }
+    latch = nullptr;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QHash>
+#include <QThread>
+
+/**
+ * @brief Re-entrant reader-writer latch guarding one table (or the catalog)
+ *
+ * Any number of holders may hold the latch shared, or one holder may hold
+ * it exclusively. A holder is normally a thread; a thread running a
+ * statement of a transaction holds latches for the transaction instead
+ * (see HolderScope), so the transaction keeps them from one statement to
+ * the next whichever thread runs it. Holds are counted per holder, so a
+ * statement that holds a table can call into TableManager methods that
+ * take the same latch again: a holder holding it exclusively may take it
+ * in either mode, and a holder holding it shared may take it shared
+ * again. A shared hold is never upgraded to an exclusive one: asking for
+ * it fails at once, whatever the timeout, so take the exclusive hold first.
+ *
+ * Writers waiting for the latch hold back holders that do not hold it
+ * yet, so a steady stream of readers cannot starve them.
+ */
+class TableLatch {
+public:
+    using Holder = const void*;
+
+    // The transaction the thread is acting for, else the thread itself
+    static Holder currentHolder();
+
+    /**
+     * @brief Makes the current thread take latches for a holder until destroyed
+     */
+    class HolderScope {
+    public:
+        explicit HolderScope(Holder holder);
+        ~HolderScope();
+
+        HolderScope(const HolderScope&) = delete;
+        HolderScope& operator=(const HolderScope&) = delete;
+
+    private:
+        Holder previous;
+    };
+
+    // Wait at most timeoutMs (forever when negative); false when the latch was not taken,
+    // at once for an exclusive hold asked for by a holder that holds the latch shared
+    bool lockShared(Holder holder, int timeoutMs = -1);
+    bool lockExclusive(Holder holder, int timeoutMs = -1);
+    // Takes the latch exclusively only if that needs no waiting
+    bool tryLockExclusive(Holder holder);
+    void unlockShared(Holder holder);
+    void unlockExclusive(Holder holder);
+    // Whether the holder holds the latch in either mode
+    bool isHeldBy(Holder holder) const;
+
+private:
+    mutable QMutex mutex;
+    QWaitCondition released;
+    QHash<Holder, int> readers;         // Holder -> shared holds
+    Holder writer = nullptr;
+    int writeHolds = 0;
+    int waitingWriters = 0;
+};
+
+/**
+ * @brief Holds a TableLatch for its own lifetime; a null latch holds nothing
+ *
+ * The hold belongs to the current holder when it is taken and is released
+ * for that holder, whichever thread destroys it.
+ */
+class LatchHold {
+public:
+    enum Mode {
+        Shared,
+        Exclusive
+    };
+
+    // With a timeout the hold may give up waiting; see timedOut()
+    LatchHold(TableLatch* latch, Mode mode, int timeoutMs = -1);
+    ~LatchHold();
+
+    LatchHold(const LatchHold&) = delete;
+    LatchHold& operator=(const LatchHold&) = delete;
+
+    // Gives the latch up before the hold is destroyed
+    void release();
+    // The latch could not be taken within the timeout; nothing is held
+    bool timedOut() const { return expired; }
+
+private:
+    TableLatch* latch;
+    Mode mode;
+    TableLatch::Holder holder;
+    bool expired = false;
+};
@@ -1,15 +1,133 @@
 #include "table_manager.h"
 #include "../storage/storage_engine.h"
+#include "checkpointer.h"
+#include "index.h"
+#include "hash_index.h"
+#include "transaction_manager.h"
+#include "../storage/write_ahead_log.h"
 #include "../utils/logger.h"
+#include <QDeadlineTimer>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <algorithm>
+
+namespace {
+// Wake the checkpointer early once the log grows past this size so recovery stays short
+constexpr qint64 WAL_CHECKPOINT_BYTES = 16 * 1024 * 1024;
+constexpr int CHECKPOINT_INTERVAL_MS = 5000;
+const QString PRIMARY_KEY_CONSTRAINT = "PRIMARY";
+
+// Untimed latches fail only when the caller holds the table shared: that hold is never upgraded
+OperationResult notLatched(const QString& tableName) {
+    return OperationResult{false, QString("Table '%1' is held for reading and cannot be changed").arg(tableName), 0, -1};
+}
+
+const RowStore& findRows(const QMap<QString, RowStore>& tableData, const QString& key) {
+    static const RowStore noRows;
+    auto it = tableData.constFind(key);
+    return it != tableData.constEnd() ? it.value() : noRows;
+}
+}
+
+TableScan::TableScan(const TableManager& manager, const QString& key, int timeoutMs)
+    : catalogHold(&manager.catalogLatch, LatchHold::Shared, timeoutMs), rows(&snapshot) {
+    if (catalogHold.timedOut()) {
+        expired = true;
+        return;
+    }
+    tableHold = std::make_unique<LatchHold>(manager.latchOf(key), LatchHold::Shared, 0);
+    if (tableHold->timedOut()) {
+        // A writer holds the table: the rows as last committed are read instead of waiting
+        // for it. Writers change rows only under dataMutex, and a transaction or bulk load
+        // keeps the committed version before its first change, so under dataMutex that
+        // version, or else the table itself, is the committed one. This also covers a
+        // statement that has latched the table but not changed it yet.
+        {
+            QMutexLocker locker(&manager.dataMutex);
+            auto it = manager.committedVersions.constFind(key);
+            snapshot = it != manager.committedVersions.constEnd() ? it.value() : findRows(manager.tableData, key);
+        }
+        tableHold.reset();
+        catalogHold.release();
+        return;
+    }
+    rows = &findRows(manager.tableData, key);
+}
+
+void TableScan::takeSnapshot() {
+    if (isSnapshot()) {
+        return;
+    }
+    // Copied while the latch still keeps writers out, so the version is consistent
+    snapshot = *rows;
+    rows = &snapshot;
+    tableHold.reset();
+    catalogHold.release();
+}
+
+TableLocks::TableLocks(const TableManager& manager, LatchHold::Mode catalogMode, const QStringList& readTables,
+                       const QStringList& writeTables, int timeoutMs)
+    : catalogHold(&manager.catalogLatch, catalogMode, timeoutMs) {
+    if (catalogHold.timedOut()) {
+        expired = true;
+        return;
+    }
+    // Each table once, in name order; exclusive if the statement writes it at all
+    QMap<QString, bool> exclusive;
+    for (const QString& name : readTables) {
+        exclusive.insert(name.toLower(), false);
+    }
+    for (const QString& name : writeTables) {
+        exclusive.insert(name.toLower(), true);
+    }
+    for (auto it = exclusive.constBegin(); it != exclusive.constEnd(); ++it) {
+        tableHolds.push_back(std::make_unique<LatchHold>(manager.latchOf(it.key()),
+            it.value() ? LatchHold::Exclusive : LatchHold::Shared, timeoutMs));
+        if (tableHolds.back()->timedOut()) {
+            expired = true;
+            release();
+            return;
+        }
+    }
+}
+
+void TableLocks::release() {
+    tableHolds.clear();
+    catalogHold.release();
+}
 
 TableManager::TableManager(const QString& dataPath) 
-    : storageEngine(std::make_shared<StorageEngine>(dataPath)) {
+    : storageEngine(std::make_shared<StorageEngine>(dataPath)),
+      wal(std::make_unique<WriteAheadLog>(storageEngine->getDataPath())) {
+    if (!wal->open()) {
+        // Fall back to rewriting the table file on every change
+        Logger::instance().error("Write-ahead log unavailable: " + wal->getLastError());
+        wal.reset();
+    }
     loadAllTables();
+    
+    if (wal) {
+        checkpointer = std::make_unique<Checkpointer>(this, CHECKPOINT_INTERVAL_MS);
+        checkpointer->start();
+    }
+}
+
+TableManager::~TableManager() {
+    if (checkpointer) {
+        checkpointer->stop();
+    }
+    // Fold outstanding changes into the table files on clean shutdown
+    checkpoint();
+}
+
+QString TableManager::getDataPath() const {
+    return storageEngine->getDataPath();
 }
 
 void TableManager::loadAllTables() {
     if (!storageEngine) return;
     
+    LatchHold catalogHold(&catalogLatch, LatchHold::Exclusive);
     QVector<QString> tableNames = storageEngine->listAllTables();
     for (const QString& tableName : tableNames) {
         auto schema = storageEngine->loadTableSchema(tableName);
@@ -17,42 +135,221 @@ void TableManager::loadAllTables() {
             addTable(schema);
             
             // Load table data
-            QVector<QStringList> rows = storageEngine->loadTableData(tableName);
-            QVector<QVector<QString>> tableRows;
-            for (const QStringList& row : rows) {
-                tableRows.append(row.toVector());
+            quint64 checkpointLsn = 0;
+            QVector<qint64> rowIds;
+            qint64 nextRowId = 0;
+            QVector<QStringList> rows = storageEngine->loadTableData(tableName, &checkpointLsn, &rowIds, &nextRowId);
+            RowStore tableRows(schema->getColumnTypes());
+            tableRows.reserve(rows.size());
+            for (int i = 0; i < rows.size(); ++i) {
+                tableRows.insertWithId(i < rowIds.size() ? rowIds[i] : i, rows[i].toVector());
             }
+            // Ids of rows deleted before the checkpoint are never handed out again
+            tableRows.setNextRowId(nextRowId);
+            
+            QMutexLocker locker(&dataMutex);
             tableData[tableName.toLower()] = tableRows;
+            checkpointLsns[tableName.toLower()] = checkpointLsn;
+            dirtyTables.remove(tableName.toLower());
             Logger::instance().info(QString("Loaded table: %1 with %2 rows").arg(tableName).arg(rows.size()));
         }
     }
+    
+    // Redo changes made since each table's last checkpoint
+    int replayed = replayLog();
+    if (replayed > 0) {
+        Logger::instance().info(QString("Recovered %1 change(s) from the write-ahead log").arg(replayed));
+        checkpoint();
+    }
+    
+    // Indexes are not persisted, only their definitions
+    for (auto it = tables.constBegin(); it != tables.constEnd(); ++it) {
+        rebuildIndexes(it.key());
+    }
 }
 
 void TableManager::saveAllTables() {
-    if (!storageEngine) return;
+    checkpoint();
+}
+
+bool TableManager::checkpoint() {
+    if (!storageEngine) return false;
+    
+    // Only one checkpoint at a time; DML keeps running while files are written
+    QMutexLocker checkpointLocker(&checkpointMutex);
     
-    for (auto it = tables.begin(); it != tables.end(); ++it) {
-        const QString& tableName = it.key();
+    QMap<QString, RowStore> snapshot;
+    QSet<QString> deferred;
+    quint64 checkpointLsn = 0;
+    int activeSegment = -1;
+    {
+        QMutexLocker locker(&dataMutex);
+        for (const QString& tableName : dirtyTables) {
+            // A table being bulk loaded is written when the load finishes, one with
+            // uncommitted changes once its transaction ends
+            if (bulkLoads.contains(tableName) || transactionTables.contains(tableName)) {
+                deferred.insert(tableName);
+                continue;
+            }
+            // Compact while the table is being written anyway; row ids are unaffected.
+            // Compaction moves rows under open scans, so it needs the table to itself;
+            // the checkpointer never waits for a latch, a busy table is compacted later.
+            // That includes a table the caller holds (finishBulkLoad under COPY's latch):
+            // the re-entrant latch would let the caller's own scans see rows move
+            auto it = tableData.find(tableName);
+            TableLatch* latch = latchOf(tableName);
+            const TableLatch::Holder self = TableLatch::currentHolder();
+            if (it != tableData.end() && it.value().tombstoneCount() > 0 && latch && !latch->isHeldBy(self) &&
+                latch->tryLockExclusive(self)) {
+                it.value().vacuum();
+                latch->unlockExclusive(self);
+            }
+            snapshot[tableName] = tableData.value(tableName);
+        }
+        dirtyTables = deferred;
         
-        // Save schema
-        storageEngine->saveTableSchema(it.value());
+        // Records after this point belong to the next checkpoint
+        if (wal) {
+            checkpointLsn = wal->getLastLsn();
+            activeSegment = wal->rotate();
+        }
+    }
+    
+    if (snapshot.isEmpty()) {
+        return true;
+    }
+    
+    // Deferred tables still rely on the log for their earlier changes
+    bool allSaved = deferred.isEmpty();
+    for (auto it = snapshot.constBegin(); it != snapshot.constEnd(); ++it) {
+        const RowStore& store = it.value();
+        QVector<QStringList> rows;
+        QVector<qint64> rowIds;
+        rows.reserve(store.size());
+        rowIds.reserve(store.size());
+        for (auto row = store.begin(); row != store.end(); ++row) {
+            rows.append(*row);
+            rowIds.append(row.rowId());
+        }
+        
+        bool saved = storageEngine->saveTableData(it.key(), rows, checkpointLsn, rowIds, store.nextRowId());
+        
+        QMutexLocker locker(&dataMutex);
+        if (saved) {
+            checkpointLsns[it.key()] = checkpointLsn;
+        } else if (tables.contains(it.key())) {
+            // Retry on the next checkpoint; the log still holds the changes
+            dirtyTables.insert(it.key());
+            allSaved = false;
+        }
+    }
+    
+    // Keep older segments if any table could not be written, replay skips what was saved
+    if (wal && allSaved && activeSegment > 0) {
+        wal->removeSegmentsBefore(activeSegment);
+    }
+    
+    Logger::instance().debug(QString("Checkpointed %1 table(s) at LSN %2").arg(snapshot.size()).arg(checkpointLsn));
+    return allSaved;
+}
+
+bool TableManager::logMutation(WalRecord& record) {
+    if (!wal) {
+        return true;
+    }
+    if (!wal->append(record)) {
+        lastError = wal->getLastError();
+        Logger::instance().error(lastError);
+        return false;
+    }
+    return true;
+}
+
+bool TableManager::logMutations(QVector<WalRecord>& records, TransactionManager* transaction) {
+    if (transaction) {
+        transaction->redoLog += records;
+        return true;
+    }
+    if (!wal) {
+        return true;
+    }
+    if (!wal->appendBatch(records)) {
+        lastError = wal->getLastError();
+        Logger::instance().error(lastError);
+        return false;
+    }
+    return true;
+}
+
+int TableManager::replayLog() {
+    if (!wal) {
+        return 0;
+    }
+    
+    QMutexLocker locker(&dataMutex);
+    int applied = 0;
+    wal->replay([this, &applied](const WalRecord& record) {
+        QString key = record.tableName.toLower();
+        if (!tableData.contains(key) || record.lsn <= checkpointLsns.value(key)) {
+            return;
+        }
         
-        // Save data
+        // Records name rows by their stable id, so replay order alone places them
+        auto& tableRows = tableData[key];
+        switch (record.operation) {
+            case WalRecord::INSERT:
+                tableRows.insertWithId(record.rowId, record.values.toVector());
+                break;
+            case WalRecord::UPDATE:
+                tableRows.update(record.rowId, record.values.toVector());
+                break;
+            case WalRecord::DELETE:
+                tableRows.remove(record.rowId);
+                break;
+        }
+        dirtyTables.insert(key);
+        applied++;
+    });
+    return applied;
+}
+
+void TableManager::checkpointIfNeeded(const QString& tableName) {
+    {
+        QMutexLocker locker(&dataMutex);
+        if (bulkLoads.contains(tableName.toLower()) || transactionTables.contains(tableName.toLower())) {
+            return;
+        }
+    }
+    if (!wal) {
+        const RowStore& store = findRows(tableData, tableName.toLower());
         QVector<QStringList> rows;
-        if (tableData.contains(tableName)) {
-            for (const QVector<QString>& row : tableData[tableName]) {
-                rows.append(row.toList());
-            }
+        QVector<qint64> rowIds;
+        for (auto row = store.begin(); row != store.end(); ++row) {
+            rows.append(*row);
+            rowIds.append(row.rowId());
         }
-        storageEngine->saveTableData(tableName, rows);
+        storageEngine->saveTableData(tableName, rows, 0, rowIds, store.nextRowId());
+    } else if (checkpointer && wal->getSize() > WAL_CHECKPOINT_BYTES) {
+        checkpointer->requestCheckpoint();
     }
 }
 
 
 void TableManager::addTable(const std::shared_ptr<TableSchema>& schema) {
-    tables[schema->getTableName().toLower()] = schema;
-    // Initialize empty row vector for this table
-    tableData[schema->getTableName().toLower()] = QVector<QVector<QString>>();
+    LatchHold catalogHold(&catalogLatch, LatchHold::Exclusive);
+    {
+        QMutexLocker locker(&dataMutex);
+        QString key = schema->getTableName().toLower();
+        tables[key] = schema;
+        // Initialize empty row store for this table
+        tableData[key] = RowStore(schema->getColumnTypes());
+        if (!latches.contains(key)) {
+            latches.insert(key, std::make_shared<TableLatch>());
+        }
+        // Written by the next checkpoint so stale log records for the name are skipped
+        dirtyTables.insert(key);
+    }
+    rebuildIndexes(schema->getTableName());
     
     // Save schema to disk immediately
     if (storageEngine) {
@@ -61,6 +358,7 @@ void TableManager::addTable(const std::shared_ptr<TableSchema>& schema) {
 }
 
 std::shared_ptr<TableSchema> TableManager::getTable(const QString& tableName) const {
+    LatchHold catalogHold(&catalogLatch, LatchHold::Shared);
     auto it = tables.find(tableName.toLower());
     if (it != tables.end()) {
         return it.value();
@@ -69,12 +367,391 @@ std::shared_ptr<TableSchema> TableManager::getTable(const QString& tableName) co
 }
 
 bool TableManager::tableExists(const QString& tableName) const {
+    LatchHold catalogHold(&catalogLatch, LatchHold::Shared);
     return tables.contains(tableName.toLower());
 }
 
-void TableManager::removeTable(const QString& tableName) {
-    tables.remove(tableName.toLower());
-    tableData.remove(tableName.toLower());
+QMap<QString, std::shared_ptr<TableSchema>> TableManager::getTables() const {
+    LatchHold catalogHold(&catalogLatch, LatchHold::Shared);
+    return tables;
+}
+
+bool TableManager::removeTable(const QString& tableName) {
+    // Every scan and statement holds the catalog shared, so none is left on the table,
+    // and a transaction that changed the table holds it until it ends
+    TableLocks locks = lockCatalog(QStringList() << tableName, LOCK_WAIT_TIMEOUT_MS);
+    if (!locks.acquired()) {
+        Logger::instance().warning(QString("Table '%1' is in use and was not removed").arg(tableName));
+        return false;
+    }
+    {
+        QMutexLocker locker(&dataMutex);
+        tables.remove(tableName.toLower());
+        tableData.remove(tableName.toLower());
+        latches.remove(tableName.toLower());
+        dirtyTables.remove(tableName.toLower());
+        checkpointLsns.remove(tableName.toLower());
+    }
+    QWriteLocker indexLocker(&indexLock);
+    indexes.remove(tableName.toLower());
+    constraintIndexes.remove(tableName.toLower());
+    return true;
+}
+
+TableLatch* TableManager::latchOf(const QString& key) const {
+    auto it = latches.constFind(key);
+    return it != latches.constEnd() ? it.value().get() : nullptr;
+}
+
+QMap<QString, std::shared_ptr<Index>> TableManager::indexesOf(const QString& tableName) const {
+    QReadLocker locker(&indexLock);
+    return indexes.value(tableName.toLower());
+}
+
+QVector<std::shared_ptr<HashIndex>> TableManager::constraintIndexesOf(const QString& tableName) const {
+    QReadLocker locker(&indexLock);
+    return constraintIndexes.value(tableName.toLower());
+}
+
+OperationResult TableManager::createIndex(
+    const QString& tableName,
+    const QString& indexName,
+    const QStringList& columns,
+    bool unique) {
+    
+    // Changes the table's schema, so no statement may be using it
+    TableLocks locks = lockCatalog(QStringList() << tableName, LOCK_WAIT_TIMEOUT_MS);
+    if (!locks.acquired()) {
+        return OperationResult{false, QString("Lock wait timeout after %1 ms").arg(LOCK_WAIT_TIMEOUT_MS), 0, -1};
+    }
+    auto schema = getTable(tableName);
+    if (!schema) {
+        return OperationResult{false, "Table not found", 0, -1};
+    }
+    if (indexName.isEmpty() || columns.isEmpty()) {
+        return OperationResult{false, "Index name and columns are required", 0, -1};
+    }
+    
+    // Index names are unique across the database
+    {
+        QReadLocker indexLocker(&indexLock);
+        for (const auto& tableIndexes : indexes) {
+            if (tableIndexes.contains(indexName.toLower())) {
+                return OperationResult{false, QString("Index '%1' already exists").arg(indexName), 0, -1};
+            }
+        }
+    }
+    
+    IndexDefinition definition;
+    definition.name = indexName;
+    definition.unique = unique;
+    for (const QString& column : columns) {
+        const Column* col = schema->getColumn(schema->getColumnIndex(column));
+        if (!col) {
+            return OperationResult{false, QString("Column '%1' not found in table '%2'").arg(column, tableName), 0, -1};
+        }
+        definition.columns.append(col->getName());
+    }
+    
+    QString errorMessage;
+    auto index = buildIndex(tableName, definition, errorMessage);
+    if (!index) {
+        return OperationResult{false, errorMessage, 0, -1};
+    }
+    
+    {
+        QWriteLocker indexLocker(&indexLock);
+        indexes[tableName.toLower()][indexName.toLower()] = index;
+    }
+    schema->addIndexDefinition(definition);
+    if (storageEngine) {
+        storageEngine->saveTableSchema(schema);
+    }
+    
+    Logger::instance().info(QString("Created %1index '%2' on %3(%4) with %5 key(s)")
+        .arg(unique ? "unique " : "").arg(indexName).arg(tableName)
+        .arg(definition.columns.join(", ")).arg(index->keyCount()));
+    return OperationResult{true, "", index->entryCount(), -1};
+}
+
+std::shared_ptr<Index> TableManager::getIndex(const QString& tableName, const QString& indexName) const {
+    return indexesOf(tableName).value(indexName.toLower());
+}
+
+QVector<std::shared_ptr<Index>> TableManager::getIndexes(const QString& tableName) const {
+    QVector<std::shared_ptr<Index>> result;
+    for (const auto& index : indexesOf(tableName)) {
+        result.append(index);
+    }
+    return result;
+}
+
+std::shared_ptr<Index> TableManager::findIndex(const QString& tableName, const QStringList& columns) const {
+    for (const auto& index : indexesOf(tableName)) {
+        const QStringList indexColumns = index->getColumns();
+        if (indexColumns.size() != columns.size()) {
+            continue;
+        }
+        bool matches = true;
+        for (int i = 0; i < columns.size() && matches; ++i) {
+            matches = indexColumns[i].toLower() == columns[i].toLower();
+        }
+        if (matches) {
+            return index;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Index> TableManager::buildIndex(
+    const QString& tableName,
+    const IndexDefinition& definition,
+    QString& errorMessage) const {
+    
+    auto schema = getTable(tableName);
+    if (!schema) {
+        errorMessage = "Table not found";
+        return nullptr;
+    }
+    
+    QVector<int> positions;
+    QVector<DataType> types;
+    for (const QString& column : definition.columns) {
+        int idx = schema->getColumnIndex(column);
+        if (idx < 0) {
+            errorMessage = QString("Column '%1' not found in table '%2'").arg(column, tableName);
+            return nullptr;
+        }
+        positions.append(idx);
+        types.append(schema->getColumns()[idx].getType());
+    }
+    
+    auto index = std::make_shared<Index>(definition.name, tableName, definition.columns, types, definition.unique);
+    
+    const RowStore& rows = tableData[tableName.toLower()];
+    QVector<QPair<IndexKey, qint64>> entries;
+    entries.reserve(rows.size());
+    // Read only the indexed columns instead of assembling whole rows
+    for (int slot = 0; slot < rows.slotCount(); ++slot) {
+        if (!rows.isLive(slot)) {
+            continue;
+        }
+        QVector<QString> values;
+        for (int pos : positions) {
+            values.append(pos < rows.columnCount() ? rows.valueAt(slot, pos) : QString());
+        }
+        entries.append(qMakePair(index->makeKey(values), rows.rowIdAt(slot)));
+    }
+    index->bulkLoad(entries);
+    
+    // A unique index cannot be built over rows that already collide (NULLs never collide)
+    if (definition.unique && index->keyCount() != index->entryCount()) {
+        bool duplicate = false;
+        index->scan(nullptr, true, nullptr, true, [&](const IndexKey& key, const QVector<qint64>& rowIds) {
+            duplicate = rowIds.size() > 1 && !key.hasNull();
+            if (duplicate) {
+                errorMessage = QString("Cannot create unique index '%1': duplicate key (%2)")
+                    .arg(definition.name, key.toString());
+            }
+            return !duplicate;
+        });
+        if (duplicate) {
+            return nullptr;
+        }
+    }
+    return index;
+}
+
+void TableManager::rebuildIndexes(const QString& tableName) {
+    auto schema = getTable(tableName);
+    if (!schema) return;
+    
+    rebuildConstraintIndexes(tableName);
+    
+    QMap<QString, std::shared_ptr<Index>> tableIndexes;
+    for (const auto& definition : schema->getIndexDefinitions()) {
+        QString errorMessage;
+        auto index = buildIndex(tableName, definition, errorMessage);
+        if (index) {
+            tableIndexes[definition.name.toLower()] = index;
+        } else {
+            Logger::instance().warning(QString("Skipping index '%1': %2").arg(definition.name, errorMessage));
+        }
+    }
+    QWriteLocker indexLocker(&indexLock);
+    indexes[tableName.toLower()] = tableIndexes;
+}
+
+void TableManager::rebuildConstraintIndexes(const QString& tableName) {
+    auto schema = getTable(tableName);
+    if (!schema) return;
+    
+    const RowStore& rows = findRows(tableData, tableName.toLower());
+    const auto& columns = schema->getColumns();
+    QVector<std::shared_ptr<HashIndex>> tableConstraints;
+    QSet<QString> coveredColumns;
+    
+    auto addConstraint = [&](const QString& name, const QStringList& constraintColumns) {
+        QVector<int> positions;
+        for (const QString& column : constraintColumns) {
+            int idx = schema->getColumnIndex(column);
+            if (idx < 0) {
+                Logger::instance().warning(QString("Constraint '%1' references unknown column '%2'").arg(name, column));
+                return;
+            }
+            positions.append(idx);
+        }
+        if (constraintColumns.size() == 1) {
+            coveredColumns.insert(constraintColumns.first().toLower());
+        }
+        
+        auto index = std::make_shared<HashIndex>(name, constraintColumns, positions);
+        int duplicates = index->build(rows);
+        if (duplicates > 0) {
+            Logger::instance().warning(QString("Table '%1' already has %2 row(s) violating %3 on %4")
+                .arg(tableName).arg(duplicates).arg(name, constraintColumns.join(", ")));
+        }
+        tableConstraints.append(index);
+    };
+    
+    // Primary key, falling back to column-level PRIMARY KEY flags
+    QStringList pkColumns = schema->getPrimaryKeyColumns();
+    if (pkColumns.isEmpty()) {
+        for (const auto& column : columns) {
+            if (column.isPrimaryKey()) {
+                pkColumns.append(column.getName());
+            }
+        }
+    }
+    if (!pkColumns.isEmpty()) {
+        addConstraint(PRIMARY_KEY_CONSTRAINT, pkColumns);
+    }
+    
+    // Table-level UNIQUE constraints, then column-level UNIQUE flags
+    const auto uniqueConstraints = schema->getUniqueConstraints();
+    for (auto it = uniqueConstraints.constBegin(); it != uniqueConstraints.constEnd(); ++it) {
+        addConstraint(it.key(), it.value());
+    }
+    for (const auto& column : columns) {
+        if (column.isUnique() && !coveredColumns.contains(column.getName().toLower())) {
+            addConstraint(column.getName(), QStringList() << column.getName());
+        }
+    }
+    
+    QWriteLocker indexLocker(&indexLock);
+    constraintIndexes[tableName.toLower()] = tableConstraints;
+}
+
+IndexKey TableManager::indexKeyForRow(const QString& tableName, const Index& index, const QVector<QString>& row) const {
+    // The table's latch keeps its schema as it is; the map is read under dataMutex rather
+    // than the catalog latch, so rolling a transaction back never waits for the catalog
+    std::shared_ptr<TableSchema> schema;
+    {
+        QMutexLocker locker(&dataMutex);
+        schema = tables.value(tableName.toLower());
+    }
+    QVector<QString> values;
+    for (const QString& column : index.getColumns()) {
+        int idx = schema ? schema->getColumnIndex(column) : -1;
+        values.append(idx >= 0 && idx < row.size() ? row[idx] : QString());
+    }
+    return index.makeKey(values);
+}
+
+bool TableManager::validateUniqueBatch(
+    const QString& tableName,
+    const QVector<QVector<QString>>& newRows,
+    const QSet<qint64>& replacedRowIds,
+    QString& errorMessage) const {
+    
+    for (const auto& index : constraintIndexesOf(tableName)) {
+        QSet<QString> batchKeys;
+        batchKeys.reserve(newRows.size());
+        for (const auto& row : newRows) {
+            QString key;
+            if (!index->makeKey(row, key)) {
+                continue;
+            }
+            qint64 existingRowId = index->findKey(key);
+            bool taken = existingRowId >= 0 && !replacedRowIds.contains(existingRowId);
+            if (taken || batchKeys.contains(key)) {
+                errorMessage = QString("%1 constraint violation on column(s): %2")
+                    .arg(index->getConstraintName() == PRIMARY_KEY_CONSTRAINT ? "PRIMARY KEY" : "UNIQUE")
+                    .arg(index->getColumns().join(", "));
+                return false;
+            }
+            batchKeys.insert(key);
+        }
+    }
+    
+    for (const auto& index : indexesOf(tableName)) {
+        if (!index->isUnique()) continue;
+        
+        QVector<IndexKey> batchKeys;
+        bool duplicate = false;
+        for (const auto& row : newRows) {
+            IndexKey key = indexKeyForRow(tableName, *index, row);
+            if (key.hasNull()) continue;
+            
+            for (qint64 rowId : index->find(key)) {
+                if (!replacedRowIds.contains(rowId)) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            batchKeys.append(key);
+        }
+        
+        // Keys repeated within the statement itself
+        std::sort(batchKeys.begin(), batchKeys.end());
+        for (int i = 1; !duplicate && i < batchKeys.size(); ++i) {
+            duplicate = batchKeys[i] == batchKeys[i - 1];
+        }
+        if (duplicate) {
+            errorMessage = QString("UNIQUE index '%1' violation on column(s): %2")
+                .arg(index->getIndexName(), index->getColumns().join(", "));
+            return false;
+        }
+    }
+    return true;
+}
+
+void TableManager::indexRowInserted(const QString& tableName, const QVector<QString>& row, qint64 rowId,
+                                    bool bulkLoading) {
+    for (const auto& index : constraintIndexesOf(tableName)) {
+        index->insert(row, rowId);
+    }
+    // During a bulk load only unique indexes are kept current (they are needed to
+    // validate the next rows); the rest are rebuilt in one pass when it finishes
+    for (const auto& index : indexesOf(tableName)) {
+        if (bulkLoading && !index->isUnique()) continue;
+        index->insert(indexKeyForRow(tableName, *index, row), rowId);
+    }
+}
+
+void TableManager::indexRowUpdated(const QString& tableName, const QVector<QString>& oldRow,
+                                   const QVector<QString>& newRow, qint64 rowId) {
+    for (const auto& index : constraintIndexesOf(tableName)) {
+        index->remove(oldRow, rowId);
+        index->insert(newRow, rowId);
+    }
+    for (const auto& index : indexesOf(tableName)) {
+        IndexKey oldKey = indexKeyForRow(tableName, *index, oldRow);
+        IndexKey newKey = indexKeyForRow(tableName, *index, newRow);
+        if (oldKey != newKey) {
+            index->remove(oldKey, rowId);
+            index->insert(newKey, rowId);
+        }
+    }
+}
+
+void TableManager::indexRowDeleted(const QString& tableName, const QVector<QString>& row, qint64 rowId) {
+    for (const auto& index : constraintIndexesOf(tableName)) {
+        index->remove(row, rowId);
+    }
+    for (const auto& index : indexesOf(tableName)) {
+        index->remove(indexKeyForRow(tableName, *index, row), rowId);
+    }
 }
 
 // Helper: Map column values from QVector to QMap using schema column order
@@ -101,56 +778,26 @@ QMap<QString, QString> TableManager::mapColumnsToValues(
     return columnValues;
 }
 
-// Helper: Validate UNIQUE constraints (excluding specified row ID for updates)
+// Helper: Validate PRIMARY KEY/UNIQUE constraints (excluding specified row ID for updates)
 bool TableManager::validateUniqueConstraints(
     const QString& tableName,
-    const QMap<QString, QString>& columnValues,
+    const QVector<QString>& values,
     QString& errorMessage,
-    int excludeRowId) const {
+    qint64 excludeRowId) const {
     
-    auto schema = getTable(tableName);
-    if (!schema) {
+    if (!tableExists(tableName)) {
         errorMessage = "Table not found";
         return false;
     }
     
-    const auto& uniqueConstraints = schema->getUniqueConstraints();
-    const auto& tableRows = tableData.value(tableName.toLower());
-    const auto& columns = schema->getColumns();
-    
-    // For each UNIQUE constraint, check if values already exist
-    for (auto it = uniqueConstraints.constBegin(); it != uniqueConstraints.constEnd(); ++it) {
-        const QStringList& constraintCols = it.value();
-        
-        // Build values for this constraint from current row
-        QVector<QString> currentValues;
-        for (const auto& colName : constraintCols) {
-            currentValues.append(columnValues.value(colName, ""));
-        }
-        
-        // Check against existing rows
-        for (int rowIdx = 0; rowIdx < tableRows.size(); ++rowIdx) {
-            // Skip the row being updated
-            if (rowIdx == excludeRowId) continue;
-            
-            const auto& row = tableRows[rowIdx];
-            
-            // Build values for this constraint from existing row
-            QVector<QString> existingValues;
-            for (const auto& colName : constraintCols) {
-                // Find column index by name
-                int colIdx = schema->getColumnIndex(colName);
-                if (colIdx >= 0 && colIdx < row.size()) {
-                    existingValues.append(row[colIdx]);
-                }
-            }
-            
-            // Compare values
-            if (currentValues == existingValues) {
-                errorMessage = QString("UNIQUE constraint violation on column(s): %1")
-                    .arg(constraintCols.join(", "));
-                return false;
-            }
+    // One hash lookup per constraint instead of a scan over every row
+    for (const auto& index : constraintIndexesOf(tableName)) {
+        qint64 existingRowId = index->find(values);
+        if (existingRowId >= 0 && existingRowId != excludeRowId) {
+            errorMessage = QString("%1 constraint violation on column(s): %2")
+                .arg(index->getConstraintName() == PRIMARY_KEY_CONSTRAINT ? "PRIMARY KEY" : "UNIQUE")
+                .arg(index->getColumns().join(", "));
+            return false;
         }
     }
     
@@ -197,54 +844,106 @@ OperationResult TableManager::insertRow(
     const QString& tableName,
     const QVector<QString>& values) {
     
+    return insertRows(tableName, QVector<QVector<QString>>() << values);
+}
+
+// Insert a set of rows as one statement: validate everything, then log and append once
+OperationResult TableManager::insertRows(
+    const QString& tableName,
+    const QVector<QVector<QString>>& rows,
+    TransactionManager* transaction) {
+    
+    TableLocks locks = lockTables(QStringList(), QStringList() << tableName);
+    if (!locks.acquired()) {
+        return notLatched(tableName);
+    }
     auto schema = getTable(tableName);
     if (!schema) {
         return OperationResult{false, "Table not found", 0, -1};
     }
-    
-    // Check column count
-    if (values.size() != schema->getColumns().size()) {
-        return OperationResult{false, 
-            QString("Column count mismatch: expected %1, got %2")
-            .arg(schema->getColumns().size()).arg(values.size()), 
-            0, -1};
+    if (rows.isEmpty()) {
+        return OperationResult{true, "", 0, -1};
     }
     
-    // Validate row at schema level (all constraints)
-    if (!schema->validateRow(values)) {
-        return OperationResult{false, schema->getValidationError(), 0, -1};
+    const int columnCount = schema->getColumns().size();
+    for (const auto& values : rows) {
+        // Check column count
+        if (values.size() != columnCount) {
+            return OperationResult{false, 
+                QString("Column count mismatch: expected %1, got %2")
+                .arg(columnCount).arg(values.size()), 
+                0, -1};
+        }
+        
+        // Validate row at schema level (all constraints)
+        if (!schema->validateRow(values)) {
+            return OperationResult{false, schema->getValidationError(), 0, -1};
+        }
+        
+        // Validate FOREIGN KEY constraints
+        QString fkError;
+        if (!validateForeignKeyConstraints(tableName, mapColumnsToValues(tableName, values), fkError)) {
+            return OperationResult{false, fkError, 0, -1};
+        }
     }
     
-    // Map values to column names for additional validation
-    QMap<QString, QString> columnValues = mapColumnsToValues(tableName, values);
-    
-    // Validate UNIQUE constraints
+    // Validate UNIQUE constraints and indexes against the table and within the batch
     QString uniqueError;
-    if (!validateUniqueConstraints(tableName, columnValues, uniqueError)) {
+    if (!validateUniqueBatch(tableName, rows, QSet<qint64>(), uniqueError)) {
         return OperationResult{false, uniqueError, 0, -1};
     }
     
-    // Validate FOREIGN KEY constraints
-    QString fkError;
-    if (!validateForeignKeyConstraints(tableName, columnValues, fkError)) {
-        return OperationResult{false, fkError, 0, -1};
+    // All validations passed - log every row in one write, then append them.
+    // A bulk load is made durable by its closing checkpoint instead of the log.
+    if (transaction) {
+        enlist(*transaction, tableName.toLower());
     }
-    
-    // All validations passed - insert the row
     auto& tableRows = tableData[tableName.toLower()];
-    int newRowId = tableRows.size(); // Row ID is simply the index
-    tableRows.append(values);
+    bool bulkLoading = false;
+    {
+        QMutexLocker locker(&dataMutex);
+        bulkLoading = bulkLoads.contains(tableName.toLower());
+    }
+    QVector<WalRecord> records;
+    if (!bulkLoading) {
+        records.reserve(rows.size());
+        for (const auto& values : rows) {
+            WalRecord record;
+            record.operation = WalRecord::INSERT;
+            record.tableName = tableName.toLower();
+            record.values = values.toList();
+            records.append(record);
+        }
+    }
     
-    // Save to disk
-    if (storageEngine) {
-        QVector<QStringList> rows;
-        for (const QVector<QString>& row : tableRows) {
-            rows.append(row.toList());
+    qint64 firstRowId = -1;
+    {
+        QMutexLocker locker(&dataMutex);
+        firstRowId = tableRows.nextRowId();
+        for (int i = 0; i < records.size(); ++i) {
+            records[i].rowId = firstRowId + i;
+        }
+        if (!logMutations(records, transaction)) {
+            return OperationResult{false, lastError, 0, -1};
+        }
+        tableRows.reserve(tableRows.slotCount() + rows.size());
+        for (int i = 0; i < rows.size(); ++i) {
+            tableRows.insertWithId(firstRowId + i, rows[i]);
         }
-        storageEngine->saveTableData(tableName, rows);
+        if (transaction) {
+            for (int i = 0; i < rows.size(); ++i) {
+                transaction->undoLog.append({WalRecord::INSERT, tableName.toLower(), firstRowId + i, {}});
+            }
+        }
+        dirtyTables.insert(tableName.toLower());
+    }
+    for (int i = 0; i < rows.size(); ++i) {
+        indexRowInserted(tableName, rows[i], firstRowId + i, bulkLoading);
     }
+    checkpointIfNeeded(tableName);
     
-    return OperationResult{true, "", 1, newRowId};
+    // For a single row this is its id; for a batch, the first id (the rest follow in order)
+    return OperationResult{true, "", static_cast<int>(rows.size()), firstRowId};
 }
 
 // Insert a row using map of column names to values
@@ -273,67 +972,16 @@ OperationResult TableManager::insertRow(
 // Update a row by row ID
 OperationResult TableManager::updateRow(
     const QString& tableName,
-    int rowId,
+    qint64 rowId,
     const QVector<QString>& values) {
     
-    auto schema = getTable(tableName);
-    if (!schema) {
-        return OperationResult{false, "Table not found", 0, -1};
-    }
-    
-    auto& tableRows = tableData[tableName.toLower()];
-    
-    if (rowId < 0 || rowId >= tableRows.size()) {
-        return OperationResult{false, "Row ID out of bounds", 0, -1};
-    }
-    
-    // Check column count
-    if (values.size() != schema->getColumns().size()) {
-        return OperationResult{false, 
-            QString("Column count mismatch: expected %1, got %2")
-            .arg(schema->getColumns().size()).arg(values.size()), 
-            0, -1};
-    }
-    
-    // Validate row at schema level
-    if (!schema->validateRow(values)) {
-        return OperationResult{false, schema->getValidationError(), 0, -1};
-    }
-    
-    // Map values to column names for additional validation
-    QMap<QString, QString> columnValues = mapColumnsToValues(tableName, values);
-    
-    // Validate UNIQUE constraints (excluding this row being updated)
-    QString uniqueError;
-    if (!validateUniqueConstraints(tableName, columnValues, uniqueError, rowId)) {
-        return OperationResult{false, uniqueError, 0, -1};
-    }
-    
-    // Validate FOREIGN KEY constraints
-    QString fkError;
-    if (!validateForeignKeyConstraints(tableName, columnValues, fkError)) {
-        return OperationResult{false, fkError, 0, -1};
-    }
-    
-    // All validations passed - update the row
-    tableRows[rowId] = values;
-    
-    // Save to disk
-    if (storageEngine) {
-        QVector<QStringList> rows;
-        for (const QVector<QString>& row : tableRows) {
-            rows.append(row.toList());
-        }
-        storageEngine->saveTableData(tableName, rows);
-    }
-    
-    return OperationResult{true, "", 1, rowId};
+    return updateRows(tableName, QVector<QPair<qint64, QVector<QString>>>() << qMakePair(rowId, values));
 }
 
 // Update a row by row ID using map
 OperationResult TableManager::updateRow(
     const QString& tableName,
-    int rowId,
+    qint64 rowId,
     const QMap<QString, QString>& columnValues) {
     
     auto schema = getTable(tableName);
@@ -354,37 +1002,144 @@ OperationResult TableManager::updateRow(
     return updateRow(tableName, rowId, values);
 }
 
-// Delete a row by row ID
-OperationResult TableManager::deleteRow(
+// Update a set of rows as one statement: validate everything, then log and apply once
+OperationResult TableManager::updateRows(
     const QString& tableName,
-    int rowId) {
+    const QVector<QPair<qint64, QVector<QString>>>& updates,
+    TransactionManager* transaction) {
     
+    TableLocks locks = lockTables(QStringList(), QStringList() << tableName);
+    if (!locks.acquired()) {
+        return notLatched(tableName);
+    }
     auto schema = getTable(tableName);
     if (!schema) {
         return OperationResult{false, "Table not found", 0, -1};
     }
+    if (updates.isEmpty()) {
+        return OperationResult{true, "", 0, -1};
+    }
     
     auto& tableRows = tableData[tableName.toLower()];
+    const int columnCount = schema->getColumns().size();
     
-    if (rowId < 0 || rowId >= tableRows.size()) {
-        return OperationResult{false, "Row ID out of bounds", 0, -1};
+    QVector<QVector<QString>> newRows;
+    QSet<qint64> replacedRowIds;
+    newRows.reserve(updates.size());
+    replacedRowIds.reserve(updates.size());
+    
+    for (const auto& update : updates) {
+        const QVector<QString>& values = update.second;
+        if (!tableRows.contains(update.first)) {
+            return OperationResult{false, QString("Row %1 does not exist").arg(update.first), 0, -1};
+        }
+        
+        // Check column count
+        if (values.size() != columnCount) {
+            return OperationResult{false, 
+                QString("Column count mismatch: expected %1, got %2")
+                .arg(columnCount).arg(values.size()), 
+                0, -1};
+        }
+        
+        // Validate row at schema level
+        if (!schema->validateRow(values)) {
+            return OperationResult{false, schema->getValidationError(), 0, -1};
+        }
+        
+        // Validate FOREIGN KEY constraints
+        QString fkError;
+        if (!validateForeignKeyConstraints(tableName, mapColumnsToValues(tableName, values), fkError)) {
+            return OperationResult{false, fkError, 0, -1};
+        }
+        
+        newRows.append(values);
+        replacedRowIds.insert(update.first);
     }
     
-    // Check referential integrity - any foreign keys pointing to this row?
-    const auto& deletingRow = tableRows[rowId];
-    const auto& pkCols = schema->getPrimaryKeyColumns();
+    // Validate UNIQUE constraints and indexes for the statement as a whole: the
+    // updated rows give up their old keys and must not collide with each other
+    QString uniqueError;
+    if (!validateUniqueBatch(tableName, newRows, replacedRowIds, uniqueError)) {
+        return OperationResult{false, uniqueError, 0, -1};
+    }
     
-    if (!pkCols.isEmpty()) {
-        QVector<QString> pkValues;
-        
-        for (const auto& pkCol : pkCols) {
-            int colIdx = schema->getColumnIndex(pkCol);
-            if (colIdx >= 0 && colIdx < deletingRow.size()) {
-                pkValues.append(deletingRow[colIdx]);
+    // All validations passed - log every change in one write, then apply them
+    QVector<WalRecord> records;
+    records.reserve(updates.size());
+    for (const auto& update : updates) {
+        WalRecord record;
+        record.operation = WalRecord::UPDATE;
+        record.tableName = tableName.toLower();
+        record.rowId = update.first;
+        record.values = update.second.toList();
+        records.append(record);
+    }
+    
+    if (transaction) {
+        enlist(*transaction, tableName.toLower());
+    }
+    QVector<QVector<QString>> oldRows(updates.size());
+    {
+        QMutexLocker locker(&dataMutex);
+        if (!logMutations(records, transaction)) {
+            return OperationResult{false, lastError, 0, -1};
+        }
+        for (int i = 0; i < updates.size(); ++i) {
+            tableRows.update(updates[i].first, updates[i].second, &oldRows[i]);
+        }
+        if (transaction) {
+            for (int i = 0; i < updates.size(); ++i) {
+                transaction->undoLog.append({WalRecord::UPDATE, tableName.toLower(), updates[i].first, oldRows[i]});
             }
         }
-        
-        // Check all tables for foreign keys pointing to this table
+        dirtyTables.insert(tableName.toLower());
+    }
+    for (int i = 0; i < updates.size(); ++i) {
+        indexRowUpdated(tableName, oldRows[i], updates[i].second, updates[i].first);
+    }
+    checkpointIfNeeded(tableName);
+    
+    return OperationResult{true, "", static_cast<int>(updates.size()),
+                           updates.size() == 1 ? updates.first().first : -1};
+}
+
+// Delete a row by row ID
+OperationResult TableManager::deleteRow(
+    const QString& tableName,
+    qint64 rowId) {
+    
+    return deleteRows(tableName, QVector<qint64>() << rowId);
+}
+
+// Delete a set of rows as one statement: check everything, then log and apply once
+OperationResult TableManager::deleteRows(
+    const QString& tableName,
+    const QVector<qint64>& rowIds,
+    TransactionManager* transaction) {
+    
+    TableLocks locks = lockTables(QStringList(), QStringList() << tableName);
+    if (!locks.acquired()) {
+        return notLatched(tableName);
+    }
+    auto schema = getTable(tableName);
+    if (!schema) {
+        return OperationResult{false, "Table not found", 0, -1};
+    }
+    if (rowIds.isEmpty()) {
+        return OperationResult{true, "", 0, -1};
+    }
+    
+    auto& tableRows = tableData[tableName.toLower()];
+    for (qint64 rowId : rowIds) {
+        if (!tableRows.contains(rowId)) {
+            return OperationResult{false, QString("Row %1 does not exist").arg(rowId), 0, -1};
+        }
+    }
+    
+    // Check referential integrity - any foreign keys pointing to these rows?
+    // The check depends only on the table, so it runs once per statement
+    if (!schema->getPrimaryKeyColumns().isEmpty()) {
         for (const auto& [tblName, tblSchema] : tables.asKeyValueRange()) {
             const auto& fkConstraints = tblSchema->getForeignKeyConstraints();
             for (auto it = fkConstraints.constBegin(); it != fkConstraints.constEnd(); ++it) {
@@ -402,19 +1157,214 @@ OperationResult TableManager::deleteRow(
         }
     }
     
-    // All checks passed - delete the row
-    tableRows.removeAt(rowId);
+    // All checks passed - log every delete in one write, then apply them
+    QVector<WalRecord> records;
+    records.reserve(rowIds.size());
+    for (qint64 rowId : rowIds) {
+        WalRecord record;
+        record.operation = WalRecord::DELETE;
+        record.tableName = tableName.toLower();
+        record.rowId = rowId;
+        records.append(record);
+    }
     
-    // Save to disk
-    if (storageEngine) {
-        QVector<QStringList> rows;
-        for (const QVector<QString>& row : tableRows) {
-            rows.append(row.toList());
+    if (transaction) {
+        enlist(*transaction, tableName.toLower());
+    }
+    QVector<QVector<QString>> deletedRows(rowIds.size());
+    {
+        QMutexLocker locker(&dataMutex);
+        if (!logMutations(records, transaction)) {
+            return OperationResult{false, lastError, 0, -1};
+        }
+        // Tombstone the slots; other rows keep their place and their ids
+        for (int i = 0; i < rowIds.size(); ++i) {
+            tableRows.remove(rowIds[i], &deletedRows[i]);
+        }
+        if (transaction) {
+            for (int i = 0; i < rowIds.size(); ++i) {
+                transaction->undoLog.append({WalRecord::DELETE, tableName.toLower(), rowIds[i], deletedRows[i]});
+            }
+        }
+        if (tableRows.needsVacuum()) {
+            tableRows.vacuum();
+        }
+        dirtyTables.insert(tableName.toLower());
+    }
+    for (int i = 0; i < rowIds.size(); ++i) {
+        indexRowDeleted(tableName, deletedRows[i], rowIds[i]);
+    }
+    checkpointIfNeeded(tableName);
+    
+    return OperationResult{true, "", static_cast<int>(rowIds.size()),
+                           rowIds.size() == 1 ? rowIds.first() : -1};
+}
+
+bool TableManager::beginBulkLoad(const QString& tableName) {
+    QString key = tableName.toLower();
+    TableLocks locks = lockTables(QStringList(), QStringList() << tableName);
+    if (!locks.acquired()) {
+        return false;
+    }
+    QMutexLocker locker(&dataMutex);
+    if (!tables.contains(key) || bulkLoads.contains(key)) {
+        return false;
+    }
+    
+    bulkLoads.insert(key, tableData[key].nextRowId());
+    keepCommittedVersion(key);
+    return true;
+}
+
+bool TableManager::finishBulkLoad(const QString& tableName) {
+    QString key = tableName.toLower();
+    {
+        TableLocks locks = lockTables(QStringList(), QStringList() << tableName);
+        if (!locks.acquired()) {
+            return false;
+        }
+        {
+            QMutexLocker locker(&dataMutex);
+            if (!bulkLoads.remove(key)) {
+                return false;
+            }
+            dropCommittedVersion(key);
+            dirtyTables.insert(key);
+        }
+        
+        // Bottom-up rebuild instead of one B+tree insert per loaded row
+        rebuildIndexes(tableName);
+    }
+    
+    // The loaded rows never went through the log; writing the table makes them durable
+    if (!checkpoint()) {
+        Logger::instance().warning(QString("Bulk load into '%1' is not yet durable; the next checkpoint retries").arg(tableName));
+        return false;
+    }
+    return true;
+}
+
+void TableManager::abortBulkLoad(const QString& tableName) {
+    QString key = tableName.toLower();
+    TableLocks locks = lockTables(QStringList(), QStringList() << tableName);
+    if (!locks.acquired()) {
+        return;
+    }
+    {
+        QMutexLocker locker(&dataMutex);
+        auto it = bulkLoads.find(key);
+        if (it == bulkLoads.end()) {
+            return;
         }
-        storageEngine->saveTableData(tableName, rows);
+        int removed = tableData[key].truncateFrom(it.value());
+        bulkLoads.erase(it);
+        dropCommittedVersion(key);
+        Logger::instance().info(QString("Bulk load into '%1' aborted, %2 row(s) discarded").arg(tableName).arg(removed));
+    }
+    rebuildIndexes(tableName);
+}
+
+void TableManager::enlist(TransactionManager& transaction, const QString& key) {
+    if (transaction.changedTables.contains(key)) {
+        return;
     }
+    Q_ASSERT_X(TableLatch::currentHolder() == &transaction, "TableManager::enlist",
+               "statements of a transaction must run in its TableLatch::HolderScope");
+    // Re-entrant: the statement holds the table already. The latch is kept alive with
+    // the hold; the table cannot be dropped while the transaction holds it.
+    auto latch = latches.value(key);
+    transaction.latchHolds.push_back(std::make_unique<LatchHold>(latch.get(), LatchHold::Exclusive));
+    transaction.latches.push_back(latch);
+    transaction.changedTables.insert(key);
     
-    return OperationResult{true, "", 1, rowId};
+    QMutexLocker locker(&dataMutex);
+    transactionTables.insert(key);
+    keepCommittedVersion(key);
+}
+
+bool TableManager::commitTransaction(TransactionManager& transaction, QString& errorMessage) {
+    if (transaction.changedTables.isEmpty()) {
+        return true;
+    }
+    // The catalog is not taken: the transaction holds every table it changed, so none of
+    // them can be dropped, and waiting for it here could queue COMMIT behind DDL that is
+    // itself waiting for one of those tables
+    QStringList existing;
+    {
+        QMutexLocker locker(&dataMutex);
+        // Every change of the transaction in one write and one flush. Records that cannot
+        // be synced are taken back out of the log, and the caller rolls the changes back
+        if (wal && !transaction.redoLog.isEmpty() && !wal->appendBatch(transaction.redoLog, true)) {
+            errorMessage = wal->getLastError();
+            Logger::instance().error(errorMessage);
+            return false;
+        }
+        for (const QString& key : transaction.changedTables) {
+            transactionTables.remove(key);
+            dropCommittedVersion(key);
+            if (tables.contains(key)) {
+                existing.append(key);
+            }
+        }
+    }
+    // Without a log this is where the changed tables are rewritten, once per commit
+    for (const QString& key : existing) {
+        checkpointIfNeeded(key);
+    }
+    return true;
+}
+
+void TableManager::rollbackTransaction(TransactionManager& transaction) {
+    if (transaction.changedTables.isEmpty()) {
+        return;
+    }
+    // The transaction still holds every table it changed, so the rows are as it left them.
+    // Like commit, this takes no catalog latch
+    const auto& undoLog = transaction.undoLog;
+    QVector<QVector<QString>> images(undoLog.size());
+    QVector<bool> undone(undoLog.size(), false);
+    {
+        QMutexLocker locker(&dataMutex);
+        for (int i = undoLog.size() - 1; i >= 0; --i) {
+            const auto& undo = undoLog[i];
+            auto it = tableData.find(undo.tableName);
+            if (it == tableData.end()) {
+                continue;   // Dropped since
+            }
+            switch (undo.operation) {
+                case WalRecord::INSERT:
+                    undone[i] = it.value().remove(undo.rowId, &images[i]);
+                    break;
+                case WalRecord::UPDATE:
+                    undone[i] = it.value().update(undo.rowId, undo.oldRow, &images[i]);
+                    break;
+                case WalRecord::DELETE:
+                    it.value().insertWithId(undo.rowId, undo.oldRow);
+                    undone[i] = true;
+                    break;
+            }
+        }
+        for (const QString& key : transaction.changedTables) {
+            transactionTables.remove(key);
+            dropCommittedVersion(key);
+        }
+    }
+    for (int i = undoLog.size() - 1; i >= 0; --i) {
+        if (!undone[i]) continue;
+        const auto& undo = undoLog[i];
+        switch (undo.operation) {
+            case WalRecord::INSERT:
+                indexRowDeleted(undo.tableName, images[i], undo.rowId);
+                break;
+            case WalRecord::UPDATE:
+                indexRowUpdated(undo.tableName, images[i], undo.oldRow, undo.rowId);
+                break;
+            case WalRecord::DELETE:
+                indexRowInserted(undo.tableName, undo.oldRow, undo.rowId, false);
+                break;
+        }
+    }
+    Logger::instance().info(QString("Transaction rolled back, %1 change(s) undone").arg(undoLog.size()));
 }
 
 // Validate a row without modifying data
@@ -423,6 +1373,7 @@ bool TableManager::validateRow(
     const QVector<QString>& values,
     QString& errorMessage) const {
     
+    TableLocks locks = lockTables(QStringList() << tableName);
     auto schema = getTable(tableName);
     if (!schema) {
         errorMessage = "Table not found";
@@ -445,7 +1396,7 @@ bool TableManager::validateRow(
     QMap<QString, QString> columnValues = mapColumnsToValues(tableName, values);
     
     // Validate UNIQUE constraints
-    if (!validateUniqueConstraints(tableName, columnValues, errorMessage)) {
+    if (!validateUniqueConstraints(tableName, values, errorMessage)) {
         return false;
     }
     
@@ -459,7 +1410,89 @@ bool TableManager::validateRow(
 
 // Select all rows from a table
 QVector<QVector<QString>> TableManager::selectAll(const QString& tableName) const {
-    return tableData.value(tableName.toLower());
+    return scanRows(tableName).rows->liveRows();
+}
+
+TableScan TableManager::scanRows(const QString& tableName, int timeoutMs) const {
+    return TableScan(*this, tableName.toLower(), timeoutMs);
+}
+
+TableLocks TableManager::lockTables(const QStringList& readTables, const QStringList& writeTables,
+                                    int timeoutMs) const {
+    return TableLocks(*this, LatchHold::Shared, readTables, writeTables, timeoutMs);
+}
+
+TableLocks TableManager::lockCatalog(const QStringList& tables, int timeoutMs) const {
+    QDeadlineTimer deadline(timeoutMs);
+    // The tables are waited for before the catalog is taken, so other sessions' statements
+    // keep running while a transaction finishes with one of them. One taken again in
+    // between is waited for under the catalog, for what is left of the timeout.
+    for (const QString& name : tables) {
+        std::shared_ptr<TableLatch> latch;
+        {
+            QMutexLocker locker(&dataMutex);
+            latch = latches.value(name.toLower());
+        }
+        LatchHold wait(latch.get(), LatchHold::Exclusive, static_cast<int>(deadline.remainingTime()));
+        if (wait.timedOut()) {
+            break;
+        }
+    }
+    return TableLocks(*this, LatchHold::Exclusive, QStringList(), tables, static_cast<int>(deadline.remainingTime()));
+}
+
+int TableManager::committedVersionCount() const {
+    QMutexLocker locker(&dataMutex);
+    return committedVersions.size();
+}
+
+std::vector<std::unique_ptr<TableScan>> TableManager::scanTables(const QStringList& tableNames, int timeoutMs) const {
+    QDeadlineTimer deadline(timeoutMs);
+    // Scanned in name order, like lockTables, whatever order the statement names them in
+    QVector<int> order(tableNames.size());
+    for (int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return tableNames[a].toLower() < tableNames[b].toLower();
+    });
+    
+    while (true) {
+        quint64 ends = 0;
+        {
+            QMutexLocker locker(&dataMutex);
+            ends = uncommittedEnds;
+        }
+        std::vector<std::unique_ptr<TableScan>> scans(tableNames.size());
+        bool committedRead = false;
+        for (int i : order) {
+            scans[i].reset(new TableScan(*this, tableNames[i].toLower(), static_cast<int>(deadline.remainingTime())));
+            if (scans[i]->timedOut()) {
+                return {};
+            }
+            committedRead = committedRead || scans[i]->isSnapshot();
+        }
+        // Rows read as last committed before a transaction ended would not match a table
+        // latched after it; the scans are taken again until no transaction ends in between
+        QMutexLocker locker(&dataMutex);
+        if (!committedRead || uncommittedEnds == ends) {
+            return scans;
+        }
+        if (deadline.hasExpired()) {
+            return {};
+        }
+    }
+}
+
+void TableManager::keepCommittedVersion(const QString& key) {
+    // Shares the columns with the table until the changes copy the ones they touch
+    committedVersions.insert(key, tableData.value(key));
+}
+
+void TableManager::dropCommittedVersion(const QString& key) {
+    if (committedVersions.remove(key)) {
+        ++uncommittedEnds;
+    }
 }
 
 // Select all rows as maps (column name -> value)
@@ -471,9 +1504,10 @@ QVector<QMap<QString, QString>> TableManager::selectAllAsMap(const QString& tabl
         return result;
     }
     
-    const auto& rows = tableData.value(tableName.toLower());
+    auto rows = scanRows(tableName);
     const auto& columns = schema->getColumns();
     
+    result.reserve(rows.size());
     for (const auto& row : rows) {
         QMap<QString, QString> rowMap;
         for (int i = 0; i < columns.size() && i < row.size(); ++i) {
@@ -2,12 +2,28 @@
 
 #include "table_schema.h"
 #include "value.h"
+#include "row_store.h"
+#include "table_latch.h"
 #include <QString>
 #include <QMap>
 #include <QVector>
+#include <QPair>
+#include <QSet>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QStringList>
 #include <memory>
+#include <vector>
 
 class StorageEngine;
+class Checkpointer;
+class Index;
+class IndexKey;
+class HashIndex;
+class WriteAheadLog;
+class TableManager;
+class TransactionManager;
+struct WalRecord;
 
 /**
  * @brief Result of row operation (INSERT, UPDATE, DELETE)
@@ -16,65 +32,323 @@ struct OperationResult {
     bool success;
     QString errorMessage;
     int rowsAffected;
-    int rowId;
+    qint64 rowId;
     
-    OperationResult(bool ok = true, const QString& msg = "", int rows = 0, int id = -1)
+    OperationResult(bool ok = true, const QString& msg = "", int rows = 0, qint64 id = -1)
         : success(ok), errorMessage(msg), rowsAffected(rows), rowId(id) {}
 };
 
+/**
+ * @brief Guarded in-place view of one table's rows
+ *
+ * Holds the table's latch shared for its lifetime, so the rows it exposes
+ * cannot be modified or reallocated while it is alive; scans of the same
+ * table on other threads proceed in parallel. Rows are stored by column:
+ * operator[] assembles a row's text, while valueAt and column() read
+ * single cells without building the row. Release the scan (let it go out
+ * of scope) before calling a mutating TableManager method from the same
+ * thread, unless the statement already holds the table exclusively
+ * through TableManager::lockTables. A thread that needs several tables at
+ * once (a join) scans them together with TableManager::scanTables.
+ *
+ * A scan never waits for a table a writer holds (a statement, or a
+ * transaction or bulk load until it ends): it reads the rows as last
+ * committed, as a snapshot, and index lookups do not apply to it (the
+ * indexes follow the live table). With a timeout, a scan that cannot
+ * latch the catalog in time holds nothing, is empty and reports
+ * timedOut().
+ *
+ * A read-only statement can switch the scan to a snapshot with
+ * takeSnapshot() once it has done what needs the live table (index
+ * lookups): the scan keeps the table's current version and releases the
+ * latches, so writers no longer wait for it and it keeps seeing the rows
+ * as they were (see takeSnapshot).
+ *
+ * Iteration visits live rows only. Slot access (slotCount, isLive,
+ * operator[]) also sees tombstones; slots stay valid for the life of the
+ * scan, row ids for the life of the row.
+ */
+class TableScan {
+public:
+    TableScan(const TableScan&) = delete;
+    TableScan& operator=(const TableScan&) = delete;
+    
+    int size() const { return rows->size(); }
+    bool isEmpty() const { return rows->isEmpty(); }
+    
+    int slotCount() const { return rows->slotCount(); }
+    bool isLive(int slot) const { return rows->isLive(slot); }
+    QVector<QString> operator[](int slot) const { return rows->rowAt(slot); }
+    QString valueAt(int slot, int column) const { return rows->valueAt(slot, column); }
+    int columnCount() const { return rows->columnCount(); }
+    const ColumnVector& column(int column) const { return rows->column(column); }
+    qint64 rowIdAt(int slot) const { return rows->rowIdAt(slot); }
+    // Slot of a live row, or -1
+    int slotOf(qint64 rowId) const { return rows->slotOf(rowId); }
+    std::optional<QVector<QString>> find(qint64 rowId) const { return rows->find(rowId); }
+    // First slot whose row id is >= rowId (slotCount() if none)
+    int lowerBound(qint64 rowId) const { return rows->lowerBound(rowId); }
+    
+    RowStore::const_iterator begin() const { return rows->begin(); }
+    RowStore::const_iterator end() const { return rows->end(); }
+    
+    // Keeps the table's current version and releases the latches (multi-version reads).
+    // The copy is cheap: its columns stay shared with the table until a writer changes
+    // them, and only the arrays a writer touches are copied, once per version still held.
+    // The old version is freed with the last snapshot that holds it. Slots and row ids
+    // stay as they were; iterators taken before must not be used afterwards.
+    void takeSnapshot();
+    bool isSnapshot() const { return rows == &snapshot; }
+    // The catalog could not be had within the timeout; the scan is empty
+    bool timedOut() const { return expired; }
+    
+private:
+    friend class TableManager;
+    // The latches are taken before the table is looked up
+    TableScan(const TableManager& manager, const QString& key, int timeoutMs);
+    
+    LatchHold catalogHold;
+    std::unique_ptr<LatchHold> tableHold;
+    RowStore snapshot;
+    const RowStore* rows;
+    bool expired = false;
+};
+
+/**
+ * @brief Latches on a set of tables, held for the length of one statement
+ *
+ * Tables are latched in name order whatever order the statement names
+ * them in, so statements that latch overlapping sets cannot deadlock.
+ * Reads share a table with other readers; writes hold it exclusively,
+ * which also keeps the rows a statement scanned unchanged until it has
+ * applied its changes. The catalog is held shared throughout, so the
+ * tables cannot be dropped underneath the statement; a statement that
+ * changes the catalog holds it exclusively instead, together with the
+ * table it changes (lockCatalog).
+ *
+ * With a timeout, a latch that cannot be had in time releases the ones
+ * already taken and acquired() turns false.
+ */
+class TableLocks {
+public:
+    TableLocks(const TableLocks&) = delete;
+    TableLocks& operator=(const TableLocks&) = delete;
+    
+    // Releases every latch early, e.g. once the statement's scans are snapshots
+    void release();
+    bool acquired() const { return !expired; }
+    
+private:
+    friend class TableManager;
+    TableLocks(const TableManager& manager, LatchHold::Mode catalogMode, const QStringList& readTables,
+               const QStringList& writeTables, int timeoutMs);
+    
+    LatchHold catalogHold;
+    std::vector<std::unique_ptr<LatchHold>> tableHolds;
+    bool expired = false;
+};
+
 /**
  * @brief Manages all tables in the database with constraint enforcement
+ *
+ * Safe to use from several threads. Each table has a reader-writer latch:
+ * scans share it, row mutations hold it exclusively. The catalog (the set
+ * of tables and their schemas) has a latch of its own that every table
+ * access holds shared and that CREATE TABLE, CREATE INDEX and table
+ * removal hold exclusively. Latches are always taken catalog first, then
+ * tables in name order; the data mutex and index lock are taken last and
+ * briefly, and the checkpointer never waits for a table latch.
+ *
+ * Reads can also run on snapshots (TableScan::takeSnapshot): a table's rows
+ * are held in implicitly shared arrays, so a snapshot is a cheap copy of the
+ * current version, and a writer that changes an array a snapshot still
+ * holds writes to a new copy. Each snapshot keeps its version alive and
+ * consistent for as long as it needs, without holding a latch.
+ *
+ * Row mutations given a TransactionManager belong to that transaction:
+ * they are applied at once, but their log records wait in the transaction
+ * until commitTransaction, and their before-images let
+ * rollbackTransaction undo them. The transaction keeps the tables it
+ * changed latched until it ends, and checkpoints leave those tables alone
+ * meanwhile; scans from other sessions read the rows those tables had
+ * before the transaction changed them.
  */
 class TableManager {
 public:
+    // How long a statement waits for a table or the catalog another session holds
+    static constexpr int LOCK_WAIT_TIMEOUT_MS = 5000;
+    
     TableManager(const QString& dataPath = "./data");
-    virtual ~TableManager() = default;
+    virtual ~TableManager();
+    
+    // Directory holding the table files and the write-ahead log
+    QString getDataPath() const;
     
     // Persistence
     void loadAllTables();
-    void saveAllTables();
+    void saveAllTables();   // Same as checkpoint()
+    
+    // Writes tables changed since the last checkpoint and drops the WAL segments they cover.
+    // Called periodically from the background Checkpointer.
+    bool checkpoint();
     
     // Table management
     void addTable(const std::shared_ptr<TableSchema>& schema);
     std::shared_ptr<TableSchema> getTable(const QString& tableName) const;
     bool tableExists(const QString& tableName) const;
-    void removeTable(const QString& tableName);
+    // Waits a bounded time for statements and transactions using the table; false if it
+    // is still in use then
+    bool removeTable(const QString& tableName);
     
-    const QMap<QString, std::shared_ptr<TableSchema>>& getTables() const {
-        return tables;
-    }
+    // A copy, so it can be read while other threads create tables
+    QMap<QString, std::shared_ptr<TableSchema>> getTables() const;
     
     // Row operations with constraint enforcement
     OperationResult insertRow(const QString& tableName, const QVector<QString>& values);
     OperationResult insertRow(const QString& tableName, const QMap<QString, QString>& columnValues);
+    // Multi-row INSERT: validated as a set (including keys repeated within the batch),
+    // logged in one write and appended together. Row ids are consecutive from rowId.
+    OperationResult insertRows(const QString& tableName, const QVector<QVector<QString>>& rows,
+                               TransactionManager* transaction = nullptr);
+    
+    // Bulk loading (COPY FROM). Rows inserted between begin and finish are still
+    // validated but skip the WAL, and non-unique secondary indexes are rebuilt once
+    // at the end; finish checkpoints the table so the load becomes durable in one
+    // sequential write. abort drops every row added since begin.
+    bool beginBulkLoad(const QString& tableName);
+    bool finishBulkLoad(const QString& tableName);
+    void abortBulkLoad(const QString& tableName);
+    
+    // Rows are addressed by the stable id returned from insertRow
+    OperationResult updateRow(const QString& tableName, qint64 rowId, const QVector<QString>& values);
+    OperationResult updateRow(const QString& tableName, qint64 rowId, const QMap<QString, QString>& columnValues);
     
-    OperationResult updateRow(const QString& tableName, int rowId, const QVector<QString>& values);
-    OperationResult updateRow(const QString& tableName, int rowId, const QMap<QString, QString>& columnValues);
+    // Leaves a tombstone; tombstones are vacuumed once they pile up and at each checkpoint
+    OperationResult deleteRow(const QString& tableName, qint64 rowId);
     
-    OperationResult deleteRow(const QString& tableName, int rowId);
+    // Statement-level mutations: every row is validated first (uniqueness across the
+    // whole set), then all changes are logged in one write and applied together.
+    // Nothing is changed when any row fails.
+    OperationResult updateRows(const QString& tableName, const QVector<QPair<qint64, QVector<QString>>>& updates,
+                               TransactionManager* transaction = nullptr);
+    OperationResult deleteRows(const QString& tableName, const QVector<qint64>& rowIds,
+                               TransactionManager* transaction = nullptr);
+    
+    // Ending a transaction (called by TransactionManager). Commit logs the transaction's
+    // records in one write and flushes the log once; rollback applies its undo log in reverse.
+    bool commitTransaction(TransactionManager& transaction, QString& errorMessage);
+    void rollbackTransaction(TransactionManager& transaction);
+    
+    // Secondary indexes
+    OperationResult createIndex(const QString& tableName, const QString& indexName,
+                                const QStringList& columns, bool unique = false);
+    std::shared_ptr<Index> getIndex(const QString& tableName, const QString& indexName) const;
+    QVector<std::shared_ptr<Index>> getIndexes(const QString& tableName) const;
+    // Index whose key is exactly the given columns, or nullptr
+    std::shared_ptr<Index> findIndex(const QString& tableName, const QStringList& columns) const;
     
     // Data retrieval
     QVector<QVector<QString>> selectAll(const QString& tableName) const;
+    // Rows of a table scanned in place under its latch, without copying the table, or
+    // as last committed while a writer holds it. Waits at most timeoutMs for the catalog
+    // (forever when negative)
+    TableScan scanRows(const QString& tableName, int timeoutMs = -1) const;
+    // Latches the tables a statement reads and writes until the result is destroyed,
+    // waiting at most timeoutMs for each (forever when negative)
+    TableLocks lockTables(const QStringList& readTables, const QStringList& writeTables = QStringList(),
+                          int timeoutMs = -1) const;
+    // Latches the catalog exclusively, as CREATE TABLE and CREATE INDEX need it, and the
+    // given tables with it. The tables are waited for first, with the catalog still free
+    TableLocks lockCatalog(const QStringList& tables = QStringList(), int timeoutMs = -1) const;
+    // Scans of several tables at once (a join), taken in name order, all showing the
+    // tables as of the same moment. Empty when the catalog could not be had within timeoutMs
+    std::vector<std::unique_ptr<TableScan>> scanTables(const QStringList& tableNames, int timeoutMs = -1) const;
     QVector<QMap<QString, QString>> selectAllAsMap(const QString& tableName) const;
+    // Versions kept as last committed for readers: one per table a transaction or bulk
+    // load is changing, dropped when it ends
+    int committedVersionCount() const;
     
     // Constraint validation
     bool validateRow(const QString& tableName, const QVector<QString>& values, QString& errorMessage) const;
     QString getLastError() const { return lastError; }
     
 private:
+    friend class TableScan;
+    friend class TableLocks;
+    
     QMap<QString, std::shared_ptr<TableSchema>> tables;
-    QMap<QString, QVector<QVector<QString>>> tableData;  // table name -> rows
+    QMap<QString, RowStore> tableData;  // table name -> rows by row id
     std::shared_ptr<StorageEngine> storageEngine;
+    std::unique_ptr<WriteAheadLog> wal;
+    std::unique_ptr<Checkpointer> checkpointer;
+    QMap<QString, quint64> checkpointLsns;  // table name -> last WAL record in its data file
+    QSet<QString> dirtyTables;              // Changed since their last checkpoint
+    QMap<QString, qint64> bulkLoads;        // table name -> first row id of a running bulk load
+    QSet<QString> transactionTables;        // Changed by a transaction that has not ended
+    // Rows as last committed of the tables in transactionTables and bulkLoads
+    QMap<QString, RowStore> committedVersions;
+    quint64 uncommittedEnds = 0;            // Entries dropped from committedVersions so far
+    QMap<QString, QMap<QString, std::shared_ptr<Index>>> indexes;  // table -> index name -> index
+    QMap<QString, QVector<std::shared_ptr<HashIndex>>> constraintIndexes;  // table -> PK/UNIQUE indexes
+    QMap<QString, std::shared_ptr<TableLatch>> latches;  // table -> latch
+    
+    // Guards tables, tableData and latches as maps; a table's rows are guarded by its latch
+    mutable TableLatch catalogLatch;
+    // Rows are mutated only under their table's exclusive latch; dataMutex orders those
+    // mutations against the checkpointer's snapshot (which takes no table latch) and
+    // guards the WAL and the dirty/bulk-load/transaction bookkeeping (with the committed
+    // versions), checkpointMutex serializes
+    // checkpoints
+    mutable QMutex dataMutex;
+    QMutex checkpointMutex;
+    // Guards indexes and constraintIndexes as maps; the indexes themselves follow their table's latch
+    mutable QReadWriteLock indexLock;
     mutable QString lastError;
     
+    // Latch of a table, or nullptr; callers hold the catalog latch
+    TableLatch* latchOf(const QString& key) const;
+    // Copies of a table's index lists, so they can be used without holding indexLock
+    QMap<QString, std::shared_ptr<Index>> indexesOf(const QString& tableName) const;
+    QVector<std::shared_ptr<HashIndex>> constraintIndexesOf(const QString& tableName) const;
+    
     // Helper methods
     QMap<QString, QString> mapColumnsToValues(const QString& tableName, 
                                               const QVector<QString>& values) const;
     bool validateUniqueConstraints(const QString& tableName, 
-                                   const QMap<QString, QString>& columnValues,
+                                   const QVector<QString>& values,
                                    QString& errorMessage,
-                                   int excludeRowId = -1) const;
+                                   qint64 excludeRowId = -1) const;
     bool validateForeignKeyConstraints(const QString& tableName,
                                        const QMap<QString, QString>& columnValues,
                                        QString& errorMessage) const;
+    
+    // Index maintenance
+    std::shared_ptr<Index> buildIndex(const QString& tableName, const IndexDefinition& definition,
+                                      QString& errorMessage) const;
+    void rebuildIndexes(const QString& tableName);
+    void rebuildConstraintIndexes(const QString& tableName);
+    IndexKey indexKeyForRow(const QString& tableName, const Index& index, const QVector<QString>& row) const;
+    // PRIMARY KEY/UNIQUE checks for a set of new row images; rows in replacedRowIds
+    // give up their current keys
+    bool validateUniqueBatch(const QString& tableName, const QVector<QVector<QString>>& newRows,
+                             const QSet<qint64>& replacedRowIds, QString& errorMessage) const;
+    void indexRowInserted(const QString& tableName, const QVector<QString>& row, qint64 rowId, bool bulkLoading);
+    void indexRowUpdated(const QString& tableName, const QVector<QString>& oldRow,
+                         const QVector<QString>& newRow, qint64 rowId);
+    void indexRowDeleted(const QString& tableName, const QVector<QString>& row, qint64 rowId);
+    
+    // Latches a table the transaction is about to change until the transaction ends;
+    // the running statement already holds it exclusively for the transaction
+    void enlist(TransactionManager& transaction, const QString& key);
+    // Keeps the rows of a table as they are before uncommitted changes start, and
+    // drops them once the changes are committed or undone; callers hold dataMutex
+    void keepCommittedVersion(const QString& key);
+    void dropCommittedVersion(const QString& key);
+    
+    // Write-ahead logging
+    bool logMutation(WalRecord& record);
+    // A transaction's records are kept with it until it commits
+    bool logMutations(QVector<WalRecord>& records, TransactionManager* transaction = nullptr);
+    int replayLog();
+    void checkpointIfNeeded(const QString& tableName);
 };
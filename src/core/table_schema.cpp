@@ -36,6 +36,15 @@ int TableSchema::getColumnIndex(const QString& columnName) const {
     return -1;
 }
 
+QVector<DataType> TableSchema::getColumnTypes() const {
+    QVector<DataType> types;
+    types.reserve(columns.size());
+    for (const auto& column : columns) {
+        types.append(column.getType());
+    }
+    return types;
+}
+
 void TableSchema::addPrimaryKey(const QStringList& columnNames) {
     primaryKeyColumns = columnNames;
     
@@ -113,6 +122,29 @@ bool TableSchema::validateRow(const QVector<QString>& values) const {
     return true;
 }
 
+void TableSchema::addIndexDefinition(const IndexDefinition& definition) {
+    removeIndexDefinition(definition.name);
+    indexDefinitions.append(definition);
+}
+
+void TableSchema::removeIndexDefinition(const QString& indexName) {
+    for (int i = 0; i < indexDefinitions.size(); ++i) {
+        if (indexDefinitions[i].name.toLower() == indexName.toLower()) {
+            indexDefinitions.removeAt(i);
+            return;
+        }
+    }
+}
+
+bool TableSchema::hasIndexDefinition(const QString& indexName) const {
+    for (const auto& definition : indexDefinitions) {
+        if (definition.name.toLower() == indexName.toLower()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool TableSchema::validateColumn(const QString& columnName, const QString& value) const {
     const Column* col = getColumn(columnName);
     if (!col) {
@@ -170,6 +202,7 @@ QString TableSchema::toJson() const {
     tableObj["name"] = tableName;
     tableObj["description"] = metadata.description;
     tableObj["rowCount"] = metadata.rowCount;
+    tableObj["schemaVersion"] = metadata.schemaVersion;
     tableObj["isTemp"] = metadata.isTemp;
     
     // Columns array
@@ -235,6 +268,23 @@ QString TableSchema::toJson() const {
     
     tableObj["constraints"] = constraintsObj;
     
+    // Secondary indexes
+    if (!indexDefinitions.isEmpty()) {
+        QJsonArray indexesArray;
+        for (const auto& definition : indexDefinitions) {
+            QJsonObject indexObj;
+            QJsonArray cols;
+            for (const auto& col : definition.columns) {
+                cols.append(col);
+            }
+            indexObj["name"] = definition.name;
+            indexObj["columns"] = cols;
+            indexObj["unique"] = definition.unique;
+            indexesArray.append(indexObj);
+        }
+        tableObj["indexes"] = indexesArray;
+    }
+    
     QJsonDocument doc(tableObj);
     return QString::fromUtf8(doc.toJson());
 }
@@ -255,6 +305,8 @@ TableSchema* TableSchema::fromJson(const QString& json) {
         QJsonObject colObj = colVal.toObject();
         Column col(colObj["name"].toString(), 
                   DataTypeManager::stringToType(colObj["type"].toString()));
+        col.setPrimaryKey(colObj["primaryKey"].toBool(false));
+        col.setUnique(colObj["unique"].toBool(false));
         col.setNullable(colObj["nullable"].toBool(true));
         col.setDescription(colObj["description"].toString());
         schema->addColumn(col);
@@ -273,9 +325,37 @@ TableSchema* TableSchema::fromJson(const QString& json) {
         schema->addPrimaryKey(pkCols);
     }
     
+    // Unique constraints
+    QJsonObject uniqueObj = constraintsObj["unique"].toObject();
+    for (const auto& name : uniqueObj.keys()) {
+        QStringList uniqueCols;
+        for (const auto& col : uniqueObj[name].toArray()) {
+            uniqueCols.append(col.toString());
+        }
+        if (!uniqueCols.isEmpty()) {
+            schema->addUnique(name, uniqueCols);
+        }
+    }
+    
+    // Secondary indexes
+    QJsonArray indexesArray = tableObj["indexes"].toArray();
+    for (const auto& indexVal : indexesArray) {
+        QJsonObject indexObj = indexVal.toObject();
+        IndexDefinition definition;
+        definition.name = indexObj["name"].toString();
+        definition.unique = indexObj["unique"].toBool(false);
+        for (const auto& col : indexObj["columns"].toArray()) {
+            definition.columns.append(col.toString());
+        }
+        if (!definition.name.isEmpty() && !definition.columns.isEmpty()) {
+            schema->addIndexDefinition(definition);
+        }
+    }
+    
     // Load metadata
     schema->setDescription(tableObj["description"].toString());
     schema->setRowCount(tableObj["rowCount"].toInt(0));
+    schema->metadata.schemaVersion = tableObj["schemaVersion"].toInt(1);
     
     return schema;
 }
@@ -16,12 +16,22 @@ struct TableMetadata {
     QDateTime lastModifiedAt;
     QString createdBy;
     int rowCount = 0;
+    int schemaVersion = 1;      // Bumped on layout changes; stamped into table file headers
     bool isTemp = false;
     
     TableMetadata() : createdAt(QDateTime::currentDateTime()), 
                      lastModifiedAt(QDateTime::currentDateTime()) {}
 };
 
+/**
+ * @brief Persisted definition of a secondary index (CREATE INDEX)
+ */
+struct IndexDefinition {
+    QString name;
+    QStringList columns;
+    bool unique = false;
+};
+
 /**
  * @brief Represents the schema of a table
  */
@@ -36,6 +46,7 @@ public:
     int getColumnIndex(const QString& columnName) const;
     int getColumnCount() const { return columns.size(); }
     const QVector<Column>& getColumns() const { return columns; }
+    QVector<DataType> getColumnTypes() const;
     
     // Table identification
     QString getTableName() const { return tableName; }
@@ -54,6 +65,12 @@ public:
     QMap<QString, ForeignKeyConstraint*> getForeignKeyConstraints() const { return foreignKeys; }
     QMap<QString, CheckConstraint*> getCheckConstraints() const { return checkConstraints; }
     
+    // Secondary index definitions
+    void addIndexDefinition(const IndexDefinition& definition);
+    void removeIndexDefinition(const QString& indexName);
+    bool hasIndexDefinition(const QString& indexName) const;
+    QVector<IndexDefinition> getIndexDefinitions() const { return indexDefinitions; }
+    
     // Constraint validation
     bool validateRow(const QVector<QString>& values) const;
     bool validateColumn(const QString& columnName, const QString& value) const;
@@ -83,6 +100,7 @@ private:
     QMap<QString, QStringList> uniqueConstraints;  // constraintName -> columnNames
     QMap<QString, ForeignKeyConstraint*> foreignKeys;  // constraintName -> constraint
     QMap<QString, CheckConstraint*> checkConstraints;  // constraintName -> constraint
+    QVector<IndexDefinition> indexDefinitions;
     
     mutable QString lastValidationError;
     
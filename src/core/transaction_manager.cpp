@@ -1,20 +1,70 @@
 #include "transaction_manager.h"
+#include "../utils/logger.h"
 
-TransactionManager::TransactionManager() : inTransaction(false) {
+TransactionManager::TransactionManager(std::shared_ptr<TableManager> tableManager)
+    : tableManager(std::move(tableManager)), inTransaction(false) {
 }
 
-void TransactionManager::beginTransaction() {
+TransactionManager::~TransactionManager() {
+    if (inTransaction) {
+        Logger::instance().info("Rolling back a transaction left open");
+        rollback();
+    }
+}
+
+void TransactionManager::setTableManager(std::shared_ptr<TableManager> manager) {
+    if (manager == tableManager) {
+        return;
+    }
+    if (inTransaction) {
+        rollback();
+    }
+    tableManager = std::move(manager);
+}
+
+OperationResult TransactionManager::beginTransaction() {
+    if (!tableManager) {
+        return OperationResult{false, "No table manager", 0, -1};
+    }
+    if (inTransaction) {
+        return OperationResult{false, "A transaction is already in progress", 0, -1};
+    }
     inTransaction = true;
-    rollbackLog.clear();
+    return OperationResult{true, "", 0, -1};
 }
 
-void TransactionManager::commit() {
-    inTransaction = false;
-    rollbackLog.clear();
+OperationResult TransactionManager::commit() {
+    if (!inTransaction) {
+        return OperationResult{false, "No transaction in progress", 0, -1};
+    }
+    // Acting for the transaction, the latches it holds are taken again without waiting
+    TableLatch::HolderScope holder(this);
+    int changes = undoLog.size();
+    QString error;
+    if (!tableManager->commitTransaction(*this, error)) {
+        rollback();
+        return OperationResult{false, QString("COMMIT failed, transaction rolled back: %1").arg(error), 0, -1};
+    }
+    finish();
+    return OperationResult{true, "", changes, -1};
+}
+
+OperationResult TransactionManager::rollback() {
+    if (!inTransaction) {
+        return OperationResult{false, "No transaction in progress", 0, -1};
+    }
+    TableLatch::HolderScope holder(this);
+    int changes = undoLog.size();
+    tableManager->rollbackTransaction(*this);
+    finish();
+    return OperationResult{true, "", changes, -1};
 }
 
-void TransactionManager::rollback() {
-    // To be implemented in Phase 8
+void TransactionManager::finish() {
+    undoLog.clear();
+    redoLog.clear();
+    changedTables.clear();
+    latchHolds.clear();
+    latches.clear();
     inTransaction = false;
-    rollbackLog.clear();
 }
@@ -1,23 +1,76 @@
 #pragma once
 
+#include "table_manager.h"
+#include "../storage/write_ahead_log.h"
 #include <QString>
 #include <QVector>
+#include <QSet>
+#include <memory>
+#include <vector>
 
 /**
- * @brief Manages database transactions
+ * @brief One session's transaction: BEGIN ... COMMIT or ROLLBACK
+ *
+ * Statements inside a transaction change the tables at once, so the
+ * transaction reads its own writes, but their redo records are kept here
+ * instead of going to the write-ahead log: COMMIT logs them all in one
+ * write and flushes the log once, however many statements and rows the
+ * transaction changed. Each change also leaves its before-image in an
+ * in-memory undo log, which ROLLBACK applies in reverse order.
+ *
+ * A table the transaction changes stays latched exclusively by it until it
+ * ends, so no checkpoint writes uncommitted rows and other sessions read
+ * the table as last committed meanwhile; tables it only reads are latched
+ * for one statement at a time, and the catalog likewise only while each
+ * statement runs. Statements run while the transaction is open must
+ * act for it (TableLatch::HolderScope) and wait at most
+ * TableManager::LOCK_WAIT_TIMEOUT_MS for a latch: two transactions waiting for each other's tables give up instead
+ * of deadlocking. COMMIT and ROLLBACK act for it too and take no latch
+ * beyond the tables it already holds, so ending a transaction never waits
+ * for another session. Destroying an open transaction rolls it back.
  */
 class TransactionManager {
 public:
-    TransactionManager();
-    
+    explicit TransactionManager(std::shared_ptr<TableManager> tableManager = nullptr);
+    ~TransactionManager();
+
+    TransactionManager(const TransactionManager&) = delete;
+    TransactionManager& operator=(const TransactionManager&) = delete;
+
+    // Rolls back a transaction still open on the previous table manager
+    void setTableManager(std::shared_ptr<TableManager> manager);
+
     bool isInTransaction() const { return inTransaction; }
-    
-    // To be implemented in Phase 8
-    void beginTransaction();
-    void commit();
-    void rollback();
-    
+    // Rows changed so far (undo records)
+    int changeCount() const { return undoLog.size(); }
+
+    OperationResult beginTransaction();
+    // Makes every change durable with one log write and flush, then releases the tables.
+    // If the changes cannot be logged and synced the transaction is rolled back instead,
+    // and the result reports the COMMIT as failed.
+    OperationResult commit();
+    OperationResult rollback();
+
 private:
+    friend class TableManager;
+
+    // Before-image of one changed row
+    struct UndoRecord {
+        WalRecord::Operation operation;     // The change being undone
+        QString tableName;
+        qint64 rowId;
+        QVector<QString> oldRow;            // Empty for INSERT
+    };
+
+    std::shared_ptr<TableManager> tableManager;
     bool inTransaction;
-    QVector<QString> rollbackLog;
+    QVector<UndoRecord> undoLog;
+    QVector<WalRecord> redoLog;             // Logged at COMMIT
+    QSet<QString> changedTables;
+    // Exclusive holds on changedTables; the latches are kept alive with them
+    std::vector<std::shared_ptr<TableLatch>> latches;
+    std::vector<std::unique_ptr<LatchHold>> latchHolds;
+
+    // Forgets the changes and releases the tables
+    void finish();
 };
@@ -70,6 +70,25 @@ int main(int argc, char* argv[]) {
         
         // Start Server
         DatabaseServer server(tableManager);
+        
+        // --workers N sets the query thread pool size (default: one per core)
+        int workersArg = app.arguments().indexOf("--workers");
+        if (workersArg >= 0 && workersArg + 1 < app.arguments().size()) {
+            bool ok = false;
+            int workers = app.arguments().at(workersArg + 1).toInt(&ok);
+            if (ok && workers > 0) {
+                server.setWorkerCount(workers);
+            } else {
+                LOG_WARNING("Ignoring invalid --workers value");
+            }
+        }
+        
+        // --copy-dir DIR lets clients COPY files in DIR (COPY is refused otherwise)
+        int copyDirArg = app.arguments().indexOf("--copy-dir");
+        if (copyDirArg >= 0 && copyDirArg + 1 < app.arguments().size()) {
+            server.setCopyDirectory(app.arguments().at(copyDirArg + 1));
+        }
+        
         if (server.start(8081)) {
             LOG_INFO("Database Server is running. Press Ctrl+C to stop.");
             return app.exec();
@@ -13,6 +13,41 @@ public:
     virtual ~ASTNode() = default;
 };
 
+// Expression tree for WHERE conditions
+class Expression {
+public:
+    enum Kind {
+        COLUMN,                       // value = column name, qualifier = optional table
+        LITERAL,                      // value = literal text
+        NULL_LITERAL,                 // NULL
+        UNARY,                        // op applied to children[0]
+        BINARY,                       // children[0] op children[1]
+        IN_LIST,                      // children[0] IN (children[1..])
+        BETWEEN,                      // children[0] BETWEEN children[1] AND children[2]
+        LIKE,                         // children[0] LIKE children[1]
+        IS_NULL,                      // children[0] IS NULL
+        AGGREGATE                     // value = function (COUNT, SUM, ...), children[0] = column, none for COUNT(*)
+    };
+    
+    enum Operator {
+        NONE,
+        EQ, NE, LT, LE, GT, GE,       // Comparison
+        AND, OR, NOT,                 // Logical
+        PLUS, MINUS, MULTIPLY, DIVIDE, MODULO, NEGATE  // Arithmetic
+    };
+    
+    Kind kind = LITERAL;
+    Operator op = NONE;
+    QString value;
+    QString qualifier;
+    bool stringLiteral = false;       // Literal was quoted
+    bool negated = false;             // NOT IN, NOT BETWEEN, NOT LIKE, IS NOT NULL
+    QVector<std::shared_ptr<Expression>> children;
+    
+    Expression(Kind k = LITERAL, Operator o = NONE, const QString& v = "")
+        : kind(k), op(o), value(v) {}
+};
+
 // Column Definition for CREATE TABLE
 class ColumnDefinition {
 public:
@@ -27,15 +62,86 @@ public:
         : name(n), dataType(t) {}
 };
 
+// Select-list term: a column, or an aggregate over one
+class SelectItem {
+public:
+    enum Aggregate {
+        NONE,
+        COUNT, SUM, AVG, MIN, MAX
+    };
+    
+    QString column;                   // Column name, possibly "table.column"; empty for COUNT(*)
+    Aggregate aggregate = NONE;
+    
+    SelectItem(const QString& c = "", Aggregate a = NONE)
+        : column(c), aggregate(a) {}
+    
+    // Function called by name (any case), NONE when it is not an aggregate
+    static Aggregate aggregateNamed(const QString& name) {
+        for (int function = COUNT; function <= MAX; ++function) {
+            if (name.compare(functionName(static_cast<Aggregate>(function)), Qt::CaseInsensitive) == 0) {
+                return static_cast<Aggregate>(function);
+            }
+        }
+        return NONE;
+    }
+    
+    static QString functionName(Aggregate aggregate) {
+        static const char* const names[] = {"", "COUNT", "SUM", "AVG", "MIN", "MAX"};
+        return QString(names[aggregate]);
+    }
+    
+    // Result column header: the column, or the call as written, e.g. "SUM(price)"
+    QString label() const {
+        if (aggregate == NONE) {
+            return column;
+        }
+        return QString("%1(%2)").arg(functionName(aggregate), column.isEmpty() ? QString("*") : column);
+    }
+};
+
+// ORDER BY term
+class OrderByItem {
+public:
+    QString column;
+    bool descending = false;
+    SelectItem::Aggregate aggregate = SelectItem::NONE;  // Ordering by an aggregate of column
+    
+    OrderByItem(const QString& c = "", bool desc = false)
+        : column(c), descending(desc) {}
+};
+
+// JOIN clause of a SELECT
+class JoinClause {
+public:
+    enum Type {
+        INNER,
+        LEFT                          // LEFT [OUTER] JOIN
+    };
+    
+    Type type = INNER;
+    QString table;                    // Joined table
+    QString alias;                    // Alias (empty = the table name)
+    QString onClause;                 // ON condition
+    std::shared_ptr<Expression> on;   // Parsed ON condition
+};
+
 // SELECT Statement
 class SelectStatement : public ASTNode {
 public:
-    QStringList columns;              // Column names or "*"
+    QStringList columns;              // Column names or "*"; aggregates by their label
+    QVector<SelectItem> items;        // Parsed select list (empty for "*")
     QString fromTable;                // Table name
+    QString fromAlias;                // Alias of fromTable (empty = the table name)
+    QVector<JoinClause> joins;        // JOIN clauses, joined left to right
     QString whereClause;              // WHERE condition
+    std::shared_ptr<Expression> where; // Parsed WHERE condition (null = all rows)
+    QStringList groupBy;              // GROUP BY columns
+    QString havingClause;             // HAVING condition
+    std::shared_ptr<Expression> having; // Parsed HAVING condition (null = all groups)
     QString orderBy;                  // ORDER BY clause
+    QVector<OrderByItem> orderByItems; // Parsed ORDER BY terms
     int limit = -1;                   // LIMIT value (-1 = no limit)
-    QString joinClause;               // JOIN clause (future)
 };
 
 // INSERT Statement
@@ -46,6 +152,18 @@ public:
     QVector<QStringList> values;      // Multiple rows of values
 };
 
+// COPY Statement (bulk load from, or export to, a server-side file)
+class CopyStatement : public ASTNode {
+public:
+    QString tableName;                // Target table
+    QStringList columns;              // Column names (optional)
+    bool toFile = false;              // COPY ... TO (export) instead of FROM
+    QString filePath;                 // File to read or write
+    QString format;                   // FORMAT option (empty = from the file extension)
+    bool header = false;              // HEADER option: first CSV line names the columns
+    QString delimiter;                // DELIMITER option (empty = comma)
+};
+
 // UPDATE Statement
 class UpdateStatement : public ASTNode {
 public:
@@ -53,6 +171,7 @@ public:
     QStringList columns;              // Column names being updated
     QStringList values;               // New values for columns
     QString whereClause;              // WHERE condition
+    std::shared_ptr<Expression> where; // Parsed WHERE condition (null = all rows)
 };
 
 // DELETE Statement
@@ -60,6 +179,7 @@ class DeleteStatement : public ASTNode {
 public:
     QString tableName;                // Target table
     QString whereClause;              // WHERE condition (recommended)
+    std::shared_ptr<Expression> where; // Parsed WHERE condition (null = all rows)
 };
 
 // CREATE TABLE Statement
@@ -218,6 +218,7 @@ Token::Type Lexer::keywordToTokenType(const QString& keyword) const {
     if (upper == "COMMIT") return Token::COMMIT;
     if (upper == "ROLLBACK") return Token::ROLLBACK;
     if (upper == "INDEX") return Token::INDEX;
+    if (upper == "COPY") return Token::COPY;
     if (upper == "CONSTRAINT") return Token::CONSTRAINT;
     if (upper == "PRIMARY") return Token::PRIMARY_KEY;
     if (upper == "UNIQUE") return Token::UNIQUE;
@@ -233,8 +234,14 @@ Token::Type Lexer::keywordToTokenType(const QString& keyword) const {
     if (upper == "DESC") return Token::DESC;
     if (upper == "LIMIT") return Token::LIMIT;
     if (upper == "OFFSET") return Token::OFFSET;
+    if (upper == "GROUP") return Token::GROUP;
+    if (upper == "HAVING") return Token::HAVING;
     if (upper == "AND") return Token::AND;
     if (upper == "OR") return Token::OR;
+    if (upper == "IN") return Token::IN;
+    if (upper == "BETWEEN") return Token::BETWEEN;
+    if (upper == "LIKE") return Token::LIKE;
+    if (upper == "IS") return Token::IS;
     if (upper == "TRUE") return Token::TRUE_KW;
     if (upper == "FALSE") return Token::FALSE_KW;
     if (upper == "NOW") return Token::IDENTIFIER;  // NOW() is a function, treated as identifier
@@ -63,14 +63,16 @@ std::unique_ptr<ASTNode> Parser::parseStatement() {
             return parseUpdateStatement();
         case Token::DELETE:
             return parseDeleteStatement();
+        case Token::COPY:
+            return parseCopyStatement();
         case Token::CREATE:
             advance();
             if (current().type == Token::TABLE) {
                 return parseCreateTableStatement();
-            } else if (current().type == Token::INDEX) {
+            } else if (current().type == Token::INDEX || current().type == Token::UNIQUE) {
                 return parseCreateIndexStatement();
             }
-            error("Expected TABLE or INDEX after CREATE");
+            error("Expected TABLE, INDEX or UNIQUE INDEX after CREATE");
             break;
         case Token::ALTER:
             return parseAlterTableStatement();
@@ -98,22 +100,39 @@ std::unique_ptr<SelectStatement> Parser::parseSelectStatement() {
         stmt->columns.append("*");
         advance();
     } else {
-        stmt->columns = parseColumnList();
+        parseSelectList(*stmt);
     }
     
     // Parse FROM clause
     if (match(Token::FROM)) {
         stmt->fromTable = parseIdentifier();
+        stmt->fromAlias = parseTableAlias();
+        
+        // Parse JOIN clauses
+        while (current().type == Token::JOIN || current().type == Token::INNER ||
+               current().type == Token::LEFT || current().type == Token::RIGHT ||
+               current().type == Token::FULL || current().type == Token::CROSS) {
+            stmt->joins.append(parseJoinClause());
+        }
     }
     
     // Parse WHERE clause
     if (current().type == Token::WHERE) {
-        stmt->whereClause = parseWhereClause();
+        stmt->where = parseConditionClause(Token::WHERE, stmt->whereClause);
+    }
+    
+    // Parse GROUP BY and HAVING clauses
+    if (match(Token::GROUP)) {
+        expect(Token::BY);
+        stmt->groupBy = parseColumnList();
+    }
+    if (current().type == Token::HAVING) {
+        stmt->having = parseConditionClause(Token::HAVING, stmt->havingClause);
     }
     
     // Parse ORDER BY clause
     if (current().type == Token::ORDER) {
-        stmt->orderBy = parseOrderByClause();
+        stmt->orderBy = parseOrderByClause(stmt->orderByItems);
     }
     
     // Parse LIMIT clause
@@ -185,7 +204,7 @@ std::unique_ptr<UpdateStatement> Parser::parseUpdateStatement() {
     
     // Parse WHERE clause (optional)
     if (current().type == Token::WHERE) {
-        stmt->whereClause = parseWhereClause();
+        stmt->where = parseConditionClause(Token::WHERE, stmt->whereClause);
     }
     
     return stmt;
@@ -201,7 +220,7 @@ std::unique_ptr<DeleteStatement> Parser::parseDeleteStatement() {
     
     // Parse WHERE clause (optional but recommended)
     if (current().type == Token::WHERE) {
-        stmt->whereClause = parseWhereClause();
+        stmt->where = parseConditionClause(Token::WHERE, stmt->whereClause);
     }
     
     return stmt;
@@ -419,7 +438,10 @@ std::unique_ptr<DropTableStatement> Parser::parseDropTableStatement() {
 std::unique_ptr<CreateIndexStatement> Parser::parseCreateIndexStatement() {
     auto stmt = std::make_unique<CreateIndexStatement>();
     
-    expect(Token::CREATE);
+    // Note: CREATE token was already consumed by parseStatement()
+    if (match(Token::UNIQUE)) {
+        stmt->unique = true;
+    }
     expect(Token::INDEX);
     
     stmt->indexName = parseIdentifier();
@@ -435,6 +457,71 @@ std::unique_ptr<CreateIndexStatement> Parser::parseCreateIndexStatement() {
     return stmt;
 }
 
+std::unique_ptr<CopyStatement> Parser::parseCopyStatement() {
+    auto stmt = std::make_unique<CopyStatement>();
+    
+    expect(Token::COPY);
+    
+    stmt->tableName = parseIdentifier();
+    
+    // Parse column list (optional)
+    if (match(Token::LPAREN)) {
+        stmt->columns = parseColumnList();
+        expect(Token::RPAREN);
+    }
+    
+    // TO is not reserved, so it arrives as an identifier
+    if (current().type == Token::IDENTIFIER && current().value.toUpper() == "TO") {
+        advance();
+        stmt->toFile = true;
+    } else {
+        expect(Token::FROM);
+    }
+    stmt->filePath = expect(Token::STRING).value;
+    
+    parseCopyOptions(*stmt);
+    return stmt;
+}
+
+// Options after the file name, PostgreSQL style, with or without WITH and parentheses:
+//   FORMAT csv|ndjson|binary, HEADER [TRUE|FALSE], DELIMITER 'c', or a bare CSV / NDJSON / BINARY
+void Parser::parseCopyOptions(CopyStatement& stmt) {
+    if (current().type == Token::IDENTIFIER && current().value.toUpper() == "WITH") {
+        advance();
+    }
+    bool parenthesized = match(Token::LPAREN);
+    
+    while (current().type != Token::END_OF_FILE && current().type != Token::SEMICOLON &&
+           current().type != Token::RPAREN) {
+        QString option = current().value.toUpper();
+        advance();
+        
+        if (option == "FORMAT") {
+            stmt.format = current().value;
+            advance();
+        } else if (option == "CSV" || option == "NDJSON" || option == "JSON" || option == "BINARY") {
+            stmt.format = option;
+        } else if (option == "HEADER") {
+            stmt.header = true;
+            if (current().type == Token::TRUE_KW) {
+                advance();
+            } else if (current().type == Token::FALSE_KW) {
+                stmt.header = false;
+                advance();
+            }
+        } else if (option == "DELIMITER") {
+            stmt.delimiter = expect(Token::STRING).value;
+        } else {
+            error(QString("Unknown COPY option '%1'").arg(option));
+        }
+        match(Token::COMMA);
+    }
+    
+    if (parenthesized) {
+        expect(Token::RPAREN);
+    }
+}
+
 std::unique_ptr<BeginStatement> Parser::parseBeginStatement() {
     expect(Token::BEGIN);
     return std::make_unique<BeginStatement>();
@@ -463,6 +550,47 @@ QString Parser::parseIdentifier() {
     return token.value;
 }
 
+// Column name, optionally qualified by a table or alias: "column" or "table.column"
+QString Parser::parseColumnReference() {
+    QString name = parseIdentifier();
+    if (match(Token::DOT)) {
+        name += "." + parseIdentifier();
+    }
+    return name;
+}
+
+// Optional "[AS] alias" after a table name; empty when there is none
+QString Parser::parseTableAlias() {
+    if (current().type != Token::IDENTIFIER) {
+        return QString();
+    }
+    if (current().value.compare("AS", Qt::CaseInsensitive) == 0) {
+        advance();
+    }
+    return parseIdentifier();
+}
+
+JoinClause Parser::parseJoinClause() {
+    JoinClause join;
+    
+    if (current().type == Token::RIGHT || current().type == Token::FULL || current().type == Token::CROSS) {
+        error(QString("%1 JOIN is not supported").arg(current().value.toUpper()));
+    }
+    if (match(Token::LEFT)) {
+        join.type = JoinClause::LEFT;
+        match(Token::OUTER);
+    } else {
+        match(Token::INNER);
+    }
+    expect(Token::JOIN);
+    
+    join.table = parseIdentifier();
+    join.alias = parseTableAlias();
+    join.on = parseConditionClause(Token::ON, join.onClause);
+    
+    return join;
+}
+
 QString Parser::parseExpression() {
     QString expr;
     
@@ -529,48 +657,286 @@ QStringList Parser::parseColumnList() {
     return columns;
 }
 
-QString Parser::parseWhereClause() {
-    QString clause;
+void Parser::parseSelectList(SelectStatement& stmt) {
+    do {
+        SelectItem::Aggregate aggregate = aggregateAt();
+        SelectItem item = aggregate != SelectItem::NONE ? parseAggregateCall(aggregate) : SelectItem(parseColumnReference());
+        stmt.items.append(item);
+        stmt.columns.append(item.label());
+    } while (match(Token::COMMA));
+}
+
+// Aggregate function starting at the current token, NONE when it is not a call to one
+SelectItem::Aggregate Parser::aggregateAt() const {
+    if (current().type != Token::IDENTIFIER || peek().type != Token::LPAREN) {
+        return SelectItem::NONE;
+    }
+    return SelectItem::aggregateNamed(current().value);
+}
+
+SelectItem Parser::parseAggregateCall(SelectItem::Aggregate aggregate) {
+    advance();
+    expect(Token::LPAREN);
+    SelectItem item(QString(), aggregate);
+    if (aggregate == SelectItem::COUNT && match(Token::ASTERISK)) {
+        // COUNT(*) counts rows; item.column stays empty
+    } else {
+        item.column = parseColumnReference();
+    }
+    expect(Token::RPAREN);
+    return item;
+}
+
+std::shared_ptr<Expression> Parser::parseConditionClause(Token::Type keyword, QString& clauseText) {
+    expect(keyword);
     
-    expect(Token::WHERE);
+    int start = position;
+    auto condition = parseOrCondition();
     
-    // Collect tokens until ORDER BY, LIMIT, or statement end
-    while (current().type != Token::ORDER && 
-           current().type != Token::LIMIT &&
-           current().type != Token::SEMICOLON &&
-           current().type != Token::END_OF_FILE &&
-           current().type != Token::RPAREN) {
-        clause += current().value + " ";
-        advance();
+    // Keep the source text for logging and messages
+    QStringList parts;
+    for (int i = start; i < position && i < tokens.size(); ++i) {
+        parts.append(tokens[i].type == Token::STRING ? "'" + tokens[i].value + "'" : tokens[i].value);
     }
+    clauseText = parts.join(" ");
     
-    return clause.trimmed();
+    return condition;
 }
 
-QString Parser::parseOrderByClause() {
-    QString clause;
+std::shared_ptr<Expression> Parser::parseOrCondition() {
+    auto left = parseAndCondition();
+    while (match(Token::OR)) {
+        auto node = std::make_shared<Expression>(Expression::BINARY, Expression::OR);
+        node->children << left << parseAndCondition();
+        left = node;
+    }
+    return left;
+}
+
+std::shared_ptr<Expression> Parser::parseAndCondition() {
+    auto left = parseNotCondition();
+    while (match(Token::AND)) {
+        auto node = std::make_shared<Expression>(Expression::BINARY, Expression::AND);
+        node->children << left << parseNotCondition();
+        left = node;
+    }
+    return left;
+}
+
+std::shared_ptr<Expression> Parser::parseNotCondition() {
+    if (match(Token::NOT)) {
+        auto node = std::make_shared<Expression>(Expression::UNARY, Expression::NOT);
+        node->children << parseNotCondition();
+        return node;
+    }
+    return parsePredicate();
+}
+
+std::shared_ptr<Expression> Parser::parsePredicate() {
+    auto left = parseAdditive();
+    
+    // Comparison operators
+    Expression::Operator compareOp = Expression::NONE;
+    switch (current().type) {
+        case Token::EQUALS: compareOp = Expression::EQ; break;
+        case Token::NOT_EQUALS: compareOp = Expression::NE; break;
+        case Token::LESS: compareOp = Expression::LT; break;
+        case Token::LESS_EQUAL: compareOp = Expression::LE; break;
+        case Token::GREATER: compareOp = Expression::GT; break;
+        case Token::GREATER_EQUAL: compareOp = Expression::GE; break;
+        default: break;
+    }
+    if (compareOp != Expression::NONE) {
+        advance();
+        auto node = std::make_shared<Expression>(Expression::BINARY, compareOp);
+        node->children << left << parseAdditive();
+        return node;
+    }
     
-    expect(Token::ORDER);
-    expect(Token::BY);
+    // IS [NOT] NULL
+    if (match(Token::IS)) {
+        auto node = std::make_shared<Expression>(Expression::IS_NULL);
+        node->negated = match(Token::NOT);
+        expect(Token::NULL_KW);
+        node->children << left;
+        return node;
+    }
+    
+    // [NOT] IN / BETWEEN / LIKE
+    bool negated = false;
+    if (current().type == Token::NOT &&
+        (peek().type == Token::IN || peek().type == Token::BETWEEN || peek().type == Token::LIKE)) {
+        advance();
+        negated = true;
+    }
     
-    clause = parseIdentifier();
+    if (match(Token::IN)) {
+        auto node = std::make_shared<Expression>(Expression::IN_LIST);
+        node->negated = negated;
+        node->children << left;
+        expect(Token::LPAREN);
+        node->children << parseAdditive();
+        while (match(Token::COMMA)) {
+            node->children << parseAdditive();
+        }
+        expect(Token::RPAREN);
+        return node;
+    }
     
-    if (match(Token::ASC)) {
-        clause += " ASC";
-    } else if (match(Token::DESC)) {
-        clause += " DESC";
+    if (match(Token::BETWEEN)) {
+        auto node = std::make_shared<Expression>(Expression::BETWEEN);
+        node->negated = negated;
+        node->children << left << parseAdditive();
+        expect(Token::AND);
+        node->children << parseAdditive();
+        return node;
     }
     
-    while (match(Token::COMMA)) {
-        clause += ", " + parseIdentifier();
+    if (match(Token::LIKE)) {
+        auto node = std::make_shared<Expression>(Expression::LIKE);
+        node->negated = negated;
+        node->children << left << parseAdditive();
+        return node;
+    }
+    
+    return left;
+}
+
+std::shared_ptr<Expression> Parser::parseAdditive() {
+    auto left = parseMultiplicative();
+    while (current().type == Token::PLUS || current().type == Token::MINUS) {
+        auto op = current().type == Token::PLUS ? Expression::PLUS : Expression::MINUS;
+        advance();
+        auto node = std::make_shared<Expression>(Expression::BINARY, op);
+        node->children << left << parseMultiplicative();
+        left = node;
+    }
+    return left;
+}
+
+std::shared_ptr<Expression> Parser::parseMultiplicative() {
+    auto left = parseUnary();
+    while (current().type == Token::ASTERISK || current().type == Token::MULTIPLY ||
+           current().type == Token::DIVIDE || current().type == Token::PERCENT ||
+           current().type == Token::MODULO) {
+        Expression::Operator op = Expression::MULTIPLY;
+        if (current().type == Token::DIVIDE) {
+            op = Expression::DIVIDE;
+        } else if (current().type == Token::PERCENT || current().type == Token::MODULO) {
+            op = Expression::MODULO;
+        }
+        advance();
+        auto node = std::make_shared<Expression>(Expression::BINARY, op);
+        node->children << left << parseUnary();
+        left = node;
+    }
+    return left;
+}
+
+std::shared_ptr<Expression> Parser::parseUnary() {
+    if (match(Token::MINUS)) {
+        auto operand = parseUnary();
+        // Fold negative numeric literals
+        if (operand->kind == Expression::LITERAL && !operand->stringLiteral) {
+            operand->value = operand->value.startsWith("-") ? operand->value.mid(1) : "-" + operand->value;
+            return operand;
+        }
+        auto node = std::make_shared<Expression>(Expression::UNARY, Expression::NEGATE);
+        node->children << operand;
+        return node;
+    }
+    if (match(Token::PLUS)) {
+        return parseUnary();
+    }
+    return parsePrimary();
+}
+
+std::shared_ptr<Expression> Parser::parsePrimary() {
+    Token token = current();
+    
+    switch (token.type) {
+        case Token::NUMBER:
+            advance();
+            return std::make_shared<Expression>(Expression::LITERAL, Expression::NONE, token.value);
+        case Token::STRING: {
+            advance();
+            auto node = std::make_shared<Expression>(Expression::LITERAL, Expression::NONE, token.value);
+            node->stringLiteral = true;
+            return node;
+        }
+        case Token::TRUE_KW:
+            advance();
+            return std::make_shared<Expression>(Expression::LITERAL, Expression::NONE, "TRUE");
+        case Token::FALSE_KW:
+            advance();
+            return std::make_shared<Expression>(Expression::LITERAL, Expression::NONE, "FALSE");
+        case Token::NULL_KW:
+            advance();
+            return std::make_shared<Expression>(Expression::NULL_LITERAL);
+        case Token::IDENTIFIER: {
+            SelectItem::Aggregate aggregate = aggregateAt();
+            if (aggregate != SelectItem::NONE) {
+                SelectItem call = parseAggregateCall(aggregate);
+                auto node = std::make_shared<Expression>(Expression::AGGREGATE, Expression::NONE,
+                                                         SelectItem::functionName(aggregate));
+                if (!call.column.isEmpty()) {
+                    auto column = std::make_shared<Expression>(Expression::COLUMN, Expression::NONE, call.column);
+                    int dot = call.column.indexOf('.');
+                    if (dot >= 0) {
+                        column->qualifier = call.column.left(dot);
+                        column->value = call.column.mid(dot + 1);
+                    }
+                    node->children << column;
+                }
+                return node;
+            }
+            advance();
+            auto node = std::make_shared<Expression>(Expression::COLUMN, Expression::NONE, token.value);
+            if (match(Token::DOT)) {
+                node->qualifier = node->value;
+                node->value = parseIdentifier();
+            }
+            return node;
+        }
+        case Token::LPAREN: {
+            advance();
+            auto inner = parseOrCondition();
+            expect(Token::RPAREN);
+            return inner;
+        }
+        default:
+            error(QString("Unexpected '%1' in expression").arg(token.value));
+    }
+    return std::make_shared<Expression>(Expression::NULL_LITERAL);
+}
+
+QString Parser::parseOrderByClause(QVector<OrderByItem>& items) {
+    QStringList terms;
+    
+    expect(Token::ORDER);
+    expect(Token::BY);
+    
+    do {
+        OrderByItem item;
+        SelectItem::Aggregate aggregate = aggregateAt();
+        if (aggregate != SelectItem::NONE) {
+            item.column = parseAggregateCall(aggregate).column;
+            item.aggregate = aggregate;
+        } else {
+            item.column = parseColumnReference();
+        }
+        QString term = SelectItem(item.column, item.aggregate).label();
         if (match(Token::ASC)) {
-            clause += " ASC";
+            term += " ASC";
         } else if (match(Token::DESC)) {
-            clause += " DESC";
+            item.descending = true;
+            term += " DESC";
         }
-    }
+        items.append(item);
+        terms.append(term);
+    } while (match(Token::COMMA));
     
-    return clause;
+    return terms.join(", ");
 }
 
 int Parser::parseLimit() {
@@ -605,6 +971,7 @@ std::string Parser::tokenTypeToString(Token::Type type) const {
         case Token::FROM: return "FROM";
         case Token::WHERE: return "WHERE";
         case Token::INSERT: return "INSERT";
+        case Token::COPY: return "COPY";
         case Token::INTO: return "INTO";
         case Token::VALUES: return "VALUES";
         case Token::UPDATE: return "UPDATE";
@@ -627,6 +994,17 @@ std::string Parser::tokenTypeToString(Token::Type type) const {
         case Token::INT: return "INT";
         case Token::VARCHAR: return "VARCHAR";
         case Token::DATE: return "DATE";
+        case Token::AND: return "AND";
+        case Token::NULL_KW: return "NULL";
+        case Token::IN: return "IN";
+        case Token::BETWEEN: return "BETWEEN";
+        case Token::LIKE: return "LIKE";
+        case Token::IS: return "IS";
+        case Token::GROUP: return "GROUP";
+        case Token::HAVING: return "HAVING";
+        case Token::JOIN: return "JOIN";
+        case Token::ON: return "ON";
+        case Token::DOT: return ".";
         case Token::END_OF_FILE: return "end of file";
         default: return "unknown";
     }
@@ -37,17 +37,35 @@ private:
     std::unique_ptr<AlterTableStatement> parseAlterTableStatement();
     std::unique_ptr<DropTableStatement> parseDropTableStatement();
     std::unique_ptr<CreateIndexStatement> parseCreateIndexStatement();
+    std::unique_ptr<CopyStatement> parseCopyStatement();
     std::unique_ptr<BeginStatement> parseBeginStatement();
     std::unique_ptr<CommitStatement> parseCommitStatement();
     std::unique_ptr<RollbackStatement> parseRollbackStatement();
     
     // Helper parsing methods
     QString parseIdentifier();
+    QString parseColumnReference();
+    QString parseTableAlias();
+    JoinClause parseJoinClause();
     QString parseExpression();
     QStringList parseColumnList();
-    QString parseWhereClause();
-    QString parseOrderByClause();
+    void parseSelectList(SelectStatement& stmt);
+    SelectItem::Aggregate aggregateAt() const;
+    SelectItem parseAggregateCall(SelectItem::Aggregate aggregate);
+    std::shared_ptr<Expression> parseConditionClause(Token::Type keyword, QString& clauseText);
+    QString parseOrderByClause(QVector<OrderByItem>& items);
     int parseLimit();
+    void parseCopyOptions(CopyStatement& stmt);
+    
+    // WHERE expression parsing, lowest to highest precedence
+    std::shared_ptr<Expression> parseOrCondition();
+    std::shared_ptr<Expression> parseAndCondition();
+    std::shared_ptr<Expression> parseNotCondition();
+    std::shared_ptr<Expression> parsePredicate();
+    std::shared_ptr<Expression> parseAdditive();
+    std::shared_ptr<Expression> parseMultiplicative();
+    std::shared_ptr<Expression> parseUnary();
+    std::shared_ptr<Expression> parsePrimary();
     
     // Error handling
     void error(const QString& message);
@@ -15,9 +15,10 @@ struct Token {
         JOIN, INNER, LEFT, RIGHT, FULL, OUTER, CROSS, ON,
         BEGIN, COMMIT, ROLLBACK,
         INDEX, CREATE_INDEX,
+        COPY,
         CONSTRAINT, PRIMARY_KEY, UNIQUE, NOT_NULL, FOREIGN_KEY, CHECK, DEFAULT,
-        ORDER, BY, ASC, DESC, LIMIT, OFFSET,
-        AND, OR, NOT,
+        ORDER, BY, ASC, DESC, LIMIT, OFFSET, GROUP, HAVING,
+        AND, OR, NOT, IN, BETWEEN, LIKE, IS,
         INT, INTEGER, SMALLINT, BIGINT, DECIMAL, NUMERIC, FLOAT,
         CHAR, VARCHAR, TEXT, NCHAR, NVARCHAR, TINYTEXT, MEDIUMTEXT, LONGTEXT,
         ENUM, BOOL, JSON, DATE, TIME, DATETIME, TIMESTAMP,
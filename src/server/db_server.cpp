@@ -6,10 +6,89 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QRegularExpression>
+#include <QThread>
+
+namespace {
+
+// How long a kept-alive connection may sit idle before it is closed
+constexpr int KEEP_ALIVE_TIMEOUT_SECONDS = 15;
+
+// Bytes a socket buffers that have not been handed to the parser yet
+constexpr qint64 SOCKET_READ_BUFFER_BYTES = 64 * 1024;
+
+struct QueryReply {
+    int statusCode;
+    QByteArray body;
+};
+
+QByteArray errorBody(const QString& message) {
+    QJsonObject error;
+    error["error"] = message;
+    return QJsonDocument(error).toJson(QJsonDocument::Compact);
+}
+
+// Runs on a worker thread: everything from lexing to the encoded response
+QueryReply executeSql(const QString& sql, QueryExecutor& executor) {
+    try {
+        Lexer lexer(sql);
+        auto tokens = lexer.tokenize();
+        Parser parser(tokens);
+        auto statement = parser.parse();
+
+        if (!statement) {
+            return {400, "{\"error\": \"Parse error\"}"};
+        }
+
+        auto result = executor.execute(statement);
+
+        QJsonObject response;
+        response["success"] = result->success;
+        
+        if (result->success) {
+            response["affectedRows"] = (int)result->affectedRows;
+            
+            QJsonArray columnsArray;
+            for (const auto& col : result->columns) columnsArray.append(col);
+            response["columns"] = columnsArray;
+
+            QJsonArray rowsArray;
+            for (const auto& row : result->rows) {
+                QJsonArray rowArray;
+                for (const auto& val : row) rowArray.append(val);
+                rowsArray.append(rowArray);
+            }
+            response["rows"] = rowsArray;
+        } else {
+            response["error"] = result->errorMessage;
+        }
+
+        return {200, QJsonDocument(response).toJson()};
+
+    } catch (const std::exception& e) {
+        QString error = QString("Exception: %1").arg(e.what());
+        Logger::instance().error(error);
+        return {500, errorBody(error)};
+    } catch (...) {
+        QString error = "Unknown exception during request handling";
+        Logger::instance().error(error);
+        return {500, errorBody(error)};
+    }
+}
+
+}
 
 DatabaseServer::DatabaseServer(std::shared_ptr<TableManager> tableManager, QObject* parent)
-    : QObject(parent), tableManager(tableManager), queryExecutor(std::make_unique<QueryExecutor>()) {
-    queryExecutor->setTableManager(tableManager);
+    : QObject(parent), tableManager(tableManager) {
+    workers.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+DatabaseServer::~DatabaseServer() {
+    // Running queries post their responses back to this object
+    workers.waitForDone();
+}
+
+void DatabaseServer::setWorkerCount(int count) {
+    workers.setMaxThreadCount(qMax(1, count));
 }
 
 bool DatabaseServer::start(quint16 port) {
@@ -21,7 +100,8 @@ bool DatabaseServer::start(quint16 port) {
         return false;
     }
 
-    Logger::instance().info(QString("Server listening on port %1").arg(port));
+    Logger::instance().info(QString("Server listening on port %1 with %2 worker threads")
+        .arg(port).arg(workers.maxThreadCount()));
     return true;
 }
 
@@ -34,42 +114,71 @@ void DatabaseServer::stop() {
 
 void DatabaseServer::onNewConnection() {
     QTcpSocket* socket = tcpServer->nextPendingConnection();
+    
+    // Close connections that sit idle between requests
+    Connection connection;
+    connection.idleTimer = new QTimer(socket);
+    connection.idleTimer->setSingleShot(true);
+    connection.idleTimer->setInterval(KEEP_ALIVE_TIMEOUT_SECONDS * 1000);
+    connect(connection.idleTimer, &QTimer::timeout, socket, &QTcpSocket::disconnectFromHost);
+    connection.idleTimer->start();
+    connection.session = std::make_shared<QueryExecutor>(tableManager);
+    // Clients are not trusted with the server's file system
+    connection.session->setCopyDirectory(copyDirectory);
+    connections.insert(socket, connection);
+    
+    // Unread input stops at this size, after which TCP flow control holds the client back
+    socket->setReadBufferSize(SOCKET_READ_BUFFER_BYTES);
+    
     connect(socket, &QTcpSocket::readyRead, this, &DatabaseServer::onReadyRead);
-    connect(socket, &QTcpSocket::disconnected, socket, &QTcpSocket::deleteLater);
+    connect(socket, &QTcpSocket::disconnected, this, &DatabaseServer::onDisconnected);
+}
+
+void DatabaseServer::onDisconnected() {
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) return;
+    
+    auto it = connections.find(socket);
+    if (it == connections.end()) {
+        socket->deleteLater();
+        return;
+    }
+    // Destroying the session rolls back its open transaction, so the last reference is
+    // dropped on a worker, the way its statements run, and never on the event loop. A
+    // query still running holds a reference of its own and drops it when it is done
+    std::shared_ptr<QueryExecutor> session = std::move(it->session);
+    connections.erase(it);
+    QPointer<QTcpSocket> target(socket);
+    workers.start([this, target, session = std::move(session)]() mutable {
+        session.reset();
+        QMetaObject::invokeMethod(this, [target]() {
+            if (target) {
+                target->deleteLater();
+            }
+        }, Qt::QueuedConnection);
+    });
 }
 
 void DatabaseServer::onReadyRead() {
     QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
     if (!socket) return;
     
-    // Logger::instance().info("TRACE: onReadyRead entered"); // Verbose debug
+    readRequests(socket);
+}
 
+void DatabaseServer::readRequests(QTcpSocket* socket) {
     try {
-        // Read all available data
+        // While a query runs the input stays in the socket, so a client pipelining faster
+        // than its queries finish cannot grow the parser's buffer without bound
+        auto it = connections.find(socket);
+        if (it == connections.end() || it->busy) return;
+        
         QByteArray data = socket->readAll();
-        if (data.isEmpty()) return; // Don't process empty reads
-
-        QString request = QString::fromUtf8(data);
+        if (data.isEmpty() || it->closing) return;
         
-        // Simple HTTP parsing
-        QStringList lines = request.split("\r\n");
-        if (lines.isEmpty()) return;
-
-        QString requestLine = lines[0];
-        QStringList parts = requestLine.split(" ");
-        if (parts.size() < 2) return;
-
-        QString method = parts[0];
-        QString path = parts[1];
-
-        // Find body (after double CRLF)
-        int bodyIndex = request.indexOf("\r\n\r\n");
-        QByteArray body;
-        if (bodyIndex != -1) {
-            body = data.mid(bodyIndex + 4);
-        }
-
-        handleRequest(socket, method, path, body);
+        it->parser.append(data);
+        it->idleTimer->start();
+        processRequests(socket);
     } catch (const std::exception& e) {
         Logger::instance().error(QString("Exception in onReadyRead: %1").arg(e.what()));
     } catch (...) {
@@ -77,89 +186,115 @@ void DatabaseServer::onReadyRead() {
     }
 }
 
-void DatabaseServer::handleRequest(QTcpSocket* socket, const QString& method, const QString& path, const QByteArray& body) {
+void DatabaseServer::processRequests(QTcpSocket* socket) {
+    // Answer every complete request in order; pipelined requests may already be buffered.
+    // The connection is looked up again after each response, which may have closed it
+    HttpRequest request;
+    auto it = connections.end();
+    while ((it = connections.find(socket)) != connections.end() && !it->closing && !it->busy) {
+        HttpRequestParser::Status status = it->parser.parse(request);
+        
+        if (status == HttpRequestParser::Status::Incomplete) {
+            if (it->parser.takeContinueRequest()) {
+                socket->write("HTTP/1.1 100 Continue\r\n\r\n");
+            }
+            break;
+        }
+        
+        if (status == HttpRequestParser::Status::Failed) {
+            Logger::instance().warning(QString("Malformed request from %1: %2")
+                .arg(socket->peerAddress().toString(), it->parser.errorMessage()));
+            sendResponse(socket, it->parser.errorStatus(), "application/json",
+                         errorBody(it->parser.errorMessage()), false);
+            break;
+        }
+        
+        handleRequest(socket, request);
+    }
+}
+
+void DatabaseServer::handleRequest(QTcpSocket* socket, const HttpRequest& request) {
+    const QString& method = request.method;
+    const QString& path = request.path;
+    const QByteArray& body = request.body;
+    const bool keepAlive = request.keepAlive();
     Logger::instance().info(QString("Request: %1 %2").arg(method).arg(path));
 
     // CORS Preflight
     if (method == "OPTIONS") {
-        sendResponse(socket, 204, "text/plain", "");
+        sendResponse(socket, 204, "text/plain", "", keepAlive);
         return;
     }
 
     if (path == "/query" && method == "POST") {
         QJsonDocument doc = QJsonDocument::fromJson(body);
         if (!doc.isObject()) {
-            sendResponse(socket, 400, "application/json", "{\"error\": \"Invalid JSON\"}");
+            sendResponse(socket, 400, "application/json", "{\"error\": \"Invalid JSON\"}", keepAlive);
             return;
         }
 
         QString sql = doc.object().value("sql").toString();
         if (sql.isEmpty()) {
-            sendResponse(socket, 400, "application/json", "{\"error\": \"Missing 'sql' field\"}");
+            sendResponse(socket, 400, "application/json", "{\"error\": \"Missing 'sql' field\"}", keepAlive);
             return;
         }
 
-        Logger::instance().info(QString("Executing SQL: %1").arg(sql));
-
-        try {
-            // Lexer & Parser
-            Lexer lexer(sql);
-            auto tokens = lexer.tokenize();
-            Parser parser(tokens);
-            auto statement = parser.parse();
-
-            if (!statement) {
-                 sendResponse(socket, 400, "application/json", "{\"error\": \"Parse error\"}");
-                 return;
-            }
-
-            auto result = queryExecutor->execute(statement);
+        runQuery(socket, sql, keepAlive);
+        return;
+    }
 
-            QJsonObject response;
-            response["success"] = result->success;
-            
-            if (result->success) {
-                response["affectedRows"] = (int)result->affectedRows;
-                
-                QJsonArray columnsArray;
-                for (const auto& col : result->columns) columnsArray.append(col);
-                response["columns"] = columnsArray;
-
-                QJsonArray rowsArray;
-                for (const auto& row : result->rows) {
-                    QJsonArray rowArray;
-                    for (const auto& val : row) rowArray.append(val);
-                    rowsArray.append(rowArray);
-                }
-                response["rows"] = rowsArray;
-            } else {
-                response["error"] = result->errorMessage;
-            }
+    sendResponse(socket, 404, "text/plain", "Not Found", keepAlive);
+}
 
-            sendResponse(socket, 200, "application/json", QJsonDocument(response).toJson());
+void DatabaseServer::runQuery(QTcpSocket* socket, const QString& sql, bool keepAlive) {
+    auto it = connections.find(socket);
+    if (it == connections.end()) return;
+    
+    // Later requests on this connection wait until the response is sent; a long
+    // query does not count as idle time
+    it->busy = true;
+    it->idleTimer->stop();
+    
+    // The session runs one statement at a time, so workers never share it
+    QPointer<QTcpSocket> target(socket);
+    std::shared_ptr<QueryExecutor> session = it->session;
+    workers.start([this, target, sql, keepAlive, session]() {
+        Logger::instance().info(QString("Executing SQL: %1").arg(sql));
+        QueryReply reply = executeSql(sql, *session);
+        QMetaObject::invokeMethod(this, [this, target, reply, keepAlive]() {
+            finishQuery(target, reply.statusCode, reply.body, keepAlive);
+        }, Qt::QueuedConnection);
+    });
+}
 
-        } catch (const std::exception& e) {
-            QString error = QString("Exception: %1").arg(e.what());
-             Logger::instance().error(error);
-             sendResponse(socket, 500, "application/json", QString("{\"error\": \"%1\"}").arg(error).toUtf8());
-        } catch (...) {
-             QString error = "Unknown exception during request handling";
-             Logger::instance().error(error);
-             sendResponse(socket, 500, "application/json", QString("{\"error\": \"%1\"}").arg(error).toUtf8());
-        }
-        return;
+void DatabaseServer::finishQuery(const QPointer<QTcpSocket>& socket, int statusCode, const QByteArray& body,
+                                 bool keepAlive) {
+    // The client may have gone away while the query ran
+    auto it = socket ? connections.find(socket.data()) : connections.end();
+    if (it == connections.end()) return;
+    
+    it->busy = false;
+    it->idleTimer->start();
+    sendResponse(socket, statusCode, "application/json", body, keepAlive);
+    processRequests(socket);
+    // Input that arrived while the query ran raises no further readyRead
+    if (socket && socket->bytesAvailable() > 0) {
+        readRequests(socket);
     }
-
-    sendResponse(socket, 404, "text/plain", "Not Found");
 }
 
-void DatabaseServer::sendResponse(QTcpSocket* socket, int statusCode, const QByteArray& contentType, const QByteArray& body) {
+void DatabaseServer::sendResponse(QTcpSocket* socket, int statusCode, const QByteArray& contentType, const QByteArray& body,
+                                  bool keepAlive) {
     QString statusText;
     if (statusCode == 200) statusText = "OK";
     else if (statusCode == 204) statusText = "No Content";
     else if (statusCode == 400) statusText = "Bad Request";
     else if (statusCode == 404) statusText = "Not Found";
+    else if (statusCode == 413) statusText = "Payload Too Large";
+    else if (statusCode == 431) statusText = "Request Header Fields Too Large";
     else if (statusCode == 500) statusText = "Internal Server Error";
+    else if (statusCode == 501) statusText = "Not Implemented";
+    else if (statusCode == 505) statusText = "HTTP Version Not Supported";
 
     QByteArray response = QString("HTTP/1.1 %1 %2\r\n").arg(statusCode).arg(statusText).toUtf8();
     response += "Access-Control-Allow-Origin: *\r\n";
@@ -167,12 +302,24 @@ void DatabaseServer::sendResponse(QTcpSocket* socket, int statusCode, const QByt
     response += "Access-Control-Allow-Headers: Content-Type\r\n";
     response += QString("Content-Type: %1\r\n").arg(QString::fromUtf8(contentType)).toUtf8();
     response += QString("Content-Length: %1\r\n").arg(body.size()).toUtf8();
-    response += "Connection: close\r\n\r\n";
+    if (keepAlive) {
+        response += "Connection: keep-alive\r\n";
+        response += QString("Keep-Alive: timeout=%1\r\n\r\n").arg(KEEP_ALIVE_TIMEOUT_SECONDS).toUtf8();
+    } else {
+        response += "Connection: close\r\n\r\n";
+    }
     response += body;
 
     if (socket->state() == QAbstractSocket::ConnectedState) {
         socket->write(response);
-        socket->disconnectFromHost();
+        if (!keepAlive) {
+            // Requests pipelined behind this one are not answered
+            auto it = connections.find(socket);
+            if (it != connections.end()) {
+                it->closing = true;
+            }
+            socket->disconnectFromHost();
+        }
         Logger::instance().info(QString("Response sent: %1").arg(statusCode));
     } else {
         Logger::instance().warning("Socket not connected, cannot send response");
@@ -3,28 +3,83 @@
 #include <QObject>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTimer>
+#include <QHash>
+#include <QPointer>
+#include <QThreadPool>
 #include <memory>
+#include "http_parser.h"
 #include "../core/query_executor.h"
 #include "../core/table_manager.h"
 
+/**
+ * @brief HTTP/1.1 front end: POST /query runs one SQL statement
+ *
+ * Connections are kept alive between requests (unless the client asks to
+ * close) and requests may be pipelined; each connection has its own
+ * incremental parser, so requests split across reads are reassembled and
+ * answered in order. Idle connections are closed after a timeout.
+ *
+ * Socket I/O stays on the event-loop thread; lexing, parsing, execution
+ * and JSON encoding run on a pool of worker threads and the response is
+ * posted back. A connection runs one query at a time so its responses
+ * stay in request order, while different connections run in parallel
+ * (TableManager's table latches keep concurrent statements apart). Input
+ * a connection sends while its query runs is left unread in the socket,
+ * whose buffer is capped, so a client cannot queue up unbounded memory.
+ *
+ * Each connection is a session with its own QueryExecutor, so a
+ * transaction opened with BEGIN spans the requests sent on that
+ * connection until COMMIT or ROLLBACK; closing the connection (including
+ * the idle timeout) rolls an open transaction back, on a worker thread.
+ */
 class DatabaseServer : public QObject {
     Q_OBJECT
 
 public:
     explicit DatabaseServer(std::shared_ptr<TableManager> tableManager, QObject* parent = nullptr);
+    ~DatabaseServer() override;
     bool start(quint16 port = 8080);
     void stop();
+    
+    // Worker threads that run queries; one per core unless set
+    void setWorkerCount(int count);
+    int workerCount() const { return workers.maxThreadCount(); }
+    
+    // The only directory COPY may read and write for clients; COPY is refused unless set
+    void setCopyDirectory(const QString& directory) { copyDirectory = directory; }
 
 private slots:
     void onNewConnection();
     void onReadyRead();
+    void onDisconnected();
 
 private:
-    void handleRequest(QTcpSocket* socket, const QString& method, const QString& path, const QByteArray& body);
-    void sendResponse(QTcpSocket* socket, int statusCode, const QByteArray& contentType, const QByteArray& body);
+    struct Connection {
+        HttpRequestParser parser;
+        QTimer* idleTimer = nullptr;    // Owned by the socket
+        bool closing = false;           // A response asked to close; further input is ignored
+        bool busy = false;              // A query is running; later requests wait in the socket
+        // The session's executor; shared with the worker running its query, which may outlive the connection
+        std::shared_ptr<QueryExecutor> session;
+    };
+    
+    // Hands the socket's input to the parser and answers it, unless a query is running
+    void readRequests(QTcpSocket* socket);
+    // Answers the buffered requests in order until one needs a worker or more bytes
+    void processRequests(QTcpSocket* socket);
+
+    void handleRequest(QTcpSocket* socket, const HttpRequest& request);
+    void runQuery(QTcpSocket* socket, const QString& sql, bool keepAlive);
+    // Back on the event-loop thread: sends a worker's response, then resumes the connection
+    void finishQuery(const QPointer<QTcpSocket>& socket, int statusCode, const QByteArray& body, bool keepAlive);
+    void sendResponse(QTcpSocket* socket, int statusCode, const QByteArray& contentType, const QByteArray& body,
+                      bool keepAlive);
     void sendCorsHeaders(QTcpSocket* socket);
 
     QTcpServer* tcpServer;
-    std::unique_ptr<QueryExecutor> queryExecutor;
+    QHash<QTcpSocket*, Connection> connections;
     std::shared_ptr<TableManager> tableManager;
+    QThreadPool workers;
+    QString copyDirectory;
 };
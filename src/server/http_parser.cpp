@@ -0,0 +1,293 @@
+#include "http_parser.h"
+#include <QList>
+
+namespace {
+
+// Request line plus headers (or chunk trailers)
+constexpr int MAX_HEADER_BYTES = 64 * 1024;
+constexpr qint64 MAX_BODY_BYTES = 64 * 1024 * 1024;
+
+// A chunk size line is a few hex digits and maybe extensions
+constexpr int MAX_CHUNK_LINE_BYTES = 1024;
+
+bool isDigits(const QByteArray& text) {
+    if (text.isEmpty()) {
+        return false;
+    }
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+bool HttpRequest::keepAlive() const {
+    const QList<QByteArray> options = header("connection").toLower().split(',');
+    for (const QByteArray& option : options) {
+        QByteArray token = option.trimmed();
+        if (token == "close") {
+            return false;
+        }
+        if (token == "keep-alive") {
+            return true;
+        }
+    }
+    return version == "HTTP/1.1";
+}
+
+void HttpRequestParser::append(const QByteArray& data) {
+    if (state == State::Failed) {
+        return;
+    }
+    // Drop what earlier requests consumed before growing the buffer
+    if (position > 0) {
+        buffer.remove(0, position);
+        position = 0;
+    }
+    buffer.append(data);
+}
+
+HttpRequestParser::Status HttpRequestParser::parse(HttpRequest& request) {
+    // A header line still arriving counts against the limit too
+    auto headerIncomplete = [this]() {
+        return headerBytes + (buffer.size() - position) > MAX_HEADER_BYTES
+            ? fail(431, "Request header too large") : Status::Incomplete;
+    };
+    
+    QByteArray line;
+    while (true) {
+        switch (state) {
+            case State::RequestLine:
+                if (!readLine(line)) {
+                    return headerIncomplete();
+                }
+                if (headerBytes > MAX_HEADER_BYTES) {
+                    return fail(431, "Request header too large");
+                }
+                // Empty lines between pipelined requests are ignored
+                if (line.isEmpty()) {
+                    headerBytes = 0;
+                    continue;
+                }
+                if (!parseRequestLine(line)) {
+                    return Status::Failed;
+                }
+                state = State::Headers;
+                break;
+
+            case State::Headers:
+                if (!readLine(line)) {
+                    return headerIncomplete();
+                }
+                if (headerBytes > MAX_HEADER_BYTES) {
+                    return fail(431, "Request header too large");
+                }
+                if (!line.isEmpty()) {
+                    if (!parseHeader(line)) {
+                        return Status::Failed;
+                    }
+                    break;
+                }
+                if (!beginBody()) {
+                    return Status::Failed;
+                }
+                break;
+
+            case State::Body:
+                if (!readBody()) {
+                    return Status::Incomplete;
+                }
+                finishRequest(request);
+                return Status::Complete;
+
+            case State::ChunkSize: {
+                if (!readLine(line)) {
+                    return buffer.size() - position > MAX_CHUNK_LINE_BYTES
+                        ? fail(400, "Malformed chunk size") : Status::Incomplete;
+                }
+                // Chunk extensions (";name=value") are ignored
+                int extension = line.indexOf(';');
+                QByteArray digits = (extension >= 0 ? line.left(extension) : line).trimmed();
+                bool ok = false;
+                qint64 size = digits.toLongLong(&ok, 16);
+                if (!ok || size < 0 || digits.isEmpty()) {
+                    return fail(400, "Malformed chunk size");
+                }
+                if (size > MAX_BODY_BYTES - current.body.size()) {
+                    return fail(413, "Request body too large");
+                }
+                remaining = size;
+                headerBytes = 0;
+                state = size == 0 ? State::Trailers : State::ChunkData;
+                break;
+            }
+
+            case State::ChunkData:
+                if (!readBody()) {
+                    return Status::Incomplete;
+                }
+                state = State::ChunkDataEnd;
+                break;
+
+            case State::ChunkDataEnd:
+                if (buffer.size() - position < 2) {
+                    return Status::Incomplete;
+                }
+                if (buffer[position] != '\r' || buffer[position + 1] != '\n') {
+                    return fail(400, "Missing CRLF after chunk data");
+                }
+                position += 2;
+                state = State::ChunkSize;
+                break;
+
+            case State::Trailers:
+                if (!readLine(line)) {
+                    return headerIncomplete();
+                }
+                if (headerBytes > MAX_HEADER_BYTES) {
+                    return fail(431, "Request header too large");
+                }
+                // Trailer fields are read past; the request's headers are already final
+                if (!line.isEmpty()) {
+                    break;
+                }
+                finishRequest(request);
+                return Status::Complete;
+
+            case State::Failed:
+                return Status::Failed;
+        }
+    }
+}
+
+bool HttpRequestParser::takeContinueRequest() {
+    bool requested = continueRequested;
+    continueRequested = false;
+    return requested;
+}
+
+bool HttpRequestParser::readLine(QByteArray& line) {
+    int end = buffer.indexOf('\n', position);
+    if (end < 0) {
+        return false;
+    }
+    int length = end - position;
+    if (length > 0 && buffer[end - 1] == '\r') {
+        --length;
+    }
+    line = buffer.mid(position, length);
+    headerBytes += end + 1 - position;
+    position = end + 1;
+    return true;
+}
+
+bool HttpRequestParser::readBody() {
+    qint64 available = qMin<qint64>(remaining, buffer.size() - position);
+    current.body.append(buffer.constData() + position, available);
+    position += static_cast<int>(available);
+    remaining -= available;
+    return remaining == 0;
+}
+
+void HttpRequestParser::finishRequest(HttpRequest& request) {
+    request = std::move(current);
+    current = HttpRequest();
+    state = State::RequestLine;
+    headerBytes = 0;
+    continueRequested = false;
+}
+
+bool HttpRequestParser::parseRequestLine(const QByteArray& line) {
+    const QList<QByteArray> parts = line.split(' ');
+    if (parts.size() != 3 || parts[0].isEmpty() || parts[1].isEmpty()) {
+        fail(400, "Malformed request line");
+        return false;
+    }
+    if (parts[2] != "HTTP/1.1" && parts[2] != "HTTP/1.0") {
+        fail(505, "Only HTTP/1.0 and HTTP/1.1 are supported");
+        return false;
+    }
+    current.method = QString::fromLatin1(parts[0]);
+    current.path = QString::fromUtf8(parts[1]);
+    current.version = parts[2];
+    return true;
+}
+
+bool HttpRequestParser::parseHeader(const QByteArray& line) {
+    // Folded continuation lines are obsolete and not accepted
+    if (line[0] == ' ' || line[0] == '\t') {
+        fail(400, "Folded header lines are not supported");
+        return false;
+    }
+    int colon = line.indexOf(':');
+    if (colon <= 0) {
+        fail(400, "Malformed header line");
+        return false;
+    }
+    QByteArray name = line.left(colon).trimmed().toLower();
+    QByteArray value = line.mid(colon + 1).trimmed();
+
+    auto existing = current.headers.find(name);
+    if (existing == current.headers.end()) {
+        current.headers.insert(name, value);
+    } else if (name == "content-length") {
+        // Conflicting lengths leave the body's end ambiguous
+        if (existing.value() != value) {
+            fail(400, "Conflicting Content-Length headers");
+            return false;
+        }
+    } else {
+        existing.value() += ", " + value;
+    }
+    return true;
+}
+
+bool HttpRequestParser::beginBody() {
+    const QByteArray transferEncoding = current.header("transfer-encoding").toLower();
+    const QByteArray contentLength = current.header("content-length");
+
+    if (!transferEncoding.isEmpty()) {
+        // Both framings at once is how requests get smuggled past proxies
+        if (!contentLength.isEmpty()) {
+            fail(400, "Both Transfer-Encoding and Content-Length given");
+            return false;
+        }
+        if (transferEncoding.trimmed() != "chunked") {
+            fail(501, "Only chunked Transfer-Encoding is supported");
+            return false;
+        }
+        state = State::ChunkSize;
+    } else if (!contentLength.isEmpty()) {
+        if (!isDigits(contentLength)) {
+            fail(400, "Malformed Content-Length");
+            return false;
+        }
+        bool ok = false;
+        remaining = contentLength.toLongLong(&ok);
+        if (!ok || remaining > MAX_BODY_BYTES) {
+            fail(413, "Request body too large");
+            return false;
+        }
+        state = State::Body;
+    } else {
+        remaining = 0;
+        state = State::Body;
+    }
+
+    const bool bodyExpected = state == State::ChunkSize || remaining > 0;
+    continueRequested = bodyExpected && current.header("expect").toLower() == "100-continue" &&
+                        current.version == "HTTP/1.1";
+    return true;
+}
+
+HttpRequestParser::Status HttpRequestParser::fail(int status, const QString& message) {
+    state = State::Failed;
+    failureStatus = status;
+    failureMessage = message;
+    buffer.clear();
+    position = 0;
+    return Status::Failed;
+}
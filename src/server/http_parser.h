@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+/**
+ * @brief One HTTP request as read off a connection
+ */
+struct HttpRequest {
+    QString method;
+    QString path;
+    QByteArray version;                         // "HTTP/1.0" or "HTTP/1.1"
+    QHash<QByteArray, QByteArray> headers;      // Lower-case name -> value
+    QByteArray body;                            // Decoded when it was sent chunked
+
+    QByteArray header(const QByteArray& name) const { return headers.value(name.toLower()); }
+    // HTTP/1.1 keeps the connection open unless the client asks to close it;
+    // HTTP/1.0 only when the client asks to keep it
+    bool keepAlive() const;
+};
+
+/**
+ * @brief Incremental HTTP/1.x request parser for one connection
+ *
+ * Bytes are appended as they arrive, in pieces of any size, and parse()
+ * returns each request once it is complete; several pipelined requests
+ * can be buffered at once and come out in order. The body is framed by
+ * Content-Length or by chunked Transfer-Encoding, so a body split across
+ * reads is accumulated rather than cut short. Malformed or oversized
+ * requests fail with the status code to answer them with, after which
+ * the connection should be closed.
+ */
+class HttpRequestParser {
+public:
+    enum class Status {
+        Incomplete,     // Needs more bytes
+        Complete,       // A request was returned
+        Failed          // See errorStatus(); the connection cannot be reused
+    };
+
+    void append(const QByteArray& data);
+    // Parses as far as the buffered bytes allow; on Complete the next request is moved into request
+    Status parse(HttpRequest& request);
+
+    int errorStatus() const { return failureStatus; }
+    QString errorMessage() const { return failureMessage; }
+    // True once for a request that sent "Expect: 100-continue" and whose body is still to come
+    bool takeContinueRequest();
+
+private:
+    enum class State {
+        RequestLine,
+        Headers,
+        Body,           // Content-Length bytes
+        ChunkSize,
+        ChunkData,
+        ChunkDataEnd,   // CRLF after a chunk's data
+        Trailers,
+        Failed
+    };
+
+    QByteArray buffer;
+    int position = 0;               // Start of the unparsed bytes in buffer
+    State state = State::RequestLine;
+    HttpRequest current;
+    qint64 remaining = 0;           // Body or chunk bytes still to read
+    int headerBytes = 0;            // Request line and headers read so far
+    bool continueRequested = false;
+    int failureStatus = 0;
+    QString failureMessage;
+
+    // Next line without its line ending; false when no complete line is buffered yet
+    bool readLine(QByteArray& line);
+    // Moves buffered body bytes into the request; true once the body or chunk is complete
+    bool readBody();
+    void finishRequest(HttpRequest& request);
+    bool parseRequestLine(const QByteArray& line);
+    bool parseHeader(const QByteArray& line);
+    // Decides how the body is framed once the headers are in
+    bool beginBody();
+    Status fail(int status, const QString& message);
+};
@@ -0,0 +1,426 @@
+#include "copy_file.h"
+#include "page_file.h"
+#include <QFileInfo>
+#include <QtEndian>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QVariant>
+
+namespace {
+
+// Binary COPY files start with this magic and a format version
+const QByteArray BINARY_MAGIC("SRDBCOPY");
+constexpr quint32 BINARY_VERSION = 1;
+constexpr int FRAME_LENGTH_SIZE = 4;
+
+QByteArray binaryFrame(const QStringList& values) {
+    QByteArray record = RowCodec::encode(values);
+    QByteArray frame(FRAME_LENGTH_SIZE, '\0');
+    qToLittleEndian<quint32>(static_cast<quint32>(record.size()), frame.data());
+    frame.append(record);
+    return frame;
+}
+
+// JSON scalars as the engine's text values; nested values keep their JSON text
+QString jsonToText(const QJsonValue& value) {
+    switch (value.type()) {
+        case QJsonValue::Null:
+        case QJsonValue::Undefined:
+            return QString();
+        case QJsonValue::Bool:
+            return value.toBool() ? "true" : "false";
+        case QJsonValue::Double:
+            return value.toVariant().toString();
+        case QJsonValue::String:
+            return value.toString();
+        case QJsonValue::Array:
+            return QString::fromUtf8(QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact));
+        case QJsonValue::Object:
+            return QString::fromUtf8(QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact));
+    }
+    return QString();
+}
+
+}
+
+bool CopyOptions::formatFromName(const QString& name, CopyFormat& format) {
+    QString upper = name.toUpper();
+    if (upper == "CSV") {
+        format = CopyFormat::CSV;
+        return true;
+    }
+    if (upper == "NDJSON" || upper == "JSONL" || upper == "JSON") {
+        format = CopyFormat::NDJSON;
+        return true;
+    }
+    if (upper == "BINARY") {
+        format = CopyFormat::BINARY;
+        return true;
+    }
+    return false;
+}
+
+CopyFormat CopyOptions::formatFromPath(const QString& filePath) {
+    QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "ndjson" || suffix == "jsonl" || suffix == "json") {
+        return CopyFormat::NDJSON;
+    }
+    if (suffix == "bin") {
+        return CopyFormat::BINARY;
+    }
+    return CopyFormat::CSV;
+}
+
+CopyReader::CopyReader(const QString& filePath, const CopyOptions& options)
+    : filePath(filePath), options(options), file(filePath) {
+}
+
+bool CopyReader::open() {
+    if (!file.open(QIODevice::ReadOnly)) {
+        lastError = QString("Failed to open %1 for reading: %2").arg(filePath, file.errorString());
+        return false;
+    }
+    lineNumber = 0;
+    
+    if (options.format == CopyFormat::BINARY) {
+        QByteArray magic = file.read(BINARY_MAGIC.size() + 4);
+        if (magic.size() != BINARY_MAGIC.size() + 4 || !magic.startsWith(BINARY_MAGIC)) {
+            lastError = QString("%1 is not a binary COPY file").arg(filePath);
+            return false;
+        }
+        quint32 version = qFromLittleEndian<quint32>(magic.constData() + BINARY_MAGIC.size());
+        if (version != BINARY_VERSION) {
+            lastError = QString("%1 has unsupported binary COPY version %2").arg(filePath).arg(version);
+            return false;
+        }
+        if (!readBinaryRecord(header)) {
+            if (!hasError()) {
+                lastError = QString("%1 has no column header").arg(filePath);
+            }
+            return false;
+        }
+        return true;
+    }
+    
+    if (options.format == CopyFormat::CSV && options.header) {
+        if (!readCsvRecord(header)) {
+            if (!hasError()) {
+                lastError = QString("%1 has no header line").arg(filePath);
+            }
+            return false;
+        }
+        for (QString& name : header) {
+            name = name.trimmed();
+        }
+    }
+    return true;
+}
+
+void CopyReader::close() {
+    file.close();
+}
+
+void CopyReader::setColumns(const QStringList& names) {
+    columns = names;
+    columnPositions.clear();
+    for (int i = 0; i < names.size(); ++i) {
+        columnPositions.insert(names[i].toLower(), i);
+    }
+}
+
+bool CopyReader::readRow(QStringList& row) {
+    if (!file.isOpen()) {
+        lastError = "Reader is not open";
+        return false;
+    }
+    switch (options.format) {
+        case CopyFormat::NDJSON:
+            return readJsonRecord(row);
+        case CopyFormat::BINARY:
+            return readBinaryRecord(row);
+        case CopyFormat::CSV:
+            break;
+    }
+    return readCsvRecord(row);
+}
+
+bool CopyReader::readLine(QByteArray& line, QByteArray* ending) {
+    if (file.atEnd()) {
+        return false;
+    }
+    line = file.readLine();
+    lineNumber++;
+    
+    int length = line.size();
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+        length--;
+    }
+    if (ending) {
+        *ending = line.mid(length);
+    }
+    line.truncate(length);
+    // UTF-8 byte order mark
+    if (lineNumber == 1 && line.startsWith("\xEF\xBB\xBF")) {
+        line.remove(0, 3);
+    }
+    return true;
+}
+
+bool CopyReader::readCsvRecord(QStringList& row) {
+    QByteArray bytes;
+    QByteArray ending;
+    do {
+        if (!readLine(bytes, &ending)) {
+            return false;
+        }
+    } while (bytes.isEmpty());
+    
+    const qint64 startLine = lineNumber;
+    QString line = QString::fromUtf8(bytes);
+    QString field;
+    bool quoted = false;
+    int i = 0;
+    
+    row.clear();
+    while (true) {
+        if (i >= line.size()) {
+            if (!quoted) {
+                row.append(field);
+                return true;
+            }
+            // A quoted field continues on the next line and keeps the line break as written
+            field += QString::fromUtf8(ending);
+            if (!readLine(bytes, &ending)) {
+                lastError = QString("Unterminated quoted field starting on line %1").arg(startLine);
+                return false;
+            }
+            line = QString::fromUtf8(bytes);
+            i = 0;
+            continue;
+        }
+        
+        QChar c = line[i++];
+        if (quoted) {
+            if (c != QChar('"')) {
+                field += c;
+            } else if (i < line.size() && line[i] == QChar('"')) {
+                field += c;
+                i++;
+            } else {
+                quoted = false;
+            }
+        } else if (c == options.delimiter) {
+            row.append(field);
+            field.clear();
+        } else if (c == QChar('"') && field.isEmpty()) {
+            quoted = true;
+        } else {
+            field += c;
+        }
+    }
+}
+
+bool CopyReader::readJsonRecord(QStringList& row) {
+    QByteArray line;
+    do {
+        if (!readLine(line)) {
+            return false;
+        }
+    } while (line.trimmed().isEmpty());
+    
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        lastError = QString("Invalid JSON on line %1: %2").arg(lineNumber).arg(parseError.errorString());
+        return false;
+    }
+    
+    row.clear();
+    if (doc.isArray()) {
+        const QJsonArray values = doc.array();
+        for (const QJsonValue& value : values) {
+            row.append(jsonToText(value));
+        }
+        return true;
+    }
+    
+    if (!doc.isObject()) {
+        lastError = QString("Line %1 is neither a JSON object nor an array").arg(lineNumber);
+        return false;
+    }
+    if (columns.isEmpty()) {
+        lastError = "No columns set for reading JSON objects";
+        return false;
+    }
+    
+    // Keys are matched to columns case-insensitively; missing keys are NULL
+    row.reserve(columns.size());
+    for (int i = 0; i < columns.size(); ++i) {
+        row.append(QString());
+    }
+    const QJsonObject object = doc.object();
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        auto position = columnPositions.constFind(it.key().toLower());
+        if (position != columnPositions.constEnd()) {
+            row[position.value()] = jsonToText(it.value());
+        }
+    }
+    return true;
+}
+
+bool CopyReader::readBinaryRecord(QStringList& row) {
+    if (file.atEnd()) {
+        return false;
+    }
+    // Line numbers count frames in binary files
+    lineNumber++;
+    
+    QByteArray length = file.read(FRAME_LENGTH_SIZE);
+    if (length.size() != FRAME_LENGTH_SIZE) {
+        lastError = QString("Truncated frame %1").arg(lineNumber);
+        return false;
+    }
+    qint64 size = qFromLittleEndian<quint32>(length.constData());
+    QByteArray record = file.read(size);
+    if (record.size() != size) {
+        lastError = QString("Truncated frame %1").arg(lineNumber);
+        return false;
+    }
+    if (!RowCodec::decode(record, row)) {
+        lastError = QString("Corrupt frame %1").arg(lineNumber);
+        return false;
+    }
+    return true;
+}
+
+CopyWriter::CopyWriter(const QString& filePath, const CopyOptions& options)
+    : filePath(filePath), options(options) {
+}
+
+CopyWriter::~CopyWriter() {
+    cancel();
+}
+
+bool CopyWriter::open(const QStringList& columnNames) {
+    columns = columnNames;
+    rowCount = 0;
+    
+    file = std::make_unique<QSaveFile>(filePath);
+    if (!file->open(QIODevice::WriteOnly)) {
+        lastError = QString("Failed to open %1 for writing: %2").arg(filePath, file->errorString());
+        file.reset();
+        return false;
+    }
+    
+    switch (options.format) {
+        case CopyFormat::BINARY: {
+            QByteArray header = BINARY_MAGIC;
+            char version[4];
+            qToLittleEndian<quint32>(BINARY_VERSION, version);
+            header.append(version, 4);
+            header.append(binaryFrame(columns));
+            return write(header);
+        }
+        case CopyFormat::CSV:
+            if (options.header) {
+                return write(encodeCsv(QVector<QString>(columns.begin(), columns.end())));
+            }
+            return true;
+        case CopyFormat::NDJSON:
+            return true;
+    }
+    return true;
+}
+
+bool CopyWriter::writeRow(const QVector<QString>& row) {
+    if (!file) {
+        lastError = "Writer is not open";
+        return false;
+    }
+    
+    QByteArray bytes;
+    switch (options.format) {
+        case CopyFormat::CSV:
+            bytes = encodeCsv(row);
+            break;
+        case CopyFormat::NDJSON:
+            bytes = encodeJson(row);
+            break;
+        case CopyFormat::BINARY:
+            bytes = binaryFrame(QStringList(row.begin(), row.end()));
+            break;
+    }
+    if (!write(bytes)) {
+        return false;
+    }
+    rowCount++;
+    return true;
+}
+
+bool CopyWriter::commit() {
+    if (!file) {
+        lastError = "Writer is not open";
+        return false;
+    }
+    if (!file->commit()) {
+        lastError = QString("Failed to commit %1: %2").arg(filePath, file->errorString());
+        file.reset();
+        return false;
+    }
+    file.reset();
+    return true;
+}
+
+void CopyWriter::cancel() {
+    if (file) {
+        file->cancelWriting();
+        file.reset();
+    }
+}
+
+bool CopyWriter::write(const QByteArray& bytes) {
+    if (file->write(bytes) != bytes.size()) {
+        lastError = QString("Failed to write %1: %2").arg(filePath, file->errorString());
+        cancel();
+        return false;
+    }
+    return true;
+}
+
+QByteArray CopyWriter::encodeCsv(const QVector<QString>& row) const {
+    QString line;
+    for (int i = 0; i < row.size(); ++i) {
+        if (i > 0) {
+            line += options.delimiter;
+        }
+        const QString& value = row[i];
+        // Quote only what the reader would otherwise split or unquote
+        bool needsQuotes = value.contains(options.delimiter) || value.contains(QChar('"')) ||
+                           value.contains(QChar('\n')) || value.contains(QChar('\r'));
+        if (needsQuotes) {
+            QString escaped = value;
+            escaped.replace(QChar('"'), QString("\"\""));
+            line += QChar('"') + escaped + QChar('"');
+        } else {
+            line += value;
+        }
+    }
+    // A lone empty field would be a blank line, which the reader skips
+    if (row.size() == 1 && row[0].isEmpty()) {
+        line = "\"\"";
+    }
+    line += QChar('\n');
+    return line.toUtf8();
+}
+
+QByteArray CopyWriter::encodeJson(const QVector<QString>& row) const {
+    QJsonObject object;
+    for (int i = 0; i < columns.size() && i < row.size(); ++i) {
+        object.insert(columns[i], row[i].isEmpty() ? QJsonValue() : QJsonValue(row[i]));
+    }
+    QByteArray line = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    line.append('\n');
+    return line;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QFile>
+#include <QSaveFile>
+#include <memory>
+
+/**
+ * @brief External file layouts understood by COPY
+ */
+enum class CopyFormat {
+    CSV,        // RFC 4180: quoted fields, "" escapes, quoted fields may span lines
+    NDJSON,     // One JSON object (keyed by column) or array per line
+    BINARY      // Magic, then length-prefixed RowCodec frames: column names first, then rows
+};
+
+/**
+ * @brief Options of a COPY statement
+ */
+struct CopyOptions {
+    CopyFormat format = CopyFormat::CSV;
+    bool header = false;        // CSV: first line holds column names
+    QChar delimiter = QChar(',');
+
+    // Parses a FORMAT option; returns false for unknown names
+    static bool formatFromName(const QString& name, CopyFormat& format);
+    // Guesses the format from the file extension (.ndjson, .jsonl, .json -> NDJSON, .bin -> BINARY, else CSV)
+    static CopyFormat formatFromPath(const QString& filePath);
+};
+
+/**
+ * @brief Streaming reader for COPY FROM
+ *
+ * Reads one record at a time through the file's buffer, so memory use is
+ * bounded by the longest record rather than the file size. Empty fields
+ * and JSON nulls come back as empty strings, which the engine treats as
+ * NULL. Blank lines are skipped.
+ */
+class CopyReader {
+public:
+    CopyReader(const QString& filePath, const CopyOptions& options);
+
+    // Opens the file and reads the header (CSV with HEADER, or the column frame of a binary file)
+    bool open();
+    void close();
+
+    // Column names NDJSON objects are read by, in output order
+    void setColumns(const QStringList& columns);
+
+    // Reads the next record into row; false at end of file or on error (see hasError)
+    bool readRow(QStringList& row);
+
+    QStringList getHeader() const { return header; }
+    qint64 getLineNumber() const { return lineNumber; }
+    QString getError() const { return lastError; }
+    bool hasError() const { return !lastError.isEmpty(); }
+
+private:
+    QString filePath;
+    CopyOptions options;
+    QFile file;
+    QStringList header;
+    QStringList columns;
+    QHash<QString, int> columnPositions;  // lower-case column name -> position in row
+    qint64 lineNumber = 0;
+    QString lastError;
+
+    // The line without its terminator; ending, when given, receives the terminator
+    bool readLine(QByteArray& line, QByteArray* ending = nullptr);
+    bool readCsvRecord(QStringList& row);
+    bool readJsonRecord(QStringList& row);
+    bool readBinaryRecord(QStringList& row);
+};
+
+/**
+ * @brief Streaming writer for COPY TO
+ *
+ * Rows are encoded one at a time straight into the output file, so memory
+ * use does not grow with the table. The file is written to a temporary
+ * and replaces the target only on commit(), so a failed export never
+ * leaves a truncated file behind. Empty values (NULL) are written as
+ * empty CSV fields and JSON nulls.
+ */
+class CopyWriter {
+public:
+    CopyWriter(const QString& filePath, const CopyOptions& options);
+    ~CopyWriter();
+
+    // Opens the temporary file and writes the header: CSV column names when
+    // options.header is set, always for binary files
+    bool open(const QStringList& columns);
+    bool writeRow(const QVector<QString>& row);
+    bool commit();
+    void cancel();
+
+    qint64 getRowCount() const { return rowCount; }
+    QString getError() const { return lastError; }
+
+private:
+    QString filePath;
+    CopyOptions options;
+    std::unique_ptr<QSaveFile> file;
+    QStringList columns;
+    qint64 rowCount = 0;
+    QString lastError;
+
+    QByteArray encodeCsv(const QVector<QString>& row) const;
+    QByteArray encodeJson(const QVector<QString>& row) const;
+    bool write(const QByteArray& bytes);
+};
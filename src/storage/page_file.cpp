@@ -0,0 +1,651 @@
+#include "page_file.h"
+#include "storage_utils.h"
+#include "../core/column_vector.h"
+#include <QtEndian>
+#include <cstring>
+
+using namespace PageFormat;
+
+namespace {
+
+void appendU32(QByteArray& out, quint32 value) {
+    char buf[4];
+    qToLittleEndian<quint32>(value, buf);
+    out.append(buf, 4);
+}
+
+void appendU64(QByteArray& out, quint64 value) {
+    char buf[8];
+    qToLittleEndian<quint64>(value, buf);
+    out.append(buf, 8);
+}
+
+quint32 readU32At(const QByteArray& in, int offset) {
+    return qFromLittleEndian<quint32>(in.constData() + offset);
+}
+
+quint64 readU64At(const QByteArray& in, int offset) {
+    return qFromLittleEndian<quint64>(in.constData() + offset);
+}
+
+}
+
+// ============================================================================
+// SlottedPage
+// ============================================================================
+
+SlottedPage::SlottedPage() {
+    reset(FREE_PAGE);
+}
+
+SlottedPage::SlottedPage(const QByteArray& bytes) : data(bytes) {
+}
+
+void SlottedPage::reset(PageType type) {
+    data = QByteArray(PAGE_SIZE, '\0');
+    data[PAGE_TYPE] = static_cast<char>(type);
+    writeU16(PAGE_SLOT_COUNT, 0);
+    writeU16(PAGE_FREE_START, PAGE_HEADER_SIZE);
+    writeU16(PAGE_FREE_END, static_cast<quint16>(PAGE_SIZE));
+    writeU32(PAGE_NEXT, 0);
+}
+
+PageType SlottedPage::getType() const {
+    return static_cast<PageType>(static_cast<quint8>(data[PAGE_TYPE]));
+}
+
+int SlottedPage::getSlotCount() const {
+    return readU16(PAGE_SLOT_COUNT);
+}
+
+int SlottedPage::getFreeSpace() const {
+    return readU16(PAGE_FREE_END) - readU16(PAGE_FREE_START);
+}
+
+quint32 SlottedPage::getNextPage() const {
+    return readU32(PAGE_NEXT);
+}
+
+void SlottedPage::setNextPage(quint32 pageNo) {
+    writeU32(PAGE_NEXT, pageNo);
+}
+
+bool SlottedPage::addRecord(const QByteArray& record, bool overflowStub) {
+    if (record.size() + SLOT_SIZE > getFreeSpace()) {
+        return false;
+    }
+
+    quint16 freeStart = readU16(PAGE_FREE_START);
+    quint16 freeEnd = readU16(PAGE_FREE_END);
+    quint16 offset = static_cast<quint16>(freeEnd - record.size());
+
+    std::memcpy(data.data() + offset, record.constData(), record.size());
+    writeU16(freeStart, overflowStub ? (offset | SLOT_OVERFLOW) : offset);
+    writeU16(freeStart + 2, static_cast<quint16>(record.size()));
+
+    writeU16(PAGE_SLOT_COUNT, static_cast<quint16>(getSlotCount() + 1));
+    writeU16(PAGE_FREE_START, static_cast<quint16>(freeStart + SLOT_SIZE));
+    writeU16(PAGE_FREE_END, offset);
+    return true;
+}
+
+QByteArray SlottedPage::getRecord(int slot, bool* overflowStub) const {
+    if (slot < 0 || slot >= getSlotCount()) {
+        return QByteArray();
+    }
+
+    int slotPos = PAGE_HEADER_SIZE + slot * SLOT_SIZE;
+    quint16 rawOffset = readU16(slotPos);
+    quint16 length = readU16(slotPos + 2);
+    quint16 offset = rawOffset & ~SLOT_OVERFLOW;
+
+    if (overflowStub) {
+        *overflowStub = (rawOffset & SLOT_OVERFLOW) != 0;
+    }
+    if (offset + length > PAGE_SIZE) {
+        return QByteArray();
+    }
+    return data.mid(offset, length);
+}
+
+int SlottedPage::setOverflowPayload(const char* payload, int length) {
+    int capacity = PAGE_SIZE - PAGE_HEADER_SIZE;
+    int n = qMin(length, capacity);
+    std::memcpy(data.data() + PAGE_HEADER_SIZE, payload, n);
+    writeU16(PAGE_FREE_START, static_cast<quint16>(PAGE_HEADER_SIZE + n));
+    return n;
+}
+
+QByteArray SlottedPage::getOverflowPayload() const {
+    int end = qMin<int>(readU16(PAGE_FREE_START), PAGE_SIZE);
+    return data.mid(PAGE_HEADER_SIZE, end - PAGE_HEADER_SIZE);
+}
+
+void SlottedPage::seal() {
+    writeU32(PAGE_CHECKSUM, 0);
+    writeU32(PAGE_CHECKSUM, StorageUtils::crc32(data));
+}
+
+bool SlottedPage::verify() const {
+    if (data.size() != PAGE_SIZE) {
+        return false;
+    }
+    QByteArray copy = data;
+    std::memset(copy.data() + PAGE_CHECKSUM, 0, 4);
+    return StorageUtils::crc32(copy) == readU32(PAGE_CHECKSUM);
+}
+
+quint16 SlottedPage::readU16(int offset) const {
+    return qFromLittleEndian<quint16>(data.constData() + offset);
+}
+
+quint32 SlottedPage::readU32(int offset) const {
+    return qFromLittleEndian<quint32>(data.constData() + offset);
+}
+
+void SlottedPage::writeU16(int offset, quint16 value) {
+    qToLittleEndian<quint16>(value, data.data() + offset);
+}
+
+void SlottedPage::writeU32(int offset, quint32 value) {
+    qToLittleEndian<quint32>(value, data.data() + offset);
+}
+
+// ============================================================================
+// PageFileWriter
+// ============================================================================
+
+PageFileWriter::PageFileWriter(const QString& filePath, quint32 schemaVersion, quint32 columnCount)
+    : filePath(filePath), schemaVersion(schemaVersion), columnCount(columnCount) {
+}
+
+PageFileWriter::~PageFileWriter() {
+    if (file) {
+        cancel();
+    }
+}
+
+bool PageFileWriter::open() {
+    file = std::make_unique<QSaveFile>(filePath);
+    if (!file->open(QIODevice::WriteOnly)) {
+        lastError = QString("Failed to open %1 for writing: %2").arg(filePath, file->errorString());
+        file.reset();
+        return false;
+    }
+
+    // Reserve page 0; the real header is written on commit once counts are known
+    if (file->write(QByteArray(PAGE_SIZE, '\0')) != PAGE_SIZE) {
+        lastError = QString("Failed to write header page: %1").arg(file->errorString());
+        cancel();
+        return false;
+    }
+
+    nextPageNo = 1;
+    rowCount = 0;
+    dictionaryPage = 0;
+    dictionaryCodes.clear();
+    dictionaryValues.clear();
+    currentPage.reset(DATA_PAGE);
+    pageHasRecords = false;
+    return true;
+}
+
+bool PageFileWriter::appendRow(const QStringList& row, qint64 rowId) {
+    if (!file) {
+        lastError = "Writer is not open";
+        return false;
+    }
+
+    quint64 storedId = rowId >= 0 ? static_cast<quint64>(rowId) : rowCount;
+    QByteArray record;
+    appendU64(record, storedId);
+    record.append(encodeRow(row));
+    nextRowId = qMax(nextRowId, storedId + 1);
+    if (!addRecord(record)) {
+        return false;
+    }
+    rowCount++;
+    return true;
+}
+
+int PageFileWriter::getDictionarySize() const {
+    int size = 0;
+    for (const QStringList& values : dictionaryValues) {
+        size += values.size();
+    }
+    return size;
+}
+
+QByteArray PageFileWriter::encodeRow(const QStringList& row) {
+    if (dictionaryCodes.size() < static_cast<int>(columnCount)) {
+        dictionaryCodes.resize(columnCount);
+        dictionaryValues.resize(columnCount);
+    }
+
+    QByteArray out;
+    appendU32(out, static_cast<quint32>(row.size()));
+    for (int i = 0; i < row.size(); ++i) {
+        const QString& value = row[i];
+        // NULLs are already as short as a code
+        qint32 code = i < dictionaryCodes.size() && !value.isEmpty() ? dictionaryCode(i, value) : -1;
+        if (code >= 0) {
+            appendU32(out, DICTIONARY_REF | static_cast<quint32>(code));
+            continue;
+        }
+        QByteArray utf8 = value.toUtf8();
+        appendU32(out, static_cast<quint32>(utf8.size()));
+        out.append(utf8);
+    }
+    return out;
+}
+
+qint32 PageFileWriter::dictionaryCode(int column, const QString& value) {
+    QHash<QString, qint32>& codes = dictionaryCodes[column];
+    auto it = codes.find(value);
+    if (it == codes.end()) {
+        // The first occurrence is written inline; an entry only pays off once the value repeats
+        const int seen = codes.size();
+        // Columns stop collecting values by the same rule as the in-memory dictionaries
+        if (seen < ColumnVector::MAX_DICTIONARY_SIZE &&
+            (seen < ColumnVector::MIN_DICTIONARY_SAMPLE || static_cast<quint64>(seen) * 2 <= rowCount)) {
+            codes.insert(value, -1);
+        }
+        return -1;
+    }
+    if (it.value() < 0) {
+        it.value() = static_cast<qint32>(dictionaryValues[column].size());
+        dictionaryValues[column].append(value);
+    }
+    return it.value();
+}
+
+bool PageFileWriter::addRecord(const QByteArray& data) {
+    QByteArray record = data;
+    bool overflow = record.size() + SLOT_SIZE > PAGE_SIZE - PAGE_HEADER_SIZE;
+
+    if (overflow) {
+        quint32 firstPage = 0;
+        if (!writeOverflowChain(record, firstPage)) {
+            return false;
+        }
+        quint32 totalLength = static_cast<quint32>(record.size());
+        record.clear();
+        appendU32(record, firstPage);
+        appendU32(record, totalLength);
+    }
+
+    if (!currentPage.addRecord(record, overflow)) {
+        if (!flushCurrentPage()) {
+            return false;
+        }
+        currentPage.addRecord(record, overflow);
+    }
+    pageHasRecords = true;
+    return true;
+}
+
+bool PageFileWriter::commit() {
+    if (!file) {
+        lastError = "Writer is not open";
+        return false;
+    }
+
+    if (!writeDictionaries() || (pageHasRecords && !flushCurrentPage())) {
+        return false;
+    }
+
+    if (!file->seek(0) || file->write(buildHeader()) != PAGE_SIZE) {
+        lastError = QString("Failed to write file header: %1").arg(file->errorString());
+        cancel();
+        return false;
+    }
+
+    if (!file->commit()) {
+        lastError = QString("Failed to commit %1: %2").arg(filePath, file->errorString());
+        file.reset();
+        return false;
+    }
+    file.reset();
+    return true;
+}
+
+void PageFileWriter::cancel() {
+    if (file) {
+        file->cancelWriting();
+        file.reset();
+    }
+}
+
+bool PageFileWriter::writeDictionaries() {
+    for (int column = 0; column < dictionaryValues.size(); ++column) {
+        for (const QString& value : dictionaryValues[column]) {
+            // Dictionary pages start on a fresh page after the last data page
+            if (dictionaryPage == 0) {
+                if (pageHasRecords && !flushCurrentPage()) {
+                    return false;
+                }
+                currentPage.reset(DICTIONARY_PAGE);
+                dictionaryPage = nextPageNo;
+            }
+
+            QByteArray record;
+            appendU32(record, static_cast<quint32>(column));
+            record.append(value.toUtf8());
+            if (!addRecord(record)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool PageFileWriter::writePage(SlottedPage& page) {
+    page.seal();
+    if (file->write(page.bytes()) != PAGE_SIZE) {
+        lastError = QString("Failed to write page %1: %2").arg(nextPageNo).arg(file->errorString());
+        cancel();
+        return false;
+    }
+    nextPageNo++;
+    return true;
+}
+
+bool PageFileWriter::flushCurrentPage() {
+    if (!writePage(currentPage)) {
+        return false;
+    }
+    // Once the dictionary pages have begun, every page that follows is one
+    currentPage.reset(dictionaryPage != 0 ? DICTIONARY_PAGE : DATA_PAGE);
+    pageHasRecords = false;
+    return true;
+}
+
+bool PageFileWriter::writeOverflowChain(const QByteArray& record, quint32& firstPage) {
+    // Overflow pages are appended back to back, so each page links to the next number
+    firstPage = nextPageNo;
+    int written = 0;
+    SlottedPage page;
+
+    while (written < record.size()) {
+        page.reset(OVERFLOW_PAGE);
+        written += page.setOverflowPayload(record.constData() + written, record.size() - written);
+        page.setNextPage(written < record.size() ? nextPageNo + 1 : 0);
+        if (!writePage(page)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QByteArray PageFileWriter::buildHeader() const {
+    QByteArray header(PAGE_SIZE, '\0');
+    char* p = header.data();
+
+    std::memcpy(p + HEADER_MAGIC, MAGIC, sizeof(MAGIC));
+    qToLittleEndian<quint16>(FORMAT_VERSION, p + HEADER_FORMAT_VERSION);
+    qToLittleEndian<quint16>(0, p + HEADER_FLAGS);
+    qToLittleEndian<quint32>(PAGE_SIZE, p + HEADER_PAGE_SIZE);
+    qToLittleEndian<quint32>(schemaVersion, p + HEADER_SCHEMA_VERSION);
+    qToLittleEndian<quint32>(nextPageNo, p + HEADER_PAGE_COUNT);
+    qToLittleEndian<quint32>(columnCount, p + HEADER_COLUMN_COUNT);
+    qToLittleEndian<quint64>(rowCount, p + HEADER_ROW_COUNT);
+    qToLittleEndian<quint64>(checkpointLsn, p + HEADER_CHECKPOINT_LSN);
+    qToLittleEndian<quint64>(nextRowId, p + HEADER_NEXT_ROW_ID);
+    qToLittleEndian<quint32>(dictionaryPage, p + HEADER_DICTIONARY_PAGE);
+    qToLittleEndian<quint32>(StorageUtils::crc32(p, HEADER_CHECKSUM), p + HEADER_CHECKSUM);
+
+    return header;
+}
+
+// ============================================================================
+// PageFileReader
+// ============================================================================
+
+PageFileReader::PageFileReader(const QString& filePath) : file(filePath) {
+}
+
+bool PageFileReader::open() {
+    if (!file.open(QIODevice::ReadOnly)) {
+        lastError = QString("Failed to open %1: %2").arg(file.fileName(), file.errorString());
+        return false;
+    }
+
+    QByteArray header = file.read(PAGE_SIZE);
+    if (header.size() != PAGE_SIZE) {
+        lastError = "Truncated file header";
+        return false;
+    }
+
+    const char* p = header.constData();
+    if (std::memcmp(p + HEADER_MAGIC, MAGIC, sizeof(MAGIC)) != 0) {
+        lastError = "Not a SimpleRDBMS table file";
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(p + HEADER_CHECKSUM) != StorageUtils::crc32(p, HEADER_CHECKSUM)) {
+        lastError = "File header checksum mismatch";
+        return false;
+    }
+
+    formatVersion = qFromLittleEndian<quint16>(p + HEADER_FORMAT_VERSION);
+    if (formatVersion > FORMAT_VERSION) {
+        lastError = QString("Unsupported table file version %1").arg(formatVersion);
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(p + HEADER_PAGE_SIZE) != static_cast<quint32>(PAGE_SIZE)) {
+        lastError = "Unsupported page size";
+        return false;
+    }
+
+    schemaVersion = qFromLittleEndian<quint32>(p + HEADER_SCHEMA_VERSION);
+    pageCount = qFromLittleEndian<quint32>(p + HEADER_PAGE_COUNT);
+    columnCount = qFromLittleEndian<quint32>(p + HEADER_COLUMN_COUNT);
+    rowCount = qFromLittleEndian<quint64>(p + HEADER_ROW_COUNT);
+    checkpointLsn = qFromLittleEndian<quint64>(p + HEADER_CHECKPOINT_LSN);
+    nextRowId = formatVersion >= 2 ? qFromLittleEndian<quint64>(p + HEADER_NEXT_ROW_ID) : rowCount;
+    dictionaryPage = formatVersion >= 3 ? qFromLittleEndian<quint32>(p + HEADER_DICTIONARY_PAGE) : 0;
+    if (dictionaryPage >= pageCount) {
+        dictionaryPage = 0;
+    }
+
+    dictionaries.clear();
+    if (dictionaryPage != 0 && !readDictionaries()) {
+        return false;
+    }
+
+    currentPageNo = 0;
+    currentSlot = 0;
+    rowsRead = 0;
+    return true;
+}
+
+bool PageFileReader::readNextRow(QStringList& row, qint64* rowId) {
+    while (true) {
+        if (currentPageNo > 0 && currentSlot < currentPage.getSlotCount()) {
+            bool overflowStub = false;
+            QByteArray record = currentPage.getRecord(currentSlot++, &overflowStub);
+
+            if (overflowStub) {
+                QByteArray fullRecord;
+                if (!readOverflowChain(record, fullRecord)) {
+                    return false;
+                }
+                record = fullRecord;
+            }
+
+            quint64 storedId = rowsRead++;
+            if (formatVersion >= 2) {
+                if (record.size() < RECORD_ROW_ID_SIZE) {
+                    lastError = QString("Corrupt record in page %1").arg(currentPageNo);
+                    return false;
+                }
+                storedId = readU64At(record, 0);
+                record.remove(0, RECORD_ROW_ID_SIZE);
+            }
+            if (rowId) {
+                *rowId = static_cast<qint64>(storedId);
+            }
+
+            if (!RowCodec::decode(record, row, &dictionaries)) {
+                lastError = QString("Corrupt record in page %1").arg(currentPageNo);
+                return false;
+            }
+            return true;
+        }
+
+        // Data pages end where the dictionary pages begin
+        if (currentPageNo + 1 >= (dictionaryPage != 0 ? dictionaryPage : pageCount)) {
+            return false;
+        }
+
+        // Overflow pages carry no slots and are skipped by the sequential scan
+        currentPageNo++;
+        currentSlot = 0;
+        if (!readPage(currentPageNo, currentPage)) {
+            return false;
+        }
+    }
+}
+
+void PageFileReader::close() {
+    file.close();
+}
+
+bool PageFileReader::readPage(quint32 pageNo, SlottedPage& page) {
+    if (!file.seek(static_cast<qint64>(pageNo) * PAGE_SIZE)) {
+        lastError = QString("Failed to seek to page %1").arg(pageNo);
+        return false;
+    }
+
+    QByteArray bytes = file.read(PAGE_SIZE);
+    if (bytes.size() != PAGE_SIZE) {
+        lastError = QString("Truncated page %1").arg(pageNo);
+        return false;
+    }
+
+    page = SlottedPage(bytes);
+    if (!page.verify()) {
+        lastError = QString("Checksum mismatch in page %1").arg(pageNo);
+        return false;
+    }
+    return true;
+}
+
+bool PageFileReader::readOverflowChain(const QByteArray& stub, QByteArray& record) {
+    if (stub.size() != OVERFLOW_STUB_SIZE) {
+        lastError = QString("Corrupt overflow stub in page %1").arg(currentPageNo);
+        return false;
+    }
+
+    quint32 pageNo = readU32At(stub, 0);
+    quint32 totalLength = readU32At(stub, 4);
+    record.clear();
+    record.reserve(totalLength);
+
+    SlottedPage page;
+    for (quint32 hops = 0; pageNo != 0 && hops < pageCount; ++hops) {
+        if (pageNo >= pageCount || !readPage(pageNo, page)) {
+            if (lastError.isEmpty()) {
+                lastError = QString("Overflow page %1 out of range").arg(pageNo);
+            }
+            return false;
+        }
+        if (page.getType() != OVERFLOW_PAGE) {
+            lastError = QString("Page %1 is not an overflow page").arg(pageNo);
+            return false;
+        }
+        record.append(page.getOverflowPayload());
+        pageNo = page.getNextPage();
+    }
+
+    if (static_cast<quint32>(record.size()) != totalLength) {
+        lastError = QString("Overflow chain length mismatch (%1 of %2 bytes)")
+            .arg(record.size()).arg(totalLength);
+        return false;
+    }
+    return true;
+}
+
+bool PageFileReader::readDictionaries() {
+    SlottedPage page;
+    for (currentPageNo = dictionaryPage; currentPageNo < pageCount; ++currentPageNo) {
+        if (!readPage(currentPageNo, page)) {
+            return false;
+        }
+        // Long values sit in overflow pages between the dictionary pages
+        if (page.getType() != DICTIONARY_PAGE) {
+            continue;
+        }
+
+        for (int slot = 0; slot < page.getSlotCount(); ++slot) {
+            bool overflowStub = false;
+            QByteArray record = page.getRecord(slot, &overflowStub);
+            if (overflowStub) {
+                QByteArray fullRecord;
+                if (!readOverflowChain(record, fullRecord)) {
+                    return false;
+                }
+                record = fullRecord;
+            }
+
+            quint32 column = record.size() >= 4 ? readU32At(record, 0) : columnCount;
+            if (column >= columnCount) {
+                lastError = QString("Corrupt dictionary entry in page %1").arg(currentPageNo);
+                return false;
+            }
+            if (dictionaries.size() <= static_cast<int>(column)) {
+                dictionaries.resize(column + 1);
+            }
+            dictionaries[column].append(QString::fromUtf8(record.constData() + 4, record.size() - 4));
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// RowCodec
+// ============================================================================
+
+QByteArray RowCodec::encode(const QStringList& row) {
+    QByteArray out;
+    appendU32(out, static_cast<quint32>(row.size()));
+    for (const QString& value : row) {
+        QByteArray utf8 = value.toUtf8();
+        appendU32(out, static_cast<quint32>(utf8.size()));
+        out.append(utf8);
+    }
+    return out;
+}
+
+bool RowCodec::decode(const QByteArray& record, QStringList& row, const QVector<QVector<QString>>* dictionaries) {
+    row.clear();
+    if (record.size() < 4) {
+        return false;
+    }
+
+    quint32 fieldCount = readU32At(record, 0);
+    int pos = 4;
+    row.reserve(fieldCount);
+
+    for (quint32 i = 0; i < fieldCount; ++i) {
+        if (pos + 4 > record.size()) {
+            return false;
+        }
+        quint32 length = readU32At(record, pos);
+        pos += 4;
+        if ((length & DICTIONARY_REF) && dictionaries) {
+            quint32 code = length & ~DICTIONARY_REF;
+            if (i >= static_cast<quint32>(dictionaries->size()) ||
+                code >= static_cast<quint32>(dictionaries->at(i).size())) {
+                return false;
+            }
+            row.append(dictionaries->at(i).at(code));
+            continue;
+        }
+        if (length > static_cast<quint32>(record.size() - pos)) {
+            return false;
+        }
+        row.append(QString::fromUtf8(record.constData() + pos, length));
+        pos += length;
+    }
+    return pos == record.size();
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include <QFile>
+#include <QSaveFile>
+#include <memory>
+
+/**
+ * @brief On-disk layout of paged table files (<table>.tbl)
+ *
+ * Page 0 is the file header. Every following page is either a slotted
+ * DATA page (slot directory grows forward from the page header, records
+ * grow backward from the end of the page) or an OVERFLOW page holding
+ * part of a record that does not fit in an empty data page. All integers
+ * are little-endian and every page carries a CRC-32 of its contents.
+ *
+ * From version 3, values that repeat within a column are written once into
+ * DICTIONARY pages that follow the data pages; records refer to them by a
+ * per-column code in place of the value's bytes.
+ */
+namespace PageFormat {
+    constexpr int PAGE_SIZE = 8192;
+    constexpr quint16 FORMAT_VERSION = 3;     // 2: records carry their row id, 3: column dictionaries
+    constexpr char MAGIC[4] = {'S', 'R', 'D', 'B'};
+
+    // File header (page 0)
+    constexpr int HEADER_MAGIC = 0;
+    constexpr int HEADER_FORMAT_VERSION = 4;
+    constexpr int HEADER_FLAGS = 6;
+    constexpr int HEADER_PAGE_SIZE = 8;
+    constexpr int HEADER_SCHEMA_VERSION = 12;
+    constexpr int HEADER_PAGE_COUNT = 16;
+    constexpr int HEADER_COLUMN_COUNT = 20;
+    constexpr int HEADER_ROW_COUNT = 24;
+    constexpr int HEADER_CHECKPOINT_LSN = 32; // Last WAL record reflected in this file
+    constexpr int HEADER_NEXT_ROW_ID = 40;  // Row id the table assigns next
+    constexpr int HEADER_DICTIONARY_PAGE = 48; // First page after the data pages, 0 without dictionaries (version 3+)
+    constexpr int HEADER_CHECKSUM = 64;     // CRC-32 of bytes [0, 64)
+
+    // Page header (DATA and OVERFLOW pages)
+    constexpr int PAGE_TYPE = 0;
+    constexpr int PAGE_FLAGS = 1;
+    constexpr int PAGE_SLOT_COUNT = 2;
+    constexpr int PAGE_FREE_START = 4;      // End of slot directory / overflow payload
+    constexpr int PAGE_FREE_END = 6;        // Start of record area
+    constexpr int PAGE_NEXT = 8;            // Next page of an overflow chain
+    constexpr int PAGE_CHECKSUM = 12;       // CRC-32 of the page with this field zeroed
+    constexpr int PAGE_HEADER_SIZE = 16;
+
+    constexpr int SLOT_SIZE = 4;            // u16 offset, u16 length
+    constexpr quint16 SLOT_OVERFLOW = 0x8000; // Offset flag: record is an overflow stub
+    constexpr int OVERFLOW_STUB_SIZE = 8;   // u32 first page, u32 total length
+    constexpr int RECORD_ROW_ID_SIZE = 8;   // u64 row id in front of each encoded row (version 2+)
+    constexpr quint32 DICTIONARY_REF = 0x80000000; // Field length flag: the low bits are a dictionary code (version 3+)
+
+    enum PageType : quint8 {
+        FREE_PAGE = 0,
+        DATA_PAGE = 1,
+        OVERFLOW_PAGE = 2,
+        DICTIONARY_PAGE = 3     // Records are a u32 column followed by the value's UTF-8 bytes
+    };
+}
+
+/**
+ * @brief A single fixed-size slotted page
+ */
+class SlottedPage {
+public:
+    SlottedPage();
+    explicit SlottedPage(const QByteArray& bytes);
+
+    void reset(PageFormat::PageType type);
+
+    PageFormat::PageType getType() const;
+    int getSlotCount() const;
+    int getFreeSpace() const;
+    quint32 getNextPage() const;
+    void setNextPage(quint32 pageNo);
+
+    // DATA pages
+    bool addRecord(const QByteArray& record, bool overflowStub = false);
+    QByteArray getRecord(int slot, bool* overflowStub = nullptr) const;
+
+    // OVERFLOW pages
+    int setOverflowPayload(const char* data, int length);
+    QByteArray getOverflowPayload() const;
+
+    // Checksums
+    void seal();
+    bool verify() const;
+
+    const QByteArray& bytes() const { return data; }
+
+private:
+    QByteArray data;
+
+    quint16 readU16(int offset) const;
+    quint32 readU32(int offset) const;
+    void writeU16(int offset, quint16 value);
+    void writeU32(int offset, quint32 value);
+};
+
+/**
+ * @brief Streams rows into a new paged table file
+ *
+ * Pages are written sequentially to a temporary file that atomically
+ * replaces the target on commit(), so readers never observe a torn file.
+ * A value is written inline the first time a column holds it and by
+ * dictionary code after that; columns that turn out to be mostly distinct
+ * stop collecting values.
+ */
+class PageFileWriter {
+public:
+    PageFileWriter(const QString& filePath, quint32 schemaVersion, quint32 columnCount);
+    ~PageFileWriter();
+
+    bool open();
+    // rowId < 0 numbers rows by their position in the file
+    bool appendRow(const QStringList& row, qint64 rowId = -1);
+    bool commit();
+    void cancel();
+
+    void setCheckpointLsn(quint64 lsn) { checkpointLsn = lsn; }
+    void setNextRowId(quint64 rowId) { nextRowId = rowId; }
+    quint64 getRowCount() const { return rowCount; }
+    // Values written to dictionary pages so far, over all columns
+    int getDictionarySize() const;
+    QString getError() const { return lastError; }
+
+private:
+    QString filePath;
+    quint32 schemaVersion;
+    quint32 columnCount;
+    quint64 checkpointLsn = 0;
+    quint64 nextRowId = 0;
+    std::unique_ptr<QSaveFile> file;
+    SlottedPage currentPage;
+    bool pageHasRecords = false;
+    quint32 nextPageNo = 1;
+    quint64 rowCount = 0;
+    quint32 dictionaryPage = 0;
+    QVector<QHash<QString, qint32>> dictionaryCodes;  // column -> value -> code, -1 when seen once
+    QVector<QStringList> dictionaryValues;            // column -> code -> value
+    QString lastError;
+
+    QByteArray encodeRow(const QStringList& row);
+    qint32 dictionaryCode(int column, const QString& value);
+    bool addRecord(const QByteArray& record);
+    bool writeDictionaries();
+    bool writePage(SlottedPage& page);
+    bool flushCurrentPage();
+    bool writeOverflowChain(const QByteArray& record, quint32& firstPage);
+    QByteArray buildHeader() const;
+};
+
+/**
+ * @brief Reads a paged table file one page at a time
+ */
+class PageFileReader {
+public:
+    explicit PageFileReader(const QString& filePath);
+
+    bool open();
+    // Version 1 files have no stored ids; their rows are numbered by position
+    bool readNextRow(QStringList& row, qint64* rowId = nullptr);
+    void close();
+
+    quint32 getSchemaVersion() const { return schemaVersion; }
+    quint32 getColumnCount() const { return columnCount; }
+    quint32 getPageCount() const { return pageCount; }
+    quint64 getRowCount() const { return rowCount; }
+    quint64 getCheckpointLsn() const { return checkpointLsn; }
+    quint64 getNextRowId() const { return nextRowId; }
+    int getDictionarySize(int column) const { return column < dictionaries.size() ? dictionaries[column].size() : 0; }
+    QString getError() const { return lastError; }
+    bool hasError() const { return !lastError.isEmpty(); }
+
+private:
+    QFile file;
+    quint16 formatVersion = 0;
+    quint32 schemaVersion = 0;
+    quint32 columnCount = 0;
+    quint32 pageCount = 0;
+    quint64 rowCount = 0;
+    quint64 checkpointLsn = 0;
+    quint64 nextRowId = 0;
+    quint32 dictionaryPage = 0;
+    QVector<QVector<QString>> dictionaries;
+    quint64 rowsRead = 0;
+    quint32 currentPageNo = 0;
+    int currentSlot = 0;
+    SlottedPage currentPage;
+    QString lastError;
+
+    bool readPage(quint32 pageNo, SlottedPage& page);
+    bool readOverflowChain(const QByteArray& stub, QByteArray& record);
+    bool readDictionaries();
+};
+
+/**
+ * @brief Row <-> record encoding used inside data pages
+ */
+class RowCodec {
+public:
+    static QByteArray encode(const QStringList& row);
+    // dictionaries resolves fields written as DICTIONARY_REF codes; without it such fields are corrupt
+    static bool decode(const QByteArray& record, QStringList& row,
+                       const QVector<QVector<QString>>* dictionaries = nullptr);
+};
@@ -1,4 +1,5 @@
 #include "storage_engine.h"
+#include "page_file.h"
 #include "../core/table_schema.h"
 #include "../core/column.h"
 #include "../utils/logger.h"
@@ -11,6 +12,7 @@
 
 StorageEngine::StorageEngine(const QString& dataPath) : dataPath(dataPath) {
     initializeDataPath();
+    migrateLegacyTables();
 }
 
 bool StorageEngine::initializeDataPath() {
@@ -26,6 +28,10 @@ bool StorageEngine::initializeDataPath() {
 }
 
 QString StorageEngine::getTableDataPath(const QString& tableName) const {
+    return QDir(dataPath).filePath(tableName + ".tbl");
+}
+
+QString StorageEngine::getLegacyTableDataPath(const QString& tableName) const {
     return QDir(dataPath).filePath(tableName + ".json");
 }
 
@@ -52,6 +58,7 @@ bool StorageEngine::saveTableSchema(const std::shared_ptr<TableSchema>& schema)
     
     file.write(jsonStr.toUtf8());
     file.close();
+    rememberSchema(*schema);
     Logger::instance().debug(QString("Saved schema for table: %1").arg(schema->getTableName()));
     return true;
 }
@@ -75,46 +82,205 @@ std::shared_ptr<TableSchema> StorageEngine::loadTableSchema(const QString& table
         return nullptr;
     }
     
+    rememberSchema(*schema);
     Logger::instance().debug(QString("Loaded schema for table: %1").arg(tableName));
     return std::shared_ptr<TableSchema>(schema);
 }
 
-bool StorageEngine::saveTableData(const QString& tableName, const QVector<QStringList>& rows) {
-    QString dataPath = getTableDataPath(tableName);
+void StorageEngine::rememberSchema(const TableSchema& schema) {
+    SchemaInfo info;
+    info.version = schema.getMetadata().schemaVersion;
+    info.columnCount = schema.getColumnCount();
+    schemaInfo[schema.getTableName().toLower()] = info;
+}
+
+StorageEngine::SchemaInfo StorageEngine::getSchemaInfo(const QString& tableName) {
+    auto it = schemaInfo.find(tableName.toLower());
+    if (it != schemaInfo.end()) {
+        return it.value();
+    }
     
-    // Load schema for proper data formatting
-    auto schema = loadTableSchema(tableName);
+    // Not seen yet in this session - loading the schema records it
+    if (loadTableSchema(tableName)) {
+        return schemaInfo.value(tableName.toLower());
+    }
+    return SchemaInfo();
+}
+
+bool StorageEngine::saveTableData(const QString& tableName, const QVector<QStringList>& rows, quint64 checkpointLsn,
+                                  const QVector<qint64>& rowIds, qint64 nextRowId) {
+    QString filePath = getTableDataPath(tableName);
+    SchemaInfo info = getSchemaInfo(tableName);
     
-    QJsonObject dataObj;
-    dataObj["tableName"] = tableName;
-    dataObj["rowCount"] = static_cast<int>(rows.size());
-    
-    QJsonArray rowsArray;
-    for (const QStringList& row : rows) {
-        if (schema) {
-            rowsArray.append(rowToJson(row, schema));
-        } else {
-            // Fallback: store as simple string array
-            rowsArray.append(QJsonArray::fromStringList(row));
+    // Rows are streamed into pages; the previous file is replaced only on commit
+    PageFileWriter writer(filePath, info.version, info.columnCount);
+    writer.setCheckpointLsn(checkpointLsn);
+    writer.setNextRowId(static_cast<quint64>(qMax<qint64>(nextRowId, 0)));
+    if (!writer.open()) {
+        Logger::instance().error(writer.getError());
+        return false;
+    }
+    
+    bool hasIds = rowIds.size() == rows.size();
+    for (int i = 0; i < rows.size(); ++i) {
+        if (!writer.appendRow(rows[i], hasIds ? rowIds[i] : -1)) {
+            Logger::instance().error(QString("Failed to save table %1: %2").arg(tableName, writer.getError()));
+            return false;
         }
     }
-    dataObj["rows"] = rowsArray;
     
-    QJsonDocument doc(dataObj);
-    QFile file(dataPath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        Logger::instance().error(QString("Failed to open data file for writing: %1").arg(dataPath));
+    if (!writer.commit()) {
+        Logger::instance().error(writer.getError());
+        return false;
+    }
+    
+    Logger::instance().debug(QString("Saved data for table: %1 (%2 rows, %3 dictionary values)")
+        .arg(tableName).arg(rows.size()).arg(writer.getDictionarySize()));
+    return true;
+}
+
+QVector<QStringList> StorageEngine::loadTableData(const QString& tableName, quint64* checkpointLsn,
+                                                  QVector<qint64>* rowIds, qint64* nextRowId) {
+    QString filePath = getTableDataPath(tableName);
+    if (checkpointLsn) {
+        *checkpointLsn = 0;
+    }
+    if (rowIds) {
+        rowIds->clear();
+    }
+    if (nextRowId) {
+        *nextRowId = 0;
+    }
+    
+    if (!QFile::exists(filePath)) {
+        if (QFile::exists(getLegacyTableDataPath(tableName))) {
+            QVector<QStringList> rows = loadLegacyTableData(tableName);
+            // Legacy files have no ids; number rows by position
+            if (rowIds) {
+                rowIds->reserve(rows.size());
+                for (int i = 0; i < rows.size(); ++i) {
+                    rowIds->append(i);
+                }
+            }
+            if (nextRowId) {
+                *nextRowId = rows.size();
+            }
+            return rows;
+        }
+        Logger::instance().warning(QString("Data file not found: %1").arg(filePath));
+        return QVector<QStringList>();
+    }
+    
+    PageFileReader reader(filePath);
+    if (!reader.open()) {
+        Logger::instance().error(QString("Failed to open table file %1: %2").arg(filePath, reader.getError()));
+        return QVector<QStringList>();
+    }
+    
+    if (checkpointLsn) {
+        *checkpointLsn = reader.getCheckpointLsn();
+    }
+    if (nextRowId) {
+        *nextRowId = static_cast<qint64>(reader.getNextRowId());
+    }
+    
+    SchemaInfo info = getSchemaInfo(tableName);
+    if (static_cast<int>(reader.getSchemaVersion()) != info.version) {
+        Logger::instance().warning(QString("Table file %1 was written with schema version %2, current schema is version %3")
+            .arg(filePath).arg(reader.getSchemaVersion()).arg(info.version));
+    }
+    
+    QVector<QStringList> rows;
+    rows.reserve(static_cast<int>(reader.getRowCount()));
+    if (rowIds) {
+        rowIds->reserve(static_cast<int>(reader.getRowCount()));
+    }
+    
+    QStringList row;
+    qint64 rowId = 0;
+    while (reader.readNextRow(row, &rowId)) {
+        rows.append(row);
+        if (rowIds) {
+            rowIds->append(rowId);
+        }
+    }
+    
+    if (reader.hasError()) {
+        Logger::instance().error(QString("Error reading table file %1 after %2 rows: %3")
+            .arg(filePath).arg(rows.size()).arg(reader.getError()));
+    }
+    
+    Logger::instance().debug(QString("Loaded data for table: %1 (%2 rows, %3 pages)")
+        .arg(tableName).arg(rows.size()).arg(reader.getPageCount()));
+    return rows;
+}
+
+int StorageEngine::migrateLegacyTables() {
+    int migrated = 0;
+    
+    for (const QString& tableName : listAllTables()) {
+        if (!migrateLegacySchema(tableName)) {
+            continue;
+        }
+        
+        QString legacyPath = getLegacyTableDataPath(tableName);
+        if (!QFile::exists(legacyPath) || QFile::exists(getTableDataPath(tableName))) {
+            continue;
+        }
+        
+        QVector<QStringList> rows = loadLegacyTableData(tableName);
+        if (!saveTableData(tableName, rows)) {
+            Logger::instance().error(QString("Failed to migrate table %1 to paged format").arg(tableName));
+            continue;
+        }
+        
+        // Keep the original around until the user removes it
+        QString backupPath = legacyPath + ".bak";
+        QFile::remove(backupPath);
+        if (!QFile::rename(legacyPath, backupPath)) {
+            Logger::instance().warning(QString("Migrated %1 but could not rename %2").arg(tableName, legacyPath));
+        }
+        
+        Logger::instance().info(QString("Migrated table %1 to paged format (%2 rows)").arg(tableName).arg(rows.size()));
+        migrated++;
+    }
+    
+    return migrated;
+}
+
+bool StorageEngine::migrateLegacySchema(const QString& tableName) {
+    QString schemaPath = getTableSchemaPath(tableName);
+    
+    QFile file(schemaPath);
+    if (!file.open(QIODevice::ReadOnly)) {
         return false;
     }
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
     
-    file.write(doc.toJson());
+    if (!doc.isObject()) {
+        Logger::instance().error(QString("Invalid schema JSON format: %1").arg(schemaPath));
+        return false;
+    }
+    
+    QJsonObject tableObj = doc.object();
+    if (tableObj.contains("schemaVersion")) {
+        return true;
+    }
+    
+    // Add the version field in place so no other schema content is touched
+    tableObj["schemaVersion"] = 1;
+    if (!file.open(QIODevice::WriteOnly)) {
+        Logger::instance().error(QString("Failed to open schema file for writing: %1").arg(schemaPath));
+        return false;
+    }
+    file.write(QJsonDocument(tableObj).toJson());
     file.close();
-    Logger::instance().debug(QString("Saved data for table: %1 (%2 rows)").arg(tableName).arg(rows.size()));
     return true;
 }
 
-QVector<QStringList> StorageEngine::loadTableData(const QString& tableName) {
-    QString dataPath = getTableDataPath(tableName);
+QVector<QStringList> StorageEngine::loadLegacyTableData(const QString& tableName) {
+    QString dataPath = getLegacyTableDataPath(tableName);
     
     QFile file(dataPath);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -150,12 +316,12 @@ QVector<QStringList> StorageEngine::loadTableData(const QString& tableName) {
         }
     }
     
-    Logger::instance().debug(QString("Loaded data for table: %1 (%2 rows)").arg(tableName).arg(rows.size()));
+    Logger::instance().debug(QString("Loaded legacy data for table: %1 (%2 rows)").arg(tableName).arg(rows.size()));
     return rows;
 }
 
 bool StorageEngine::tableFileExists(const QString& tableName) const {
-    return QFile::exists(getTableDataPath(tableName));
+    return QFile::exists(getTableDataPath(tableName)) || QFile::exists(getLegacyTableDataPath(tableName));
 }
 
 bool StorageEngine::schemaFileExists(const QString& tableName) const {
@@ -163,13 +329,15 @@ bool StorageEngine::schemaFileExists(const QString& tableName) const {
 }
 
 bool StorageEngine::deleteTableFile(const QString& tableName) {
-    QString dataPath = getTableDataPath(tableName);
-    if (QFile::exists(dataPath)) {
-        if (!QFile::remove(dataPath)) {
-            Logger::instance().error(QString("Failed to delete data file: %1").arg(dataPath));
-            return false;
+    for (const QString& dataPath : {getTableDataPath(tableName), getLegacyTableDataPath(tableName)}) {
+        if (QFile::exists(dataPath)) {
+            if (!QFile::remove(dataPath)) {
+                Logger::instance().error(QString("Failed to delete data file: %1").arg(dataPath));
+                return false;
+            }
         }
     }
+    schemaInfo.remove(tableName.toLower());
     return deleteSchemaFile(tableName);
 }
 
@@ -200,17 +368,6 @@ QVector<QString> StorageEngine::listAllTables() const {
     return tableNames;
 }
 
-QJsonObject StorageEngine::rowToJson(const QStringList& row, const std::shared_ptr<TableSchema>& schema) {
-    QJsonObject obj;
-    for (int i = 0; i < row.size() && i < schema->getColumnCount(); ++i) {
-        const Column* col = schema->getColumn(i);
-        if (col) {
-            obj[col->getName()] = row[i];
-        }
-    }
-    return obj;
-}
-
 QStringList StorageEngine::jsonToRow(const QJsonObject& obj, const std::shared_ptr<TableSchema>& schema) {
     QStringList row;
     for (int i = 0; i < schema->getColumnCount(); ++i) {
@@ -2,6 +2,7 @@
 
 #include <QString>
 #include <QVector>
+#include <QMap>
 #include <QJsonObject>
 #include <memory>
 
@@ -24,9 +25,16 @@ public:
     bool saveTableSchema(const std::shared_ptr<TableSchema>& schema);
     std::shared_ptr<TableSchema> loadTableSchema(const QString& tableName);
     
-    // Data persistence
-    bool saveTableData(const QString& tableName, const QVector<QStringList>& rows);
-    QVector<QStringList> loadTableData(const QString& tableName);
+    // Data persistence (paged <table>.tbl files)
+    // checkpointLsn records the last write-ahead log entry already reflected in the rows.
+    // rowIds, when given, holds the stable id of each row; otherwise rows are numbered by position.
+    bool saveTableData(const QString& tableName, const QVector<QStringList>& rows, quint64 checkpointLsn = 0,
+                       const QVector<qint64>& rowIds = QVector<qint64>(), qint64 nextRowId = 0);
+    QVector<QStringList> loadTableData(const QString& tableName, quint64* checkpointLsn = nullptr,
+                                       QVector<qint64>* rowIds = nullptr, qint64* nextRowId = nullptr);
+    
+    // One-shot conversion of legacy <table>.json / <table>_schema.json files
+    int migrateLegacyTables();
     
     // File management
     bool tableFileExists(const QString& tableName) const;
@@ -37,9 +45,22 @@ public:
     
 private:
     QString dataPath;
+    
+    // Shape of the last saved/loaded schema, recorded in table file headers
+    struct SchemaInfo {
+        int version = 1;
+        int columnCount = 0;
+    };
+    QMap<QString, SchemaInfo> schemaInfo;  // lowercase table name -> info
+    
     QString getTableDataPath(const QString& tableName) const;
+    QString getLegacyTableDataPath(const QString& tableName) const;
     QString getTableSchemaPath(const QString& tableName) const;
+    SchemaInfo getSchemaInfo(const QString& tableName);
+    void rememberSchema(const TableSchema& schema);
     
-    // JSON conversion helpers
-    QJsonObject rowToJson(const QStringList& row, const std::shared_ptr<TableSchema>& schema);
-    QStringList jsonToRow(const QJsonObject& obj, const std::shared_ptr<TableSchema>& schema);};
\ No newline at end of file
+    // Legacy JSON format helpers
+    QVector<QStringList> loadLegacyTableData(const QString& tableName);
+    bool migrateLegacySchema(const QString& tableName);
+    QStringList jsonToRow(const QJsonObject& obj, const std::shared_ptr<TableSchema>& schema);
+};
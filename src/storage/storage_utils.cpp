@@ -0,0 +1,53 @@
+#include "storage_utils.h"
+#include <QFileDevice>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct Crc32Table {
+    quint32 entries[256];
+    
+    Crc32Table() {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+}
+
+quint32 StorageUtils::crc32(const char* data, qsizetype length, quint32 seed) {
+    static const Crc32Table table;
+    
+    quint32 crc = ~seed;
+    for (qsizetype i = 0; i < length; ++i) {
+        crc = table.entries[(crc ^ static_cast<quint8>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+bool StorageUtils::syncToDisk(QFileDevice& file) {
+    if (!file.flush()) {
+        return false;
+    }
+    
+    int fd = file.handle();
+    if (fd < 0) {
+        return false;
+    }
+    
+#ifdef Q_OS_WIN
+    return _commit(fd) == 0;
+#else
+    return fsync(fd) == 0;
+#endif
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+
+class QFileDevice;
+
+/**
+ * @brief Low-level helpers shared by the on-disk file formats
+ */
+class StorageUtils {
+public:
+    // CRC-32 (IEEE 802.3) used for page and header checksums
+    static quint32 crc32(const char* data, qsizetype length, quint32 seed = 0);
+    static quint32 crc32(const QByteArray& data) { return crc32(data.constData(), data.size()); }
+    
+    // Force written data from the OS cache onto stable storage
+    static bool syncToDisk(QFileDevice& file);
+};
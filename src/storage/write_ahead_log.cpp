@@ -0,0 +1,404 @@
+#include "write_ahead_log.h"
+#include "page_file.h"
+#include "storage_utils.h"
+#include "../utils/logger.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr char WAL_MAGIC[4] = {'S', 'R', 'W', 'L'};
+constexpr quint32 WAL_VERSION = 1;
+constexpr int WAL_HEADER_SIZE = 16;         // magic, u32 version, u64 first LSN
+constexpr int FRAME_HEADER_SIZE = 8;        // u32 payload length, u32 crc32
+constexpr quint32 MAX_PAYLOAD_SIZE = 64 * 1024 * 1024;
+
+template <typename T>
+void appendInt(QByteArray& out, T value) {
+    char buf[sizeof(T)];
+    qToLittleEndian<T>(value, buf);
+    out.append(buf, sizeof(T));
+}
+
+template <typename T>
+bool readInt(const QByteArray& in, int& pos, T& value) {
+    if (pos + static_cast<int>(sizeof(T)) > in.size()) {
+        return false;
+    }
+    value = qFromLittleEndian<T>(in.constData() + pos);
+    pos += sizeof(T);
+    return true;
+}
+
+QByteArray buildHeader(quint64 firstLsn) {
+    QByteArray header(WAL_MAGIC, sizeof(WAL_MAGIC));
+    appendInt<quint32>(header, WAL_VERSION);
+    appendInt<quint64>(header, firstLsn);
+    return header;
+}
+
+}
+
+WriteAheadLog::WriteAheadLog(const QString& dataPath)
+    : dataPath(dataPath) {
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    close();
+}
+
+bool WriteAheadLog::open() {
+    QMutexLocker locker(&mutex);
+    QDir dir(dataPath);
+
+    // Single-file logs written before segments were introduced become segment 1
+    if (dir.exists("wal.log") && !dir.exists(segmentPath(1))) {
+        dir.rename("wal.log", segmentPath(1));
+    }
+
+    segments.clear();
+    for (const QString& name : dir.entryList(QStringList() << "wal_*.log", QDir::Files)) {
+        bool ok = false;
+        int id = name.mid(4, name.length() - 8).toInt(&ok);
+        if (ok && id > 0) {
+            segments.append(id);
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+
+    if (segments.isEmpty()) {
+        return createSegment(1);
+    }
+
+    // Older segments only contribute to LSN numbering and the size total
+    inactiveBytes = 0;
+    for (int i = 0; i < segments.size() - 1; ++i) {
+        QFile segment(segmentPath(segments[i]));
+        if (!segment.open(QIODevice::ReadOnly) || scan(segment, nullptr) < 0) {
+            Logger::instance().error(lastError.isEmpty() ? segment.errorString() : lastError);
+            return false;
+        }
+        inactiveBytes += segment.size();
+    }
+
+    file.setFileName(segmentPath(segments.last()));
+    if (!file.open(QIODevice::ReadWrite)) {
+        lastError = QString("Failed to open write-ahead log %1: %2").arg(file.fileName(), file.errorString());
+        Logger::instance().error(lastError);
+        return false;
+    }
+
+    qint64 end = scan(file, nullptr);
+    if (end < 0) {
+        Logger::instance().error(lastError);
+        file.close();
+        return false;
+    }
+
+    // Drop a torn record left behind by a crash mid-append
+    if (end < file.size()) {
+        Logger::instance().warning(QString("Discarding %1 bytes of incomplete records at the end of %2")
+            .arg(file.size() - end).arg(file.fileName()));
+        file.resize(end);
+    }
+
+    file.seek(end);
+    sinceLastSync.start();
+    return true;
+}
+
+void WriteAheadLog::close() {
+    QMutexLocker locker(&mutex);
+    if (file.isOpen()) {
+        syncLocked();
+        file.close();
+    }
+}
+
+bool WriteAheadLog::append(WalRecord& record) {
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        lastError = "Write-ahead log is not open";
+        return false;
+    }
+
+    record.lsn = nextLsn;
+    QByteArray frame;
+    appendFrame(frame, record);
+    return writeFramesLocked(frame, 1);
+}
+
+bool WriteAheadLog::appendBatch(QVector<WalRecord>& records, bool syncNow) {
+    if (records.isEmpty()) {
+        return true;
+    }
+
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        lastError = "Write-ahead log is not open";
+        return false;
+    }
+
+    QByteArray frames;
+    for (int i = 0; i < records.size(); ++i) {
+        records[i].lsn = nextLsn + i;
+        appendFrame(frames, records[i]);
+    }
+    return writeFramesLocked(frames, records.size(), syncNow);
+}
+
+void WriteAheadLog::appendFrame(QByteArray& out, const WalRecord& record) {
+    QByteArray payload = encode(record);
+    out.reserve(out.size() + FRAME_HEADER_SIZE + payload.size());
+    appendInt<quint32>(out, static_cast<quint32>(payload.size()));
+    appendInt<quint32>(out, StorageUtils::crc32(payload));
+    out.append(payload);
+}
+
+bool WriteAheadLog::writeFramesLocked(const QByteArray& frames, int recordCount, bool syncNow) {
+    qint64 before = file.pos();
+    if (file.write(frames) != frames.size() || !file.flush()) {
+        lastError = QString("Failed to append to write-ahead log: %1").arg(file.errorString());
+        file.resize(before);
+        file.seek(before);
+        return false;
+    }
+
+    const bool hadUnsyncedRecords = unsyncedRecords;
+    nextLsn += recordCount;
+    unsyncedRecords = true;
+
+    if (syncPolicy == SyncPolicy::EVERY_WRITE || (syncNow && syncPolicy != SyncPolicy::NONE) ||
+        (syncPolicy == SyncPolicy::INTERVAL && sinceLastSync.elapsed() >= syncIntervalMs)) {
+        if (!syncLocked()) {
+            // The caller is told the records were not logged, so take them back out
+            file.resize(before);
+            file.seek(before);
+            nextLsn -= recordCount;
+            unsyncedRecords = hadUnsyncedRecords;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WriteAheadLog::sync() {
+    QMutexLocker locker(&mutex);
+    return syncLocked();
+}
+
+bool WriteAheadLog::syncLocked() {
+    if (!unsyncedRecords) {
+        return true;
+    }
+    if (!StorageUtils::syncToDisk(file)) {
+        lastError = QString("Failed to sync write-ahead log: %1").arg(file.errorString());
+        return false;
+    }
+    unsyncedRecords = false;
+    sinceLastSync.restart();
+    return true;
+}
+
+int WriteAheadLog::replay(const std::function<void(const WalRecord&)>& apply) {
+    QMutexLocker locker(&mutex);
+    int count = 0;
+    auto visit = [&](const WalRecord& record) {
+        apply(record);
+        count++;
+    };
+
+    for (int i = 0; i < segments.size() - 1; ++i) {
+        QFile segment(segmentPath(segments[i]));
+        if (segment.open(QIODevice::ReadOnly)) {
+            scan(segment, visit);
+        }
+    }
+    if (file.isOpen()) {
+        scan(file, visit);
+        file.seek(file.size());
+    }
+    return count;
+}
+
+int WriteAheadLog::rotate() {
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        lastError = "Write-ahead log is not open";
+        return -1;
+    }
+
+    // Nothing to seal off, keep appending to the current segment
+    if (file.size() <= WAL_HEADER_SIZE) {
+        return segments.last();
+    }
+
+    if (!syncLocked()) {
+        return -1;
+    }
+    qint64 sealedSize = file.size();
+    file.close();
+
+    if (!createSegment(segments.last() + 1)) {
+        // Keep logging into the previous segment rather than losing records
+        file.setFileName(segmentPath(segments.last()));
+        if (file.open(QIODevice::ReadWrite)) {
+            file.seek(file.size());
+        }
+        return -1;
+    }
+    inactiveBytes += sealedSize;
+    return segments.last();
+}
+
+void WriteAheadLog::removeSegmentsBefore(int segmentId) {
+    QMutexLocker locker(&mutex);
+    while (segments.size() > 1 && segments.first() < segmentId) {
+        QString path = segmentPath(segments.first());
+        qint64 size = QFileInfo(path).size();
+        if (!QFile::remove(path)) {
+            Logger::instance().warning(QString("Failed to remove write-ahead log segment %1").arg(path));
+            break;
+        }
+        inactiveBytes -= size;
+        segments.removeFirst();
+    }
+}
+
+void WriteAheadLog::setSyncPolicy(SyncPolicy policy, int intervalMs) {
+    QMutexLocker locker(&mutex);
+    syncPolicy = policy;
+    syncIntervalMs = intervalMs;
+}
+
+quint64 WriteAheadLog::getLastLsn() const {
+    QMutexLocker locker(&mutex);
+    return nextLsn - 1;
+}
+
+qint64 WriteAheadLog::getSize() const {
+    QMutexLocker locker(&mutex);
+    return inactiveBytes + file.size();
+}
+
+bool WriteAheadLog::isEmpty() const {
+    QMutexLocker locker(&mutex);
+    return segments.size() <= 1 && file.size() <= WAL_HEADER_SIZE;
+}
+
+QString WriteAheadLog::segmentPath(int segmentId) const {
+    return QDir(dataPath).filePath(QString("wal_%1.log").arg(segmentId, 8, 10, QChar('0')));
+}
+
+bool WriteAheadLog::createSegment(int segmentId) {
+    file.setFileName(segmentPath(segmentId));
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        lastError = QString("Failed to create write-ahead log segment %1: %2").arg(file.fileName(), file.errorString());
+        Logger::instance().error(lastError);
+        return false;
+    }
+
+    // The header remembers where numbering continues so LSNs never go backwards
+    if (file.write(buildHeader(nextLsn)) != WAL_HEADER_SIZE || !StorageUtils::syncToDisk(file)) {
+        lastError = QString("Failed to initialize write-ahead log segment: %1").arg(file.errorString());
+        Logger::instance().error(lastError);
+        file.close();
+        return false;
+    }
+
+    segments.append(segmentId);
+    unsyncedRecords = false;
+    sinceLastSync.start();
+    return true;
+}
+
+qint64 WriteAheadLog::scan(QFile& segment, const std::function<void(const WalRecord&)>& visit) {
+    segment.seek(0);
+    QByteArray header = segment.read(WAL_HEADER_SIZE);
+    if (header.size() != WAL_HEADER_SIZE || std::memcmp(header.constData(), WAL_MAGIC, sizeof(WAL_MAGIC)) != 0) {
+        lastError = QString("%1 is not a write-ahead log").arg(segment.fileName());
+        return -1;
+    }
+
+    int pos = 4;
+    quint32 version = 0;
+    quint64 firstLsn = 1;
+    readInt(header, pos, version);
+    readInt(header, pos, firstLsn);
+    if (version > WAL_VERSION) {
+        lastError = QString("Unsupported write-ahead log version %1").arg(version);
+        return -1;
+    }
+    nextLsn = qMax(nextLsn, firstLsn);
+
+    qint64 offset = WAL_HEADER_SIZE;
+    while (true) {
+        QByteArray frameHeader = segment.read(FRAME_HEADER_SIZE);
+        if (frameHeader.size() != FRAME_HEADER_SIZE) {
+            break;
+        }
+
+        int hpos = 0;
+        quint32 length = 0;
+        quint32 checksum = 0;
+        readInt(frameHeader, hpos, length);
+        readInt(frameHeader, hpos, checksum);
+        if (length > MAX_PAYLOAD_SIZE) {
+            break;
+        }
+
+        QByteArray payload = segment.read(length);
+        if (static_cast<quint32>(payload.size()) != length || StorageUtils::crc32(payload) != checksum) {
+            break;
+        }
+
+        WalRecord record;
+        if (!decode(payload, record)) {
+            break;
+        }
+
+        nextLsn = qMax(nextLsn, record.lsn + 1);
+        if (visit) {
+            visit(record);
+        }
+        offset += FRAME_HEADER_SIZE + length;
+    }
+    return offset;
+}
+
+QByteArray WriteAheadLog::encode(const WalRecord& record) {
+    QByteArray payload;
+    QByteArray table = record.tableName.toUtf8();
+
+    appendInt<quint64>(payload, record.lsn);
+    appendInt<quint8>(payload, record.operation);
+    appendInt<quint32>(payload, static_cast<quint32>(table.size()));
+    payload.append(table);
+    appendInt<qint64>(payload, record.rowId);
+    payload.append(RowCodec::encode(record.values));
+    return payload;
+}
+
+bool WriteAheadLog::decode(const QByteArray& payload, WalRecord& record) {
+    int pos = 0;
+    quint8 op = 0;
+    quint32 tableLength = 0;
+
+    if (!readInt(payload, pos, record.lsn) || !readInt(payload, pos, op) || !readInt(payload, pos, tableLength)) {
+        return false;
+    }
+    if (op < WalRecord::INSERT || op > WalRecord::DELETE || pos + static_cast<qint64>(tableLength) > payload.size()) {
+        return false;
+    }
+    record.operation = static_cast<WalRecord::Operation>(op);
+    record.tableName = QString::fromUtf8(payload.constData() + pos, tableLength);
+    pos += tableLength;
+
+    if (!readInt(payload, pos, record.rowId)) {
+        return false;
+    }
+    return RowCodec::decode(payload.mid(pos), record.values);
+}
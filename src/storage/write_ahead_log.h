@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QFile>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <functional>
+
+/**
+ * @brief A single redo record in the write-ahead log
+ */
+struct WalRecord {
+    enum Operation : quint8 {
+        INSERT = 1,
+        UPDATE = 2,
+        DELETE = 3
+    };
+
+    quint64 lsn = 0;            // Log sequence number, assigned on append
+    Operation operation = INSERT;
+    QString tableName;
+    qint64 rowId = -1;
+    QStringList values;         // Full row image for INSERT/UPDATE, empty for DELETE
+};
+
+/**
+ * @brief Append-only redo log for row mutations
+ *
+ * The log is a sequence of segment files (wal_00000001.log, ...); records
+ * are only appended to the newest one. Each record is framed as
+ * [u32 length][u32 crc32][payload] so a torn write at the tail is detected
+ * and discarded when the log is reopened. A checkpoint rotates to a fresh
+ * segment, writes the tables, then removes the segments it has made
+ * redundant while new records keep flowing into the active segment.
+ */
+class WriteAheadLog {
+public:
+    enum class SyncPolicy {
+        EVERY_WRITE,    // fsync after every record (safest, slowest)
+        INTERVAL,       // fsync at most once per sync interval
+        NONE            // hand records to the OS, never fsync explicitly
+    };
+
+    explicit WriteAheadLog(const QString& dataPath);
+    ~WriteAheadLog();
+
+    bool open();
+    void close();
+
+    // Appends the record, assigning its LSN. Returns false if it could not be written, or
+    // synced when the policy syncs this write; the log is then left as it was before.
+    bool append(WalRecord& record);
+    // Appends the records with consecutive LSNs in one write and at most one sync;
+    // either all of them are written or none. With syncNow the write is synced at once
+    // unless the policy is NONE (a transaction commit), and taken back out if that fails.
+    bool appendBatch(QVector<WalRecord>& records, bool syncNow = false);
+    bool sync();
+
+    // Invokes apply() for every intact record in log order
+    int replay(const std::function<void(const WalRecord&)>& apply);
+
+    // Starts a new active segment and returns its id (-1 on failure)
+    int rotate();
+    // Deletes every segment older than segmentId once a checkpoint covers them
+    void removeSegmentsBefore(int segmentId);
+
+    void setSyncPolicy(SyncPolicy policy, int intervalMs = 100);
+    SyncPolicy getSyncPolicy() const { return syncPolicy; }
+
+    quint64 getLastLsn() const;
+    qint64 getSize() const;     // Bytes across all segments
+    bool isEmpty() const;
+    QString getFilePath() const { return file.fileName(); }
+    QString getLastError() const { return lastError; }
+
+private:
+    QString dataPath;
+    QFile file;                 // Active segment
+    QVector<int> segments;      // Segment ids, oldest first; the last one is active
+    qint64 inactiveBytes = 0;
+    quint64 nextLsn = 1;
+    SyncPolicy syncPolicy = SyncPolicy::INTERVAL;
+    int syncIntervalMs = 100;
+    QElapsedTimer sinceLastSync;
+    bool unsyncedRecords = false;
+    QString lastError;
+    mutable QMutex mutex;
+
+    QString segmentPath(int segmentId) const;
+    bool createSegment(int segmentId);
+    bool syncLocked();
+    bool writeFramesLocked(const QByteArray& frames, int recordCount, bool syncNow = false);
+
+    static void appendFrame(QByteArray& out, const WalRecord& record);
+
+    static QByteArray encode(const WalRecord& record);
+    static bool decode(const QByteArray& payload, WalRecord& record);
+
+    // Reads frames from the start of a segment, returning the offset after the last intact one
+    qint64 scan(QFile& segment, const std::function<void(const WalRecord&)>& visit);
+};
@@ -13,8 +13,11 @@ LogsPage::LogsPage(QWidget* parent)
     staticInstance = this;
     
     // Register this page with the logger so it receives all log messages
+    // Messages from worker threads are queued onto the UI thread
     Logger::instance().setLogCallback([this](const QString& message) {
-        this->addLog(message);
+        QMetaObject::invokeMethod(this, [this, message]() {
+            this->addLog(message);
+        }, Qt::AutoConnection);
     });
 }
 
@@ -113,7 +113,11 @@ void TableManagerPage::deleteTable() {
                                        QMessageBox::Yes | QMessageBox::No);
     
     if (reply == QMessageBox::Yes) {
-        tableManager->removeTable(tableName);
+        if (!tableManager->removeTable(tableName)) {
+            QMessageBox::warning(this, "Table In Use",
+                                 QString("Table '%1' is in use by another session; try again later.").arg(tableName));
+            return;
+        }
         refreshTableList();
         
         // Clear display if the deleted table was showing
@@ -49,6 +49,9 @@ void Logger::log(LogLevel level, const QString& message) {
     QString levelStr = levelToString(level);
     QString formattedMsg = QString("[%1] %2: %3").arg(timestamp, levelStr, message);
     
+    // Background threads (e.g. the checkpointer) log too
+    QMutexLocker locker(&mutex);
+    
     // Console output
     std::cout << formattedMsg.toStdString() << std::endl;
     
@@ -2,6 +2,7 @@
 
 #include <QString>
 #include <QDateTime>
+#include <QMutex>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -52,6 +53,7 @@ private:
     QString logFilePath;
     std::ofstream logStream;
     LogCallback uiCallback;
+    QMutex mutex;
 };
 
 #define LOG_DEBUG(msg) Logger::instance().debug(msg)
@@ -2,10 +2,15 @@
 #include <QString>
 #include <QVector>
 #include <memory>
+#include <atomic>
+#include <QThread>
 #include "src/core/table_manager.h"
 #include "src/core/table_schema.h"
 #include "src/core/column.h"
 #include "src/core/data_type.h"
+#include "src/core/query_executor.h"
+#include "src/parser/lexer.h"
+#include "src/parser/parser.h"
 #include "src/utils/logger.h"
 
 int main() {
@@ -49,6 +54,18 @@ int main() {
         
         Logger::instance().info("3 rows inserted into 'products'");
         
+        // Orders refer to products by id
+        auto ordersSchema = std::make_shared<TableSchema>("orders");
+        ordersSchema->addColumn(Column("order_id", DataType::INT));
+        ordersSchema->addColumn(Column("product_id", DataType::INT));
+        ordersSchema->addColumn(Column("quantity", DataType::INT));
+        manager.addTable(ordersSchema);
+        
+        manager.insertRow("orders", QVector<QString>() << "10" << "1" << "2");
+        manager.insertRow("orders", QVector<QString>() << "11" << "2" << "5");
+        manager.insertRow("orders", QVector<QString>() << "12" << "1" << "1");
+        Logger::instance().info("3 rows inserted into 'orders'");
+        
         // Save all tables and their data
         manager.saveAllTables();
         Logger::instance().info("All tables saved");
@@ -155,6 +172,220 @@ int main() {
         }
     }
     
+    // Session 3: Query the persisted data with WHERE, ORDER BY and LIMIT
+    {
+        Logger::instance().info("\n--- Session 3: Filtered and Ordered SELECT ---");
+        auto manager = std::make_shared<TableManager>("./persistence_test_data");
+        manager->loadAllTables();
+        
+        QueryExecutor executor;
+        executor.setTableManager(manager);
+        
+        Lexer lexer("SELECT product_name FROM products WHERE price < 500 ORDER BY price DESC LIMIT 1");
+        Parser parser(lexer.tokenize());
+        auto result = executor.execute(parser.parse());
+        
+        if (!result->success || result->rows.size() != 1 || result->rows[0] != QStringList() << "Keyboard") {
+            Logger::instance().error(QString("Filtered SELECT failed: %1").arg(result->errorMessage));
+            return 1;
+        }
+        Logger::instance().info("Filtered SELECT verified: Keyboard");
+        
+        Lexer aggregateLexer("SELECT COUNT(*), MAX(price), MIN(product_name) FROM products WHERE price < 500");
+        Parser aggregateParser(aggregateLexer.tokenize());
+        result = executor.execute(aggregateParser.parse());
+        
+        if (!result->success || result->rows.size() != 1 ||
+            result->rows[0] != QStringList() << "2" << "79.99" << "Keyboard") {
+            Logger::instance().error(QString("Aggregate SELECT failed: %1").arg(result->errorMessage));
+            return 1;
+        }
+        
+        Lexer groupLexer("SELECT product_name, COUNT(*) FROM products GROUP BY product_name "
+                         "HAVING COUNT(*) = 1 AND product_name <> 'Laptop' ORDER BY product_name DESC");
+        Parser groupParser(groupLexer.tokenize());
+        result = executor.execute(groupParser.parse());
+        
+        if (!result->success || result->rows.size() != 2 ||
+            result->rows[0] != QStringList() << "Mouse" << "1" || result->columns[1] != "COUNT(*)") {
+            Logger::instance().error(QString("GROUP BY SELECT failed: %1").arg(result->errorMessage));
+            return 1;
+        }
+        Logger::instance().info("Aggregate and GROUP BY SELECT verified");
+    }
+    
+    // Session 4: Join the persisted tables
+    {
+        Logger::instance().info("\n--- Session 4: JOIN ---");
+        auto manager = std::make_shared<TableManager>("./persistence_test_data");
+        manager->loadAllTables();
+        
+        QueryExecutor executor;
+        executor.setTableManager(manager);
+        
+        // Hash join
+        Lexer lexer("SELECT o.order_id, p.product_name FROM orders o JOIN products p ON o.product_id = p.id "
+                    "ORDER BY o.order_id");
+        Parser parser(lexer.tokenize());
+        auto result = executor.execute(parser.parse());
+        
+        if (!result->success || result->rows.size() != 3 ||
+            result->rows[1] != QStringList() << "11" << "Mouse" || result->columns[1] != "p.product_name") {
+            Logger::instance().error(QString("INNER JOIN failed: %1").arg(result->errorMessage));
+            return 1;
+        }
+        
+        // LEFT JOIN keeps the product nobody ordered, with NULLs for the order
+        Lexer leftLexer("SELECT product_name, quantity FROM products LEFT JOIN orders ON product_id = id "
+                        "WHERE order_id IS NULL");
+        Parser leftParser(leftLexer.tokenize());
+        result = executor.execute(leftParser.parse());
+        
+        if (!result->success || result->rows.size() != 1 || result->rows[0] != QStringList() << "Keyboard" << "") {
+            Logger::instance().error(QString("LEFT JOIN failed: %1").arg(result->errorMessage));
+            return 1;
+        }
+        
+        // Index nested-loop join: two filtered products probe the index on orders
+        Lexer indexLexer("CREATE INDEX idx_orders_product ON orders (product_id)");
+        Parser indexParser(indexLexer.tokenize());
+        result = executor.execute(indexParser.parse());
+        
+        Lexer indexedLexer("SELECT p.product_name, o.quantity FROM products p JOIN orders o ON o.product_id = p.id "
+                           "WHERE p.price < 500");
+        Parser indexedParser(indexedLexer.tokenize());
+        result = executor.execute(indexedParser.parse());
+        
+        if (!result->success || result->rows.size() != 1 || result->rows[0] != QStringList() << "Mouse" << "5") {
+            Logger::instance().error(QString("Indexed JOIN failed: %1").arg(result->errorMessage));
+            return 1;
+        }
+        
+        Lexer ambiguousLexer("SELECT id FROM products JOIN products ON id = id");
+        Parser ambiguousParser(ambiguousLexer.tokenize());
+        result = executor.execute(ambiguousParser.parse());
+        
+        if (result->success) {
+            Logger::instance().error("JOIN of a table with itself without aliases should fail");
+            return 1;
+        }
+        Logger::instance().info("INNER, LEFT and indexed JOIN verified");
+    }
+    
+    // Session 5: Statements from several threads at once
+    {
+        Logger::instance().info("\n--- Session 5: Concurrent Statements ---");
+        auto manager = std::make_shared<TableManager>("./persistence_test_data");
+        
+        auto run = [&manager](const QString& sql) {
+            QueryExecutor executor;
+            executor.setTableManager(manager);
+            Lexer lexer(sql);
+            Parser parser(lexer.tokenize());
+            return executor.execute(parser.parse());
+        };
+        
+        // Readers join both tables while a writer inserts into and deletes from one
+        constexpr int WRITES = 200;
+        std::atomic<int> failures{0};
+        QVector<QThread*> threads;
+        threads.append(QThread::create([&]() {
+            for (int i = 0; i < WRITES; ++i) {
+                if (!run(QString("INSERT INTO orders VALUES (%1, 2, 1)").arg(1000 + i))->success) failures++;
+            }
+            if (!run("DELETE FROM orders WHERE order_id >= 1000")->success) failures++;
+        }));
+        for (int r = 0; r < 3; ++r) {
+            threads.append(QThread::create([&]() {
+                for (int i = 0; i < WRITES; ++i) {
+                    auto result = run("SELECT o.order_id, p.product_name FROM orders o JOIN products p ON o.product_id = p.id");
+                    if (!result->success || result->rows.size() < 3) failures++;
+                }
+            }));
+        }
+        for (QThread* thread : threads) thread->start();
+        for (QThread* thread : threads) {
+            thread->wait();
+            delete thread;
+        }
+        
+        // A snapshot keeps the version it was taken from and does not hold writers back
+        {
+            auto snapshot = manager->scanRows("orders");
+            snapshot.takeSnapshot();
+            auto inserted = manager->insertRow("orders", QVector<QString>() << "2000" << "1" << "1");
+            if (!inserted.success || snapshot.size() != 3 || manager->scanRows("orders").size() != 4 ||
+                !manager->deleteRow("orders", inserted.rowId).success) {
+                failures++;
+            }
+        }
+        
+        auto result = run("SELECT COUNT(*) FROM orders");
+        if (failures > 0 || !result->success || result->rows[0][0] != "3") {
+            Logger::instance().error(QString("Concurrent statements failed: %1 failure(s)").arg(failures.load()));
+            return 1;
+        }
+        Logger::instance().info("Concurrent readers and writer verified");
+    }
+    
+    // Session 6: BEGIN ... ROLLBACK undoes every change, BEGIN ... COMMIT keeps them
+    {
+        Logger::instance().info("\n--- Session 6: Transactions ---");
+        auto manager = std::make_shared<TableManager>("./persistence_test_data");
+        
+        QueryExecutor executor(manager);
+        auto run = [&executor](const QString& sql) {
+            Lexer lexer(sql);
+            Parser parser(lexer.tokenize());
+            return executor.execute(parser.parse());
+        };
+        
+        bool ok = run("BEGIN")->success &&
+                  run("INSERT INTO orders VALUES (20, 3, 1)")->success &&
+                  run("UPDATE orders SET quantity = 9 WHERE order_id = 10")->success &&
+                  run("DELETE FROM orders WHERE order_id = 11")->success;
+        // The transaction reads its own writes
+        auto inside = run("SELECT order_id FROM orders WHERE product_id = 3");
+        ok = ok && inside->success && inside->rows.size() == 1 && executor.isInTransaction();
+        ok = ok && !run("BEGIN")->success && !run("CREATE INDEX idx_orders_quantity ON orders (quantity)")->success;
+        ok = ok && run("ROLLBACK")->success && !executor.isInTransaction();
+        
+        // Rows and the index on product_id are back as they were
+        auto undone = run("SELECT order_id, quantity FROM orders WHERE order_id <= 20 ORDER BY order_id");
+        auto unindexed = run("SELECT order_id FROM orders WHERE product_id = 3");
+        if (!ok || !undone->success || undone->rows.size() != 3 ||
+            undone->rows[0] != QStringList() << "10" << "2" || undone->rows[1][0] != "11" ||
+            unindexed->rows.size() != 0) {
+            Logger::instance().error("ROLLBACK did not undo the transaction");
+            return 1;
+        }
+        
+        ok = run("BEGIN")->success &&
+             run("INSERT INTO orders VALUES (21, 3, 4)")->success &&
+             run("INSERT INTO orders VALUES (22, 3, 6)")->success;
+        auto committed = run("COMMIT");
+        if (!ok || !committed->success || committed->affectedRows != 2 || run("COMMIT")->success) {
+            Logger::instance().error(QString("COMMIT failed: %1").arg(committed->errorMessage));
+            return 1;
+        }
+    }
+    {
+        // The committed rows survive a restart (from the log or the checkpoint)
+        auto manager = std::make_shared<TableManager>("./persistence_test_data");
+        QueryExecutor executor(manager);
+        Lexer lexer("SELECT order_id FROM orders WHERE product_id = 3");
+        Parser parser(lexer.tokenize());
+        auto result = executor.execute(parser.parse());
+        if (!result->success || result->rows.size() != 2) {
+            Logger::instance().error("Committed transaction was not persisted");
+            return 1;
+        }
+        Lexer deleteLexer("DELETE FROM orders WHERE product_id = 3");
+        Parser deleteParser(deleteLexer.tokenize());
+        executor.execute(deleteParser.parse());
+        Logger::instance().info("BEGIN, COMMIT and ROLLBACK verified");
+    }
+    
     Logger::instance().info("\n=== All Integration Tests PASSED ===");
     return 0;
 }
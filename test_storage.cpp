@@ -69,6 +69,20 @@ int main() {
         }
     }
     
+    // Repeated values are written once into the file's dictionary pages
+    QVector<QStringList> repeatedRows;
+    const QStringList names = {"Alice", "Bob", "Charlie"};
+    for (int i = 0; i < 2000; ++i) {
+        repeatedRows.append(QStringList() << QString::number(i) << names[i % names.size()] << (i % 4 == 0 ? "" : "30"));
+    }
+    storage.saveTableData("users", repeatedRows);
+    if (storage.loadTableData("users") != repeatedRows) {
+        Logger::instance().error("Dictionary encoded rows did not round-trip");
+        dataCorrect = false;
+    } else {
+        Logger::instance().info(QString("Dictionary encoded rows verified: %1 rows").arg(repeatedRows.size()));
+    }
+    
     if (dataCorrect) {
         Logger::instance().info("=== All tests PASSED ===");
         return 0;
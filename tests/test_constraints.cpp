@@ -4,6 +4,8 @@
 #include "../src/core/table_schema.h"
 #include "../src/core/constraint.h"
 #include "../src/core/data_type.h"
+#include "../src/core/hash_index.h"
+#include "../src/core/row_store.h"
 
 using namespace std;
 
@@ -392,6 +394,45 @@ void test_error_reporting() {
     assert_test(error3.contains("NULL"), "NOT NULL error is specific");
 }
 
+// Test Suite 16: Hash Index Uniqueness
+void test_hash_index_uniqueness() {
+    print_separator("TEST SUITE 16: Hash Index Uniqueness");
+    
+    HashIndex pk("PRIMARY", QStringList() << "id", QVector<int>() << 0);
+    RowStore rows;
+    rows.insert({"1", "alice"});
+    rows.insert({"2", "bob"});
+    rows.insert({"3", "carol"});
+    
+    // Test 16.1: Build from existing rows
+    int duplicates = pk.build(rows);
+    assert_test(duplicates == 0 && pk.size() == 3, "Hash index built without duplicates");
+    
+    // Test 16.2: Duplicate key is found
+    assert_test(pk.find({"2", "someone"}) == 1, "Duplicate key resolves to existing row");
+    assert_test(pk.find({"4", "dave"}) == -1, "New key is not found");
+    
+    // Test 16.3: Insert rejects a taken key
+    assert_test(!pk.insert({"3", "eve"}, 3), "Insert rejects duplicate key");
+    assert_test(pk.insert({"4", "dave"}, 3), "Insert accepts new key");
+    
+    // Test 16.4: Row ids are stable across a delete
+    pk.remove({"1", "alice"}, 0);
+    assert_test(pk.find({"2", ""}) == 1, "Row ids stay put after delete");
+    assert_test(pk.find({"1", ""}) == -1, "Removed key is gone");
+    
+    // Test 16.5: NULLs never conflict
+    HashIndex email("uq_email", QStringList() << "email", QVector<int>() << 1);
+    assert_test(email.insert({"1", ""}, 0), "NULL value accepted");
+    assert_test(email.insert({"2", ""}, 1), "Second NULL value accepted");
+    assert_test(email.size() == 0, "NULL values are not indexed");
+    
+    // Test 16.6: Composite keys do not collide on concatenation
+    HashIndex composite("uq_pair", QStringList() << "a" << "b", QVector<int>() << 0 << 1);
+    assert_test(composite.insert({"ab", "c"}, 0), "Composite key inserted");
+    assert_test(composite.find({"a", "bc"}) == -1, "Composite keys are length-delimited");
+}
+
 // Main test runner
 int main() {
     cout << "\n" << string(60, '#') << endl;
@@ -414,6 +455,7 @@ int main() {
     test_json_serialization();
     test_json_deserialization();
     test_error_reporting();
+    test_hash_index_uniqueness();
     
     // Print summary
     print_separator("TEST SUMMARY");
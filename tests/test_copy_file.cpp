@@ -0,0 +1,297 @@
+#include <iostream>
+#include <QDir>
+#include <QFile>
+#include "../src/storage/copy_file.h"
+
+using namespace std;
+
+// Test counter
+int testsRun = 0;
+int testsPassed = 0;
+int testsFailed = 0;
+
+void assert_test(bool condition, const QString& testName) {
+    testsRun++;
+    if (condition) {
+        testsPassed++;
+        cout << "✓ " << testName.toStdString() << endl;
+    } else {
+        testsFailed++;
+        cout << "✗ " << testName.toStdString() << endl;
+    }
+}
+
+void print_separator(const QString& section) {
+    cout << "\n" << string(60, '=') << endl;
+    cout << section.toStdString() << endl;
+    cout << string(60, '=') << endl;
+}
+
+const QString DATA_DIR = "./copy_test_data";
+
+QString dataFile(const QString& name) {
+    return QDir(DATA_DIR).filePath(name);
+}
+
+bool writeFile(const QString& path, const QStringList& columns, const QVector<QVector<QString>>& rows,
+               const CopyOptions& options) {
+    CopyWriter writer(path, options);
+    if (!writer.open(columns)) {
+        return false;
+    }
+    for (const auto& row : rows) {
+        if (!writer.writeRow(row)) {
+            return false;
+        }
+    }
+    return writer.commit() && writer.getRowCount() == rows.size();
+}
+
+// Reads every record; columns are only needed for NDJSON objects
+QVector<QVector<QString>> readFile(const QString& path, const CopyOptions& options, QStringList* header = nullptr,
+                                   const QStringList& columns = QStringList(), QString* error = nullptr) {
+    QVector<QVector<QString>> rows;
+    CopyReader reader(path, options);
+    if (!reader.open()) {
+        if (error) *error = reader.getError();
+        return rows;
+    }
+    if (header) *header = reader.getHeader();
+    reader.setColumns(columns);
+    QStringList row;
+    while (reader.readRow(row)) {
+        rows.append(QVector<QString>(row.begin(), row.end()));
+    }
+    if (error) *error = reader.getError();
+    return rows;
+}
+
+QByteArray fileContents(const QString& path) {
+    QFile file(path);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+// Test Suite 1: CSV quoting round trip
+void test_csv_round_trip() {
+    print_separator("TEST SUITE 1: CSV Round Trip");
+
+    CopyOptions options;
+    const QStringList columns = QStringList() << "id" << "note";
+    QVector<QVector<QString>> rows;
+    rows.append(QVector<QString>() << "1" << "plain");
+    rows.append(QVector<QString>() << "2" << "a, comma");
+    rows.append(QVector<QString>() << "3" << "say \"hi\"");
+    rows.append(QVector<QString>() << "4" << "two\nlines");
+    rows.append(QVector<QString>() << "5" << "windows\r\nline");
+    rows.append(QVector<QString>() << "6" << "");
+    rows.append(QVector<QString>() << "" << "\"");
+
+    const QString path = dataFile("round_trip.csv");
+    assert_test(writeFile(path, columns, rows, options), "CSV file is written");
+
+    QString error;
+    QVector<QVector<QString>> readBack = readFile(path, options, nullptr, QStringList(), &error);
+    assert_test(error.isEmpty(), "CSV file reads without error");
+    assert_test(readBack.size() == rows.size(), "Every record reads back");
+    assert_test(readBack == rows, "Delimiters, quotes, empty fields and line breaks survive");
+    assert_test(readBack.size() > 4 && readBack[4][1] == "windows\r\nline", "CRLF inside a quoted field is kept");
+
+    // A different delimiter quotes its own character, not commas
+    options.delimiter = QChar(';');
+    const QString semicolonPath = dataFile("semicolon.csv");
+    QVector<QVector<QString>> semicolonRows;
+    semicolonRows.append(QVector<QString>() << "a;b" << "c,d");
+    writeFile(semicolonPath, columns, semicolonRows, options);
+    assert_test(fileContents(semicolonPath) == "\"a;b\";c,d\n", "Only the delimiter in use is quoted");
+    assert_test(readFile(semicolonPath, options) == semicolonRows, "Custom delimiter round trip");
+}
+
+// Test Suite 2: CSV records of a single column
+void test_csv_single_column() {
+    print_separator("TEST SUITE 2: CSV Single Column");
+
+    CopyOptions options;
+    QVector<QVector<QString>> rows;
+    rows.append(QVector<QString>() << "first");
+    rows.append(QVector<QString>() << "");
+    rows.append(QVector<QString>() << "last");
+
+    const QString path = dataFile("single.csv");
+    writeFile(path, QStringList() << "value", rows, options);
+    assert_test(fileContents(path) == "first\n\"\"\nlast\n", "Empty value is written as a quoted empty field");
+    assert_test(readFile(path, options) == rows, "Empty value is not lost as a blank line");
+
+    // Blank lines in files written elsewhere are still skipped
+    QFile file(dataFile("blank_lines.csv"));
+    file.open(QIODevice::WriteOnly);
+    file.write("1,a\n\n2,b\r\n\r\n");
+    file.close();
+    QVector<QVector<QString>> readBack = readFile(dataFile("blank_lines.csv"), options);
+    assert_test(readBack.size() == 2 && readBack[1] == QVector<QString>() << "2" << "b", "Blank lines are skipped");
+}
+
+// Test Suite 3: CSV header handling
+void test_csv_header() {
+    print_separator("TEST SUITE 3: CSV Header");
+
+    CopyOptions options;
+    options.header = true;
+    const QStringList columns = QStringList() << "id" << "full name";
+    QVector<QVector<QString>> rows;
+    rows.append(QVector<QString>() << "1" << "Ada");
+
+    const QString path = dataFile("header.csv");
+    writeFile(path, columns, rows, options);
+    assert_test(fileContents(path) == "id,full name\n1,Ada\n", "Header line precedes the rows");
+
+    QStringList header;
+    QVector<QVector<QString>> readBack = readFile(path, options, &header);
+    assert_test(header == columns, "Header is read as column names");
+    assert_test(readBack == rows, "Header is not returned as a row");
+
+    // Header names are trimmed, and a byte order mark is ignored
+    QFile file(dataFile("bom.csv"));
+    file.open(QIODevice::WriteOnly);
+    file.write("\xEF\xBB\xBF id , name\r\n7,x\r\n");
+    file.close();
+    readBack = readFile(dataFile("bom.csv"), options, &header);
+    assert_test(header == QStringList() << "id" << "name", "Header names are trimmed after the byte order mark");
+    assert_test(readBack.size() == 1 && readBack[0] == QVector<QString>() << "7" << "x", "Rows follow the header");
+
+    QFile empty(dataFile("empty.csv"));
+    empty.open(QIODevice::WriteOnly);
+    empty.close();
+    QString error;
+    readFile(dataFile("empty.csv"), options, &header, QStringList(), &error);
+    assert_test(error.contains("no header line"), "Missing header is reported");
+
+    options.header = false;
+    file.setFileName(dataFile("unterminated.csv"));
+    file.open(QIODevice::WriteOnly);
+    file.write("1,\"open\n");
+    file.close();
+    readFile(dataFile("unterminated.csv"), options, nullptr, QStringList(), &error);
+    assert_test(error.contains("Unterminated quoted field starting on line 1"), "Unterminated quote is reported");
+}
+
+// Test Suite 4: NDJSON round trip
+void test_ndjson() {
+    print_separator("TEST SUITE 4: NDJSON");
+
+    CopyOptions options;
+    options.format = CopyFormat::NDJSON;
+    const QStringList columns = QStringList() << "id" << "name" << "note";
+    QVector<QVector<QString>> rows;
+    rows.append(QVector<QString>() << "1" << "Ada" << "line\nbreak \"quoted\"");
+    rows.append(QVector<QString>() << "2" << "" << "");
+
+    const QString path = dataFile("rows.ndjson");
+    assert_test(writeFile(path, columns, rows, options), "NDJSON file is written");
+    assert_test(fileContents(path).count('\n') == 2, "One line per row");
+    assert_test(fileContents(path).contains("\"name\":null"), "Empty values are written as null");
+
+    // Objects are read by column name whatever the key order or case
+    QVector<QVector<QString>> readBack = readFile(path, options, nullptr, QStringList() << "NOTE" << "id" << "name");
+    assert_test(readBack.size() == 2 && readBack[0] == QVector<QString>() << rows[0][2] << "1" << "Ada",
+                "Objects map to columns by name");
+    assert_test(readBack.size() == 2 && readBack[1] == QVector<QString>() << "" << "2" << "",
+                "Nulls read back as empty values");
+
+    QFile file(dataFile("mixed.ndjson"));
+    file.open(QIODevice::WriteOnly);
+    file.write("[1, \"x\", null, true]\n\n{\"id\": 2.5, \"extra\": 1}\n{not json}\n");
+    file.close();
+    QString error;
+    readBack = readFile(dataFile("mixed.ndjson"), options, nullptr, QStringList() << "id" << "name", &error);
+    assert_test(readBack.size() == 2 && readBack[0] == QVector<QString>() << "1" << "x" << "" << "true",
+                "Arrays read positionally");
+    assert_test(readBack.size() == 2 && readBack[1] == QVector<QString>() << "2.5" << "",
+                "Unknown keys are ignored and missing ones are empty");
+    assert_test(error.contains("Invalid JSON on line 4"), "Invalid JSON is reported with its line");
+}
+
+// Test Suite 5: Binary round trip
+void test_binary() {
+    print_separator("TEST SUITE 5: Binary");
+
+    CopyOptions options;
+    options.format = CopyFormat::BINARY;
+    const QStringList columns = QStringList() << "id" << "payload";
+    QVector<QVector<QString>> rows;
+    rows.append(QVector<QString>() << "1" << QString("comma, quote \" newline\r\n tab\t"));
+    rows.append(QVector<QString>() << "" << "");
+    rows.append(QVector<QString>() << "3" << QString(100000, QChar(0x4e2d)));
+
+    const QString path = dataFile("rows.bin");
+    assert_test(writeFile(path, columns, rows, options), "Binary file is written");
+    assert_test(fileContents(path).startsWith("SRDBCOPY"), "Binary file starts with its magic");
+
+    QStringList header;
+    QString error;
+    QVector<QVector<QString>> readBack = readFile(path, options, &header, QStringList(), &error);
+    assert_test(header == columns, "Column names are always stored");
+    assert_test(error.isEmpty() && readBack == rows, "Rows read back byte for byte");
+
+    // A truncated frame is an error, not a short file
+    QByteArray bytes = fileContents(path);
+    QFile truncated(dataFile("truncated.bin"));
+    truncated.open(QIODevice::WriteOnly);
+    truncated.write(bytes.left(bytes.size() - 10));
+    truncated.close();
+    readBack = readFile(dataFile("truncated.bin"), options, nullptr, QStringList(), &error);
+    assert_test(readBack.size() == 2 && error.contains("Truncated frame"), "Truncated frame is reported");
+
+    options.format = CopyFormat::CSV;
+    writeFile(dataFile("not_binary.bin"), columns, rows, options);
+    options.format = CopyFormat::BINARY;
+    readFile(dataFile("not_binary.bin"), options, nullptr, QStringList(), &error);
+    assert_test(error.contains("is not a binary COPY file"), "Other files are rejected");
+}
+
+// Test Suite 6: Format options
+void test_format_options() {
+    print_separator("TEST SUITE 6: Format Options");
+
+    CopyFormat format = CopyFormat::CSV;
+    assert_test(CopyOptions::formatFromName("jsonl", format) && format == CopyFormat::NDJSON, "JSONL names NDJSON");
+    assert_test(CopyOptions::formatFromName("Binary", format) && format == CopyFormat::BINARY, "Names ignore case");
+    assert_test(!CopyOptions::formatFromName("xml", format), "Unknown names are rejected");
+    assert_test(CopyOptions::formatFromPath("out/rows.NDJSON") == CopyFormat::NDJSON &&
+                CopyOptions::formatFromPath("rows.bin") == CopyFormat::BINARY &&
+                CopyOptions::formatFromPath("rows.txt") == CopyFormat::CSV, "Format follows the file extension");
+
+    // A failed export leaves the previous file in place
+    const QString path = dataFile("kept.csv");
+    CopyOptions options;
+    QVector<QVector<QString>> rows;
+    rows.append(QVector<QString>() << "old");
+    writeFile(path, QStringList() << "value", rows, options);
+    {
+        CopyWriter writer(path, options);
+        writer.open(QStringList() << "value");
+        writer.writeRow(QVector<QString>() << "new");
+    }
+    assert_test(fileContents(path) == "old\n", "Uncommitted export does not replace the file");
+}
+
+int main() {
+    QDir(DATA_DIR).removeRecursively();
+    QDir().mkpath(DATA_DIR);
+
+    test_csv_round_trip();
+    test_csv_single_column();
+    test_csv_header();
+    test_ndjson();
+    test_binary();
+    test_format_options();
+
+    QDir(DATA_DIR).removeRecursively();
+
+    print_separator("TEST SUMMARY");
+    cout << "Tests Run:    " << testsRun << endl;
+    cout << "Tests Passed: " << testsPassed << endl;
+    cout << "Tests Failed: " << testsFailed << endl;
+
+    return testsFailed == 0 ? 0 : 1;
+}
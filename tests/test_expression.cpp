@@ -0,0 +1,273 @@
+#include <iostream>
+#include "../src/parser/lexer.h"
+#include "../src/parser/parser.h"
+#include "../src/core/table_schema.h"
+#include "../src/core/expression_evaluator.h"
+#include "../src/core/filter_kernels.h"
+
+using namespace std;
+
+// Test counter
+int testsRun = 0;
+int testsPassed = 0;
+int testsFailed = 0;
+
+void assert_test(bool condition, const QString& testName) {
+    testsRun++;
+    if (condition) {
+        testsPassed++;
+        cout << "✓ " << testName.toStdString() << endl;
+    } else {
+        testsFailed++;
+        cout << "✗ " << testName.toStdString() << endl;
+    }
+}
+
+void print_separator(const QString& section) {
+    cout << "\n" << string(60, '=') << endl;
+    cout << section.toStdString() << endl;
+    cout << string(60, '=') << endl;
+}
+
+TableSchema makeSchema() {
+    TableSchema schema("people");
+    schema.addColumn(Column("id", DataType::INT));
+    schema.addColumn(Column("name", DataType::VARCHAR));
+    schema.addColumn(Column("age", DataType::INT));
+    schema.addColumn(Column("email", DataType::VARCHAR));
+    return schema;
+}
+
+// Parses "SELECT * FROM people WHERE <condition>" and compiles the condition
+std::unique_ptr<CompiledExpression> compileWhere(const QString& condition, QString& error) {
+    Lexer lexer("SELECT * FROM people WHERE " + condition);
+    Parser parser(lexer.tokenize());
+    auto statement = parser.parse();
+    auto select = dynamic_cast<SelectStatement*>(statement.get());
+    TableSchema schema = makeSchema();
+    return CompiledExpression::compile(select->where.get(), schema, error);
+}
+
+bool whereMatches(const QString& condition, const QVector<QString>& row) {
+    QString error;
+    auto compiled = compileWhere(condition, error);
+    return compiled && compiled->matches(row);
+}
+
+// Test Suite 1: Parsing into an expression tree
+void test_parse_tree() {
+    print_separator("TEST SUITE 1: WHERE Expression Parsing");
+    
+    Lexer lexer("DELETE FROM people WHERE age >= 18 AND (name = 'bob' OR NOT id IN (1, 2))");
+    Parser parser(lexer.tokenize());
+    auto statement = parser.parse();
+    auto del = dynamic_cast<DeleteStatement*>(statement.get());
+    
+    assert_test(del && del->where, "DELETE carries a parsed condition");
+    assert_test(del->where->kind == Expression::BINARY && del->where->op == Expression::AND, "Top-level node is AND");
+    
+    auto right = del->where->children[1];
+    assert_test(right->op == Expression::OR, "Parentheses group the OR");
+    assert_test(right->children[1]->op == Expression::NOT, "NOT applies to the IN predicate");
+    assert_test(right->children[1]->children[0]->kind == Expression::IN_LIST, "IN list parsed");
+    assert_test(!del->whereClause.isEmpty(), "Source text of the condition kept");
+}
+
+// Test Suite 2: Comparisons and arithmetic
+void test_comparisons() {
+    print_separator("TEST SUITE 2: Comparisons and Arithmetic");
+    
+    QVector<QString> row = {"7", "alice", "30", "alice@example.com"};
+    
+    assert_test(whereMatches("id = 7", row), "Integer equality");
+    assert_test(whereMatches("name = 'alice'", row), "String equality");
+    assert_test(!whereMatches("name = 'bob'", row), "String inequality");
+    assert_test(whereMatches("age > 9", row), "Numeric comparison is not lexical");
+    assert_test(whereMatches("age <> 31 AND age <= 30", row), "Combined comparisons");
+    assert_test(whereMatches("age * 2 - 10 = 50", row), "Arithmetic precedence");
+    assert_test(whereMatches("-age < 0", row), "Unary minus");
+    assert_test(!whereMatches("age / 0 = 1", row), "Division by zero is NULL, not TRUE");
+}
+
+// Test Suite 3: IN, BETWEEN, LIKE and IS NULL
+void test_predicates() {
+    print_separator("TEST SUITE 3: IN, BETWEEN, LIKE, IS NULL");
+    
+    QVector<QString> row = {"3", "Carol", "45", ""};
+    
+    assert_test(whereMatches("id IN (1, 3, 5)", row), "IN finds member");
+    assert_test(whereMatches("id NOT IN (1, 2)", row), "NOT IN excludes non-members");
+    assert_test(whereMatches("age BETWEEN 40 AND 50", row), "BETWEEN inclusive range");
+    assert_test(!whereMatches("age NOT BETWEEN 40 AND 50", row), "NOT BETWEEN");
+    assert_test(whereMatches("name LIKE 'c%'", row), "LIKE prefix, case-insensitive");
+    assert_test(whereMatches("name LIKE '_ar%l'", row), "LIKE with _ and %");
+    assert_test(!whereMatches("name LIKE 'car'", row), "LIKE without wildcard is exact");
+    assert_test(whereMatches("email IS NULL", row), "Empty value IS NULL");
+    assert_test(whereMatches("name IS NOT NULL", row), "IS NOT NULL");
+}
+
+// Test Suite 4: Three-valued logic and errors
+void test_null_logic() {
+    print_separator("TEST SUITE 4: NULL Semantics and Errors");
+    
+    QVector<QString> row = {"4", "dave", "", "null"};
+    
+    assert_test(!whereMatches("age = 20", row), "Comparison with NULL is not TRUE");
+    assert_test(!whereMatches("NOT age = 20", row), "NOT of unknown is still unknown");
+    assert_test(whereMatches("age = 20 OR id = 4", row), "OR with TRUE side is TRUE");
+    assert_test(!whereMatches("id NOT IN (1, NULL)", row), "NOT IN with NULL member is unknown");
+    assert_test(CompiledExpression::likeMatch("abc", "%"), "Lone % matches anything");
+    
+    QString error;
+    auto compiled = compileWhere("missing = 1", error);
+    assert_test(!compiled && error.contains("missing"), "Unknown column is reported");
+    
+    bool threw = false;
+    try {
+        compileWhere("id = = 1", error);
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    assert_test(threw, "Malformed condition is a parse error");
+}
+
+// Test Suite 5: Vectorized filter kernels
+void test_filter_kernels() {
+    print_separator("TEST SUITE 5: Vectorized Filter Kernels");
+    
+    // Lengths around the 64-value word and vector widths exercise every tail path
+    const int count = 203;
+    QVector<qint64> ints(count);
+    QVector<double> doubles(count);
+    QVector<qint32> dates(count);
+    for (int i = 0; i < count; ++i) {
+        ints[i] = (i * 37) % 101 - 50;
+        doubles[i] = ((i * 13) % 41 - 20) / 4.0;
+        dates[i] = 19000 + (i * 7) % 60;
+    }
+    const int words = (count + 63) / 64;
+    
+    auto bit = [](const QVector<quint64>& bits, int i) { return (bits[i / 64] >> (i % 64)) & 1; };
+    
+    const FilterKernels::Isa detected = FilterKernels::detectIsa();
+    for (int level = 0; level <= static_cast<int>(detected); ++level) {
+        auto isa = static_cast<FilterKernels::Isa>(level);
+        FilterKernels::setIsa(isa);
+        
+        QVector<quint64> intRange(words), doubleRange(words), dateRange(words), intIn(words), dateIn(words);
+        FilterKernels::selectRange(ints.constData(), count, qint64(-10), qint64(25), intRange.data());
+        FilterKernels::selectRange(doubles.constData(), count, -1.25, 2.5, doubleRange.data());
+        FilterKernels::selectRange(dates.constData(), count, 19010, 19019, dateRange.data());
+        FilterKernels::selectIn(ints.constData(), count, QVector<qint64>() << -50 << 0 << 7, intIn.data());
+        FilterKernels::selectIn(dates.constData(), count, QVector<qint32>() << 19000 << 19059, dateIn.data());
+        
+        bool same = true;
+        for (int i = 0; i < words * 64 && same; ++i) {
+            bool inside = i < count;
+            same = bit(intRange, i) == (inside && ints[i] >= -10 && ints[i] <= 25) &&
+                   bit(doubleRange, i) == (inside && doubles[i] >= -1.25 && doubles[i] <= 2.5) &&
+                   bit(dateRange, i) == (inside && dates[i] >= 19010 && dates[i] <= 19019) &&
+                   bit(intIn, i) == (inside && (ints[i] == -50 || ints[i] == 0 || ints[i] == 7)) &&
+                   bit(dateIn, i) == (inside && (dates[i] == 19000 || dates[i] == 19059));
+        }
+        assert_test(same, QString("%1 kernels match the row-by-row result").arg(FilterKernels::isaName(isa)));
+    }
+    FilterKernels::setIsa(detected);
+    
+    QVector<quint64> none(1);
+    FilterKernels::selectRange(ints.constData(), 10, qint64(5), qint64(4), none.data());
+    assert_test(none[0] == 0, "Empty range selects nothing");
+}
+
+// Test Suite 6: Aggregates, GROUP BY and HAVING
+void test_group_by_parsing() {
+    print_separator("TEST SUITE 6: Aggregates, GROUP BY and HAVING");
+    
+    Lexer lexer("SELECT age, count(*), SUM(age) FROM people WHERE age > 1 GROUP BY age "
+                "HAVING COUNT(*) >= 2 ORDER BY MAX(id) DESC LIMIT 5");
+    Parser parser(lexer.tokenize());
+    auto statement = parser.parse();
+    auto select = dynamic_cast<SelectStatement*>(statement.get());
+    
+    assert_test(select && select->items.size() == 3 && select->items[1].aggregate == SelectItem::COUNT &&
+                select->items[1].column.isEmpty() && select->items[2].aggregate == SelectItem::SUM,
+                "Select list holds columns and aggregate calls");
+    assert_test(select && select->columns == QStringList() << "age" << "COUNT(*)" << "SUM(age)",
+                "Aggregates are labelled by their call");
+    assert_test(select && select->groupBy == QStringList() << "age" && select->limit == 5, "GROUP BY columns parsed");
+    assert_test(select && select->having && select->having->children[0]->kind == Expression::AGGREGATE &&
+                select->having->children[0]->value == "COUNT",
+                "HAVING holds aggregate calls");
+    assert_test(select && select->orderByItems.size() == 1 && select->orderByItems[0].aggregate == SelectItem::MAX &&
+                select->orderByItems[0].descending, "ORDER BY accepts an aggregate");
+    
+    QString error;
+    assert_test(!compileWhere("COUNT(*) > 1", error) && error.contains("COUNT"), "Aggregates are rejected in WHERE");
+}
+
+// Test Suite 7: JOIN clauses
+void test_join_parsing() {
+    print_separator("TEST SUITE 7: JOIN Clauses");
+    
+    Lexer lexer("SELECT o.id, c.name FROM orders o INNER JOIN customers AS c ON o.customer_id = c.id "
+                "LEFT OUTER JOIN regions ON c.region = regions.code AND regions.active = TRUE WHERE o.total > 10");
+    Parser parser(lexer.tokenize());
+    auto statement = parser.parse();
+    auto select = dynamic_cast<SelectStatement*>(statement.get());
+    
+    assert_test(select && select->fromTable == "orders" && select->fromAlias == "o", "FROM table alias parsed");
+    assert_test(select && select->columns == QStringList() << "o.id" << "c.name", "Qualified select columns parsed");
+    assert_test(select && select->joins.size() == 2, "Two JOIN clauses parsed");
+    if (select && select->joins.size() == 2) {
+        const JoinClause& inner = select->joins[0];
+        assert_test(inner.type == JoinClause::INNER && inner.table == "customers" && inner.alias == "c",
+                    "INNER JOIN with AS alias");
+        assert_test(inner.on && inner.on->children[0]->qualifier == "o" && inner.on->children[0]->value == "customer_id",
+                    "ON condition keeps column qualifiers");
+        const JoinClause& left = select->joins[1];
+        assert_test(left.type == JoinClause::LEFT && left.alias.isEmpty() && left.on->op == Expression::AND,
+                    "LEFT OUTER JOIN without alias");
+    }
+    assert_test(select && select->where && select->where->children[0]->qualifier == "o", "WHERE follows the joins");
+    
+    bool rejected = false;
+    try {
+        Lexer rightLexer("SELECT * FROM a RIGHT JOIN b ON a.id = b.id");
+        Parser rightParser(rightLexer.tokenize());
+        rightParser.parse();
+    } catch (const std::exception&) {
+        rejected = true;
+    }
+    assert_test(rejected, "RIGHT JOIN is rejected");
+}
+
+// Main test runner
+int main() {
+    cout << "\n" << string(60, '#') << endl;
+    cout << "# SimpleRDBMS - WHERE Expression Test Suite #" << endl;
+    cout << string(60, '#') << endl;
+    
+    test_parse_tree();
+    test_comparisons();
+    test_predicates();
+    test_null_logic();
+    test_filter_kernels();
+    test_group_by_parsing();
+    test_join_parsing();
+    
+    // Print summary
+    print_separator("TEST SUMMARY");
+    cout << "Tests Run:    " << testsRun << endl;
+    cout << "Tests Passed: " << testsPassed << endl;
+    cout << "Tests Failed: " << testsFailed << endl;
+    
+    if (testsFailed == 0) {
+        cout << "\n✓ ALL TESTS PASSED!" << endl;
+    } else {
+        cout << "\n✗ " << testsFailed << " test(s) failed" << endl;
+    }
+    
+    cout << string(60, '#') << endl << endl;
+    
+    return testsFailed == 0 ? 0 : 1;
+}
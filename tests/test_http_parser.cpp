@@ -0,0 +1,286 @@
+#include <iostream>
+#include "../src/server/http_parser.h"
+
+using namespace std;
+
+// Test counter
+int testsRun = 0;
+int testsPassed = 0;
+int testsFailed = 0;
+
+void assert_test(bool condition, const QString& testName) {
+    testsRun++;
+    if (condition) {
+        testsPassed++;
+        cout << "✓ " << testName.toStdString() << endl;
+    } else {
+        testsFailed++;
+        cout << "✗ " << testName.toStdString() << endl;
+    }
+}
+
+void print_separator(const QString& section) {
+    cout << "\n" << string(60, '=') << endl;
+    cout << section.toStdString() << endl;
+    cout << string(60, '=') << endl;
+}
+
+using Status = HttpRequestParser::Status;
+
+// Appends everything at once and parses the first request
+Status parseAll(HttpRequestParser& parser, const QByteArray& bytes, HttpRequest& request) {
+    parser.append(bytes);
+    return parser.parse(request);
+}
+
+const QByteArray SIMPLE_POST =
+    "POST /query HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: 21\r\n"
+    "\r\n"
+    "{\"sql\": \"SELECT 1;\"}\n";
+
+// Test Suite 1: Requests split across reads
+void test_split_reads() {
+    print_separator("TEST SUITE 1: Split Reads");
+
+    HttpRequestParser parser;
+    HttpRequest request;
+    bool incompleteUntilEnd = true;
+    Status status = Status::Incomplete;
+    for (int i = 0; i < SIMPLE_POST.size(); ++i) {
+        parser.append(SIMPLE_POST.mid(i, 1));
+        status = parser.parse(request);
+        if (i < SIMPLE_POST.size() - 1 && status != Status::Incomplete) {
+            incompleteUntilEnd = false;
+        }
+    }
+    assert_test(incompleteUntilEnd, "Incomplete until the last byte arrives");
+    assert_test(status == Status::Complete, "Complete once the body is in");
+    assert_test(request.method == "POST" && request.path == "/query" && request.version == "HTTP/1.1",
+                "Request line is parsed");
+    assert_test(request.header("content-type") == "application/json" && request.header("HOST") == "localhost",
+                "Headers are looked up case-insensitively");
+    assert_test(request.body == "{\"sql\": \"SELECT 1;\"}\n", "Body is reassembled");
+    assert_test(parser.parse(request) == Status::Incomplete, "Nothing more is buffered");
+
+    // Bare LF line endings are accepted
+    HttpRequestParser lfParser;
+    assert_test(parseAll(lfParser, "GET /health HTTP/1.1\nHost: x\n\n", request) == Status::Complete &&
+                request.path == "/health" && request.body.isEmpty(), "LF-only lines are accepted");
+}
+
+// Test Suite 2: Chunked bodies
+void test_chunked() {
+    print_separator("TEST SUITE 2: Chunked Bodies");
+
+    const QByteArray chunked =
+        "POST /query HTTP/1.1\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5;name=value\r\n"
+        "hello\r\n"
+        "6\r\n"
+        " world\r\n"
+        "0\r\n"
+        "X-Checksum: abc\r\n"
+        "X-Other: def\r\n"
+        "\r\n";
+
+    HttpRequestParser parser;
+    HttpRequest request;
+    assert_test(parseAll(parser, chunked, request) == Status::Complete, "Chunked request completes");
+    assert_test(request.body == "hello world", "Chunks are joined and extensions ignored");
+    assert_test(request.header("x-checksum").isEmpty(), "Trailer fields are read past");
+    assert_test(parser.parse(request) == Status::Incomplete, "Trailers are consumed");
+
+    // The same request in small pieces
+    HttpRequestParser splitParser;
+    Status status = Status::Incomplete;
+    for (int i = 0; i < chunked.size() && status == Status::Incomplete; i += 3) {
+        splitParser.append(chunked.mid(i, 3));
+        status = splitParser.parse(request);
+    }
+    assert_test(status == Status::Complete && request.body == "hello world", "Chunked body split across reads");
+
+    HttpRequestParser badSize;
+    assert_test(parseAll(badSize, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n", request) ==
+                Status::Failed && badSize.errorStatus() == 400, "Malformed chunk size is rejected");
+
+    HttpRequestParser missingCrlf;
+    assert_test(parseAll(missingCrlf, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n2\r\nabcd\r\n", request) ==
+                Status::Failed && missingCrlf.errorStatus() == 400, "Chunk longer than its size is rejected");
+
+    HttpRequestParser gzip;
+    assert_test(parseAll(gzip, "POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n", request) ==
+                Status::Failed && gzip.errorStatus() == 501, "Other transfer codings are not implemented");
+}
+
+// Test Suite 3: Pipelined requests
+void test_pipelining() {
+    print_separator("TEST SUITE 3: Pipelined Requests");
+
+    HttpRequestParser parser;
+    parser.append(SIMPLE_POST + "\r\n" +
+                  "GET /first HTTP/1.1\r\n\r\n"
+                  "POST /second HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc"
+                  "GET /third HTTP/1.1\r\n");
+
+    HttpRequest first, second, third, fourth;
+    assert_test(parser.parse(first) == Status::Complete && first.path == "/query", "First request comes out first");
+    assert_test(parser.parse(second) == Status::Complete && second.path == "/first" && second.body.isEmpty(),
+                "Empty line between requests is skipped");
+    assert_test(parser.parse(third) == Status::Complete && third.path == "/second" && third.body == "abc",
+                "Body ends at its Content-Length");
+    assert_test(parser.parse(fourth) == Status::Incomplete, "Partial request waits for more bytes");
+    parser.append("Connection: close\r\n\r\n");
+    assert_test(parser.parse(fourth) == Status::Complete && fourth.path == "/third" && !fourth.keepAlive(),
+                "Partial request completes when the rest arrives");
+}
+
+// Test Suite 4: Framing that could be read two ways is rejected
+void test_ambiguous_framing() {
+    print_separator("TEST SUITE 4: Ambiguous Framing");
+
+    HttpRequest request;
+    HttpRequestParser both;
+    assert_test(parseAll(both, "POST / HTTP/1.1\r\nContent-Length: 5\r\nTransfer-Encoding: chunked\r\n\r\n", request) ==
+                Status::Failed && both.errorStatus() == 400, "Content-Length with Transfer-Encoding is rejected");
+
+    HttpRequestParser duplicate;
+    assert_test(parseAll(duplicate, "POST / HTTP/1.1\r\nContent-Length: 3\r\ncontent-length: 3\r\n\r\nabc", request) ==
+                Status::Complete && request.body == "abc", "Repeated identical Content-Length is accepted");
+
+    HttpRequestParser conflicting;
+    assert_test(parseAll(conflicting, "POST / HTTP/1.1\r\nContent-Length: 3\r\nContent-Length: 4\r\n\r\nabcd", request) ==
+                Status::Failed && conflicting.errorStatus() == 400, "Conflicting Content-Length is rejected");
+
+    HttpRequestParser list;
+    assert_test(parseAll(list, "POST / HTTP/1.1\r\nContent-Length: 3, 3\r\n\r\nabc", request) == Status::Failed &&
+                list.errorStatus() == 400, "Content-Length that is not a number is rejected");
+
+    HttpRequestParser negative;
+    assert_test(parseAll(negative, "POST / HTTP/1.1\r\nContent-Length: -1\r\n\r\n", request) == Status::Failed &&
+                negative.errorStatus() == 400, "Negative Content-Length is rejected");
+
+    HttpRequestParser folded;
+    assert_test(parseAll(folded, "GET / HTTP/1.1\r\nX-A: 1\r\n  continued\r\n\r\n", request) == Status::Failed &&
+                folded.errorStatus() == 400, "Folded header lines are rejected");
+
+    HttpRequestParser version;
+    assert_test(parseAll(version, "GET / HTTP/2.0\r\n\r\n", request) == Status::Failed &&
+                version.errorStatus() == 505, "Unsupported versions are rejected");
+
+    HttpRequestParser requestLine;
+    assert_test(parseAll(requestLine, "GET /\r\n\r\n", request) == Status::Failed &&
+                requestLine.errorStatus() == 400, "Malformed request line is rejected");
+
+    // A failed parser stays failed
+    both.append(SIMPLE_POST);
+    assert_test(both.parse(request) == Status::Failed, "Input after a failure is ignored");
+}
+
+// Test Suite 5: Size limits
+void test_limits() {
+    print_separator("TEST SUITE 5: Size Limits");
+
+    const int maxHeaderBytes = 64 * 1024;
+    const qint64 maxBodyBytes = 64 * 1024 * 1024;
+    HttpRequest request;
+
+    HttpRequestParser longLine;
+    longLine.append("GET / HTTP/1.1\r\nX-Long: ");
+    assert_test(longLine.parse(request) == Status::Incomplete, "A header line may arrive in pieces");
+    longLine.append(QByteArray(maxHeaderBytes, 'a'));
+    assert_test(longLine.parse(request) == Status::Failed && longLine.errorStatus() == 431,
+                "A header line over the limit fails before it ends");
+
+    HttpRequestParser manyHeaders;
+    QByteArray headers = "GET / HTTP/1.1\r\n";
+    for (int i = 0; headers.size() <= maxHeaderBytes; ++i) {
+        headers += "X-Header-" + QByteArray::number(i) + ": value\r\n";
+    }
+    assert_test(parseAll(manyHeaders, headers + "\r\n", request) == Status::Failed && manyHeaders.errorStatus() == 431,
+                "Headers over the limit in total fail with 431");
+
+    HttpRequestParser bigLength;
+    assert_test(parseAll(bigLength, "POST / HTTP/1.1\r\nContent-Length: " + QByteArray::number(maxBodyBytes + 1) +
+                         "\r\n\r\n", request) == Status::Failed && bigLength.errorStatus() == 413,
+                "Content-Length over the limit fails with 413 before the body is read");
+
+    HttpRequestParser atLimit;
+    assert_test(parseAll(atLimit, "POST / HTTP/1.1\r\nContent-Length: " + QByteArray::number(maxBodyBytes) +
+                         "\r\n\r\n", request) == Status::Incomplete, "Content-Length at the limit is accepted");
+
+    HttpRequestParser bigChunk;
+    assert_test(parseAll(bigChunk, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n" +
+                         QByteArray::number(maxBodyBytes + 1, 16) + "\r\n", request) == Status::Failed &&
+                bigChunk.errorStatus() == 413, "A chunk over the limit fails with 413");
+
+    // Chunks that are each small but add up past the limit
+    HttpRequestParser manyChunks;
+    manyChunks.append("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n");
+    const QByteArray chunk = QByteArray(1024 * 1024, 'c');
+    Status status = Status::Incomplete;
+    for (int i = 0; i <= 64 && status == Status::Incomplete; ++i) {
+        manyChunks.append(QByteArray::number(chunk.size(), 16) + "\r\n" + chunk + "\r\n");
+        status = manyChunks.parse(request);
+    }
+    assert_test(status == Status::Failed && manyChunks.errorStatus() == 413,
+                "Chunks adding up past the limit fail with 413");
+}
+
+// Test Suite 6: Expect: 100-continue and connection reuse
+void test_continue_and_keep_alive() {
+    print_separator("TEST SUITE 6: 100-continue and Keep-Alive");
+
+    HttpRequest request;
+    HttpRequestParser parser;
+    parser.append("POST /query HTTP/1.1\r\nExpect: 100-continue\r\nContent-Length: 4\r\n\r\n");
+    assert_test(parser.parse(request) == Status::Incomplete, "Headers alone leave the request incomplete");
+    assert_test(parser.takeContinueRequest(), "100-continue is requested once the headers are in");
+    assert_test(!parser.takeContinueRequest(), "The request is handed out only once");
+    parser.append("body");
+    assert_test(parser.parse(request) == Status::Complete && request.body == "body", "Body follows the interim reply");
+
+    HttpRequestParser noBody;
+    parseAll(noBody, "GET / HTTP/1.1\r\nExpect: 100-continue\r\n\r\n", request);
+    assert_test(!noBody.takeContinueRequest(), "No 100-continue without a body");
+
+    HttpRequestParser http10;
+    http10.append("POST / HTTP/1.0\r\nExpect: 100-continue\r\nContent-Length: 4\r\n\r\n");
+    http10.parse(request);
+    assert_test(!http10.takeContinueRequest(), "No 100-continue for HTTP/1.0 clients");
+
+    HttpRequestParser arrived;
+    parseAll(arrived, "POST / HTTP/1.1\r\nExpect: 100-continue\r\nContent-Length: 2\r\n\r\nok", request);
+    assert_test(!arrived.takeContinueRequest(), "No 100-continue once the body has arrived");
+
+    HttpRequest keepAlive;
+    keepAlive.version = "HTTP/1.1";
+    assert_test(keepAlive.keepAlive(), "HTTP/1.1 keeps the connection by default");
+    keepAlive.headers.insert("connection", "Upgrade, Close");
+    assert_test(!keepAlive.keepAlive(), "Connection: close ends it");
+    HttpRequest http10Request;
+    http10Request.version = "HTTP/1.0";
+    assert_test(!http10Request.keepAlive(), "HTTP/1.0 closes by default");
+    http10Request.headers.insert("connection", "keep-alive");
+    assert_test(http10Request.keepAlive(), "HTTP/1.0 keeps the connection when asked");
+}
+
+int main() {
+    test_split_reads();
+    test_chunked();
+    test_pipelining();
+    test_ambiguous_framing();
+    test_limits();
+    test_continue_and_keep_alive();
+
+    print_separator("TEST SUMMARY");
+    cout << "Tests Run:    " << testsRun << endl;
+    cout << "Tests Passed: " << testsPassed << endl;
+    cout << "Tests Failed: " << testsFailed << endl;
+
+    return testsFailed == 0 ? 0 : 1;
+}
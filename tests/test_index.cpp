@@ -0,0 +1,329 @@
+#include <iostream>
+#include <vector>
+#include "../src/core/bplus_tree.h"
+#include "../src/core/index.h"
+#include "../src/core/row_store.h"
+
+using namespace std;
+
+// Test counter
+int testsRun = 0;
+int testsPassed = 0;
+int testsFailed = 0;
+
+void assert_test(bool condition, const QString& testName) {
+    testsRun++;
+    if (condition) {
+        testsPassed++;
+        cout << "✓ " << testName.toStdString() << endl;
+    } else {
+        testsFailed++;
+        cout << "✗ " << testName.toStdString() << endl;
+    }
+}
+
+void print_separator(const QString& section) {
+    cout << "\n" << string(60, '=') << endl;
+    cout << section.toStdString() << endl;
+    cout << string(60, '=') << endl;
+}
+
+// Test Suite 1: B+tree insert, lookup and ordering
+void test_bplus_tree_basic() {
+    print_separator("TEST SUITE 1: B+tree Insert and Lookup");
+    
+    // Small nodes force splits at several levels
+    BPlusTree<int, int, std::less<int>, 4> tree;
+    bool allInserted = true;
+    for (int i = 0; i < 1000; ++i) {
+        allInserted &= tree.insert((i * 7919) % 1000, i);
+    }
+    assert_test(allInserted && tree.size() == 1000, "Inserts 1000 distinct keys");
+    assert_test(!tree.insert(42, -1), "Rejects duplicate key");
+    assert_test(tree.height() > 2, "Tree grows beyond two levels");
+    
+    const int* value = tree.find(500);
+    assert_test(value && (*value * 7919) % 1000 == 500, "Point lookup finds stored value");
+    assert_test(tree.find(1000) == nullptr, "Point lookup misses absent key");
+    
+    bool ordered = true;
+    int expected = 0;
+    for (auto it = tree.begin(); !it.atEnd(); ++it) {
+        ordered &= it.key() == expected++;
+    }
+    assert_test(ordered && expected == 1000, "Leaf chain iterates keys in order");
+    
+    bool reversed = true;
+    expected = 999;
+    for (auto it = tree.last(); !it.atEnd(); --it) {
+        reversed &= it.key() == expected--;
+    }
+    assert_test(reversed && expected == -1, "Leaf chain iterates backwards");
+}
+
+// Test Suite 2: B+tree erase and rebalancing
+void test_bplus_tree_erase() {
+    print_separator("TEST SUITE 2: B+tree Erase");
+    
+    BPlusTree<int, int, std::less<int>, 4> tree;
+    for (int i = 0; i < 500; ++i) {
+        tree.insert(i, i);
+    }
+    
+    bool allErased = true;
+    for (int i = 0; i < 500; i += 2) {
+        allErased &= tree.erase(i);
+    }
+    assert_test(allErased && tree.size() == 250, "Erases every even key");
+    assert_test(!tree.erase(0), "Erase of absent key fails");
+    
+    bool onlyOdd = true;
+    int seen = 0;
+    for (auto it = tree.begin(); !it.atEnd(); ++it, ++seen) {
+        onlyOdd &= it.key() % 2 == 1;
+    }
+    assert_test(onlyOdd && seen == 250, "Remaining keys are intact after merges");
+    
+    for (int i = 1; i < 500; i += 2) {
+        tree.erase(i);
+    }
+    assert_test(tree.isEmpty() && tree.begin().atEnd(), "Tree is empty after erasing everything");
+}
+
+// Test Suite 3: Range scans and bulk load
+void test_bplus_tree_range_and_bulk_load() {
+    print_separator("TEST SUITE 3: B+tree Range Scan and Bulk Load");
+    
+    std::vector<std::pair<int, int>> entries;
+    for (int i = 0; i < 10000; ++i) {
+        entries.emplace_back(i * 2, i);
+    }
+    BPlusTree<int, int> tree;
+    tree.bulkLoad(std::move(entries));
+    assert_test(tree.size() == 10000, "Bulk load stores every entry");
+    
+    auto lower = tree.lowerBound(101);
+    assert_test(!lower.atEnd() && lower.key() == 102, "lowerBound skips to next key");
+    auto upper = tree.upperBound(102);
+    assert_test(!upper.atEnd() && upper.key() == 104, "upperBound excludes equal key");
+    assert_test(tree.lowerBound(20000).atEnd(), "lowerBound past the end");
+    
+    int count = 0;
+    for (auto it = tree.lowerBound(100); !it.atEnd() && it.key() <= 200; ++it) {
+        count++;
+    }
+    assert_test(count == 51, "Range scan visits 51 keys in [100, 200]");
+    
+    tree.insert(1, -1);
+    tree.erase(0);
+    assert_test(tree.contains(1) && !tree.contains(0), "Bulk loaded tree accepts updates");
+}
+
+// Test Suite 4: Typed index keys
+void test_index_key_ordering() {
+    print_separator("TEST SUITE 4: Typed Index Keys");
+    
+    IndexKey nine = IndexKey::fromString("9", DataType::INT);
+    IndexKey ten = IndexKey::fromString("10", DataType::INT);
+    assert_test(nine < ten, "INT keys compare numerically");
+    
+    IndexKey textNine = IndexKey::fromString("9", DataType::VARCHAR);
+    IndexKey textTen = IndexKey::fromString("10", DataType::VARCHAR);
+    assert_test(textTen < textNine, "VARCHAR keys compare as text");
+    
+    IndexKey price = IndexKey::fromString("2.5", DataType::DECIMAL);
+    IndexKey two = IndexKey::fromString("2", DataType::INT);
+    assert_test(two < price, "Integer and decimal keys compare numerically");
+    
+    IndexKey null = IndexKey::fromString("", DataType::INT);
+    assert_test(null.hasNull() && null < nine, "NULL sorts first");
+    
+    QVector<DataType> types;
+    types << DataType::VARCHAR << DataType::INT;
+    IndexKey a = IndexKey::fromValues(QVector<QString>() << "smith" << "2", types);
+    IndexKey b = IndexKey::fromValues(QVector<QString>() << "smith" << "10", types);
+    IndexKey c = IndexKey::fromValues(QVector<QString>() << "adams" << "99", types);
+    assert_test(c < a && a < b, "Composite keys compare column by column");
+}
+
+// Test Suite 5: Index lookups
+void test_index_lookup() {
+    print_separator("TEST SUITE 5: Index Lookup");
+    
+    QVector<DataType> types;
+    types << DataType::INT;
+    Index index("idx_age", "users", QStringList() << "age", types);
+    
+    for (int rowId = 0; rowId < 100; ++rowId) {
+        index.insert(index.makeKey(QVector<QString>() << QString::number(rowId % 10)), rowId);
+    }
+    assert_test(index.keyCount() == 10 && index.entryCount() == 100, "Index groups duplicate keys");
+    
+    QVector<qint64> rows = index.find(index.makeKey(QVector<QString>() << "3"));
+    assert_test(rows.size() == 10 && rows.contains(13), "Point lookup returns every matching row");
+    
+    IndexKey low = index.makeKey(QVector<QString>() << "2");
+    IndexKey high = index.makeKey(QVector<QString>() << "4");
+    assert_test(index.range(&low, true, &high, true).size() == 30, "Inclusive range scan");
+    assert_test(index.range(&low, false, &high, false).size() == 10, "Exclusive range scan");
+    assert_test(index.range(nullptr, true, &low, false).size() == 20, "Unbounded lower range");
+    
+    assert_test(index.remove(index.makeKey(QVector<QString>() << "3"), 13), "Remove single row id");
+    assert_test(!index.find(index.makeKey(QVector<QString>() << "3")).contains(13), "Removed row id is gone");
+    
+    index.insert("7", 1000);
+    assert_test(index.search("7"), "String key API still works");
+    
+    QVector<QPair<IndexKey, qint64>> entries;
+    for (int rowId = 0; rowId < 50; ++rowId) {
+        entries.append(qMakePair(index.makeKey(QVector<QString>() << QString::number(49 - rowId)), rowId));
+    }
+    index.bulkLoad(entries);
+    assert_test(index.keyCount() == 50 && index.entryCount() == 50, "Bulk load from unsorted input");
+    assert_test(index.find(index.makeKey(QVector<QString>() << "49")) == QVector<qint64>() << 0, "Bulk loaded key maps to its row");
+}
+
+// Test Suite 6: Stable row ids with tombstones
+void test_row_store() {
+    print_separator("TEST SUITE 6: Row Store Ids and Tombstones");
+    
+    RowStore store;
+    for (int i = 0; i < 5; ++i) {
+        store.insert(QVector<QString>() << QString::number(i));
+    }
+    assert_test(store.size() == 5 && store.nextRowId() == 5, "Inserts assign sequential row ids");
+    
+    assert_test(store.remove(1) && store.remove(3), "Delete live rows");
+    assert_test(!store.remove(3), "Deleting a tombstone fails");
+    assert_test(store.size() == 3 && store.tombstoneCount() == 2, "Deletes leave tombstones");
+    assert_test(store.find(4) && store.find(4)->first() == "4", "Later rows keep their ids after a delete");
+    assert_test(!store.find(1), "Deleted row is not found");
+    
+    QVector<qint64> visited;
+    for (auto it = store.begin(); it != store.end(); ++it) {
+        visited.append(it.rowId());
+    }
+    assert_test(visited == QVector<qint64>() << 0 << 2 << 4, "Iteration skips tombstones");
+    
+    assert_test(store.vacuum() == 2 && store.slotCount() == 3, "Vacuum drops tombstones");
+    assert_test(store.find(4) && store.find(4)->first() == "4", "Vacuum does not renumber rows");
+    assert_test(store.insert(QVector<QString>() << "5") == 5, "Ids of deleted rows are not reused");
+    
+    RowStore replayed;
+    replayed.insertWithId(7, QVector<QString>() << "b");
+    replayed.insertWithId(2, QVector<QString>() << "a");
+    replayed.insertWithId(7, QVector<QString>() << "c");
+    assert_test(replayed.size() == 2 && replayed.rowIdAt(0) == 2, "Rows placed by id stay ordered");
+    assert_test(replayed.find(7)->first() == "c" && replayed.nextRowId() == 8, "Placing an existing id replaces the row");
+    
+    RowStore bulk;
+    for (int i = 0; i < 4096; ++i) {
+        bulk.insert(QVector<QString>() << QString::number(i));
+    }
+    for (qint64 rowId = 0; rowId < 2048; ++rowId) {
+        bulk.remove(rowId);
+    }
+    assert_test(bulk.needsVacuum(), "Vacuum is due once tombstones reach the live row count");
+}
+
+// Test Suite 7: Typed column storage
+void test_typed_columns() {
+    print_separator("TEST SUITE 7: Typed Column Storage");
+    
+    RowStore store(QVector<DataType>() << DataType::INT << DataType::DOUBLE << DataType::BOOL
+                                       << DataType::DATE << DataType::VARCHAR);
+    QVector<QString> canonical = {"42", "2.5", "true", "2024-02-29", "alice"};
+    QVector<QString> irregular = {"007", "1.50", "True", "2024-2-1", ""};
+    qint64 first = store.insert(canonical);
+    qint64 second = store.insert(irregular);
+    
+    assert_test(*store.find(first) == canonical, "Canonical values read back unchanged");
+    assert_test(*store.find(second) == irregular, "Non-canonical text reads back verbatim");
+    assert_test(store.column(0).isNative(0) && store.column(0).int64At(0) == 42, "INT held as a native integer");
+    assert_test(store.column(3).isNative(0) && store.column(3).dateAt(0) == 19782, "DATE held as days since the epoch");
+    assert_test(!store.column(0).isNative(1), "Non-canonical integer is not native");
+    assert_test(store.column(4).isNull(1) && store.valueAt(1, 4).isEmpty(), "Empty value is NULL");
+    
+    store.update(first, {"-5", "", "FALSE", "1999-12-31", "bob"});
+    store.remove(second);
+    store.vacuum();
+    assert_test(store.slotCount() == 1 && store.valueAt(0, 0) == "-5" && store.valueAt(0, 4) == "bob",
+                "Update and vacuum keep cells aligned");
+    
+    RowStore replayed(QVector<DataType>() << DataType::INT << DataType::TEXT);
+    replayed.insertWithId(5, {"5", "five"});
+    replayed.insertWithId(1, {"01", "one"});
+    replayed.insertWithId(3, {"3", ""});
+    assert_test(replayed.valueAt(0, 0) == "01" && replayed.valueAt(1, 1).isEmpty() && replayed.valueAt(2, 1) == "five",
+                "Out-of-order placement shifts every column");
+}
+
+// Test Suite 8: Dictionary encoded text columns
+void test_dictionary_columns() {
+    print_separator("TEST SUITE 8: Dictionary Encoded Columns");
+    
+    ColumnVector status(DataType::VARCHAR);
+    const QStringList values = {"active", "pending", "closed"};
+    for (int i = 0; i < 3000; ++i) {
+        status.append(i % 10 == 9 ? QString() : values[i % 3]);
+    }
+    assert_test(status.isDictionaryEncoded() && status.dictionarySize() == 3, "Repeated values share one dictionary entry");
+    assert_test(status.value(4) == "pending" && status.isNull(9), "Dictionary cells and NULLs read back");
+    assert_test(status.codeAt(0) == status.codeOf("active") && status.codeOf("missing") < 0, "Cells hold their value's code");
+    
+    status.set(0, "archived");
+    assert_test(status.value(0) == "archived" && status.dictionarySize() == 4, "Update adds a dictionary entry");
+    
+    ColumnVector names(DataType::VARCHAR);
+    for (int i = 0; i < 3000; ++i) {
+        names.append(QString("user%1").arg(i));
+    }
+    assert_test(!names.isDictionaryEncoded() && names.value(0) == "user0" && names.value(2999) == "user2999",
+                "Mostly distinct column moves to the arena intact");
+    
+    QVector<bool> keep(3000, false);
+    for (int i = 0; i < 9; i += 3) {
+        keep[i] = true;
+    }
+    status.compact(keep);
+    names.compact(keep);
+    assert_test(status.size() == 3 && status.dictionarySize() == 2 && status.value(0) == "archived",
+                "Compaction drops unused dictionary entries");
+    assert_test(names.isDictionaryEncoded() && names.value(2) == "user6", "Compaction re-decides the encoding");
+    
+    ColumnVector amount(DataType::DECIMAL);
+    amount.append("1.00");
+    assert_test(!amount.isDictionaryEncoded(), "DECIMAL is never dictionary encoded");
+}
+
+// Main test runner
+int main() {
+    cout << "\n" << string(60, '#') << endl;
+    cout << "# SimpleRDBMS - B+tree Index Test Suite #" << endl;
+    cout << string(60, '#') << endl;
+    
+    test_bplus_tree_basic();
+    test_bplus_tree_erase();
+    test_bplus_tree_range_and_bulk_load();
+    test_index_key_ordering();
+    test_index_lookup();
+    test_row_store();
+    test_typed_columns();
+    test_dictionary_columns();
+    
+    // Print summary
+    print_separator("TEST SUMMARY");
+    cout << "Tests Run:    " << testsRun << endl;
+    cout << "Tests Passed: " << testsPassed << endl;
+    cout << "Tests Failed: " << testsFailed << endl;
+    
+    if (testsFailed == 0) {
+        cout << "\n✓ ALL TESTS PASSED!" << endl;
+    } else {
+        cout << "\n✗ " << testsFailed << " test(s) failed" << endl;
+    }
+    
+    cout << string(60, '#') << endl << endl;
+    
+    return testsFailed == 0 ? 0 : 1;
+}
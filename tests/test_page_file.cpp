@@ -0,0 +1,298 @@
+#include <iostream>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QtEndian>
+#include "../src/storage/page_file.h"
+#include "../src/storage/storage_engine.h"
+#include "../src/core/table_schema.h"
+#include "../src/core/column.h"
+#include "../src/core/data_type.h"
+
+using namespace std;
+
+// Test counter
+int testsRun = 0;
+int testsPassed = 0;
+int testsFailed = 0;
+
+void assert_test(bool condition, const QString& testName) {
+    testsRun++;
+    if (condition) {
+        testsPassed++;
+        cout << "✓ " << testName.toStdString() << endl;
+    } else {
+        testsFailed++;
+        cout << "✗ " << testName.toStdString() << endl;
+    }
+}
+
+void print_separator(const QString& section) {
+    cout << "\n" << string(60, '=') << endl;
+    cout << section.toStdString() << endl;
+    cout << string(60, '=') << endl;
+}
+
+const QString DATA_DIR = "./page_file_test_data";
+
+QString dataFile(const QString& name) {
+    return QDir(DATA_DIR).filePath(name);
+}
+
+// Writes rows with ids 100, 101, ... and commits the file
+bool writeRows(const QString& path, const QVector<QStringList>& rows, quint64 checkpointLsn = 0) {
+    PageFileWriter writer(path, 1, 2);
+    writer.setCheckpointLsn(checkpointLsn);
+    if (!writer.open()) {
+        return false;
+    }
+    for (int i = 0; i < rows.size(); ++i) {
+        if (!writer.appendRow(rows[i], 100 + i)) {
+            return false;
+        }
+    }
+    return writer.commit();
+}
+
+bool readRows(const QString& path, QVector<QStringList>& rows, QVector<qint64>& rowIds, QString* error = nullptr) {
+    PageFileReader reader(path);
+    if (!reader.open()) {
+        if (error) *error = reader.getError();
+        return false;
+    }
+    QStringList row;
+    qint64 rowId = 0;
+    while (reader.readNextRow(row, &rowId)) {
+        rows.append(row);
+        rowIds.append(rowId);
+    }
+    if (error) *error = reader.getError();
+    return !reader.hasError();
+}
+
+// Test Suite 1: Slotted pages and their checksums
+void test_slotted_page() {
+    print_separator("TEST SUITE 1: Slotted Pages");
+
+    SlottedPage page;
+    page.reset(PageFormat::DATA_PAGE);
+    bool added = page.addRecord("first") && page.addRecord("second");
+    assert_test(added && page.getSlotCount() == 2, "Records are added to slots");
+    assert_test(page.getRecord(0) == "first" && page.getRecord(1) == "second", "Records read back by slot");
+
+    int records = 2;
+    while (page.addRecord(QByteArray(100, 'x'))) {
+        records++;
+    }
+    assert_test(records > 2 && page.getFreeSpace() < 100 + PageFormat::SLOT_SIZE, "A full page refuses records");
+
+    page.seal();
+    assert_test(page.verify(), "Sealed page verifies");
+
+    QByteArray bytes = page.bytes();
+    bytes[PageFormat::PAGE_SIZE - 1] = static_cast<char>(bytes[PageFormat::PAGE_SIZE - 1] ^ 0x01);
+    assert_test(!SlottedPage(bytes).verify(), "Flipped bit fails verification");
+}
+
+// Test Suite 2: Writer/reader round trip, including rows larger than a page
+void test_round_trip() {
+    print_separator("TEST SUITE 2: Page File Round Trip");
+
+    QVector<QStringList> rows;
+    for (int i = 0; i < 2000; ++i) {
+        rows.append(QStringList() << QString::number(i) << QString("name %1").arg(i % 7));
+    }
+    // Bigger than a page: stored as an overflow chain over several pages
+    const QString large(3 * PageFormat::PAGE_SIZE, QChar('L'));
+    rows[10] = QStringList() << "10" << large;
+    rows.append(QStringList() << "" << QString(PageFormat::PAGE_SIZE, QChar(0x00e9)));
+
+    const QString path = dataFile("round_trip.tbl");
+    assert_test(writeRows(path, rows, 42), "Writer commits the file");
+
+    PageFileReader reader(path);
+    assert_test(reader.open() && reader.getRowCount() == static_cast<quint64>(rows.size()) &&
+                reader.getCheckpointLsn() == 42 && reader.getNextRowId() == static_cast<quint64>(100 + rows.size()),
+                "Header records row count, checkpoint LSN and next row id");
+    assert_test(reader.getPageCount() > 4, "Rows span several pages");
+    reader.close();
+
+    QVector<QStringList> readBack;
+    QVector<qint64> rowIds;
+    assert_test(readRows(path, readBack, rowIds), "Reader reads every page without error");
+    assert_test(readBack == rows, "Rows read back unchanged, in order");
+    assert_test(readBack.size() > 10 && readBack[10][1].size() == large.size(),
+                "Overflow-chain row larger than a page is reassembled");
+    assert_test(rowIds.size() == rows.size() && rowIds.first() == 100 && rowIds.last() == 100 + rows.size() - 1,
+                "Row ids are stored with the rows");
+}
+
+// Test Suite 3: Every page on disk carries the type of what it holds
+void test_page_types() {
+    print_separator("TEST SUITE 3: Page Types");
+
+    // Repeated values go to dictionary pages after the data pages; one row overflows
+    QVector<QStringList> rows;
+    for (int i = 0; i < 3000; ++i) {
+        rows.append(QStringList() << QString::number(i) << QString("city %1").arg(i % 50));
+    }
+    rows[100] = QStringList() << "100" << QString(2 * PageFormat::PAGE_SIZE, QChar('x'));
+    const QString path = dataFile("page_types.tbl");
+    assert_test(writeRows(path, rows), "Writer commits the file");
+
+    QFile file(path);
+    file.open(QIODevice::ReadOnly);
+    const QByteArray header = file.read(PageFormat::PAGE_SIZE);
+    const quint32 pageCount = qFromLittleEndian<quint32>(header.constData() + PageFormat::HEADER_PAGE_COUNT);
+    const quint32 dictionaryPage = qFromLittleEndian<quint32>(header.constData() + PageFormat::HEADER_DICTIONARY_PAGE);
+    assert_test(pageCount > 3 && dictionaryPage > 1 && dictionaryPage < pageCount,
+                "Dictionary pages follow the data pages");
+
+    int dataPages = 0;
+    int overflowPages = 0;
+    int dictionaryPages = 0;
+    bool typesMatch = true;
+    for (quint32 pageNo = 1; pageNo < pageCount; ++pageNo) {
+        SlottedPage page(file.read(PageFormat::PAGE_SIZE));
+        if (!page.verify()) {
+            typesMatch = false;
+            continue;
+        }
+        switch (page.getType()) {
+            case PageFormat::DATA_PAGE:
+                dataPages++;
+                typesMatch = typesMatch && pageNo < dictionaryPage;
+                break;
+            case PageFormat::DICTIONARY_PAGE:
+                dictionaryPages++;
+                typesMatch = typesMatch && pageNo >= dictionaryPage;
+                break;
+            case PageFormat::OVERFLOW_PAGE:
+                overflowPages++;
+                break;
+            default:
+                typesMatch = false;
+                break;
+        }
+    }
+    file.close();
+    assert_test(typesMatch, "Each page is typed data, overflow or dictionary by its position");
+    assert_test(dataPages > 1, "Data pages are typed DATA_PAGE");
+    assert_test(overflowPages >= 2, "Overflow chain pages are typed OVERFLOW_PAGE");
+    assert_test(dictionaryPages >= 1, "Dictionary pages are typed DICTIONARY_PAGE");
+
+    QVector<QStringList> readBack;
+    QVector<qint64> rowIds;
+    assert_test(readRows(path, readBack, rowIds) && readBack == rows, "Rows read back through the dictionary");
+}
+
+// Test Suite 4: Corrupted pages are rejected
+void test_bad_checksum() {
+    print_separator("TEST SUITE 4: Checksum Mismatch");
+
+    QVector<QStringList> rows;
+    for (int i = 0; i < 500; ++i) {
+        rows.append(QStringList() << QString::number(i) << QString("row %1").arg(i));
+    }
+    const QString path = dataFile("corrupt.tbl");
+    writeRows(path, rows);
+
+    // Flip one byte in the middle of the second data page
+    QFile file(path);
+    bool patched = file.open(QIODevice::ReadWrite) && file.seek(2 * PageFormat::PAGE_SIZE + PageFormat::PAGE_SIZE / 2);
+    QByteArray byte = patched ? file.read(1) : QByteArray();
+    patched = patched && byte.size() == 1 && file.seek(2 * PageFormat::PAGE_SIZE + PageFormat::PAGE_SIZE / 2);
+    byte[0] = static_cast<char>(byte[0] ^ 0x5a);
+    patched = patched && file.write(byte) == 1;
+    file.close();
+    assert_test(patched, "Corrupted one byte of page 2");
+
+    QVector<QStringList> readBack;
+    QVector<qint64> rowIds;
+    QString error;
+    bool ok = readRows(path, readBack, rowIds, &error);
+    assert_test(!ok && error.contains("Checksum mismatch in page 2"), "Reader rejects the page with a bad CRC");
+    assert_test(readBack.size() < rows.size(), "No rows are returned from the corrupt page");
+
+    // A corrupt header is rejected before any page is read
+    QFile header(path);
+    header.open(QIODevice::ReadWrite);
+    header.seek(PageFormat::HEADER_ROW_COUNT);
+    header.write(QByteArray(1, '\x7f'));
+    header.close();
+    PageFileReader reader(path);
+    assert_test(!reader.open(), "Reader rejects a header with a bad CRC");
+}
+
+// Test Suite 5: Legacy JSON tables are migrated to the paged format
+void test_legacy_migration() {
+    print_separator("TEST SUITE 5: Legacy JSON Migration");
+
+    TableSchema schema("legacy");
+    schema.addColumn(Column("id", DataType::INT));
+    schema.addColumn(Column("name", DataType::VARCHAR));
+
+    // Legacy schema files predate the schemaVersion field
+    QJsonObject schemaObject = QJsonDocument::fromJson(schema.toJson().toUtf8()).object();
+    schemaObject.remove("schemaVersion");
+    QFile schemaFile(dataFile("legacy_schema.json"));
+    schemaFile.open(QIODevice::WriteOnly);
+    schemaFile.write(QJsonDocument(schemaObject).toJson());
+    schemaFile.close();
+
+    QJsonArray rows;
+    for (int i = 0; i < 3; ++i) {
+        QJsonObject row;
+        row["id"] = QString::number(i + 1);
+        row["name"] = QString("user %1").arg(i + 1);
+        rows.append(row);
+    }
+    QJsonObject data;
+    data["rows"] = rows;
+    QFile dataJson(dataFile("legacy.json"));
+    dataJson.open(QIODevice::WriteOnly);
+    dataJson.write(QJsonDocument(data).toJson());
+    dataJson.close();
+
+    // Opening the data directory migrates it
+    StorageEngine storage(DATA_DIR);
+    assert_test(QFile::exists(dataFile("legacy.tbl")), "Paged table file is written");
+    assert_test(!QFile::exists(dataFile("legacy.json")) && QFile::exists(dataFile("legacy.json.bak")),
+                "Legacy data file is kept as a backup");
+
+    QFile migratedSchema(dataFile("legacy_schema.json"));
+    migratedSchema.open(QIODevice::ReadOnly);
+    QJsonObject migratedObject = QJsonDocument::fromJson(migratedSchema.readAll()).object();
+    assert_test(migratedObject.value("schemaVersion").toInt() == 1, "Schema file gains schemaVersion 1");
+
+    QVector<qint64> rowIds;
+    QVector<QStringList> loaded = storage.loadTableData("legacy", nullptr, &rowIds);
+    assert_test(loaded.size() == 3 && loaded[0] == QStringList() << "1" << "user 1" &&
+                loaded[2] == QStringList() << "3" << "user 3", "Migrated rows load in column order");
+    assert_test(rowIds == QVector<qint64>() << 0 << 1 << 2, "Migrated rows are numbered by position");
+
+    // A second open finds nothing left to migrate
+    assert_test(storage.migrateLegacyTables() == 0, "Migration runs only once");
+}
+
+int main() {
+    QDir(DATA_DIR).removeRecursively();
+    QDir().mkpath(DATA_DIR);
+
+    test_slotted_page();
+    test_round_trip();
+    test_page_types();
+    test_bad_checksum();
+    test_legacy_migration();
+
+    QDir(DATA_DIR).removeRecursively();
+
+    print_separator("TEST SUMMARY");
+    cout << "Tests Run:    " << testsRun << endl;
+    cout << "Tests Passed: " << testsPassed << endl;
+    cout << "Tests Failed: " << testsFailed << endl;
+
+    return testsFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+#include <iostream>
+#include <QDir>
+#include <QElapsedTimer>
+#include "../src/parser/lexer.h"
+#include "../src/parser/parser.h"
+#include "../src/core/query_executor.h"
+#include "../src/core/query_result.h"
+#include "../src/core/table_manager.h"
+#include "../src/core/table_latch.h"
+
+using namespace std;
+
+// Test counter
+int testsRun = 0;
+int testsPassed = 0;
+int testsFailed = 0;
+
+void assert_test(bool condition, const QString& testName) {
+    testsRun++;
+    if (condition) {
+        testsPassed++;
+        cout << "✓ " << testName.toStdString() << endl;
+    } else {
+        testsFailed++;
+        cout << "✗ " << testName.toStdString() << endl;
+    }
+}
+
+void print_separator(const QString& section) {
+    cout << "\n" << string(60, '=') << endl;
+    cout << section.toStdString() << endl;
+    cout << string(60, '=') << endl;
+}
+
+const QString DATA_DIR = "./transaction_test_data";
+
+std::unique_ptr<QueryResult> run(QueryExecutor& executor, const QString& sql) {
+    Lexer lexer(sql);
+    Parser parser(lexer.tokenize());
+    auto statement = parser.parse();
+    return executor.execute(statement);
+}
+
+// First column of the result rows
+QStringList firstColumn(const QueryResult& result) {
+    QStringList values;
+    for (const auto& row : result.rows) {
+        values.append(row.value(0));
+    }
+    return values;
+}
+
+std::shared_ptr<TableManager> createAccounts() {
+    QDir(DATA_DIR).removeRecursively();
+    auto manager = std::make_shared<TableManager>(DATA_DIR);
+    QueryExecutor setup(manager);
+    run(setup, "CREATE TABLE accounts (id INT PRIMARY KEY, balance INT)");
+    run(setup, "INSERT INTO accounts (id, balance) VALUES (1, 100), (2, 200)");
+    return manager;
+}
+
+// Test Suite 1: A reader arriving while a write statement holds the table
+void test_reader_during_first_write() {
+    print_separator("TEST SUITE 1: Reader During a Transaction's First UPDATE");
+    auto manager = createAccounts();
+    QueryExecutor reader(manager);
+
+    // Stands in for a transaction whose first UPDATE has latched the table but
+    // not changed it yet, so nothing has been set aside as last committed
+    int writer = 0;
+    TableLatch::HolderScope writerScope(&writer);
+    auto locks = manager->lockTables(QStringList(), QStringList() << "accounts");
+    assert_test(locks.acquired(), "Writer latches the table exclusively");
+    {
+        // The reader acts as its thread again
+        TableLatch::HolderScope readerScope(nullptr);
+        QElapsedTimer timer;
+        timer.start();
+        auto result = run(reader, "SELECT balance FROM accounts WHERE id = 1");
+        assert_test(result->success && firstColumn(*result) == QStringList() << "100",
+                    "Reader sees the committed row");
+        assert_test(timer.elapsed() < TableManager::LOCK_WAIT_TIMEOUT_MS / 2, "Reader does not wait for the writer");
+    }
+}
+
+// Test Suite 2: Other sessions read a transaction's tables as last committed
+void test_committed_reads() {
+    print_separator("TEST SUITE 2: Reads During a Transaction");
+    auto manager = createAccounts();
+    QueryExecutor session(manager);
+    QueryExecutor reader(manager);
+
+    run(session, "BEGIN");
+    auto update = run(session, "UPDATE accounts SET balance = 150 WHERE id = 1");
+    assert_test(update->success && update->affectedRows == 1, "UPDATE runs inside the transaction");
+
+    auto own = run(session, "SELECT balance FROM accounts WHERE id = 1");
+    assert_test(own->success && firstColumn(*own) == QStringList() << "150", "Transaction reads its own write");
+
+    QElapsedTimer timer;
+    timer.start();
+    auto other = run(reader, "SELECT balance FROM accounts ORDER BY id");
+    assert_test(other->success && firstColumn(*other) == QStringList() << "100" << "200",
+                "Other session reads the table as last committed");
+    auto indexed = run(reader, "SELECT balance FROM accounts WHERE id = 1");
+    assert_test(indexed->success && firstColumn(*indexed) == QStringList() << "100",
+                "Committed read does not use the live index");
+    assert_test(timer.elapsed() < TableManager::LOCK_WAIT_TIMEOUT_MS / 2, "Reads do not wait for the transaction");
+
+    auto blocked = run(reader, "UPDATE accounts SET balance = 0 WHERE id = 2");
+    assert_test(!blocked->success && blocked->errorMessage.startsWith("Lock wait timeout"),
+                "A write to the table gives up with a lock wait timeout");
+
+    auto commit = run(session, "COMMIT");
+    assert_test(commit->success, "COMMIT succeeds");
+    auto after = run(reader, "SELECT balance FROM accounts WHERE id = 1");
+    assert_test(after->success && firstColumn(*after) == QStringList() << "150", "Committed change is visible");
+
+    run(session, "BEGIN");
+    run(session, "DELETE FROM accounts WHERE id = 2");
+    auto during = run(reader, "SELECT id FROM accounts ORDER BY id");
+    assert_test(during->success && firstColumn(*during) == QStringList() << "1" << "2",
+                "Uncommitted DELETE is not seen by others");
+    run(session, "ROLLBACK");
+    auto rolledBack = run(reader, "SELECT id FROM accounts WHERE id = 2");
+    assert_test(rolledBack->success && firstColumn(*rolledBack) == QStringList() << "2", "ROLLBACK restores the row");
+}
+
+// Test Suite 3: Schema changes beside an open transaction
+void test_schema_changes() {
+    print_separator("TEST SUITE 3: Schema Changes During a Transaction");
+    auto manager = createAccounts();
+    QueryExecutor session(manager);
+    QueryExecutor other(manager);
+
+    run(session, "BEGIN");
+    run(session, "UPDATE accounts SET balance = 120 WHERE id = 1");
+
+    QElapsedTimer timer;
+    timer.start();
+    auto create = run(other, "CREATE TABLE audit (id INT PRIMARY KEY, note VARCHAR(50))");
+    assert_test(create->success, "CREATE TABLE runs while a transaction is open");
+    auto index = run(other, "CREATE INDEX idx_note ON audit (note)");
+    assert_test(index->success, "CREATE INDEX on another table runs while a transaction is open");
+    assert_test(timer.elapsed() < TableManager::LOCK_WAIT_TIMEOUT_MS / 2, "Neither waits for the transaction");
+
+    auto blocked = run(other, "CREATE INDEX idx_balance ON accounts (balance)");
+    assert_test(!blocked->success && blocked->errorMessage.startsWith("Lock wait timeout"),
+                "CREATE INDEX on the transaction's table gives up with a lock wait timeout");
+
+    auto insert = run(session, "INSERT INTO accounts (id, balance) VALUES (3, 300)");
+    assert_test(insert->success, "Transaction keeps running after the schema changes");
+    auto commit = run(session, "COMMIT");
+    assert_test(commit->success, "COMMIT succeeds");
+
+    auto after = run(other, "CREATE INDEX idx_balance ON accounts (balance)");
+    assert_test(after->success, "CREATE INDEX on the table runs once the transaction ends");
+}
+
+// Test Suite 4: A shared hold is not upgraded
+void test_latch_upgrade() {
+    print_separator("TEST SUITE 4: Latch Upgrade");
+    TableLatch latch;
+    int holder = 0;
+    int other = 0;
+
+    assert_test(latch.lockShared(&holder), "Holder takes the latch shared");
+    QElapsedTimer timer;
+    timer.start();
+    assert_test(!latch.lockExclusive(&holder), "Untimed upgrade fails instead of waiting forever");
+    assert_test(!latch.lockExclusive(&holder, 1000), "Timed upgrade fails too");
+    assert_test(timer.elapsed() < 500, "Both fail at once");
+    assert_test(latch.lockShared(&other, 0), "Other readers are not held back by the failed upgrade");
+    latch.unlockShared(&other);
+    latch.unlockShared(&holder);
+    assert_test(latch.lockExclusive(&holder, 0), "Exclusive hold is taken once the shared one is released");
+    latch.unlockExclusive(&holder);
+
+    auto manager = createAccounts();
+    auto scan = manager->scanRows("accounts");
+    auto insert = manager->insertRow("accounts", QVector<QString>() << "3" << "300");
+    assert_test(!insert.success, "Writing a table the thread is scanning fails instead of hanging");
+}
+
+// Test Suite 5: How long versions are kept
+void test_snapshot_lifetime() {
+    print_separator("TEST SUITE 5: Snapshot Lifetime");
+    auto manager = createAccounts();
+    assert_test(manager->committedVersionCount() == 0, "No version kept without a writer");
+
+    {
+        auto scan = manager->scanRows("accounts");
+        scan.takeSnapshot();
+        auto insert = manager->insertRow("accounts", QVector<QString>() << "3" << "300");
+        assert_test(insert.success, "Writer proceeds while a snapshot is read");
+        assert_test(scan.size() == 2, "Snapshot keeps the version it was taken from");
+    }
+    assert_test(manager->scanRows("accounts").size() == 3, "New scans see the write once the snapshot is gone");
+
+    QueryExecutor session(manager);
+    run(session, "BEGIN");
+    run(session, "UPDATE accounts SET balance = 110 WHERE id = 1");
+    assert_test(manager->committedVersionCount() == 1, "A transaction keeps one version of a table it changes");
+    run(session, "UPDATE accounts SET balance = 220 WHERE id = 2");
+    run(session, "INSERT INTO accounts (id, balance) VALUES (4, 400)");
+    assert_test(manager->committedVersionCount() == 1, "Further statements on the table keep no more versions");
+    run(session, "COMMIT");
+    assert_test(manager->committedVersionCount() == 0, "COMMIT drops the version");
+
+    run(session, "BEGIN");
+    run(session, "DELETE FROM accounts WHERE id = 4");
+    run(session, "ROLLBACK");
+    assert_test(manager->committedVersionCount() == 0, "ROLLBACK drops the version");
+
+    {
+        QueryExecutor dropped(manager);
+        run(dropped, "BEGIN");
+        run(dropped, "DELETE FROM accounts WHERE id = 3");
+        assert_test(manager->committedVersionCount() == 1, "Open transaction keeps its version");
+    }
+    assert_test(manager->committedVersionCount() == 0, "A session that goes away drops its version");
+}
+
+int main() {
+    test_reader_during_first_write();
+    test_committed_reads();
+    test_schema_changes();
+    test_latch_upgrade();
+    test_snapshot_lifetime();
+
+    QDir(DATA_DIR).removeRecursively();
+
+    print_separator("TEST SUMMARY");
+    cout << "Tests Run:    " << testsRun << endl;
+    cout << "Tests Passed: " << testsPassed << endl;
+    cout << "Tests Failed: " << testsFailed << endl;
+
+    return testsFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+#include <iostream>
+#include <QDir>
+#include <QFile>
+#include "../src/storage/write_ahead_log.h"
+
+using namespace std;
+
+// Test counter
+int testsRun = 0;
+int testsPassed = 0;
+int testsFailed = 0;
+
+void assert_test(bool condition, const QString& testName) {
+    testsRun++;
+    if (condition) {
+        testsPassed++;
+        cout << "✓ " << testName.toStdString() << endl;
+    } else {
+        testsFailed++;
+        cout << "✗ " << testName.toStdString() << endl;
+    }
+}
+
+void print_separator(const QString& section) {
+    cout << "\n" << string(60, '=') << endl;
+    cout << section.toStdString() << endl;
+    cout << string(60, '=') << endl;
+}
+
+const QString DATA_DIR = "./wal_test_data";
+
+void resetDataDir() {
+    QDir(DATA_DIR).removeRecursively();
+    QDir().mkpath(DATA_DIR);
+}
+
+QString segmentFile(int segmentId) {
+    return QDir(DATA_DIR).filePath(QString("wal_%1.log").arg(segmentId, 8, 10, QChar('0')));
+}
+
+WalRecord makeRecord(int rowId, const QString& value) {
+    WalRecord record;
+    record.operation = WalRecord::INSERT;
+    record.tableName = "users";
+    record.rowId = rowId;
+    record.values = QStringList() << QString::number(rowId) << value;
+    return record;
+}
+
+QVector<WalRecord> replayAll(WriteAheadLog& wal) {
+    QVector<WalRecord> records;
+    wal.replay([&](const WalRecord& record) { records.append(record); });
+    return records;
+}
+
+// Test Suite 1: Records survive reopening the log
+void test_replay_after_reopen() {
+    print_separator("TEST SUITE 1: Replay After Reopen");
+    resetDataDir();
+
+    {
+        WriteAheadLog wal(DATA_DIR);
+        wal.setSyncPolicy(WriteAheadLog::SyncPolicy::EVERY_WRITE);
+        assert_test(wal.open() && wal.isEmpty(), "New log opens empty");
+
+        WalRecord first = makeRecord(1, "alice");
+        bool ok = wal.append(first);
+        QVector<WalRecord> batch;
+        batch << makeRecord(2, "bob") << makeRecord(3, "");
+        batch[1].operation = WalRecord::UPDATE;
+        ok = ok && wal.appendBatch(batch);
+        assert_test(ok && first.lsn == 1 && batch[0].lsn == 2 && batch[1].lsn == 3, "Appends assign consecutive LSNs");
+        wal.close();
+    }
+
+    WriteAheadLog wal(DATA_DIR);
+    assert_test(wal.open() && wal.getLastLsn() == 3, "Reopened log continues from the last LSN");
+
+    QVector<WalRecord> records = replayAll(wal);
+    assert_test(records.size() == 3, "Replay visits every record");
+    assert_test(records.size() == 3 && records[0].lsn == 1 && records[2].lsn == 3, "Replay runs in log order");
+    assert_test(records.size() == 3 && records[1].operation == WalRecord::UPDATE && records[1].tableName == "users" &&
+                records[1].rowId == 2 && records[1].values == QStringList() << "2" << "bob",
+                "Records decode unchanged");
+    assert_test(records.size() == 3 && records[2].values == QStringList() << "3" << "", "Empty values survive");
+
+    WalRecord next = makeRecord(4, "dave");
+    assert_test(wal.append(next) && next.lsn == 4, "Appending after replay continues numbering");
+    assert_test(replayAll(wal).size() == 4, "Replay sees records appended after reopening");
+}
+
+// Test Suite 2: A torn record at the end is discarded
+void test_torn_tail() {
+    print_separator("TEST SUITE 2: Torn Tail");
+    resetDataDir();
+
+    qint64 intactSize = 0;
+    {
+        WriteAheadLog wal(DATA_DIR);
+        wal.open();
+        for (int i = 1; i <= 3; ++i) {
+            WalRecord record = makeRecord(i, "row");
+            wal.append(record);
+        }
+        intactSize = wal.getSize();
+        wal.close();
+    }
+
+    // A frame header promising more bytes than were written before the crash
+    QFile segment(segmentFile(1));
+    segment.open(QIODevice::Append);
+    QByteArray torn(8, '\0');
+    torn[0] = 100;
+    segment.write(torn + QByteArray(10, 'x'));
+    segment.close();
+    assert_test(QFile(segmentFile(1)).size() == intactSize + 18, "Torn frame appended to the segment");
+
+    WriteAheadLog wal(DATA_DIR);
+    assert_test(wal.open(), "Log with a torn tail opens");
+    assert_test(QFile(segmentFile(1)).size() == intactSize, "Torn bytes are truncated away");
+    assert_test(replayAll(wal).size() == 3 && wal.getLastLsn() == 3, "Intact records are kept");
+
+    WalRecord next = makeRecord(4, "after");
+    wal.append(next);
+    QVector<WalRecord> records = replayAll(wal);
+    assert_test(records.size() == 4 && records.last().lsn == 4 && records.last().values[1] == "after",
+                "New records follow the intact ones");
+}
+
+// Test Suite 3: A record with a bad CRC ends the log
+void test_checksum_mismatch() {
+    print_separator("TEST SUITE 3: Checksum Mismatch Mid-Segment");
+    resetDataDir();
+
+    QVector<qint64> sizes;
+    {
+        WriteAheadLog wal(DATA_DIR);
+        wal.open();
+        sizes.append(wal.getSize());
+        for (int i = 1; i <= 5; ++i) {
+            WalRecord record = makeRecord(i, QString("value %1").arg(i));
+            wal.append(record);
+            sizes.append(wal.getSize());
+        }
+        wal.close();
+    }
+
+    // Flip a byte in the payload of the third record
+    QFile segment(segmentFile(1));
+    segment.open(QIODevice::ReadWrite);
+    segment.seek(sizes[2] + 12);
+    QByteArray byte = segment.read(1);
+    byte[0] = static_cast<char>(byte[0] ^ 0x20);
+    segment.seek(sizes[2] + 12);
+    segment.write(byte);
+    segment.close();
+
+    WriteAheadLog wal(DATA_DIR);
+    assert_test(wal.open(), "Log with a corrupt record opens");
+    QVector<WalRecord> records = replayAll(wal);
+    assert_test(records.size() == 2 && records.last().lsn == 2, "Replay stops before the corrupt record");
+    assert_test(QFile(segmentFile(1)).size() == sizes[2], "Corrupt record and everything after it are discarded");
+}
+
+// Test Suite 4: Segment rotation and removal after a checkpoint
+void test_segments() {
+    print_separator("TEST SUITE 4: Segment Rotation");
+    resetDataDir();
+
+    {
+        WriteAheadLog wal(DATA_DIR);
+        wal.open();
+        assert_test(wal.rotate() == 1, "Rotating an empty segment keeps it");
+
+        for (int i = 1; i <= 2; ++i) {
+            WalRecord record = makeRecord(i, "old");
+            wal.append(record);
+        }
+        int active = wal.rotate();
+        assert_test(active == 2 && QFile::exists(segmentFile(1)) && QFile::exists(segmentFile(2)),
+                    "Rotation starts a new segment");
+        assert_test(wal.getFilePath() == segmentFile(2), "New records go to the new segment");
+
+        for (int i = 3; i <= 4; ++i) {
+            WalRecord record = makeRecord(i, "new");
+            wal.append(record);
+        }
+        QVector<WalRecord> records = replayAll(wal);
+        assert_test(records.size() == 4 && records[0].lsn == 1 && records[3].lsn == 4,
+                    "Replay reads every segment in order");
+
+        qint64 sizeBefore = wal.getSize();
+        qint64 oldSegmentSize = QFile(segmentFile(1)).size();
+        wal.removeSegmentsBefore(active);
+        assert_test(!QFile::exists(segmentFile(1)) && QFile::exists(segmentFile(2)), "Older segment is removed");
+        assert_test(wal.getSize() == sizeBefore - oldSegmentSize, "Size no longer counts the removed segment");
+
+        records = replayAll(wal);
+        assert_test(records.size() == 2 && records[0].lsn == 3, "Replay starts at the remaining segment");
+
+        wal.removeSegmentsBefore(active + 1);
+        assert_test(QFile::exists(segmentFile(2)), "The active segment is never removed");
+
+        // A segment whose records are all removed still carries the numbering forward
+        assert_test(wal.rotate() == 3, "Rotation after removal continues segment ids");
+        wal.removeSegmentsBefore(3);
+        wal.close();
+    }
+
+    WriteAheadLog wal(DATA_DIR);
+    assert_test(wal.open() && wal.isEmpty(), "Reopened log holds only the empty active segment");
+    WalRecord next = makeRecord(5, "later");
+    assert_test(wal.append(next) && next.lsn == 5, "LSNs never go backwards after segments are removed");
+}
+
+int main() {
+    test_replay_after_reopen();
+    test_torn_tail();
+    test_checksum_mismatch();
+    test_segments();
+
+    QDir(DATA_DIR).removeRecursively();
+
+    print_separator("TEST SUMMARY");
+    cout << "Tests Run:    " << testsRun << endl;
+    cout << "Tests Passed: " << testsPassed << endl;
+    cout << "Tests Failed: " << testsFailed << endl;
+
+    return testsFailed == 0 ? 0 : 1;
+}